@@ -0,0 +1,14 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase alloc_stats
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+include(../circuitMaster_core/circuitMaster_core.pri)
+
+SOURCES +=  tst_allocationstats_tests.cpp \
+            ../circuitMaster_core/coreTestFunctions.cpp
+
+HEADERS += ../circuitMaster_core/coreTestFunctions.h
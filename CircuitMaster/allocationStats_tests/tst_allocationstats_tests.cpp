@@ -0,0 +1,84 @@
+#include <QtTest>
+#include <memory>
+#include "../circuitMaster_core/allocationStats.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+
+/*!
+*\file
+*\brief Тесты для учета выделений памяти по этапам расчета
+*/
+
+class allocationStats_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void phase_nestedScopeRestoresOuter();
+    void phase_allocationCountedInCurrentPhase();
+    void phase_calculationDoesNotAllocate();
+
+    void report_containsAllPhases();
+};
+
+void allocationStats_tests::phase_nestedScopeRestoresOuter()
+{
+    QCOMPARE(AllocationStats::currentPhase(), AllocationStats::Phase::other);
+    {
+        CORE_ALLOCATION_PHASE(treeBuild);
+        {
+            CORE_ALLOCATION_PHASE(evaluate);
+            QCOMPARE(AllocationStats::currentPhase(), AllocationStats::Phase::evaluate);
+        }
+        QCOMPARE(AllocationStats::currentPhase(), AllocationStats::Phase::treeBuild);
+    }
+    QCOMPARE(AllocationStats::currentPhase(), AllocationStats::Phase::other);
+}
+
+void allocationStats_tests::phase_allocationCountedInCurrentPhase()
+{
+    AllocationStats::reset();
+    {
+        CORE_ALLOCATION_PHASE(output);
+        std::unique_ptr<char[]> block(new char[1000]);
+        block[0] = 0;
+    }
+    AllocationStats::Counters output = AllocationStats::get(AllocationStats::Phase::output);
+    AllocationStats::Counters evaluate = AllocationStats::get(AllocationStats::Phase::evaluate);
+
+    QCOMPARE(output.allocations, size_t(1));
+    QCOMPARE(output.bytes, size_t(1000));
+    QVERIFY(output.peakLiveBytes >= 1000);
+    QCOMPARE(evaluate.allocations, size_t(0));
+}
+
+void allocationStats_tests::phase_calculationDoesNotAllocate()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"20\" frequency=\"50\">"
+        "<par><seq><elem><type>R</type><res>1</res></elem><elem><type>L</type><ind>0.01</ind></elem></seq>"
+        "<seq><elem><type>C</type><cap>0.001</cap></elem></seq></par>"
+        "</seq>", circuitMap);
+    QVERIFY(AllocationStats::get(AllocationStats::Phase::treeBuild).allocations > 0);
+
+    AllocationStats::reset();
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    // Расчет по готовому дереву не должен выделять память
+    QCOMPARE(AllocationStats::get(AllocationStats::Phase::evaluate).allocations, size_t(0));
+}
+
+void allocationStats_tests::report_containsAllPhases()
+{
+    std::string report = AllocationStats::report();
+    QVERIFY(report.find("загрузка документа: выделений ") != std::string::npos);
+    QVERIFY(report.find("построение дерева: выделений ") != std::string::npos);
+    QVERIFY(report.find("расчет: выделений ") != std::string::npos);
+    QVERIFY(report.find("вывод: выделений ") != std::string::npos);
+    QVERIFY(report.find("прочее: выделений ") != std::string::npos);
+}
+
+QTEST_APPLESS_MAIN(allocationStats_tests)
+
+#include "tst_allocationstats_tests.moc"
@@ -0,0 +1,12 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+linux: CONFIG += io_uring
+
+TEMPLATE = app
+
+include(../circuitMaster_core/circuitMaster_core.pri)
+
+SOURCES +=  tst_batchpipeline_tests.cpp
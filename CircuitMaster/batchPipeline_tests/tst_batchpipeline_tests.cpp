@@ -0,0 +1,368 @@
+#include <QtTest>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "../circuitMaster_core/batchFileIo.h"
+#include "../circuitMaster_core/batchPipeline.h"
+#include "../circuitMaster_core/boundedQueue.h"
+#include "../circuitMaster_core/circuitContainer.h"
+#include "../circuitMaster_core/liteXmlParser.h"
+#ifdef CIRCUITMASTER_IO_URING
+#include "../circuitMaster_core/uringFileIo.h"
+#endif
+
+/*!
+*\file
+*\brief Тесты для очереди между стадиями и конвейера пакетной обработки
+*/
+
+class batchPipeline_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void queue_fifoOrder();
+    void queue_fullQueue();
+    void queue_closedQueue();
+    void queue_manyProducersAndConsumers();
+
+    void evaluate_validCircuit();
+    void evaluate_invalidCircuit();
+    void evaluate_containerSectionsInOrder();
+    void evaluate_containerParallelMatchesSequential();
+    void evaluate_emptyContainer();
+    void evaluateFiles_sameAsSeparately();
+    void run_missingInputFile();
+
+    void uringFileIo_roundTrip();
+    void run_uringMatchesSync();
+};
+
+/*!
+* \brief Создать пустую временную папку для файлов теста
+* \param[in] name - имя папки
+* \return - путь к папке
+*/
+static std::filesystem::path emptyTestDirectory(std::string const & name)
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+/*!
+* \brief Прочитать файл целиком
+* \param[in] path - путь к файлу
+* \return - содержимое файла
+*/
+static std::string fileContent(std::filesystem::path const & path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+void batchPipeline_tests::queue_fifoOrder()
+{
+    BoundedQueue<int> queue(8);
+    for (int i = 0; i < 5; i++)
+        queue.push(i);
+
+    int value;
+    for (int i = 0; i < 5; i++)
+    {
+        QVERIFY(queue.tryPop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!queue.tryPop(value));
+}
+
+void batchPipeline_tests::queue_fullQueue()
+{
+    BoundedQueue<int> queue(3);
+    QCOMPARE(queue.capacity(), size_t(4));
+
+    for (int i = 0; i < 4; i++)
+        queue.push(i);
+
+    int extra = 4;
+    QVERIFY(!queue.tryPush(extra));
+
+    int value;
+    QVERIFY(queue.tryPop(value));
+    QVERIFY(queue.tryPush(extra));
+}
+
+void batchPipeline_tests::queue_closedQueue()
+{
+    BoundedQueue<int> queue(4);
+    queue.push(1);
+    queue.close();
+
+    int value;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(!queue.pop(value));
+}
+
+void batchPipeline_tests::queue_manyProducersAndConsumers()
+{
+    const int producerCount = 4, consumerCount = 4, valuesPerProducer = 20000;
+    BoundedQueue<int> queue(16);
+    std::atomic<long long> sum(0);
+    std::atomic<int> count(0), activeProducers(producerCount);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producerCount; p++)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= valuesPerProducer; i++)
+                queue.push(i);
+            if (activeProducers.fetch_sub(1) == 1)
+                queue.close();
+        });
+    }
+    for (int c = 0; c < consumerCount; c++)
+    {
+        threads.emplace_back([&]() {
+            int value;
+            while (queue.pop(value))
+            {
+                sum += value;
+                count++;
+            }
+        });
+    }
+    for (auto iter = threads.begin(); iter != threads.end(); iter++)
+        iter->join();
+
+    QCOMPARE(count.load(), producerCount * valuesPerProducer);
+    QCOMPARE(sum.load(), (long long)producerCount * valuesPerProducer * (valuesPerProducer + 1) / 2);
+}
+
+void batchPipeline_tests::evaluate_validCircuit()
+{
+    std::string output = BatchPipeline::evaluateCircuitText(
+        "<par voltage=\"10\">"
+        "<seq name=\"b\"><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq name=\"a\"><elem><type>L</type><res>10</res></elem></seq>"
+        "</par>", LiteXmlParser());
+
+    QCOMPARE(output, std::string("a = 0 - 1i\nb = 2\n"));
+}
+
+void batchPipeline_tests::evaluate_invalidCircuit()
+{
+    try {
+        BatchPipeline::evaluateCircuitText("<par><seq><elem><type>R</type><res>5</res></elem></seq></par>", LiteXmlParser());
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void batchPipeline_tests::evaluate_containerSectionsInOrder()
+{
+    std::string output = BatchPipeline::evaluateCircuitText(
+        "<circuits>\n"
+        "<seq voltage=\"10\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem></seq></seq>\n"
+        "<seq voltage=\"10\"><elem><type>R</type><res>0</res></elem></seq>\n"
+        "<par voltage=\"10\" frequency=\"50\"><seq name=\"a\"><elem><type>L</type><res>10</res></elem></seq></par>\n"
+        "</circuits>", LiteXmlParser());
+
+    // Ошибка во второй цепи не мешает расчету третьей, номера строк указаны относительно файла
+    QCOMPARE(output, std::string("circuit = 1\na = 2\n\n"
+                                 "circuit = 2\nerror = Недопустимое значение сопротивления на строке 3. "
+                                 "Значение сопротивления должно быть больше 0.\n\n"
+                                 "circuit = 3\na = 0 - 1i\n"));
+}
+
+void batchPipeline_tests::evaluateFiles_sameAsSeparately()
+{
+    // Файлы двух топологий вперемешку, контейнер и файлы с ошибками разбора и значений
+    std::vector<std::string> texts;
+    for (int i = 1; i <= 12; i++)
+    {
+        texts.push_back("<par voltage=\"" + std::to_string(i) + "\"><seq name=\"a\"><elem><type>R</type><res>" + std::to_string(i % 5) +
+                        "</res></elem></seq><seq name=\"b\"><elem><type>L</type><res>2</res></elem></seq></par>");
+        texts.push_back("<seq voltage=\"" + std::to_string(i) + "\" frequency=\"50\"><seq name=\"c\"><elem><type>C</type><cap>" +
+                        std::to_string(i) + "e-4</cap></elem></seq></seq>");
+    }
+    texts.push_back("<circuits><seq voltage=\"10\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem></seq></seq></circuits>");
+    texts.push_back("<seq");
+
+    std::vector<FileRequest> files(texts.size());
+    std::vector<FileRequest*> requests;
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        files[i].content = texts[i];
+        requests.push_back(&files[i]);
+    }
+
+    LiteXmlParser parser;
+    PlanCache planCache;
+    CircuitArena arena;
+    BatchPipeline::evaluateFiles(requests, parser, &planCache, &arena, BatchOptions());
+
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        std::string expected, expectedError;
+        try {
+            expected = BatchPipeline::evaluateCircuitText(texts[i], parser);
+        } catch (std::string const & str) {
+            expectedError = str;
+        }
+        QCOMPARE(files[i].error, expectedError);
+        if (expectedError.empty())
+            QCOMPARE(files[i].content, expected);
+    }
+
+    // Первый файл каждой топологии строит дерево соединений, файлы с нулевым сопротивлением рассчитываются обычным образом
+    QCOMPARE(planCache.getHits(), size_t(20));
+}
+
+void batchPipeline_tests::evaluate_containerParallelMatchesSequential()
+{
+    std::string text = "<circuits>";
+    for (int i = 1; i <= 100; i++)
+        text += "<par voltage=\"" + std::to_string(i) + "\"><seq name=\"a\"><elem><type>R</type><res>" + std::to_string(i % 7 + 1) +
+                "</res></elem></seq><seq name=\"b\"><elem><type>R</type><res>2</res></elem></seq></par>";
+    text += "</circuits>";
+    DocumentNode container = LiteXmlParser().parseText(text);
+
+    BatchOptions sequential;
+    sequential.computeThreads = 1;
+    BatchOptions parallel;
+    parallel.computeThreads = 4;
+    PlanCache planCache;
+
+    QCOMPARE(CircuitContainer::evaluate(container, parallel, &planCache), CircuitContainer::evaluate(container, sequential));
+    QCOMPARE(planCache.size(), size_t(1));
+}
+
+void batchPipeline_tests::evaluate_emptyContainer()
+{
+    QVERIFY_EXCEPTION_THROWN(BatchPipeline::evaluateCircuitText("<circuits></circuits>", LiteXmlParser()), std::string);
+}
+
+void batchPipeline_tests::run_missingInputFile()
+{
+    BatchJob job;
+    job.inputPath = "missing_input_file.xml";
+    job.outputPath = "missing_output_file.txt";
+
+    BatchOptions options;
+    options.computeThreads = 2;
+    BatchSummary summary = BatchPipeline(options).run({ job, job, job });
+
+    QCOMPARE(summary.total, size_t(3));
+    QCOMPARE(summary.succeeded, size_t(0));
+    QCOMPARE(summary.failed, size_t(3));
+    QCOMPARE(summary.errors.size(), size_t(3));
+}
+
+void batchPipeline_tests::uringFileIo_roundTrip()
+{
+#ifdef CIRCUITMASTER_IO_URING
+    std::unique_ptr<BatchFileIo> uring = UringFileIo::tryCreate(8);
+    if (!uring)
+        QSKIP("io_uring недоступен в ядре системы");
+    std::filesystem::path directory = emptyTestDirectory("circuitMaster_uringFileIo_tests");
+
+    // Групп больше, чем вмещает кольцо; файлы разного размера, в том числе пустой и больше одной страницы
+    std::vector<FileRequest> written(20);
+    for (size_t i = 0; i < written.size(); i++)
+    {
+        written[i].path = (directory / ("file" + std::to_string(i) + ".txt")).string();
+        written[i].content = std::string(i * i * 997, static_cast<char>('a' + i));
+    }
+    written.back().path = (directory / "missing" / "file.txt").string();
+    std::vector<FileRequest*> writeRequests;
+    for (auto iter = written.begin(); iter != written.end(); iter++)
+        writeRequests.push_back(&*iter);
+    uring->writeFiles(writeRequests);
+
+    std::vector<FileRequest> read(written.size());
+    std::vector<FileRequest*> readRequests;
+    for (size_t i = 0; i < read.size(); i++)
+    {
+        read[i].path = written[i].path;
+        readRequests.push_back(&read[i]);
+    }
+    uring->readFiles(readRequests);
+
+    QCOMPARE(uring->name(), std::string("uring"));
+    for (size_t i = 0; i + 1 < written.size(); i++)
+    {
+        QVERIFY(written[i].error.empty());
+        QVERIFY(read[i].error.empty());
+        QVERIFY(read[i].content == written[i].content);
+        QVERIFY(fileContent(written[i].path) == written[i].content);
+    }
+    QCOMPARE(written.back().error, std::string(outputFileErrorMessage));
+    QCOMPARE(read.back().error, std::string(inputFileErrorMessage));
+    std::filesystem::remove_all(directory);
+#else
+    QSKIP("Программа собрана без CONFIG += io_uring");
+#endif
+}
+
+void batchPipeline_tests::run_uringMatchesSync()
+{
+#ifdef CIRCUITMASTER_IO_URING
+    if (!UringFileIo::tryCreate())
+        QSKIP("io_uring недоступен в ядре системы");
+#else
+    QSKIP("Программа собрана без CONFIG += io_uring");
+#endif
+    std::filesystem::path directory = emptyTestDirectory("circuitMaster_uringPipeline_tests");
+    std::filesystem::create_directories(directory / "input");
+    for (int i = 1; i <= 30; i++)
+    {
+        std::ofstream file(directory / "input" / ("circuit" + std::to_string(100 + i) + ".xml"));
+        if (i % 10 == 0)
+            file << "<par><seq><elem><type>R</type><res>5</res></elem></seq></par>";
+        else
+            file << "<par voltage=\"" << i << "\"><seq name=\"a\"><elem><type>R</type><res>" << i % 7 + 1
+                 << "</res></elem></seq><seq name=\"b\"><elem><type>R</type><res>2</res></elem></seq></par>";
+    }
+
+    // Одинаковые задания выполняются с синхронным вводом-выводом и с io_uring, группами меньше количества файлов
+    std::vector<std::string> outputs[2];
+    BatchSummary summaries[2];
+    char const * backends[2] = { "sync", "uring" };
+    for (int b = 0; b < 2; b++)
+    {
+        std::filesystem::path outputDir = directory / backends[b];
+        std::vector<BatchJob> jobs = BatchPipeline::jobsFromDirectory((directory / "input").string(), outputDir.string());
+        BatchJob missing;
+        missing.inputPath = (directory / "input" / "missing.xml").string();
+        missing.outputPath = (outputDir / "missing.txt").string();
+        jobs.push_back(missing);
+
+        BatchOptions options;
+        options.computeThreads = 2;
+        options.ioBackend = backends[b];
+        options.ioBatchSize = 7;
+        summaries[b] = BatchPipeline(options).run(jobs);
+        for (auto iter = jobs.cbegin(); iter != jobs.cend(); iter++)
+            outputs[b].push_back(fileContent(iter->outputPath));
+    }
+
+    QCOMPARE(summaries[1].ioBackend, std::string("uring"));
+    QCOMPARE(summaries[1].total, summaries[0].total);
+    QCOMPARE(summaries[1].succeeded, size_t(27));
+    QCOMPARE(summaries[1].succeeded, summaries[0].succeeded);
+    QCOMPARE(summaries[1].failed, summaries[0].failed);
+    QCOMPARE(summaries[1].errors, summaries[0].errors);
+    QCOMPARE(outputs[1], outputs[0]);
+    std::filesystem::remove_all(directory);
+}
+
+QTEST_APPLESS_MAIN(batchPipeline_tests)
+
+#include "tst_batchpipeline_tests.moc"
@@ -1,9 +1,27 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    allocationStats_tests \
+    batchPipeline_tests \
     calculateCurrentAndVoltage_tests \
     calculateElemResistance_tests \
     calculateResistance_tests \
+    complexKernels_tests \
+    componentOptimizer_tests \
     connectionFromDocElement_tests \
-    circuitMaster_main
+    coreCircuit_tests \
+    coreMetrics_tests \
+    coreTrace_tests \
+    faultAnalysis_tests \
+    goalSeek_tests \
+    harmonicAnalysis_tests \
+    perfCounters_tests \
+    planCache_tests \
+    resonanceAnalysis_tests \
+    transferFunction_tests \
+    variantEvaluator_tests \
+    worstCaseAnalysis_tests \
+    circuitMaster_main \
+    circuitMaster_lite \
+    circuitMaster_bench
 
@@ -0,0 +1,102 @@
+#include "circuitGenerator.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/*!
+*\file
+*\brief Реализация функций создания больших случайных цепей для замеров
+*/
+
+namespace {
+
+/*!
+*\brief Состояние записи случайной цепи
+*/
+struct CircuitWriter
+{
+    std::ostream& stream; /*!< Поток для записи */
+    std::mt19937 random; /*!< Генератор случайных чисел */
+    size_t written = 0; /*!< Количество записанных соединений */
+
+    /*!
+    * \brief Записать открывающий тэг соединения, каждому тысячному соединению дать имя
+    * \param[in] tag - тэг соединения
+    */
+    void openConnection(char const * tag)
+    {
+        this->stream << '<' << tag;
+        if (this->written % 1000 == 999)
+            this->stream << " name=\"n" << this->written << '"';
+        this->stream << '>';
+        this->written++;
+    }
+
+    /*!
+    * \brief Записать простое последовательное соединение из резистора и, возможно, катушки и конденсатора
+    */
+    void writeLeaf()
+    {
+        this->openConnection("seq");
+        std::uniform_int_distribution<int> value(1, 1000);
+        this->stream << "<elem><type>R</type><res>" << value(this->random) << "</res></elem>";
+        if (this->random() % 2 == 0)
+            this->stream << "<elem><type>L</type><ind>0." << value(this->random) << "</ind></elem>";
+        if (this->random() % 2 == 0)
+            this->stream << "<elem><type>C</type><cap>0.000" << value(this->random) << "</cap></elem>";
+        this->stream << "</seq>";
+    }
+
+    /*!
+    * \brief Записать соединение и всех его потомков
+    * \param[in] count - количество соединений в поддереве вместе с этим соединением
+    * \param[in] isParallel - true для параллельного соединения, false для последовательного
+    */
+    void writeSubtree(size_t count, bool isParallel)
+    {
+        if (count == 1)
+        {
+            this->writeLeaf();
+            return;
+        }
+
+        // Каждый ребёнок получает хотя бы одно соединение, остальные распределяются случайно
+        size_t childCount = std::min<size_t>(count - 1, std::uniform_int_distribution<size_t>(2, 6)(this->random));
+        std::vector<double> weights(childCount);
+        double weightSum = 0;
+        for (auto iter = weights.begin(); iter != weights.end(); iter++)
+            weightSum += *iter = std::uniform_real_distribution<double>(0, 1)(this->random);
+
+        size_t rest = count - 1 - childCount;
+        std::vector<size_t> sizes(childCount, 1);
+        size_t distributed = 0;
+        for (size_t i = 0; i + 1 < childCount; i++)
+        {
+            size_t part = static_cast<size_t>(rest * weights[i] / weightSum);
+            part = std::min(part, rest - distributed);
+            sizes[i] += part;
+            distributed += part;
+        }
+        sizes.back() += rest - distributed;
+
+        char const * tag = isParallel ? "par" : "seq";
+        this->openConnection(tag);
+        for (auto iter = sizes.cbegin(); iter != sizes.cend(); iter++)
+            this->writeSubtree(*iter, !isParallel);
+        this->stream << "</" << tag << '>';
+    }
+};
+
+}
+
+void writeGeneratedCircuit(std::ostream& stream, size_t connectionCount, unsigned seed)
+{
+    CircuitWriter writer{ stream, std::mt19937(seed) };
+
+    // Корень - последовательное соединение с напряжением и частотой, поэтому у параллельных соединений
+    // следующего уровня есть общий ток
+    stream << "<seq voltage=\"230\" frequency=\"50\">";
+    writer.written++;
+    writer.writeSubtree(std::max<size_t>(connectionCount, 2) - 1, true);
+    stream << "</seq>\n";
+}
@@ -0,0 +1,24 @@
+#ifndef CIRCUITGENERATOR_H
+#define CIRCUITGENERATOR_H
+#include <cstddef>
+#include <ostream>
+
+/*!
+*\file
+*\brief Заголовки функций создания больших случайных цепей для замеров
+*/
+
+/*!
+* \brief Записать случайную цепь в формате входного файла
+*
+* Соединения чередуются по уровням: параллельные, затем последовательные со вложенными соединениями; у каждого
+* от 2 до 6 детей. Листья - простые последовательные соединения из 1-3 элементов, в каждом есть резистор, поэтому
+* сопротивления соединений не обращаются в 0. Каждое тысячное соединение получает имя. Цепь с одинаковыми
+* параметрами всегда одна и та же
+* \param[in] stream - поток для записи
+* \param[in] connectionCount - количество соединений, не меньше 2
+* \param[in] seed - начальное значение генератора случайных чисел
+*/
+void writeGeneratedCircuit(std::ostream& stream, size_t connectionCount, unsigned seed);
+
+#endif // CIRCUITGENERATOR_H
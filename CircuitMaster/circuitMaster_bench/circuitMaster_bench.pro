@@ -0,0 +1,19 @@
+# Замер времени расчета больших цепей (см. main.cpp). Аппаратные счетчики подключены по умолчанию в Linux,
+# CONFIG -= perf_counters - собрать без них
+# CONFIG += alloc_stats, trace - дополнительные отметки этапов, как у circuitMaster_lite
+
+TEMPLATE = app
+
+CONFIG += c++17 console warn_on
+CONFIG -= app_bundle
+CONFIG -= qt
+linux: CONFIG += perf_counters
+
+include(../circuitMaster_core/circuitMaster_core.pri)
+
+SOURCES += \
+        circuitGenerator.cpp \
+        main.cpp
+
+HEADERS += \
+        circuitGenerator.h
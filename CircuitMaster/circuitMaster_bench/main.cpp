@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <clocale>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "circuitArena.h"
+#include "circuitGenerator.h"
+#include "circuitState.h"
+#include "circuitTopology.h"
+#include "coreIo.h"
+#include "liteXmlParser.h"
+#include "perfCounters.h"
+
+/*!
+*\file
+*\brief Замер времени построения и расчета больших цепей
+*
+* Создание случайной цепи из N соединений (см. writeGeneratedCircuit):
+*\code
+circuitMaster_bench --generate=1600000 [--seed=S] C:\circuit.xml
+*\endcode
+* Замер: документ разбирается один раз, затем для каждого размещения дерево соединений строится заново
+* и рассчитывается --repeat раз, выводится наименьшее время каждого этапа:
+*\code
+circuitMaster_bench [--layout=arena|heap|all] [--child-lists=reserve|grow|all] [--repeat=K] [--perf-counters] C:\circuit.xml
+*\endcode
+* - \c arena - дерево в CircuitArena, \c heap - дерево в общей памяти: каждый объект выделяется отдельно
+* - \c reserve - список детей выделяется до их создания: в арене соединения и их списки идут подряд в порядке
+*   обхода в глубину; \c grow - список растет по мере добавления детей и в арене оказывается после поддерева
+* - \c all - все варианты (по умолчанию)
+*
+* Затем так же замеряется расчет по плоской топологии (CircuitTopology и CircuitState). С \c --perf-counters
+* для каждого размещения выводятся аппаратные счетчики этапов расчета, в том числе промахи кэша (сборка
+* с CONFIG += perf_counters, в Linux подключена по умолчанию)
+*/
+
+/*!
+* \brief Получить длительность вызова функции в секундах
+* \param[in] function - замеряемая функция
+* \return - длительность
+*/
+static double measureSeconds(std::function<void()> const & function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*!
+* \brief Построить дерево соединений в заданной памяти и замерить его расчет
+* \param[in] rootElement - корневой узел документа
+* \param[in] layoutName - название размещения для вывода
+* \param[in] resource - источник памяти дерева
+* \param[in] reserveChildren - выделять ли списки детей до их создания
+* \param[in] repeatCount - количество повторов расчета
+* \param[in] showPerfCounters - выводить ли аппаратные счетчики
+*/
+static void measureLayout(DocumentNode const & rootElement, std::string const & layoutName, std::pmr::memory_resource* resource,
+                          bool reserveChildren, unsigned long repeatCount, bool showPerfCounters)
+{
+    CircuitMap circuitMap(resource);
+    double buildSeconds = measureSeconds([&]() { circuitFromDocument(rootElement, circuitMap, reserveChildren); });
+    CoreConnection& rootConnection = circuitMap.begin()->second;
+
+    if (showPerfCounters)
+        PerfCounters::start();
+
+    double resistanceSeconds = -1, currentSeconds = -1;
+    for (unsigned long k = 0; k < repeatCount; k++)
+    {
+        double resistance = measureSeconds([&]() { rootConnection.calculateResistance(); });
+        double current = measureSeconds([&]() { rootConnection.calculateCurrentAndVoltage(); });
+        resistanceSeconds = k == 0 ? resistance : std::min(resistanceSeconds, resistance);
+        currentSeconds = k == 0 ? current : std::min(currentSeconds, current);
+    }
+
+    std::cout << layoutName << ": построение дерева " << buildSeconds << " с, calculateResistance " << resistanceSeconds
+              << " с, calculateCurrentAndVoltage " << currentSeconds << " с" << std::endl;
+    if (showPerfCounters)
+    {
+        PerfCounters::stop();
+        std::cout << PerfCounters::report();
+    }
+}
+
+/*!
+* \brief Замерить построение плоской топологии и её расчет
+* \param[in] rootElement - корневой узел документа
+* \param[in] repeatCount - количество повторов расчета
+*/
+static void measureTopology(DocumentNode const & rootElement, unsigned long repeatCount)
+{
+    CircuitArena arena;
+    CircuitMap circuitMap(arena.resource());
+    circuitFromDocument(rootElement, circuitMap);
+
+    CircuitTopology topology;
+    double buildSeconds = measureSeconds([&]() {
+        topology = CircuitTopology::fromConnection(circuitMap.begin()->second, frequencyFromDocument(rootElement));
+    });
+
+    CircuitState state;
+    double evaluateSeconds = -1;
+    for (unsigned long k = 0; k < repeatCount; k++)
+    {
+        double seconds = measureSeconds([&]() { state.evaluate(topology); });
+        evaluateSeconds = k == 0 ? seconds : std::min(evaluateSeconds, seconds);
+    }
+
+    std::cout << "topology: построение " << buildSeconds << " с, CircuitState::evaluate " << evaluateSeconds << " с" << std::endl;
+}
+
+/*!
+*\brief Главная функция программы замеров
+*\param[in] argv - путь к файлу цепи и необязательные параметры
+*\return 0 - замер прошел успешно
+*/
+int main(int argc, char *argv[])
+{
+    setlocale(LC_ALL, "Russian");
+
+    std::string path;
+    std::string layout = "all";
+    std::string childLists = "all";
+    unsigned long generateCount = 0, seed = 1, repeatCount = 5;
+    bool showPerfCounters = false;
+    try {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg(argv[i]);
+            if (arg.rfind("--generate=", 0) == 0)
+                generateCount = std::stoul(arg.substr(11));
+            else if (arg.rfind("--seed=", 0) == 0)
+                seed = std::stoul(arg.substr(7));
+            else if (arg.rfind("--repeat=", 0) == 0)
+                repeatCount = std::max(1ul, std::stoul(arg.substr(9)));
+            else if (arg.rfind("--layout=", 0) == 0)
+                layout = arg.substr(9);
+            else if (arg.rfind("--child-lists=", 0) == 0)
+                childLists = arg.substr(14);
+            else if (arg == "--perf-counters")
+                showPerfCounters = true;
+            else if (path.empty() && arg.rfind("--", 0) != 0)
+                path = arg;
+            else
+                throw std::invalid_argument(arg);
+        }
+        if (layout != "arena" && layout != "heap" && layout != "all")
+            throw std::invalid_argument(layout);
+        if (childLists != "reserve" && childLists != "grow" && childLists != "all")
+            throw std::invalid_argument(childLists);
+    } catch (std::exception const &) {
+        std::cerr << "Неверное значение параметра." << std::endl;
+        return 1;
+    }
+
+    if (path.empty())
+    {
+        std::cerr << "Неверное количество аргументов." << std::endl;
+        return 1;
+    }
+
+    if (generateCount > 0)
+    {
+        std::ofstream stream(path, std::ios::binary);
+        writeGeneratedCircuit(stream, generateCount, static_cast<unsigned>(seed));
+        if (!stream)
+        {
+            std::cerr << "Не удалось записать файл цепи: \"" << path << "\"." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (showPerfCounters && !PerfCounters::isCompiledIn())
+        std::cerr << "Счетчики производительности недоступны: программа собрана без CONFIG += perf_counters." << std::endl;
+    showPerfCounters = showPerfCounters && PerfCounters::isCompiledIn();
+
+    try {
+        DocumentNode rootElement;
+        double parseSeconds = measureSeconds([&]() { rootElement = LiteXmlParser().parseFile(path); });
+        std::cout << "Разбор xml: " << parseSeconds << " с" << std::endl;
+
+        // Размещения выводятся одно под другим: сначала с выделением списков детей заранее, затем без него
+        for (bool reserveChildren : { true, false })
+        {
+            if (childLists == (reserveChildren ? "grow" : "reserve"))
+                continue;
+            std::string suffix = reserveChildren ? "/reserve" : "/grow";
+            if (layout != "heap")
+            {
+                CircuitArena arena;
+                measureLayout(rootElement, "arena" + suffix, arena.resource(), reserveChildren, repeatCount, showPerfCounters);
+            }
+            if (layout != "arena")
+                measureLayout(rootElement, "heap" + suffix, std::pmr::get_default_resource(), reserveChildren, repeatCount,
+                              showPerfCounters);
+        }
+        measureTopology(rootElement, repeatCount);
+    } catch (std::string const & str) {
+        std::cerr << str << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "allocationStats.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "coreStrings.h"
+
+/*!
+*\file
+*\brief Реализация функций учета выделений памяти по этапам расчета
+*/
+
+namespace {
+
+const size_t phaseCount = static_cast<size_t>(AllocationStats::Phase::count); /*!< Количество этапов */
+
+std::atomic<size_t> allocationCounts[phaseCount]; /*!< Количество выделений по этапам */
+std::atomic<size_t> allocatedBytes[phaseCount]; /*!< Выделено байт по этапам */
+std::atomic<size_t> peakLiveBytes[phaseCount]; /*!< Наибольший объем занятой памяти по этапам */
+std::atomic<size_t> liveBytesTotal(0); /*!< Объем занятой памяти */
+thread_local AllocationStats::Phase threadPhase = AllocationStats::Phase::other; /*!< Этап текущего потока */
+
+/*!
+* \brief Увеличить наибольший объем занятой памяти этапа
+* \param[in] phase - номер этапа
+* \param[in] live - текущий объем занятой памяти
+*/
+void raisePeak(size_t phase, size_t live)
+{
+    size_t peak = peakLiveBytes[phase].load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveBytes[phase].compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+}
+
+bool AllocationStats::isCompiledIn()
+{
+#ifdef CIRCUITMASTER_ALLOC_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationStats::reset()
+{
+    size_t live = liveBytesTotal.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < phaseCount; i++)
+    {
+        allocationCounts[i].store(0, std::memory_order_relaxed);
+        allocatedBytes[i].store(0, std::memory_order_relaxed);
+        peakLiveBytes[i].store(0, std::memory_order_relaxed);
+    }
+    raisePeak(static_cast<size_t>(threadPhase), live);
+}
+
+AllocationStats::Counters AllocationStats::get(Phase phase)
+{
+    size_t index = static_cast<size_t>(phase);
+    Counters counters;
+    counters.allocations = allocationCounts[index].load(std::memory_order_relaxed);
+    counters.bytes = allocatedBytes[index].load(std::memory_order_relaxed);
+    counters.peakLiveBytes = peakLiveBytes[index].load(std::memory_order_relaxed);
+    return counters;
+}
+
+size_t AllocationStats::liveBytes()
+{
+    return liveBytesTotal.load(std::memory_order_relaxed);
+}
+
+std::string AllocationStats::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::documentLoad:
+        return "загрузка документа";
+    case Phase::treeBuild:
+        return "построение дерева";
+    case Phase::evaluate:
+        return "расчет";
+    case Phase::output:
+        return "вывод";
+    default:
+        return "прочее";
+    }
+}
+
+std::string AllocationStats::report()
+{
+    std::string text = "Выделения памяти по этапам:\n";
+    Phase phases[] = { Phase::documentLoad, Phase::treeBuild, Phase::evaluate, Phase::output, Phase::other };
+    for (Phase phase : phases)
+    {
+        Counters counters = get(phase);
+        text += formatStr("  %1: выделений %2, байт %3, наибольший объем занятой памяти %4 байт\n",
+                          { phaseName(phase), std::to_string(counters.allocations), std::to_string(counters.bytes),
+                            std::to_string(counters.peakLiveBytes) });
+    }
+    return text;
+}
+
+AllocationStats::Phase AllocationStats::currentPhase()
+{
+    return threadPhase;
+}
+
+void AllocationStats::setCurrentPhase(Phase phase)
+{
+    threadPhase = phase;
+    raisePeak(static_cast<size_t>(phase), liveBytesTotal.load(std::memory_order_relaxed));
+}
+
+#ifdef CIRCUITMASTER_ALLOC_STATS
+
+namespace {
+
+/*!
+*\brief Заголовок перед выделенным блоком: адрес, полученный от malloc, и запрошенный размер
+*/
+struct BlockHeader
+{
+    void* raw; /*!< Адрес для free */
+    size_t size; /*!< Запрошенный размер */
+};
+
+/*!
+* \brief Выделить блок и учесть его в счетчиках текущего этапа
+* \param[in] size - запрошенный размер
+* \param[in] alignment - требуемое выравнивание
+* \return - адрес блока или nullptr, если память не выделена
+*/
+void* countedAllocate(size_t size, size_t alignment)
+{
+    if (alignment < alignof(std::max_align_t))
+        alignment = alignof(std::max_align_t);
+
+    void* raw = std::malloc(size + alignment + sizeof(BlockHeader));
+    if (raw == nullptr)
+        return nullptr;
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(raw) + sizeof(BlockHeader);
+    address = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(address) - 1;
+    header->raw = raw;
+    header->size = size;
+
+    size_t phase = static_cast<size_t>(threadPhase);
+    allocationCounts[phase].fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes[phase].fetch_add(size, std::memory_order_relaxed);
+    raisePeak(phase, liveBytesTotal.fetch_add(size, std::memory_order_relaxed) + size);
+
+    return reinterpret_cast<void*>(address);
+}
+
+/*!
+* \brief Выделить блок, вызывая new_handler при нехватке памяти, как стандартный operator new
+* \param[in] size - запрошенный размер
+* \param[in] alignment - требуемое выравнивание
+* \return - адрес блока
+*/
+void* countedAllocateOrThrow(size_t size, size_t alignment)
+{
+    void* block;
+    while ((block = countedAllocate(size, alignment)) == nullptr)
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+    }
+    return block;
+}
+
+/*!
+* \brief Освободить блок, выделенный countedAllocate
+* \param[in] block - адрес блока
+*/
+void countedFree(void* block)
+{
+    if (block == nullptr)
+        return;
+
+    BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+    liveBytesTotal.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header->raw);
+}
+
+}
+
+void* operator new(size_t size) { return countedAllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return countedAllocateOrThrow(size, 0); }
+void* operator new(size_t size, std::nothrow_t const &) noexcept { return countedAllocate(size, 0); }
+void* operator new[](size_t size, std::nothrow_t const &) noexcept { return countedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept { return countedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept { return countedAllocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* block) noexcept { countedFree(block); }
+void operator delete[](void* block) noexcept { countedFree(block); }
+void operator delete(void* block, size_t) noexcept { countedFree(block); }
+void operator delete[](void* block, size_t) noexcept { countedFree(block); }
+void operator delete(void* block, std::nothrow_t const &) noexcept { countedFree(block); }
+void operator delete[](void* block, std::nothrow_t const &) noexcept { countedFree(block); }
+void operator delete(void* block, std::align_val_t) noexcept { countedFree(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { countedFree(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { countedFree(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { countedFree(block); }
+void operator delete(void* block, std::align_val_t, std::nothrow_t const &) noexcept { countedFree(block); }
+void operator delete[](void* block, std::align_val_t, std::nothrow_t const &) noexcept { countedFree(block); }
+
+#endif // CIRCUITMASTER_ALLOC_STATS
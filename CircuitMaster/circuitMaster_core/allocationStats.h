@@ -0,0 +1,140 @@
+#ifndef ALLOCATIONSTATS_H
+#define ALLOCATIONSTATS_H
+#include <cstddef>
+#include <string>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций учета выделений памяти по этапам расчета
+*
+* В сборке с CONFIG += alloc_stats (CIRCUITMASTER_ALLOC_STATS) глобальные operator new и
+* operator delete заменяются версиями, которые считают выделения текущего этапа потока.
+* Этапы отмечаются макросом CORE_ALLOCATION_PHASE, который без этого флага не создает кода
+*/
+
+/*!
+*\class AllocationStats
+*\brief Счетчики выделений памяти по этапам расчета
+*/
+class AllocationStats
+{
+    public:
+    /*!
+    *\enum Phase
+    *\brief Этап расчета
+    */
+    enum class Phase
+    {
+        other, /*!< Вне отмеченных этапов */
+        documentLoad, /*!< Чтение и разбор документа */
+        treeBuild, /*!< Построение дерева соединений или чтение значений для готовой топологии */
+        evaluate, /*!< Расчет сопротивлений, сил тока и напряжений */
+        output, /*!< Формирование и запись результата */
+        count /*!< Количество этапов */
+    };
+
+    /*!
+    *\class Counters
+    *\brief Значения счетчиков одного этапа
+    */
+    class Counters
+    {
+        public:
+        size_t allocations = 0; /*!< Количество выделений */
+        size_t bytes = 0; /*!< Выделено байт */
+        size_t peakLiveBytes = 0; /*!< Наибольший объем занятой процессом памяти во время этапа */
+    };
+
+    /*!
+    * \brief Проверить, собрана ли программа с учетом выделений
+    * \return - true, если определен CIRCUITMASTER_ALLOC_STATS
+    */
+    static bool isCompiledIn();
+
+    /*!
+    * \brief Обнулить счетчики всех этапов
+    */
+    static void reset();
+
+    /*!
+    * \brief Получить счетчики этапа
+    * \param[in] phase - этап
+    * \return - значения счетчиков
+    */
+    static Counters get(Phase phase);
+
+    /*!
+    * \brief Получить объем занятой через operator new памяти
+    * \return - количество байт
+    */
+    static size_t liveBytes();
+
+    /*!
+    * \brief Получить название этапа
+    * \param[in] phase - этап
+    * \return - название
+    */
+    static std::string phaseName(Phase phase);
+
+    /*!
+    * \brief Сформировать таблицу счетчиков всех этапов
+    * \return - текст таблицы
+    */
+    static std::string report();
+
+    /*!
+    * \brief Получить этап, выполняемый текущим потоком
+    * \return - этап
+    */
+    static Phase currentPhase();
+
+    /*!
+    * \brief Задать этап, выполняемый текущим потоком
+    * \param[in] phase - этап
+    */
+    static void setCurrentPhase(Phase phase);
+};
+
+/*!
+*\class AllocationPhaseScope
+*\brief Этап расчета от создания объекта до выхода из области видимости. Вложенный этап
+* после завершения возвращает внешний
+*/
+class AllocationPhaseScope
+{
+    public:
+    /*!
+    * \brief Конструктор этапа
+    * \param[in] phase - этап
+    */
+    AllocationPhaseScope(AllocationStats::Phase phase)
+        : previous(AllocationStats::currentPhase())
+    {
+        AllocationStats::setCurrentPhase(phase);
+    }
+
+    /*!
+    * \brief Деструктор, возвращает предыдущий этап
+    */
+    ~AllocationPhaseScope()
+    {
+        AllocationStats::setCurrentPhase(this->previous);
+    }
+
+    AllocationPhaseScope(AllocationPhaseScope const &) = delete;
+    AllocationPhaseScope& operator=(AllocationPhaseScope const &) = delete;
+
+    private:
+    AllocationStats::Phase previous; /*!< Этап до начала текущего */
+};
+
+#ifdef CIRCUITMASTER_ALLOC_STATS
+#define CORE_ALLOCATION_CONCAT_IMPL(a, b) a##b
+#define CORE_ALLOCATION_CONCAT(a, b) CORE_ALLOCATION_CONCAT_IMPL(a, b)
+/*! Отметить этап до конца текущей области видимости */
+#define CORE_ALLOCATION_PHASE(phase) AllocationPhaseScope CORE_ALLOCATION_CONCAT(coreAllocationPhase, __LINE__)(AllocationStats::Phase::phase)
+#else
+#define CORE_ALLOCATION_PHASE(phase) ((void)0)
+#endif
+
+#endif // ALLOCATIONSTATS_H
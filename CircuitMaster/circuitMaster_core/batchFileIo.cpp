@@ -0,0 +1,66 @@
+#include "batchFileIo.h"
+#include <cstdio>
+#include "documentParser.h"
+#ifdef CIRCUITMASTER_IO_URING
+#include "uringFileIo.h"
+#endif
+
+/*!
+*\file
+*\brief Реализация функций классов файлового ввода-вывода пакетной обработки
+*/
+
+const char* const inputFileErrorMessage = "Неверно указан файл для входных данных. Возможно указанного расположения не существует или нет прав на запись.";
+
+const char* const outputFileErrorMessage = "Неверно указан файл для выходных данных. Возможно указанного расположения не существует или нет прав на запись.";
+
+std::unique_ptr<BatchFileIo> BatchFileIo::create(std::string const & name)
+{
+    if (name.empty() || name == "sync")
+        return std::unique_ptr<BatchFileIo>(new SyncFileIo());
+
+    if (name == "uring")
+    {
+#ifdef CIRCUITMASTER_IO_URING
+        std::unique_ptr<BatchFileIo> uring = UringFileIo::tryCreate();
+        if (uring)
+            return uring;
+#endif
+        // io_uring недоступен - используем синхронный ввод-вывод
+        return std::unique_ptr<BatchFileIo>(new SyncFileIo());
+    }
+
+    throw std::string("Неизвестный способ ввода-вывода \"" + name + "\".");
+}
+
+void SyncFileIo::readFiles(std::vector<FileRequest*> const & requests)
+{
+    for (auto iter = requests.begin(); iter != requests.end(); iter++)
+    {
+        if (!readWholeFile((*iter)->path, (*iter)->content))
+            (*iter)->error = inputFileErrorMessage;
+    }
+}
+
+void SyncFileIo::writeFiles(std::vector<FileRequest*> const & requests)
+{
+    for (auto iter = requests.begin(); iter != requests.end(); iter++)
+    {
+        FileRequest& request = **iter;
+        FILE* outFile = std::fopen(request.path.c_str(), "w");
+        if (outFile == nullptr)
+        {
+            request.error = outputFileErrorMessage;
+            continue;
+        }
+
+        if (std::fwrite(request.content.data(), 1, request.content.size(), outFile) != request.content.size())
+            request.error = outputFileErrorMessage;
+        std::fclose(outFile);
+    }
+}
+
+std::string SyncFileIo::name() const
+{
+    return "sync";
+}
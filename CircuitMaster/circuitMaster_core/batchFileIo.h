@@ -0,0 +1,85 @@
+#ifndef BATCHFILEIO_H
+#define BATCHFILEIO_H
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций классов файлового ввода-вывода пакетной обработки
+*/
+
+/*!
+*\class FileRequest
+*\brief Запрос на чтение или запись одного файла
+*/
+class FileRequest
+{
+    public:
+    std::string path; /*!< Путь к файлу */
+    std::string content; /*!< Содержимое файла: результат чтения или данные для записи */
+    std::string error; /*!< Сообщение об ошибке, пустое если ошибок нет */
+};
+
+/*!
+*\class BatchFileIo
+*\brief Файловый ввод-вывод стадий чтения и записи пакетной обработки
+*
+* Файлы читаются и записываются группами, что позволяет реализациям отправлять
+* запросы к системе пакетно. Ошибки не выбрасываются, а записываются в FileRequest::error
+*/
+class BatchFileIo
+{
+    public:
+    virtual ~BatchFileIo() = default;
+
+    /*!
+    * \brief Прочитать группу файлов целиком
+    * \param[in,out] requests - запросы, заполняются content или error
+    */
+    virtual void readFiles(std::vector<FileRequest*> const & requests) = 0;
+
+    /*!
+    * \brief Записать группу файлов, существующие файлы перезаписываются
+    * \param[in,out] requests - запросы, при ошибке заполняется error
+    */
+    virtual void writeFiles(std::vector<FileRequest*> const & requests) = 0;
+
+    /*!
+    * \brief Получить имя реализации
+    * \return - имя реализации
+    */
+    virtual std::string name() const = 0;
+
+    /*!
+    * \brief Создать реализацию ввода-вывода по имени
+    * \param[in] name - "sync" (по умолчанию) или "uring". Если io_uring недоступен в сборке
+    * или в ядре системы, создается "sync"
+    * \return - созданная реализация
+    */
+    static std::unique_ptr<BatchFileIo> create(std::string const & name = "");
+};
+
+/*!
+*\class SyncFileIo
+*\brief Синхронный ввод-вывод: файлы открываются, читаются и закрываются по одному
+*/
+class SyncFileIo : public BatchFileIo
+{
+    public:
+    void readFiles(std::vector<FileRequest*> const & requests) override;
+    void writeFiles(std::vector<FileRequest*> const & requests) override;
+    std::string name() const override;
+};
+
+/*!
+* \brief Сообщение об ошибке открытия файла с входными данными
+*/
+extern const char* const inputFileErrorMessage;
+
+/*!
+* \brief Сообщение об ошибке открытия файла для выходных данных
+*/
+extern const char* const outputFileErrorMessage;
+
+#endif // BATCHFILEIO_H
@@ -0,0 +1,422 @@
+#include "batchPipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <thread>
+#include "allocationStats.h"
+#include "batchFileIo.h"
+#include "boundedQueue.h"
+#include "circuitContainer.h"
+#include "coreConnection.h"
+#include "coreIo.h"
+#include "coreMetrics.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация конструкторов и функций пакетной обработки файлов
+*/
+
+namespace
+{
+
+/*!
+*\brief Задание, передаваемое между стадиями конвейера
+*/
+struct BatchItem
+{
+    size_t jobIndex = 0; /*!< Номер задания */
+    FileRequest file; /*!< Входной файл, после расчета - выходной файл */
+};
+
+/*!
+* \brief Посчитать соединения и элементы в документе
+* \param[in] node - узел документа
+* \param[in,out] connections - количество соединений
+* \param[in,out] elements - количество элементов
+*/
+void countCircuitSize(DocumentNode const & node, size_t& connections, size_t& elements)
+{
+    if (node.tagName == "seq" || node.tagName == "par")
+        connections++;
+    else if (node.tagName == "elem")
+    {
+        elements++;
+        return;
+    }
+
+    for (auto iter = node.children.cbegin(); iter != node.children.cend(); iter++)
+        countCircuitSize(*iter, connections, elements);
+}
+
+/*!
+* \brief Разобрать текст входного файла и учесть размер цепи в метриках
+* \param[in] content - текст входного файла
+* \param[in] parser - разборщик входных данных
+* \return - корневой узел документа
+*/
+DocumentNode parseCircuitText(std::string const & content, DocumentParser const & parser)
+{
+    DocumentNode rootElement;
+    try {
+        MetricsTimer timer(Metrics::Phase::parse);
+        rootElement = parser.parseText(content);
+    } catch (std::string const &) {
+        Metrics::countError(Metrics::Phase::parse);
+        throw;
+    }
+
+    size_t connections = 0;
+    size_t elements = 0;
+    countCircuitSize(rootElement, connections, elements);
+    Metrics::observeCircuitSize(connections, elements);
+    return rootElement;
+}
+
+/*!
+* \brief Рассчитать разобранный документ: одну цепь или контейнер цепей
+* \param[in] rootElement - корневой узел документа
+* \param[in,out] planCache - кэш топологий, nullptr - рассчитывать без кэша
+* \param[in,out] arena - память для дерева соединений, nullptr - общая память
+* \param[in] normalizeTree - упростить дерево соединений перед расчетом
+* \return - текст для записи в выходной файл
+*/
+std::string evaluateParsedDocument(DocumentNode const & rootElement, PlanCache* planCache, CircuitArena* arena, bool normalizeTree)
+{
+    try {
+        MetricsTimer timer(Metrics::Phase::evaluate);
+
+        // Цепи контейнера рассчитываются по очереди: файлы уже распределены между потоками расчета
+        if (CircuitContainer::isContainer(rootElement))
+        {
+            BatchOptions containerOptions;
+            containerOptions.computeThreads = 1;
+            containerOptions.normalizeTree = normalizeTree;
+            return CircuitContainer::evaluate(rootElement, containerOptions, planCache, arena);
+        }
+
+        return BatchPipeline::evaluateCircuit(rootElement, planCache, arena, normalizeTree);
+    } catch (std::string const &) {
+        Metrics::countError(Metrics::Phase::evaluate);
+        throw;
+    }
+}
+
+/*!
+* \brief Выполнить расчет файла, записав в него результат или сообщение об ошибке
+* \param[in,out] file - файл
+* \param[in] evaluate - расчет, возвращающий текст для записи
+*/
+void evaluateFile(FileRequest& file, std::function<std::string()> const & evaluate)
+{
+    try {
+        file.content = evaluate();
+    } catch (std::string const & str) {
+        file.error = str;
+    } catch (std::exception const & error) {
+        // Исключения стандартной библиотеки (например, нехватка памяти) не должны завершать поток
+        file.error = std::string("Ошибка расчета: ") + error.what();
+    }
+}
+
+}
+
+BatchPipeline::BatchPipeline(BatchOptions const & startOptions)
+{
+    this->options = startOptions;
+}
+
+BatchSummary BatchPipeline::run(std::vector<BatchJob> const & jobs) const
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Потоков расчета не больше, чем заданий и ядер процессора: лишние потоки только простаивали бы
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned computeThreads = this->options.computeThreads;
+    if (computeThreads == 0 || computeThreads > hardwareThreads)
+        computeThreads = hardwareThreads;
+    computeThreads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(computeThreads, jobs.size())));
+
+    // Создаём разборщики заранее, чтобы ошибка в имени разборщика не останавливала потоки
+    std::vector<std::unique_ptr<DocumentParser>> parsers;
+    for (unsigned i = 0; i < computeThreads; i++)
+        parsers.push_back(DocumentParser::create(this->options.parserName));
+
+    BoundedQueue<BatchItem> readQueue(this->options.queueCapacity);
+    BoundedQueue<BatchItem> writeQueue(this->options.queueCapacity);
+    std::atomic<unsigned> activeWorkers(computeThreads);
+
+    // Кэш топологий общий для всех потоков расчета
+    std::unique_ptr<PlanCache> planCache;
+    if (this->options.usePlanCache)
+        planCache.reset(new PlanCache());
+
+    // Ввод-вывод создаётся отдельно для стадий чтения и записи, так как они работают в разных потоках
+    std::unique_ptr<BatchFileIo> readIo = BatchFileIo::create(this->options.ioBackend);
+    std::unique_ptr<BatchFileIo> writeIo = BatchFileIo::create(this->options.ioBackend);
+    size_t ioBatchSize = std::max<size_t>(1, this->options.ioBatchSize);
+    size_t variantGroupSize = std::max<size_t>(1, this->options.variantGroupSize);
+
+    // Стадия чтения
+    std::thread reader([&]() {
+        if (Trace::isEnabled())
+            Trace::setThreadName("reader");
+
+        std::vector<BatchItem> group;
+        std::vector<FileRequest*> requests;
+        for (size_t groupStart = 0; groupStart < jobs.size(); groupStart += ioBatchSize)
+        {
+            size_t groupSize = std::min(ioBatchSize, jobs.size() - groupStart);
+            group.assign(groupSize, BatchItem());
+            requests.clear();
+            for (size_t i = 0; i < groupSize; i++)
+            {
+                group[i].jobIndex = groupStart + i;
+                group[i].file.path = jobs[groupStart + i].inputPath;
+                requests.push_back(&group[i].file);
+            }
+
+            {
+                CORE_TRACE_SPAN("BatchFileIo::readFiles");
+                CORE_ALLOCATION_PHASE(documentLoad);
+                MetricsTimer timer(Metrics::Phase::read);
+                readIo->readFiles(requests);
+            }
+
+            for (size_t i = 0; i < groupSize; i++)
+            {
+                if (!group[i].file.error.empty())
+                    Metrics::countError(Metrics::Phase::read);
+            }
+
+            for (size_t i = 0; i < groupSize; i++)
+                readQueue.push(std::move(group[i]));
+        }
+        readQueue.close();
+    });
+
+    // Стадия расчета
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < computeThreads; i++)
+    {
+        DocumentParser const * parser = parsers[i].get();
+        workers.emplace_back([&, parser, i]() {
+            if (Trace::isEnabled())
+                Trace::setThreadName("compute " + std::to_string(i + 1));
+
+            // Арена потока расчета используется для всех его файлов
+            CircuitArena arena(256 * 1024, this->options.useHugePages);
+
+            // Ждём первый файл группы, затем добираем уже прочитанные, не дожидаясь заполнения группы
+            std::vector<BatchItem> group(variantGroupSize);
+            std::vector<FileRequest*> files;
+            while (readQueue.pop(group[0]))
+            {
+                size_t groupSize = 1;
+                while (groupSize < variantGroupSize && readQueue.tryPop(group[groupSize]))
+                    groupSize++;
+
+                files.clear();
+                for (size_t k = 0; k < groupSize; k++)
+                {
+                    if (group[k].file.error.empty())
+                        files.push_back(&group[k].file);
+                }
+                evaluateFiles(files, *parser, planCache.get(), &arena, this->options);
+
+                for (size_t k = 0; k < groupSize; k++)
+                {
+                    group[k].file.path = jobs[group[k].jobIndex].outputPath;
+                    writeQueue.push(std::move(group[k]));
+                }
+            }
+
+            // Последний завершившийся поток расчета закрывает очередь записи
+            if (activeWorkers.fetch_sub(1) == 1)
+                writeQueue.close();
+        });
+    }
+
+    // Стадия записи выполняется в текущем потоке: ждём первое задание группы,
+    // затем добираем уже готовые задания, не дожидаясь заполнения группы
+    BatchSummary summary;
+    summary.total = jobs.size();
+    summary.ioBackend = writeIo->name();
+    std::vector<BatchItem> group(ioBatchSize);
+    std::vector<FileRequest*> requests;
+    while (writeQueue.pop(group[0]))
+    {
+        size_t groupSize = 1;
+        while (groupSize < ioBatchSize && writeQueue.tryPop(group[groupSize]))
+            groupSize++;
+
+        requests.clear();
+        for (size_t i = 0; i < groupSize; i++)
+        {
+            if (group[i].file.error.empty())
+                requests.push_back(&group[i].file);
+        }
+        {
+            CORE_TRACE_SPAN("BatchFileIo::writeFiles");
+            CORE_ALLOCATION_PHASE(output);
+            MetricsTimer timer(Metrics::Phase::write);
+            writeIo->writeFiles(requests);
+        }
+
+        for (auto iter = requests.cbegin(); iter != requests.cend(); iter++)
+        {
+            if (!(*iter)->error.empty())
+                Metrics::countError(Metrics::Phase::write);
+        }
+
+        for (size_t i = 0; i < groupSize; i++)
+        {
+            Metrics::countRequest(group[i].file.error.empty());
+            if (group[i].file.error.empty())
+                summary.succeeded++;
+            else
+            {
+                summary.failed++;
+                summary.errors.push_back(jobs[group[i].jobIndex].inputPath + ": " + group[i].file.error);
+            }
+        }
+    }
+
+    reader.join();
+    for (auto iter = workers.begin(); iter != workers.end(); iter++)
+        iter->join();
+
+    // Ошибки выводятся в порядке входных файлов, а не в порядке завершения расчета
+    std::sort(summary.errors.begin(), summary.errors.end());
+
+    if (planCache != nullptr)
+        summary.planCacheHits = planCache->getHits();
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return summary;
+}
+
+std::string BatchPipeline::evaluateCircuitText(std::string const & content, DocumentParser const & parser, PlanCache* planCache,
+                                               CircuitArena* arena, bool normalizeTree)
+{
+    CORE_TRACE_SPAN("BatchPipeline::evaluateCircuitText");
+    return evaluateParsedDocument(parseCircuitText(content, parser), planCache, arena, normalizeTree);
+}
+
+std::string BatchPipeline::evaluateCircuit(DocumentNode const & rootElement, PlanCache* planCache, CircuitArena* arena, bool normalizeTree)
+{
+    // Дерево предыдущей цепи уже уничтожено, его память используется повторно
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+    if (arena != nullptr)
+    {
+        arena->release();
+        resource = arena->resource();
+    }
+
+    if (planCache != nullptr)
+        return planCache->evaluateDocument(rootElement, resource, normalizeTree);
+
+    CircuitMap circuitMap(resource);
+    circuitFromDocument(rootElement, circuitMap);
+
+    CoreConnection& rootConnection = circuitMap.begin()->second;
+    if (normalizeTree)
+        rootConnection.normalize(circuitMap);
+    rootConnection.calculateResistance();
+    rootConnection.calculateCurrentAndVoltage();
+
+    return formatOutput(circuitMap);
+}
+
+void BatchPipeline::evaluateFiles(std::vector<FileRequest*> const & files, DocumentParser const & parser, PlanCache* planCache,
+                                  CircuitArena* arena, BatchOptions const & options)
+{
+    CORE_TRACE_SPAN("BatchPipeline::evaluateFiles");
+
+    // Одиночные цепи с кэшем откладываются и группируются по топологии, остальное рассчитывается сразу
+    std::vector<DocumentNode> documents(files.size());
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        evaluateFile(*files[i], [&]() {
+            documents[i] = parseCircuitText(files[i]->content, parser);
+            if (planCache == nullptr || CircuitContainer::isContainer(documents[i]))
+                return evaluateParsedDocument(documents[i], planCache, arena, options.normalizeTree);
+            groups[PlanCache::topologySignature(documents[i])].push_back(i);
+            return std::string();
+        });
+    }
+
+    for (auto group = groups.cbegin(); group != groups.cend(); group++)
+    {
+        std::vector<size_t> const & indices = group->second;
+        auto evaluateSeparately = [&](size_t i) {
+            evaluateFile(*files[i], [&]() { return evaluateParsedDocument(documents[i], planCache, arena, options.normalizeTree); });
+        };
+
+        // Первый файл новой топологии рассчитывается обычным образом и сохраняет её в кэш
+        size_t first = 0;
+        if (planCache->find(group->first) == nullptr)
+        {
+            evaluateSeparately(indices[0]);
+            first = 1;
+        }
+        if (first == indices.size())
+            continue;
+
+        std::vector<DocumentNode const *> rootElements;
+        for (size_t k = first; k < indices.size(); k++)
+            rootElements.push_back(&documents[indices[k]]);
+
+        // Длительность совместного расчета делится между файлами группы поровну
+        std::vector<std::string> outputs;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<bool> evaluated = planCache->evaluateDocuments(group->first, rootElements, outputs, options.precision,
+                                                                   options.floatTolerance);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t k = 0; k < rootElements.size(); k++)
+        {
+            size_t i = indices[first + k];
+            if (!evaluated[k])
+            {
+                evaluateSeparately(i);
+                continue;
+            }
+            Metrics::observeDuration(Metrics::Phase::evaluate, seconds / rootElements.size());
+            files[i]->content = std::move(outputs[k]);
+        }
+    }
+}
+
+std::vector<BatchJob> BatchPipeline::jobsFromDirectory(std::string const & inputDir, std::string const & outputDir)
+{
+    namespace fs = std::filesystem;
+    std::error_code errorCode;
+
+    if (!fs::is_directory(inputDir, errorCode))
+        throw std::string("Неверно указана папка с входными данными: \"" + inputDir + "\".");
+
+    fs::create_directories(outputDir, errorCode);
+    if (!fs::is_directory(outputDir, errorCode))
+        throw std::string("Не удалось создать папку для выходных данных: \"" + outputDir + "\".");
+
+    std::vector<BatchJob> jobs;
+    for (auto const & entry : fs::directory_iterator(inputDir, errorCode))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".xml")
+            continue;
+
+        BatchJob job;
+        job.inputPath = entry.path().string();
+        job.outputPath = (fs::path(outputDir) / entry.path().stem()).string() + ".txt";
+        jobs.push_back(job);
+    }
+
+    std::sort(jobs.begin(), jobs.end(), [](BatchJob const & a, BatchJob const & b) { return a.inputPath < b.inputPath; });
+    return jobs;
+}
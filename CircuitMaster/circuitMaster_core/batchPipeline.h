@@ -0,0 +1,138 @@
+#ifndef BATCHPIPELINE_H
+#define BATCHPIPELINE_H
+#include <string>
+#include <vector>
+#include "batchFileIo.h"
+#include "circuitArena.h"
+#include "documentParser.h"
+#include "planCache.h"
+#include "variantEvaluator.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций пакетной обработки файлов
+*/
+
+/*!
+*\class BatchJob
+*\brief Задание пакетной обработки: входной и выходной файл
+*/
+class BatchJob
+{
+    public:
+    std::string inputPath; /*!< Путь к файлу с входными данными */
+    std::string outputPath; /*!< Путь к файлу для записи выходных данных */
+};
+
+/*!
+*\class BatchOptions
+*\brief Параметры пакетной обработки
+*/
+class BatchOptions
+{
+    public:
+    unsigned computeThreads = 0; /*!< Количество потоков расчета, 0 - по числу ядер процессора */
+    size_t queueCapacity = 256; /*!< Вместимость очередей между стадиями */
+    std::string parserName; /*!< Имя разборщика входных данных, пустое - по умолчанию */
+    std::string ioBackend; /*!< Способ файлового ввода-вывода (см. BatchFileIo::create), пустой - по умолчанию */
+    size_t ioBatchSize = 64; /*!< Количество файлов, читаемых или записываемых стадией за одно обращение */
+    bool usePlanCache = true; /*!< Использовать кэш топологий (см. PlanCache) */
+    bool useHugePages = false; /*!< Размещать деревья соединений в арене на больших страницах (см. CircuitArena) */
+    bool normalizeTree = false; /*!< Упрощать дерево соединений перед расчетом (см. CoreConnection::normalize) */
+    size_t variantGroupSize = 64; /*!< Наибольшее количество файлов, которые поток расчета берет из очереди за раз.
+                                       Файлы одной топологии из кэша рассчитываются вместе (см. PlanCache::evaluateDocuments) */
+    VariantEvaluator::Precision precision = VariantEvaluator::Precision::full; /*!< Точность совместного расчета файлов */
+    double floatTolerance = 1e-4; /*!< Допустимая относительная погрешность силы тока при расчете в float */
+};
+
+/*!
+*\class BatchSummary
+*\brief Итоги пакетной обработки
+*/
+class BatchSummary
+{
+    public:
+    size_t total = 0; /*!< Всего заданий */
+    size_t succeeded = 0; /*!< Успешно обработано */
+    size_t failed = 0; /*!< Обработано с ошибкой */
+    double seconds = 0; /*!< Время обработки в секундах */
+    std::string ioBackend; /*!< Использованный способ файлового ввода-вывода */
+    size_t planCacheHits = 0; /*!< Количество файлов, рассчитанных по готовой топологии из кэша */
+    std::vector<std::string> errors; /*!< Сообщения об ошибках в виде "путь: сообщение" */
+};
+
+/*!
+*\class BatchPipeline
+*\brief Конвейер пакетной обработки файлов
+*
+* Обработка разделена на три стадии: чтение файлов, расчет цепей и запись результатов.
+* Стадии работают в отдельных потоках и связаны ограниченными неблокирующими очередями
+* (см. BoundedQueue). Если расчет не успевает, чтение приостанавливается на заполненной очереди,
+* поэтому в памяти одновременно находится не больше заданий, чем вмещают очереди
+*/
+class BatchPipeline
+{
+    public:
+    /*!
+    * \brief Конструктор конвейера
+    * \param[in] startOptions - параметры обработки
+    */
+    BatchPipeline(BatchOptions const & startOptions);
+
+    private:
+    BatchOptions options; /*!< Параметры обработки */
+
+    public:
+    /*!
+    * \brief Выполнить задания
+    * \param[in] jobs - задания
+    * \return - итоги обработки
+    */
+    BatchSummary run(std::vector<BatchJob> const & jobs) const;
+
+    /*!
+    * \brief Рассчитать цепь по тексту входного файла. Файл может содержать контейнер цепей (см. CircuitContainer)
+    * \param[in] content - текст входного файла
+    * \param[in] parser - разборщик входных данных
+    * \param[in,out] planCache - кэш топологий, nullptr - рассчитывать без кэша
+    * \param[in,out] arena - память для дерева соединений, освобождается перед расчетом. nullptr - общая память
+    * \param[in] normalizeTree - упростить дерево соединений перед расчетом
+    * \return - текст для записи в выходной файл
+    */
+    static std::string evaluateCircuitText(std::string const & content, DocumentParser const & parser, PlanCache* planCache = nullptr,
+                                           CircuitArena* arena = nullptr, bool normalizeTree = false);
+
+    /*!
+    * \brief Рассчитать одну цепь по узлу документа
+    * \param[in] rootElement - корневой узел цепи \c <seq> или \c <par>
+    * \param[in,out] planCache - кэш топологий, nullptr - рассчитывать без кэша
+    * \param[in,out] arena - память для дерева соединений, освобождается перед расчетом. nullptr - общая память
+    * \param[in] normalizeTree - упростить дерево соединений перед расчетом
+    * \return - текст вывода цепи
+    */
+    static std::string evaluateCircuit(DocumentNode const & rootElement, PlanCache* planCache = nullptr, CircuitArena* arena = nullptr,
+                                       bool normalizeTree = false);
+
+    /*!
+    * \brief Рассчитать группу файлов. Файлы, топология которых уже есть в кэше, рассчитываются одним набором вариантов
+    * на топологию (см. PlanCache::evaluateDocuments), остальные - по одному, как в evaluateCircuitText
+    * \param[in,out] files - файлы: текст входного файла заменяется текстом для записи, при ошибке заполняется error
+    * \param[in] parser - разборщик входных данных
+    * \param[in,out] planCache - кэш топологий, nullptr - рассчитывать без кэша
+    * \param[in,out] arena - память для деревьев соединений, nullptr - общая память
+    * \param[in] options - параметры обработки: упрощение дерева, точность совместного расчета
+    */
+    static void evaluateFiles(std::vector<FileRequest*> const & files, DocumentParser const & parser, PlanCache* planCache,
+                              CircuitArena* arena, BatchOptions const & options);
+
+    /*!
+    * \brief Составить задания для всех файлов .xml в папке
+    * \param[in] inputDir - папка с входными файлами
+    * \param[in] outputDir - папка для выходных файлов, создается при необходимости. Имя выходного
+    * файла совпадает с именем входного с расширением .txt
+    * \return - задания в алфавитном порядке входных файлов
+    */
+    static std::vector<BatchJob> jobsFromDirectory(std::string const & inputDir, std::string const & outputDir);
+};
+
+#endif // BATCHPIPELINE_H
@@ -0,0 +1,190 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*!
+*\file
+*\brief Ограниченная неблокирующая очередь для передачи данных между стадиями конвейера
+*/
+
+/*!
+*\class BoundedQueue
+*\brief Ограниченная очередь с несколькими производителями и потребителями без блокировок
+*
+* Кольцевой буфер, в котором каждая ячейка хранит порядковый номер (схема Д. Вьюкова).
+* tryPush/tryPop не блокируются, push/pop ждут освобождения места или появления данных,
+* что обеспечивает обратное давление между стадиями. После close() pop возвращает false,
+* как только очередь опустеет
+*/
+template <typename T>
+class BoundedQueue
+{
+    public:
+    /*!
+    * \brief Конструктор очереди
+    * \param[in] minCapacity - минимальная вместимость, округляется вверх до степени двойки
+    */
+    explicit BoundedQueue(size_t minCapacity)
+    {
+        size_t capacity = 2;
+        while (capacity < minCapacity)
+            capacity <<= 1;
+
+        this->mask = capacity - 1;
+        this->cells = std::vector<Cell>(capacity);
+        for (size_t i = 0; i < capacity; i++)
+            this->cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(BoundedQueue const &) = delete;
+    BoundedQueue& operator=(BoundedQueue const &) = delete;
+
+    /*!
+    * \brief Попытаться добавить значение в очередь
+    * \param[in,out] value - значение, перемещается в очередь при успехе
+    * \return - false, если очередь заполнена
+    */
+    bool tryPush(T& value)
+    {
+        size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell& cell = this->cells[pos & this->mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    /*!
+    * \brief Попытаться извлечь значение из очереди
+    * \param[out] value - извлеченное значение
+    * \return - false, если очередь пуста
+    */
+    bool tryPop(T& value)
+    {
+        size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell& cell = this->cells[pos & this->mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + this->mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    /*!
+    * \brief Добавить значение, ожидая освобождения места
+    * \param[in] value - значение
+    */
+    void push(T value)
+    {
+        for (unsigned attempt = 0; !this->tryPush(value); attempt++)
+            backoff(attempt);
+    }
+
+    /*!
+    * \brief Извлечь значение, ожидая его появления
+    * \param[out] value - извлеченное значение
+    * \return - false, если очередь закрыта и пуста
+    */
+    bool pop(T& value)
+    {
+        for (unsigned attempt = 0; ; attempt++)
+        {
+            if (this->tryPop(value))
+                return true;
+            // Проверяем очередь еще раз после закрытия: значение могло появиться до вызова close()
+            if (this->closed.load(std::memory_order_acquire))
+                return this->tryPop(value);
+            backoff(attempt);
+        }
+    }
+
+    /*!
+    * \brief Закрыть очередь. Вызывается, когда все производители закончили работу
+    */
+    void close()
+    {
+        this->closed.store(true, std::memory_order_release);
+    }
+
+    /*!
+    * \brief Получить вместимость очереди
+    * \return - вместимость очереди
+    */
+    size_t capacity() const
+    {
+        return this->mask + 1;
+    }
+
+    private:
+    /*!
+    * \brief Ожидание при неудачной попытке: сначала активное, затем с уступкой и засыпанием потока
+    * \param[in] attempt - номер попытки
+    */
+    static void backoff(unsigned attempt)
+    {
+        if (attempt < 64)
+            return;
+        else if (attempt < 1024)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    /*!
+    *\brief Ячейка очереди
+    */
+    struct Cell
+    {
+        std::atomic<size_t> sequence; /*!< Порядковый номер ячейки */
+        T value; /*!< Значение */
+
+        Cell() = default;
+        Cell(Cell&& other) noexcept : sequence(other.sequence.load()), value(std::move(other.value)) {}
+        Cell& operator=(Cell&& other) noexcept
+        {
+            this->sequence.store(other.sequence.load());
+            this->value = std::move(other.value);
+            return *this;
+        }
+    };
+
+    std::vector<Cell> cells; /*!< Кольцевой буфер */
+    size_t mask = 0; /*!< Вместимость минус один */
+    alignas(64) std::atomic<size_t> enqueuePos{0}; /*!< Позиция записи */
+    alignas(64) std::atomic<size_t> dequeuePos{0}; /*!< Позиция чтения */
+    alignas(64) std::atomic<bool> closed{false}; /*!< Закрыта ли очередь */
+};
+
+#endif // BOUNDEDQUEUE_H
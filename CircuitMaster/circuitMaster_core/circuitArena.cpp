@@ -0,0 +1,80 @@
+#include "circuitArena.h"
+#include <new>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/*!
+*\file
+*\brief Реализация функций памяти для хранения дерева соединений одной цепи
+*/
+
+namespace {
+
+const size_t hugePageSize = 2 * 1024 * 1024; /*!< Размер большой страницы */
+
+}
+
+HugePageResource::HugePageResource(bool enableHugePages)
+    : useHugePages(enableHugePages)
+{
+}
+
+void* HugePageResource::do_allocate(size_t bytes, size_t alignment)
+{
+#ifdef __linux__
+    if (this->useHugePages && bytes >= hugePageSize)
+    {
+        size_t mappedSize = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+        void* block = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED)
+            throw std::bad_alloc();
+
+        // Ядро может не поддерживать большие страницы, тогда блок остается на обычных
+        madvise(block, mappedSize, MADV_HUGEPAGE);
+        return block;
+    }
+#endif
+    return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+void HugePageResource::do_deallocate(void* block, size_t bytes, size_t alignment)
+{
+#ifdef __linux__
+    if (this->useHugePages && bytes >= hugePageSize)
+    {
+        munmap(block, (bytes + hugePageSize - 1) / hugePageSize * hugePageSize);
+        return;
+    }
+#endif
+    ::operator delete(block, std::align_val_t(alignment));
+}
+
+bool HugePageResource::do_is_equal(std::pmr::memory_resource const & other) const noexcept
+{
+    return this == &other;
+}
+
+CircuitArena::CircuitArena(size_t initialSize, bool useHugePages)
+    : upstream(useHugePages),
+      firstBlockSize(useHugePages && initialSize < hugePageSize ? hugePageSize : initialSize),
+      firstBlock(upstream.allocate(firstBlockSize, alignof(std::max_align_t))),
+      buffer(firstBlock, firstBlockSize, &upstream)
+{
+}
+
+CircuitArena::~CircuitArena()
+{
+    this->buffer.release();
+    this->upstream.deallocate(this->firstBlock, this->firstBlockSize, alignof(std::max_align_t));
+}
+
+std::pmr::memory_resource* CircuitArena::resource()
+{
+    return &this->buffer;
+}
+
+void CircuitArena::release()
+{
+    this->buffer.release();
+}
@@ -0,0 +1,79 @@
+#ifndef CIRCUITARENA_H
+#define CIRCUITARENA_H
+#include <cstddef>
+#include <memory_resource>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций памяти для хранения дерева соединений одной цепи
+*/
+
+/*!
+*\class HugePageResource
+*\brief Источник больших блоков памяти. В Linux блоки от 2 МБ выделяются через mmap с просьбой
+* использовать большие страницы (MADV_HUGEPAGE), остальные - через operator new
+*/
+class HugePageResource : public std::pmr::memory_resource
+{
+    public:
+    /*!
+    * \brief Конструктор источника
+    * \param[in] enableHugePages - использовать ли большие страницы
+    */
+    HugePageResource(bool enableHugePages);
+
+    protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* block, size_t bytes, size_t alignment) override;
+    bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override;
+
+    private:
+    bool useHugePages; /*!< Использовать ли большие страницы */
+};
+
+/*!
+*\class CircuitArena
+*\brief Память для соединений, элементов, списков детей и имен одной цепи
+*
+* Память выделяется последовательно из больших блоков и не возвращается по отдельности,
+* поэтому построение дерева почти не обращается к общему выделению памяти, а освобождение
+* выполняется сразу для всей цепи. Контейнер соединений (CircuitMap), созданный с resource(),
+* должен быть уничтожен раньше арены или до вызова release()
+*/
+class CircuitArena
+{
+    public:
+    /*!
+    * \brief Конструктор арены
+    * \param[in] initialSize - размер первого блока. Первый блок сохраняется при release() и используется повторно
+    * \param[in] useHugePages - выделять ли блоки на больших страницах (только Linux)
+    */
+    CircuitArena(size_t initialSize = 256 * 1024, bool useHugePages = false);
+
+    /*!
+    * \brief Деструктор, освобождает все блоки арены
+    */
+    ~CircuitArena();
+
+    CircuitArena(CircuitArena const &) = delete;
+    CircuitArena& operator=(CircuitArena const &) = delete;
+
+    /*!
+    * \brief Получить источник памяти арены для контейнеров std::pmr
+    * \return - источник памяти
+    */
+    std::pmr::memory_resource* resource();
+
+    /*!
+    * \brief Освободить всю выделенную из арены память, кроме первого блока, для расчета следующей цепи
+    */
+    void release();
+
+    private:
+    HugePageResource upstream; /*!< Источник блоков после первого */
+    size_t firstBlockSize; /*!< Размер первого блока */
+    void* firstBlock; /*!< Первый блок */
+    std::pmr::monotonic_buffer_resource buffer; /*!< Последовательное выделение из блоков */
+};
+
+#endif // CIRCUITARENA_H
@@ -0,0 +1,99 @@
+#include "circuitContainer.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "coreMetrics.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций расчета файлов, содержащих несколько независимых цепей
+*/
+
+bool CircuitContainer::isContainer(DocumentNode const & rootElement)
+{
+    return rootElement.tagName == "circuits";
+}
+
+std::string CircuitContainer::evaluate(DocumentNode const & container, BatchOptions const & options, PlanCache* planCache,
+                                       CircuitArena* arena)
+{
+    CORE_TRACE_SPAN("CircuitContainer::evaluate");
+
+    std::vector<DocumentNode const *> circuits;
+    for (auto iter = container.children.cbegin(); iter != container.children.cend(); iter++)
+    {
+        if (iter->isElement())
+            circuits.push_back(&(*iter));
+    }
+
+    // Ошибка, если в контейнере нет цепей
+    if (circuits.empty())
+        throw formatStr("Контейнер цепей \"<circuits>\" на строке %1 не содержит ни одной цепи.", { numberToStr(container.lineNumber) });
+
+    unsigned threadCount = options.computeThreads;
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, circuits.size()));
+
+    // Результат или ошибка каждой цепи записывается на её место, поэтому порядок разделов не зависит от потоков
+    std::vector<std::string> outputs(circuits.size());
+    std::vector<std::string> errors(circuits.size());
+    std::atomic<size_t> nextCircuit(0);
+
+    auto worker = [&](CircuitArena* workerArena) {
+        for (size_t i = nextCircuit++; i < circuits.size(); i = nextCircuit++)
+        {
+            try {
+                outputs[i] = BatchPipeline::evaluateCircuit(*circuits[i], planCache, workerArena, options.normalizeTree);
+            } catch (std::string const & str) {
+                errors[i] = str;
+                Metrics::countError(Metrics::Phase::evaluate);
+            }
+        }
+    };
+
+    if (threadCount == 1)
+    {
+        std::unique_ptr<CircuitArena> ownArena;
+        if (arena == nullptr)
+        {
+            ownArena.reset(new CircuitArena(256 * 1024, options.useHugePages));
+            arena = ownArena.get();
+        }
+        worker(arena);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]() {
+                if (Trace::isEnabled())
+                    Trace::setThreadName("circuits " + std::to_string(t + 1));
+
+                // Каждый поток размещает деревья своих цепей в своей арене
+                CircuitArena workerArena(256 * 1024, options.useHugePages);
+                worker(&workerArena);
+            });
+        }
+        for (auto iter = threads.begin(); iter != threads.end(); iter++)
+            iter->join();
+    }
+
+    std::string output;
+    for (size_t i = 0; i < circuits.size(); i++)
+    {
+        if (i != 0)
+            output += "\n";
+        output += formatStr("circuit = %1\n", { numberToStr(static_cast<int>(i + 1)) });
+        if (errors[i].empty())
+            output += outputs[i];
+        else
+            output += formatStr("error = %1\n", { errors[i] });
+    }
+    return output;
+}
@@ -0,0 +1,54 @@
+#ifndef CIRCUITCONTAINER_H
+#define CIRCUITCONTAINER_H
+#include <string>
+#include "batchPipeline.h"
+#include "circuitArena.h"
+#include "documentNode.h"
+#include "planCache.h"
+
+/*!
+*\file
+*\brief Заголовки функций расчета файлов, содержащих несколько независимых цепей
+*/
+
+/*!
+*\class CircuitContainer
+*\brief Расчет контейнера цепей
+*
+* Контейнер - корневой тэг \c <circuits>, каждый вложенный тэг которого является отдельной цепью
+* \c <seq> или \c <par> со своими напряжением и частотой:
+*\code
+<circuits>
+    <seq voltage="20" frequency="50">...</seq>
+    <par voltage="10">...</par>
+</circuits>
+*\endcode
+* Цепи рассчитываются параллельно. Результат каждой цепи записывается в отдельный раздел,
+* который начинается строкой "circuit = N" (N - номер цепи в контейнере, с 1). Ошибка в цепи
+* не прерывает расчет остальных и записывается в её раздел строкой "error = сообщение".
+* Разделы разделены пустой строкой и следуют в порядке цепей в контейнере
+*/
+class CircuitContainer
+{
+    public:
+    /*!
+    * \brief Узнать, является ли узел документа контейнером цепей
+    * \param[in] rootElement - корневой узел документа
+    * \return - true, если это тэг \c <circuits>
+    */
+    static bool isContainer(DocumentNode const & rootElement);
+
+    /*!
+    * \brief Рассчитать все цепи контейнера
+    * \param[in] container - узел \c <circuits>
+    * \param[in] options - параметры расчета: количество потоков (computeThreads), использование больших
+    * страниц и упрощение дерева соединений
+    * \param[in,out] planCache - кэш топологий, общий для всех потоков. nullptr - рассчитывать без кэша
+    * \param[in,out] arena - память для деревьев соединений при расчете в одном потоке. nullptr - создать свою
+    * \return - текст для записи в выходной файл
+    */
+    static std::string evaluate(DocumentNode const & container, BatchOptions const & options, PlanCache* planCache = nullptr,
+                                CircuitArena* arena = nullptr);
+};
+
+#endif // CIRCUITCONTAINER_H
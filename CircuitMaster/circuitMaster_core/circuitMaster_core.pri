@@ -0,0 +1,100 @@
+# Ядро программы без зависимости от Qt.
+# Подключается через include() в проекты, которым нужны исходники ядра.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# Пакетная обработка использует потоки стандартной библиотеки
+CONFIG += thread
+unix: LIBS += -pthread
+
+SOURCES += \
+        $$PWD/allocationStats.cpp \
+        $$PWD/batchFileIo.cpp \
+        $$PWD/batchPipeline.cpp \
+        $$PWD/circuitArena.cpp \
+        $$PWD/circuitContainer.cpp \
+        $$PWD/circuitState.cpp \
+        $$PWD/circuitTopology.cpp \
+        $$PWD/complexKernels.cpp \
+        $$PWD/componentOptimizer.cpp \
+        $$PWD/coreConnection.cpp \
+        $$PWD/coreElement.cpp \
+        $$PWD/coreIo.cpp \
+        $$PWD/coreMetrics.cpp \
+        $$PWD/coreStrings.cpp \
+        $$PWD/coreTrace.cpp \
+        $$PWD/documentNode.cpp \
+        $$PWD/documentParser.cpp \
+        $$PWD/faultAnalysis.cpp \
+        $$PWD/frequencyDerivatives.cpp \
+        $$PWD/goalSeek.cpp \
+        $$PWD/harmonicAnalysis.cpp \
+        $$PWD/liteXmlParser.cpp \
+        $$PWD/metricsExporter.cpp \
+        $$PWD/pathEvaluator.cpp \
+        $$PWD/perfCounters.cpp \
+        $$PWD/planCache.cpp \
+        $$PWD/resonanceAnalysis.cpp \
+        $$PWD/transferFunction.cpp \
+        $$PWD/variantEvaluator.cpp \
+        $$PWD/worstCaseAnalysis.cpp
+
+HEADERS += \
+        $$PWD/allocationStats.h \
+        $$PWD/batchFileIo.h \
+        $$PWD/batchPipeline.h \
+        $$PWD/boundedQueue.h \
+        $$PWD/circuitArena.h \
+        $$PWD/circuitContainer.h \
+        $$PWD/circuitState.h \
+        $$PWD/circuitTopology.h \
+        $$PWD/complexKernels.h \
+        $$PWD/componentOptimizer.h \
+        $$PWD/coreConnection.h \
+        $$PWD/coreElement.h \
+        $$PWD/coreIo.h \
+        $$PWD/coreMetrics.h \
+        $$PWD/coreStrings.h \
+        $$PWD/coreTrace.h \
+        $$PWD/documentNode.h \
+        $$PWD/documentParser.h \
+        $$PWD/faultAnalysis.h \
+        $$PWD/frequencyDerivatives.h \
+        $$PWD/goalSeek.h \
+        $$PWD/harmonicAnalysis.h \
+        $$PWD/liteXmlParser.h \
+        $$PWD/metricsExporter.h \
+        $$PWD/pathEvaluator.h \
+        $$PWD/perfCounters.h \
+        $$PWD/planCache.h \
+        $$PWD/resonanceAnalysis.h \
+        $$PWD/transferFunction.h \
+        $$PWD/variantEvaluator.h \
+        $$PWD/worstCaseAnalysis.h
+
+# Запись длительности этапов расчета (см. coreTrace.h), подключается через CONFIG += trace
+trace: DEFINES += CIRCUITMASTER_TRACE
+
+# Учет выделений памяти по этапам расчета (см. allocationStats.h), подключается через CONFIG += alloc_stats
+alloc_stats: DEFINES += CIRCUITMASTER_ALLOC_STATS
+
+# Аппаратные счетчики производительности по этапам расчета (см. perfCounters.h), подключается через CONFIG += perf_counters
+perf_counters: DEFINES += CIRCUITMASTER_PERF_COUNTERS
+
+# Разборщик на основе QDomDocument, подключается через CONFIG += qt_parser
+qt_parser {
+    CONFIG += qt
+    QT += xml
+    QT -= gui
+    DEFINES += CIRCUITMASTER_QT_PARSER
+    SOURCES += $$PWD/qtDomParser.cpp
+    HEADERS += $$PWD/qtDomParser.h
+}
+
+# Асинхронный ввод-вывод пакетной обработки на основе io_uring (только Linux), подключается через CONFIG += io_uring
+linux:io_uring {
+    DEFINES += CIRCUITMASTER_IO_URING
+    SOURCES += $$PWD/uringFileIo.cpp
+    HEADERS += $$PWD/uringFileIo.h
+}
@@ -0,0 +1,6 @@
+TEMPLATE = lib
+
+CONFIG += c++17 staticlib warn_on
+CONFIG -= qt
+
+include(circuitMaster_core.pri)
@@ -0,0 +1,137 @@
+#include "circuitState.h"
+#include "allocationStats.h"
+#include "complexKernels.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций класса CircuitState
+*/
+
+void CircuitState::evaluate(CircuitTopology const & topology)
+{
+    this->evaluate(topology, topology.rootVoltage);
+}
+
+void CircuitState::evaluate(CircuitTopology const & topology, std::complex<double> voltage, double frequency)
+{
+    CORE_TRACE_SPAN("CircuitState::evaluate");
+    CORE_ALLOCATION_PHASE(evaluate);
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    size_t nodeCount = nodes.size();
+
+    // Сопротивления элементов пересчитываются только при расчете на другой частоте
+    this->elementResistances.assign(topology.elementResistances.cbegin(), topology.elementResistances.cend());
+    if (frequency != -1 && frequency != topology.frequency)
+    {
+        if (frequency <= 0)
+            throw std::string("Недопустимое значение частоты. Значение частоты должно быть больше 0.");
+
+        for (size_t e = 0; e < this->elementResistances.size(); e++)
+        {
+            CoreElement::ElemType type = topology.elementTypes[e];
+            if (type != CoreElement::ElemType::L && type != CoreElement::ElemType::C)
+                continue;
+
+            if (topology.frequency <= 0)
+                throw std::string("Для расчета цепи на другой частоте необходимо указать частоту \"frequency\" "
+                                  "как атрибут корневого элемента цепи.");
+            double ratio = frequency / topology.frequency;
+            this->elementResistances[e] *= type == CoreElement::ElemType::L ? ratio : 1 / ratio;
+        }
+    }
+
+    this->resistances.assign(nodeCount, 0);
+    this->voltages.assign(nodeCount, 0);
+    this->currents.assign(nodeCount, 0);
+
+    // Сопротивления: дети расположены после родителя, поэтому обходим соединения с конца
+    for (size_t n = nodeCount; n-- > 0;)
+    {
+        CircuitTopology::Node const & node = nodes[n];
+        std::complex<double>& resistance = this->resistances[n];
+
+        // Для простого последовательного соединения - сумма сопротивлений элементов
+        if (node.type == CoreConnection::ConnectionType::sequential)
+        {
+            if (static_cast<size_t>(node.elementCount) < ComplexKernels::wideCount)
+            {
+                for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+                    resistance += this->elementResistances[e];
+            }
+            else
+            {
+                this->gatherReductionTerms(this->elementResistances.data() + node.firstElement, nullptr, node.elementCount);
+                resistance = ComplexKernels::sum(this->reductionRe.data(), this->reductionIm.data(), node.elementCount);
+            }
+        }
+        // Для сложного последовательного соединения - сумма сопротивлений детей
+        else if (node.type == CoreConnection::ConnectionType::sequentialComplex)
+        {
+            for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                resistance += this->resistances[topology.childIndices[c]];
+        }
+        // Для параллельного соединения - величина, обратная сумме обратных сопротивлений детей
+        else if (node.type == CoreConnection::ConnectionType::parallel)
+        {
+            std::complex<double> reverseSum = 0;
+            if (static_cast<size_t>(node.childCount) < ComplexKernels::wideCount)
+            {
+                for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                    reverseSum += 1.0 / this->resistances[topology.childIndices[c]];
+            }
+            // Проводимости широкого соединения складываются векторными командами
+            else
+            {
+                this->gatherReductionTerms(this->resistances.data(), topology.childIndices.data() + node.firstChild, node.childCount);
+                reverseSum = ComplexKernels::sumReciprocals(this->reductionRe.data(), this->reductionIm.data(), node.childCount);
+            }
+
+            if (reverseSum.real() == 0 && reverseSum.imag() == 0)
+                throw formatStr("При расчете сопротивления параллельного соединения %1 получено недопустимое значение. "
+                                "Проверьте правильность входных данных.", { node.displayName() });
+            resistance = 1.0 / reverseSum;
+        }
+
+        if (resistance.real() == 0 && resistance.imag() == 0)
+            throw formatStr("При расчете сопротивления соединения %1 был получен 0. Проверьте правильность входных данных.", { node.displayName() });
+    }
+
+    // Силы тока и напряжения: родитель расположен раньше детей, поэтому обходим соединения с начала
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        int parent = nodes[n].parent;
+
+        // Корневому соединению задано напряжение
+        if (parent < 0)
+        {
+            this->voltages[n] = voltage;
+            this->currents[n] = voltage / this->resistances[n];
+        }
+        // Дети последовательного соединения получают силу тока родителя
+        else if (nodes[parent].type == CoreConnection::ConnectionType::sequentialComplex)
+        {
+            this->currents[n] = this->currents[parent];
+            this->voltages[n] = this->currents[n] * this->resistances[n];
+        }
+        // Дети параллельного соединения получают напряжение родителя
+        else
+        {
+            this->voltages[n] = this->voltages[parent];
+            this->currents[n] = this->voltages[n] / this->resistances[n];
+        }
+    }
+}
+
+void CircuitState::gatherReductionTerms(std::complex<double> const * values, int const * indices, size_t count)
+{
+    this->reductionRe.resize(count);
+    this->reductionIm.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        std::complex<double> value = indices != nullptr ? values[indices[i]] : values[i];
+        this->reductionRe[i] = value.real();
+        this->reductionIm[i] = value.imag();
+    }
+}
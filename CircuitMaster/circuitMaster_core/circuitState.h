@@ -0,0 +1,60 @@
+#ifndef CIRCUITSTATE_H
+#define CIRCUITSTATE_H
+#include <complex>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса CircuitState
+*/
+
+/*!
+*\class CircuitState
+*\brief Значения одного расчета цепи, отделенные от её топологии
+*
+* CoreConnection хранит входные данные и результаты расчета вместе и изменяет их при расчете,
+* поэтому одно дерево нельзя рассчитывать одновременно с разными напряжениями или частотами.
+* CircuitState хранит только результаты, а топология (CircuitTopology) при расчете не изменяется:
+* несколько потоков могут рассчитывать одну загруженную цепь, каждый со своим состоянием, не копируя
+* дерево соединений. Массивы состояния выделяются при первом расчете и используются повторно
+*/
+class CircuitState
+{
+    public:
+    std::vector<std::complex<double>> elementResistances; /*!< Сопротивления элементов на частоте расчета */
+    std::vector<std::complex<double>> resistances; /*!< Сопротивления соединений в порядке топологии */
+    std::vector<std::complex<double>> voltages; /*!< Напряжения соединений в порядке топологии */
+    std::vector<std::complex<double>> currents; /*!< Силы тока соединений в порядке топологии */
+
+    /*!
+    * \brief Рассчитать цепь с напряжением и частотой исходной цепи
+    * \param[in] topology - топология цепи
+    */
+    void evaluate(CircuitTopology const & topology);
+
+    /*!
+    * \brief Рассчитать цепь с другим напряжением и частотой
+    *
+    * Сопротивления катушек пропорциональны частоте, конденсаторов - обратно пропорциональны.
+    * Ошибки расчета сообщаются исключением std::string с тем же текстом, что и у CoreConnection
+    * \param[in] topology - топология цепи
+    * \param[in] voltage - напряжение корневого соединения
+    * \param[in] frequency - частота переменного тока, -1 - частота исходной цепи
+    */
+    void evaluate(CircuitTopology const & topology, std::complex<double> voltage, double frequency = -1);
+
+    private:
+    std::vector<double> reductionRe; /*!< Действительные части слагаемых широкого соединения */
+    std::vector<double> reductionIm; /*!< Мнимые части слагаемых широкого соединения */
+
+    /*!
+    * \brief Разложить слагаемые широкого соединения на действительные и мнимые части
+    * \param[in] values - значения
+    * \param[in] indices - номера слагаемых в values, nullptr - первые count значений подряд
+    * \param[in] count - количество слагаемых
+    */
+    void gatherReductionTerms(std::complex<double> const * values, int const * indices, size_t count);
+};
+
+#endif // CIRCUITSTATE_H
@@ -0,0 +1,90 @@
+#include "circuitTopology.h"
+#include <utility>
+
+/*!
+*\file
+*\brief Реализация функций класса CircuitTopology
+*/
+
+CircuitTopology CircuitTopology::fromConnection(CoreConnection const & root, double frequency)
+{
+    CircuitTopology topology;
+    topology.rootVoltage = root.getVoltage();
+    topology.frequency = frequency;
+
+    // Обход в глубину с явным стеком: соединение и номер его родителя.
+    // Детей кладём в стек в обратном порядке, чтобы извлекать их в исходном
+    std::vector<std::pair<CoreConnection const *, int>> stack;
+    stack.emplace_back(&root, -1);
+    while (!stack.empty())
+    {
+        CoreConnection const * connection = stack.back().first;
+        int parent = stack.back().second;
+        stack.pop_back();
+
+        int index = static_cast<int>(topology.nodes.size());
+        Node node;
+        node.type = connection->getType();
+        node.parent = parent;
+        node.hasCustomName = connection->isNameCustom();
+        node.isParTag = connection->isParTagged();
+        node.id = connection->getId();
+        node.lineNumber = connection->getLineNumber();
+        if (node.hasCustomName || node.id == 0)
+            node.customName = connection->getName();
+        node.firstElement = static_cast<int>(topology.elementTypes.size());
+        node.elementCount = static_cast<int>(connection->getElements().size());
+        topology.nodes.push_back(node);
+
+        std::pmr::vector<CoreElement> const & elements = connection->getElements();
+        for (auto iter = elements.cbegin(); iter != elements.cend(); iter++)
+        {
+            topology.elementTypes.push_back(iter->getType());
+            topology.elementResistances.push_back(iter->getElemResistance());
+        }
+
+        std::pmr::vector<CoreConnection*> const & children = connection->getChildren();
+        for (auto iter = children.crbegin(); iter != children.crend(); iter++)
+            stack.emplace_back(*iter, index);
+    }
+
+    // Списки детей: номера детей известны только после нумерации всех соединений
+    std::vector<int> childCounts(topology.nodes.size(), 0);
+    for (size_t i = 1; i < topology.nodes.size(); i++)
+        childCounts[topology.nodes[i].parent]++;
+
+    int offset = 0;
+    for (size_t i = 0; i < topology.nodes.size(); i++)
+    {
+        topology.nodes[i].firstChild = offset;
+        offset += childCounts[i];
+    }
+
+    topology.childIndices.resize(offset);
+    for (size_t i = 1; i < topology.nodes.size(); i++)
+    {
+        Node& parent = topology.nodes[topology.nodes[i].parent];
+        topology.childIndices[parent.firstChild + parent.childCount] = static_cast<int>(i);
+        parent.childCount++;
+    }
+
+    return topology;
+}
+
+int CircuitTopology::findNode(std::string const & name) const
+{
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+        // Имена, сформированные автоматически, не хранятся и не ищутся
+        if (!this->nodes[i].customName.empty() && this->nodes[i].customName == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+std::string CircuitTopology::Node::displayName() const
+{
+    if (this->hasCustomName || this->id == 0)
+        return this->customName;
+    return CoreConnection::generatedName(this->isParTag, this->id, this->lineNumber);
+}
@@ -0,0 +1,77 @@
+#ifndef CIRCUITTOPOLOGY_H
+#define CIRCUITTOPOLOGY_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "coreConnection.h"
+#include "coreElement.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса CircuitTopology
+*/
+
+/*!
+*\class CircuitTopology
+*\brief Плоское представление дерева соединений
+*
+* Соединения хранятся в массиве в порядке обхода в глубину (pre-order), поэтому родитель
+* всегда расположен раньше своих детей. Обход массива с конца рассчитывает сопротивления
+* (детей раньше родителя), обход с начала - силы тока и напряжения (родителя раньше детей),
+* без рекурсии. Элементы всех простых последовательных соединений хранятся в отдельном
+* массиве в том же порядке
+*/
+class CircuitTopology
+{
+    public:
+    /*!
+    *\class Node
+    *\brief Соединение в плоском представлении
+    */
+    class Node
+    {
+        public:
+        CoreConnection::ConnectionType type = CoreConnection::ConnectionType::invalid; /*!< Тип соединения */
+        int parent = -1; /*!< Номер соединения-родителя, -1 для корня */
+        int firstChild = 0; /*!< Начало списка детей в массиве childIndices */
+        int childCount = 0; /*!< Количество детей */
+        int firstElement = 0; /*!< Номер первого элемента в массиве элементов */
+        int elementCount = 0; /*!< Количество элементов */
+        std::string customName; /*!< Имя, заданное пользователем (у корня - всегда), иначе пустое */
+        bool hasCustomName = false; /*!< Указано ли имя пользователем */
+        bool isParTag = false; /*!< Задано ли соединение тэгом <par> */
+        int id = 0; /*!< id соединения */
+        int lineNumber = -1; /*!< Номер строки тэга соединения во входном файле */
+
+        /*!
+        * \brief Получить имя соединения для вывода и сообщений об ошибках. Имя, не заданное пользователем,
+        * формируется при каждом вызове, как у CoreConnection::getName
+        * \return - имя соединения
+        */
+        std::string displayName() const;
+    };
+
+    std::vector<Node> nodes; /*!< Соединения в порядке обхода в глубину, корень - nodes[0] */
+    std::vector<int> childIndices; /*!< Номера детей всех соединений, дети одного соединения идут подряд */
+    std::vector<CoreElement::ElemType> elementTypes; /*!< Типы элементов */
+    std::vector<std::complex<double>> elementResistances; /*!< Сопротивления элементов исходной цепи */
+    std::complex<double> rootVoltage; /*!< Напряжение корневого соединения исходной цепи */
+    double frequency = -1; /*!< Частота, на которой заданы сопротивления элементов, -1 - неизвестна */
+
+    /*!
+    * \brief Построить плоское представление по дереву соединений
+    * \param[in] root - корневое соединение, у которого задано напряжение
+    * \param[in] frequency - частота переменного тока исходной цепи, -1 - неизвестна
+    * \return - плоское представление
+    */
+    static CircuitTopology fromConnection(CoreConnection const & root, double frequency = -1);
+
+    /*!
+    * \brief Найти соединение по имени, заданному пользователем
+    * \param[in] name - имя соединения
+    * \return - номер соединения или -1, если соединение не найдено
+    */
+    int findNode(std::string const & name) const;
+};
+
+#endif // CIRCUITTOPOLOGY_H
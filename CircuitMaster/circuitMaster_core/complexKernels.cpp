@@ -0,0 +1,1124 @@
+#include "complexKernels.h"
+#include <cmath>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define COMPLEX_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+/*!
+*\file
+*\brief Реализация функций над массивами комплексных чисел с векторными командами
+*/
+
+namespace {
+
+/*! Пределы квадрата модуля, в которых обратное значение рассчитывается без потери точности */
+const double minNorm = std::numeric_limits<double>::min();
+const double maxNorm = std::numeric_limits<double>::max();
+// Скалярные версии. Параметр from позволяет векторным версиям досчитывать остаток массива
+
+void addScalar(double* dstRe, double* dstIm, double const * re, double const * im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        dstRe[i] += re[i];
+        dstIm[i] += im[i];
+    }
+}
+
+void addReciprocalScalar(double* dstRe, double* dstIm, double const * re, double const * im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        double norm = re[i] * re[i] + im[i] * im[i];
+        dstRe[i] += re[i] / norm;
+        dstIm[i] -= im[i] / norm;
+    }
+}
+
+void reciprocalScalar(double* re, double* im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        double norm = re[i] * re[i] + im[i] * im[i];
+        re[i] = re[i] / norm;
+        im[i] = -im[i] / norm;
+    }
+}
+
+void multiplyScalar(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                    double const * bRe, double const * bIm, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        double re = aRe[i] * bRe[i] - aIm[i] * bIm[i];
+        double im = aRe[i] * bIm[i] + aIm[i] * bRe[i];
+        outRe[i] = re;
+        outIm[i] = im;
+    }
+}
+
+void divideScalar(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                  double const * bRe, double const * bIm, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        double norm = bRe[i] * bRe[i] + bIm[i] * bIm[i];
+        double re = (aRe[i] * bRe[i] + aIm[i] * bIm[i]) / norm;
+        double im = (aIm[i] * bRe[i] - aRe[i] * bIm[i]) / norm;
+        outRe[i] = re;
+        outIm[i] = im;
+    }
+}
+
+void sumBlockScalar(double const * re, double const * im, size_t count, double& sumRe, double& sumIm, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        sumRe += re[i];
+        sumIm += im[i];
+    }
+}
+
+bool sumReciprocalsBlockScalar(double const * re, double const * im, size_t count, double& sumRe, double& sumIm, size_t from = 0)
+{
+    bool inRange = true;
+    for (size_t i = from; i < count; i++)
+    {
+        double norm = re[i] * re[i] + im[i] * im[i];
+        if (norm < minNorm || norm > maxNorm)
+            inRange = false;
+        double inverse = 1 / norm;
+        sumRe += re[i] * inverse;
+        sumIm -= im[i] * inverse;
+    }
+    return inRange;
+}
+
+const ComplexKernels scalarKernels = {
+    ComplexKernels::SimdLevel::scalar,
+    [](double* dstRe, double* dstIm, double const * re, double const * im, size_t count) { addScalar(dstRe, dstIm, re, im, count); },
+    [](double* dstRe, double* dstIm, double const * re, double const * im, size_t count) { addReciprocalScalar(dstRe, dstIm, re, im, count); },
+    [](double* re, double* im, size_t count) { reciprocalScalar(re, im, count); },
+    [](double* outRe, double* outIm, double const * aRe, double const * aIm, double const * bRe, double const * bIm, size_t count)
+        { multiplyScalar(outRe, outIm, aRe, aIm, bRe, bIm, count); },
+    [](double* outRe, double* outIm, double const * aRe, double const * aIm, double const * bRe, double const * bIm, size_t count)
+        { divideScalar(outRe, outIm, aRe, aIm, bRe, bIm, count); },
+    [](double const * re, double const * im, size_t count, double& sumRe, double& sumIm) { sumBlockScalar(re, im, count, sumRe, sumIm); },
+    [](double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+        { return sumReciprocalsBlockScalar(re, im, count, sumRe, sumIm); }
+};
+
+// Скалярные версии для float
+
+void addFloatScalar(float* dstRe, float* dstIm, float const * re, float const * im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        dstRe[i] += re[i];
+        dstIm[i] += im[i];
+    }
+}
+
+void addReciprocalFloatScalar(float* dstRe, float* dstIm, float const * re, float const * im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        float norm = re[i] * re[i] + im[i] * im[i];
+        dstRe[i] += re[i] / norm;
+        dstIm[i] -= im[i] / norm;
+    }
+}
+
+void reciprocalFloatScalar(float* re, float* im, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        float norm = re[i] * re[i] + im[i] * im[i];
+        re[i] = re[i] / norm;
+        im[i] = -im[i] / norm;
+    }
+}
+
+void multiplyFloatScalar(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                         float const * bRe, float const * bIm, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        float re = aRe[i] * bRe[i] - aIm[i] * bIm[i];
+        float im = aRe[i] * bIm[i] + aIm[i] * bRe[i];
+        outRe[i] = re;
+        outIm[i] = im;
+    }
+}
+
+void divideFloatScalar(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                       float const * bRe, float const * bIm, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        float norm = bRe[i] * bRe[i] + bIm[i] * bIm[i];
+        float re = (aRe[i] * bRe[i] + aIm[i] * bIm[i]) / norm;
+        float im = (aIm[i] * bRe[i] - aRe[i] * bIm[i]) / norm;
+        outRe[i] = re;
+        outIm[i] = im;
+    }
+}
+
+void addBoundedFloatScalar(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                           float const * termBound, float growth, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        dstRe[i] += re[i];
+        dstIm[i] += im[i];
+        bound[i] += (std::abs(re[i]) + std::abs(im[i])) * (termBound[i] + growth);
+    }
+}
+
+void addReciprocalBoundedFloatScalar(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                                     float const * termBound, float growth, size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+    {
+        float norm = re[i] * re[i] + im[i] * im[i];
+        float yRe = re[i] / norm;
+        float yIm = im[i] / norm;
+        dstRe[i] += yRe;
+        dstIm[i] -= yIm;
+        bound[i] += (std::abs(yRe) + std::abs(yIm)) * (termBound[i] + growth);
+    }
+}
+
+void relativeBoundFloatScalar(float* bound, float const * re, float const * im, float factor, float growth,
+                              size_t count, size_t from = 0)
+{
+    for (size_t i = from; i < count; i++)
+        bound[i] = factor * bound[i] / (std::abs(re[i]) + std::abs(im[i])) + growth;
+}
+
+const FloatComplexKernels scalarFloatKernels = {
+    ComplexKernels::SimdLevel::scalar,
+    [](float* dstRe, float* dstIm, float const * re, float const * im, size_t count) { addFloatScalar(dstRe, dstIm, re, im, count); },
+    [](float* dstRe, float* dstIm, float const * re, float const * im, size_t count) { addReciprocalFloatScalar(dstRe, dstIm, re, im, count); },
+    [](float* re, float* im, size_t count) { reciprocalFloatScalar(re, im, count); },
+    [](float* outRe, float* outIm, float const * aRe, float const * aIm, float const * bRe, float const * bIm, size_t count)
+        { multiplyFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count); },
+    [](float* outRe, float* outIm, float const * aRe, float const * aIm, float const * bRe, float const * bIm, size_t count)
+        { divideFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count); },
+    [](float* dstRe, float* dstIm, float* bound, float const * re, float const * im, float const * termBound, float growth, size_t count)
+        { addBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count); },
+    [](float* dstRe, float* dstIm, float* bound, float const * re, float const * im, float const * termBound, float growth, size_t count)
+        { addReciprocalBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count); },
+    [](float* bound, float const * re, float const * im, float factor, float growth, size_t count)
+        { relativeBoundFloatScalar(bound, re, im, factor, growth, count); }
+};
+
+#ifdef COMPLEX_KERNELS_X86
+
+// Версии SSE2: по 2 числа double или 4 числа float за команду
+
+__attribute__((target("sse2")))
+void addSse2(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(dstRe + i, _mm_add_pd(_mm_loadu_pd(dstRe + i), _mm_loadu_pd(re + i)));
+        _mm_storeu_pd(dstIm + i, _mm_add_pd(_mm_loadu_pd(dstIm + i), _mm_loadu_pd(im + i)));
+    }
+    addScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void addReciprocalSse2(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d zRe = _mm_loadu_pd(re + i), zIm = _mm_loadu_pd(im + i);
+        __m128d norm = _mm_add_pd(_mm_mul_pd(zRe, zRe), _mm_mul_pd(zIm, zIm));
+        _mm_storeu_pd(dstRe + i, _mm_add_pd(_mm_loadu_pd(dstRe + i), _mm_div_pd(zRe, norm)));
+        _mm_storeu_pd(dstIm + i, _mm_sub_pd(_mm_loadu_pd(dstIm + i), _mm_div_pd(zIm, norm)));
+    }
+    addReciprocalScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void reciprocalSse2(double* re, double* im, size_t count)
+{
+    size_t i = 0;
+    __m128d zero = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d zRe = _mm_loadu_pd(re + i), zIm = _mm_loadu_pd(im + i);
+        __m128d norm = _mm_add_pd(_mm_mul_pd(zRe, zRe), _mm_mul_pd(zIm, zIm));
+        _mm_storeu_pd(re + i, _mm_div_pd(zRe, norm));
+        _mm_storeu_pd(im + i, _mm_div_pd(_mm_sub_pd(zero, zIm), norm));
+    }
+    reciprocalScalar(re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void multiplySse2(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                  double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d xRe = _mm_loadu_pd(aRe + i), xIm = _mm_loadu_pd(aIm + i);
+        __m128d yRe = _mm_loadu_pd(bRe + i), yIm = _mm_loadu_pd(bIm + i);
+        _mm_storeu_pd(outRe + i, _mm_sub_pd(_mm_mul_pd(xRe, yRe), _mm_mul_pd(xIm, yIm)));
+        _mm_storeu_pd(outIm + i, _mm_add_pd(_mm_mul_pd(xRe, yIm), _mm_mul_pd(xIm, yRe)));
+    }
+    multiplyScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("sse2")))
+void divideSse2(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d xRe = _mm_loadu_pd(aRe + i), xIm = _mm_loadu_pd(aIm + i);
+        __m128d yRe = _mm_loadu_pd(bRe + i), yIm = _mm_loadu_pd(bIm + i);
+        __m128d norm = _mm_add_pd(_mm_mul_pd(yRe, yRe), _mm_mul_pd(yIm, yIm));
+        __m128d re = _mm_add_pd(_mm_mul_pd(xRe, yRe), _mm_mul_pd(xIm, yIm));
+        __m128d im = _mm_sub_pd(_mm_mul_pd(xIm, yRe), _mm_mul_pd(xRe, yIm));
+        _mm_storeu_pd(outRe + i, _mm_div_pd(re, norm));
+        _mm_storeu_pd(outIm + i, _mm_div_pd(im, norm));
+    }
+    divideScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("sse2")))
+double horizontalSumSse2(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+__attribute__((target("sse2")))
+void sumBlockSse2(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m128d accRe0 = _mm_setzero_pd(), accIm0 = _mm_setzero_pd();
+    __m128d accRe1 = _mm_setzero_pd(), accIm1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        accRe0 = _mm_add_pd(accRe0, _mm_loadu_pd(re + i));
+        accIm0 = _mm_add_pd(accIm0, _mm_loadu_pd(im + i));
+        accRe1 = _mm_add_pd(accRe1, _mm_loadu_pd(re + i + 2));
+        accIm1 = _mm_add_pd(accIm1, _mm_loadu_pd(im + i + 2));
+    }
+    sumRe += horizontalSumSse2(_mm_add_pd(accRe0, accRe1));
+    sumIm += horizontalSumSse2(_mm_add_pd(accIm0, accIm1));
+    sumBlockScalar(re, im, count, sumRe, sumIm, i);
+}
+
+__attribute__((target("sse2")))
+bool sumReciprocalsBlockSse2(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m128d accRe = _mm_setzero_pd(), accIm = _mm_setzero_pd();
+    __m128d outOfRange = _mm_setzero_pd();
+    __m128d lowest = _mm_set1_pd(minNorm), highest = _mm_set1_pd(maxNorm), one = _mm_set1_pd(1);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d zRe = _mm_loadu_pd(re + i), zIm = _mm_loadu_pd(im + i);
+        __m128d norm = _mm_add_pd(_mm_mul_pd(zRe, zRe), _mm_mul_pd(zIm, zIm));
+        outOfRange = _mm_or_pd(outOfRange, _mm_or_pd(_mm_cmplt_pd(norm, lowest), _mm_cmpgt_pd(norm, highest)));
+        __m128d inverse = _mm_div_pd(one, norm);
+        accRe = _mm_add_pd(accRe, _mm_mul_pd(zRe, inverse));
+        accIm = _mm_sub_pd(accIm, _mm_mul_pd(zIm, inverse));
+    }
+    sumRe += horizontalSumSse2(accRe);
+    sumIm += horizontalSumSse2(accIm);
+
+    bool inRange = _mm_movemask_pd(outOfRange) == 0;
+    return sumReciprocalsBlockScalar(re, im, count, sumRe, sumIm, i) && inRange;
+}
+
+const ComplexKernels sse2Kernels = { ComplexKernels::SimdLevel::sse2, addSse2, addReciprocalSse2, reciprocalSse2, multiplySse2, divideSse2,
+                                     sumBlockSse2, sumReciprocalsBlockSse2 };
+
+__attribute__((target("sse2")))
+void addFloatSse2(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dstRe + i, _mm_add_ps(_mm_loadu_ps(dstRe + i), _mm_loadu_ps(re + i)));
+        _mm_storeu_ps(dstIm + i, _mm_add_ps(_mm_loadu_ps(dstIm + i), _mm_loadu_ps(im + i)));
+    }
+    addFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void addReciprocalFloatSse2(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 zRe = _mm_loadu_ps(re + i), zIm = _mm_loadu_ps(im + i);
+        __m128 norm = _mm_add_ps(_mm_mul_ps(zRe, zRe), _mm_mul_ps(zIm, zIm));
+        _mm_storeu_ps(dstRe + i, _mm_add_ps(_mm_loadu_ps(dstRe + i), _mm_div_ps(zRe, norm)));
+        _mm_storeu_ps(dstIm + i, _mm_sub_ps(_mm_loadu_ps(dstIm + i), _mm_div_ps(zIm, norm)));
+    }
+    addReciprocalFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void reciprocalFloatSse2(float* re, float* im, size_t count)
+{
+    size_t i = 0;
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 zRe = _mm_loadu_ps(re + i), zIm = _mm_loadu_ps(im + i);
+        __m128 norm = _mm_add_ps(_mm_mul_ps(zRe, zRe), _mm_mul_ps(zIm, zIm));
+        _mm_storeu_ps(re + i, _mm_div_ps(zRe, norm));
+        _mm_storeu_ps(im + i, _mm_div_ps(_mm_sub_ps(zero, zIm), norm));
+    }
+    reciprocalFloatScalar(re, im, count, i);
+}
+
+__attribute__((target("sse2")))
+void multiplyFloatSse2(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                       float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 xRe = _mm_loadu_ps(aRe + i), xIm = _mm_loadu_ps(aIm + i);
+        __m128 yRe = _mm_loadu_ps(bRe + i), yIm = _mm_loadu_ps(bIm + i);
+        _mm_storeu_ps(outRe + i, _mm_sub_ps(_mm_mul_ps(xRe, yRe), _mm_mul_ps(xIm, yIm)));
+        _mm_storeu_ps(outIm + i, _mm_add_ps(_mm_mul_ps(xRe, yIm), _mm_mul_ps(xIm, yRe)));
+    }
+    multiplyFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("sse2")))
+void divideFloatSse2(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                     float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 xRe = _mm_loadu_ps(aRe + i), xIm = _mm_loadu_ps(aIm + i);
+        __m128 yRe = _mm_loadu_ps(bRe + i), yIm = _mm_loadu_ps(bIm + i);
+        __m128 norm = _mm_add_ps(_mm_mul_ps(yRe, yRe), _mm_mul_ps(yIm, yIm));
+        __m128 re = _mm_add_ps(_mm_mul_ps(xRe, yRe), _mm_mul_ps(xIm, yIm));
+        __m128 im = _mm_sub_ps(_mm_mul_ps(xIm, yRe), _mm_mul_ps(xRe, yIm));
+        _mm_storeu_ps(outRe + i, _mm_div_ps(re, norm));
+        _mm_storeu_ps(outIm + i, _mm_div_ps(im, norm));
+    }
+    divideFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("sse2")))
+void addBoundedFloatSse2(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                         float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m128 sign = _mm_set1_ps(-0.0f), add = _mm_set1_ps(growth);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 zRe = _mm_loadu_ps(re + i), zIm = _mm_loadu_ps(im + i);
+        __m128 weight = _mm_add_ps(_mm_loadu_ps(termBound + i), add);
+        _mm_storeu_ps(dstRe + i, _mm_add_ps(_mm_loadu_ps(dstRe + i), zRe));
+        _mm_storeu_ps(dstIm + i, _mm_add_ps(_mm_loadu_ps(dstIm + i), zIm));
+        _mm_storeu_ps(bound + i, _mm_add_ps(_mm_loadu_ps(bound + i), _mm_mul_ps(_mm_add_ps(_mm_andnot_ps(sign, zRe), _mm_andnot_ps(sign, zIm)), weight)));
+    }
+    addBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("sse2")))
+void addReciprocalBoundedFloatSse2(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                                   float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m128 sign = _mm_set1_ps(-0.0f), add = _mm_set1_ps(growth);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 zRe = _mm_loadu_ps(re + i), zIm = _mm_loadu_ps(im + i);
+        __m128 norm = _mm_add_ps(_mm_mul_ps(zRe, zRe), _mm_mul_ps(zIm, zIm));
+        __m128 yRe = _mm_div_ps(zRe, norm), yIm = _mm_div_ps(zIm, norm);
+        __m128 weight = _mm_add_ps(_mm_loadu_ps(termBound + i), add);
+        _mm_storeu_ps(dstRe + i, _mm_add_ps(_mm_loadu_ps(dstRe + i), yRe));
+        _mm_storeu_ps(dstIm + i, _mm_sub_ps(_mm_loadu_ps(dstIm + i), yIm));
+        _mm_storeu_ps(bound + i, _mm_add_ps(_mm_loadu_ps(bound + i), _mm_mul_ps(_mm_add_ps(_mm_andnot_ps(sign, yRe), _mm_andnot_ps(sign, yIm)), weight)));
+    }
+    addReciprocalBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("sse2")))
+void relativeBoundFloatSse2(float* bound, float const * re, float const * im, float factor, float growth, size_t count)
+{
+    size_t i = 0;
+    __m128 sign = _mm_set1_ps(-0.0f), scale = _mm_set1_ps(factor), add = _mm_set1_ps(growth);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 magnitude = _mm_add_ps(_mm_andnot_ps(sign, _mm_loadu_ps(re + i)), _mm_andnot_ps(sign, _mm_loadu_ps(im + i)));
+        _mm_storeu_ps(bound + i, _mm_add_ps(_mm_div_ps(_mm_mul_ps(scale, _mm_loadu_ps(bound + i)), magnitude), add));
+    }
+    relativeBoundFloatScalar(bound, re, im, factor, growth, count, i);
+}
+
+const FloatComplexKernels sse2FloatKernels = { ComplexKernels::SimdLevel::sse2, addFloatSse2, addReciprocalFloatSse2, reciprocalFloatSse2,
+                                               multiplyFloatSse2, divideFloatSse2,
+                                               addBoundedFloatSse2, addReciprocalBoundedFloatSse2, relativeBoundFloatSse2 };
+
+// Версии AVX2: по 4 числа double или 8 чисел float за команду
+
+__attribute__((target("avx2")))
+void addAvx2(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(dstRe + i, _mm256_add_pd(_mm256_loadu_pd(dstRe + i), _mm256_loadu_pd(re + i)));
+        _mm256_storeu_pd(dstIm + i, _mm256_add_pd(_mm256_loadu_pd(dstIm + i), _mm256_loadu_pd(im + i)));
+    }
+    addScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void addReciprocalAvx2(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d zRe = _mm256_loadu_pd(re + i), zIm = _mm256_loadu_pd(im + i);
+        __m256d norm = _mm256_add_pd(_mm256_mul_pd(zRe, zRe), _mm256_mul_pd(zIm, zIm));
+        _mm256_storeu_pd(dstRe + i, _mm256_add_pd(_mm256_loadu_pd(dstRe + i), _mm256_div_pd(zRe, norm)));
+        _mm256_storeu_pd(dstIm + i, _mm256_sub_pd(_mm256_loadu_pd(dstIm + i), _mm256_div_pd(zIm, norm)));
+    }
+    addReciprocalScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void reciprocalAvx2(double* re, double* im, size_t count)
+{
+    size_t i = 0;
+    __m256d zero = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d zRe = _mm256_loadu_pd(re + i), zIm = _mm256_loadu_pd(im + i);
+        __m256d norm = _mm256_add_pd(_mm256_mul_pd(zRe, zRe), _mm256_mul_pd(zIm, zIm));
+        _mm256_storeu_pd(re + i, _mm256_div_pd(zRe, norm));
+        _mm256_storeu_pd(im + i, _mm256_div_pd(_mm256_sub_pd(zero, zIm), norm));
+    }
+    reciprocalScalar(re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void multiplyAvx2(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                  double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d xRe = _mm256_loadu_pd(aRe + i), xIm = _mm256_loadu_pd(aIm + i);
+        __m256d yRe = _mm256_loadu_pd(bRe + i), yIm = _mm256_loadu_pd(bIm + i);
+        _mm256_storeu_pd(outRe + i, _mm256_sub_pd(_mm256_mul_pd(xRe, yRe), _mm256_mul_pd(xIm, yIm)));
+        _mm256_storeu_pd(outIm + i, _mm256_add_pd(_mm256_mul_pd(xRe, yIm), _mm256_mul_pd(xIm, yRe)));
+    }
+    multiplyScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx2")))
+void divideAvx2(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d xRe = _mm256_loadu_pd(aRe + i), xIm = _mm256_loadu_pd(aIm + i);
+        __m256d yRe = _mm256_loadu_pd(bRe + i), yIm = _mm256_loadu_pd(bIm + i);
+        __m256d norm = _mm256_add_pd(_mm256_mul_pd(yRe, yRe), _mm256_mul_pd(yIm, yIm));
+        __m256d re = _mm256_add_pd(_mm256_mul_pd(xRe, yRe), _mm256_mul_pd(xIm, yIm));
+        __m256d im = _mm256_sub_pd(_mm256_mul_pd(xIm, yRe), _mm256_mul_pd(xRe, yIm));
+        _mm256_storeu_pd(outRe + i, _mm256_div_pd(re, norm));
+        _mm256_storeu_pd(outIm + i, _mm256_div_pd(im, norm));
+    }
+    divideScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx2")))
+double horizontalSumAvx2(__m256d value)
+{
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+__attribute__((target("avx2")))
+void sumBlockAvx2(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m256d accRe0 = _mm256_setzero_pd(), accIm0 = _mm256_setzero_pd();
+    __m256d accRe1 = _mm256_setzero_pd(), accIm1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        accRe0 = _mm256_add_pd(accRe0, _mm256_loadu_pd(re + i));
+        accIm0 = _mm256_add_pd(accIm0, _mm256_loadu_pd(im + i));
+        accRe1 = _mm256_add_pd(accRe1, _mm256_loadu_pd(re + i + 4));
+        accIm1 = _mm256_add_pd(accIm1, _mm256_loadu_pd(im + i + 4));
+    }
+    sumRe += horizontalSumAvx2(_mm256_add_pd(accRe0, accRe1));
+    sumIm += horizontalSumAvx2(_mm256_add_pd(accIm0, accIm1));
+    sumBlockScalar(re, im, count, sumRe, sumIm, i);
+}
+
+__attribute__((target("avx2")))
+bool sumReciprocalsBlockAvx2(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m256d accRe = _mm256_setzero_pd(), accIm = _mm256_setzero_pd();
+    __m256d outOfRange = _mm256_setzero_pd();
+    __m256d lowest = _mm256_set1_pd(minNorm), highest = _mm256_set1_pd(maxNorm), one = _mm256_set1_pd(1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d zRe = _mm256_loadu_pd(re + i), zIm = _mm256_loadu_pd(im + i);
+        __m256d norm = _mm256_add_pd(_mm256_mul_pd(zRe, zRe), _mm256_mul_pd(zIm, zIm));
+        outOfRange = _mm256_or_pd(outOfRange, _mm256_or_pd(_mm256_cmp_pd(norm, lowest, _CMP_LT_OQ),
+                                                           _mm256_cmp_pd(norm, highest, _CMP_GT_OQ)));
+        __m256d inverse = _mm256_div_pd(one, norm);
+        accRe = _mm256_add_pd(accRe, _mm256_mul_pd(zRe, inverse));
+        accIm = _mm256_sub_pd(accIm, _mm256_mul_pd(zIm, inverse));
+    }
+    sumRe += horizontalSumAvx2(accRe);
+    sumIm += horizontalSumAvx2(accIm);
+
+    bool inRange = _mm256_movemask_pd(outOfRange) == 0;
+    return sumReciprocalsBlockScalar(re, im, count, sumRe, sumIm, i) && inRange;
+}
+
+const ComplexKernels avx2Kernels = { ComplexKernels::SimdLevel::avx2, addAvx2, addReciprocalAvx2, reciprocalAvx2, multiplyAvx2, divideAvx2,
+                                     sumBlockAvx2, sumReciprocalsBlockAvx2 };
+
+__attribute__((target("avx2")))
+void addFloatAvx2(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(dstRe + i, _mm256_add_ps(_mm256_loadu_ps(dstRe + i), _mm256_loadu_ps(re + i)));
+        _mm256_storeu_ps(dstIm + i, _mm256_add_ps(_mm256_loadu_ps(dstIm + i), _mm256_loadu_ps(im + i)));
+    }
+    addFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void addReciprocalFloatAvx2(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 zRe = _mm256_loadu_ps(re + i), zIm = _mm256_loadu_ps(im + i);
+        __m256 norm = _mm256_add_ps(_mm256_mul_ps(zRe, zRe), _mm256_mul_ps(zIm, zIm));
+        _mm256_storeu_ps(dstRe + i, _mm256_add_ps(_mm256_loadu_ps(dstRe + i), _mm256_div_ps(zRe, norm)));
+        _mm256_storeu_ps(dstIm + i, _mm256_sub_ps(_mm256_loadu_ps(dstIm + i), _mm256_div_ps(zIm, norm)));
+    }
+    addReciprocalFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void reciprocalFloatAvx2(float* re, float* im, size_t count)
+{
+    size_t i = 0;
+    __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 zRe = _mm256_loadu_ps(re + i), zIm = _mm256_loadu_ps(im + i);
+        __m256 norm = _mm256_add_ps(_mm256_mul_ps(zRe, zRe), _mm256_mul_ps(zIm, zIm));
+        _mm256_storeu_ps(re + i, _mm256_div_ps(zRe, norm));
+        _mm256_storeu_ps(im + i, _mm256_div_ps(_mm256_sub_ps(zero, zIm), norm));
+    }
+    reciprocalFloatScalar(re, im, count, i);
+}
+
+__attribute__((target("avx2")))
+void multiplyFloatAvx2(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                       float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 xRe = _mm256_loadu_ps(aRe + i), xIm = _mm256_loadu_ps(aIm + i);
+        __m256 yRe = _mm256_loadu_ps(bRe + i), yIm = _mm256_loadu_ps(bIm + i);
+        _mm256_storeu_ps(outRe + i, _mm256_sub_ps(_mm256_mul_ps(xRe, yRe), _mm256_mul_ps(xIm, yIm)));
+        _mm256_storeu_ps(outIm + i, _mm256_add_ps(_mm256_mul_ps(xRe, yIm), _mm256_mul_ps(xIm, yRe)));
+    }
+    multiplyFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx2")))
+void divideFloatAvx2(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                     float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 xRe = _mm256_loadu_ps(aRe + i), xIm = _mm256_loadu_ps(aIm + i);
+        __m256 yRe = _mm256_loadu_ps(bRe + i), yIm = _mm256_loadu_ps(bIm + i);
+        __m256 norm = _mm256_add_ps(_mm256_mul_ps(yRe, yRe), _mm256_mul_ps(yIm, yIm));
+        __m256 re = _mm256_add_ps(_mm256_mul_ps(xRe, yRe), _mm256_mul_ps(xIm, yIm));
+        __m256 im = _mm256_sub_ps(_mm256_mul_ps(xIm, yRe), _mm256_mul_ps(xRe, yIm));
+        _mm256_storeu_ps(outRe + i, _mm256_div_ps(re, norm));
+        _mm256_storeu_ps(outIm + i, _mm256_div_ps(im, norm));
+    }
+    divideFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx2")))
+void addBoundedFloatAvx2(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                         float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m256 sign = _mm256_set1_ps(-0.0f), add = _mm256_set1_ps(growth);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 zRe = _mm256_loadu_ps(re + i), zIm = _mm256_loadu_ps(im + i);
+        __m256 weight = _mm256_add_ps(_mm256_loadu_ps(termBound + i), add);
+        _mm256_storeu_ps(dstRe + i, _mm256_add_ps(_mm256_loadu_ps(dstRe + i), zRe));
+        _mm256_storeu_ps(dstIm + i, _mm256_add_ps(_mm256_loadu_ps(dstIm + i), zIm));
+        _mm256_storeu_ps(bound + i, _mm256_add_ps(_mm256_loadu_ps(bound + i), _mm256_mul_ps(_mm256_add_ps(_mm256_andnot_ps(sign, zRe), _mm256_andnot_ps(sign, zIm)), weight)));
+    }
+    addBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("avx2")))
+void addReciprocalBoundedFloatAvx2(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                                   float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m256 sign = _mm256_set1_ps(-0.0f), add = _mm256_set1_ps(growth);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 zRe = _mm256_loadu_ps(re + i), zIm = _mm256_loadu_ps(im + i);
+        __m256 norm = _mm256_add_ps(_mm256_mul_ps(zRe, zRe), _mm256_mul_ps(zIm, zIm));
+        __m256 yRe = _mm256_div_ps(zRe, norm), yIm = _mm256_div_ps(zIm, norm);
+        __m256 weight = _mm256_add_ps(_mm256_loadu_ps(termBound + i), add);
+        _mm256_storeu_ps(dstRe + i, _mm256_add_ps(_mm256_loadu_ps(dstRe + i), yRe));
+        _mm256_storeu_ps(dstIm + i, _mm256_sub_ps(_mm256_loadu_ps(dstIm + i), yIm));
+        _mm256_storeu_ps(bound + i, _mm256_add_ps(_mm256_loadu_ps(bound + i), _mm256_mul_ps(_mm256_add_ps(_mm256_andnot_ps(sign, yRe), _mm256_andnot_ps(sign, yIm)), weight)));
+    }
+    addReciprocalBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("avx2")))
+void relativeBoundFloatAvx2(float* bound, float const * re, float const * im, float factor, float growth, size_t count)
+{
+    size_t i = 0;
+    __m256 sign = _mm256_set1_ps(-0.0f), scale = _mm256_set1_ps(factor), add = _mm256_set1_ps(growth);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 magnitude = _mm256_add_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(re + i)), _mm256_andnot_ps(sign, _mm256_loadu_ps(im + i)));
+        _mm256_storeu_ps(bound + i, _mm256_add_ps(_mm256_div_ps(_mm256_mul_ps(scale, _mm256_loadu_ps(bound + i)), magnitude), add));
+    }
+    relativeBoundFloatScalar(bound, re, im, factor, growth, count, i);
+}
+
+const FloatComplexKernels avx2FloatKernels = { ComplexKernels::SimdLevel::avx2, addFloatAvx2, addReciprocalFloatAvx2, reciprocalFloatAvx2,
+                                               multiplyFloatAvx2, divideFloatAvx2,
+                                               addBoundedFloatAvx2, addReciprocalBoundedFloatAvx2, relativeBoundFloatAvx2 };
+
+// Версии AVX-512: по 8 чисел double или 16 чисел float за команду
+
+__attribute__((target("avx512f")))
+void addAvx512(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm512_storeu_pd(dstRe + i, _mm512_add_pd(_mm512_loadu_pd(dstRe + i), _mm512_loadu_pd(re + i)));
+        _mm512_storeu_pd(dstIm + i, _mm512_add_pd(_mm512_loadu_pd(dstIm + i), _mm512_loadu_pd(im + i)));
+    }
+    addScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void addReciprocalAvx512(double* dstRe, double* dstIm, double const * re, double const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d zRe = _mm512_loadu_pd(re + i), zIm = _mm512_loadu_pd(im + i);
+        __m512d norm = _mm512_add_pd(_mm512_mul_pd(zRe, zRe), _mm512_mul_pd(zIm, zIm));
+        _mm512_storeu_pd(dstRe + i, _mm512_add_pd(_mm512_loadu_pd(dstRe + i), _mm512_div_pd(zRe, norm)));
+        _mm512_storeu_pd(dstIm + i, _mm512_sub_pd(_mm512_loadu_pd(dstIm + i), _mm512_div_pd(zIm, norm)));
+    }
+    addReciprocalScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void reciprocalAvx512(double* re, double* im, size_t count)
+{
+    size_t i = 0;
+    __m512d zero = _mm512_setzero_pd();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d zRe = _mm512_loadu_pd(re + i), zIm = _mm512_loadu_pd(im + i);
+        __m512d norm = _mm512_add_pd(_mm512_mul_pd(zRe, zRe), _mm512_mul_pd(zIm, zIm));
+        _mm512_storeu_pd(re + i, _mm512_div_pd(zRe, norm));
+        _mm512_storeu_pd(im + i, _mm512_div_pd(_mm512_sub_pd(zero, zIm), norm));
+    }
+    reciprocalScalar(re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void multiplyAvx512(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                    double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d xRe = _mm512_loadu_pd(aRe + i), xIm = _mm512_loadu_pd(aIm + i);
+        __m512d yRe = _mm512_loadu_pd(bRe + i), yIm = _mm512_loadu_pd(bIm + i);
+        _mm512_storeu_pd(outRe + i, _mm512_sub_pd(_mm512_mul_pd(xRe, yRe), _mm512_mul_pd(xIm, yIm)));
+        _mm512_storeu_pd(outIm + i, _mm512_add_pd(_mm512_mul_pd(xRe, yIm), _mm512_mul_pd(xIm, yRe)));
+    }
+    multiplyScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx512f")))
+void divideAvx512(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                  double const * bRe, double const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d xRe = _mm512_loadu_pd(aRe + i), xIm = _mm512_loadu_pd(aIm + i);
+        __m512d yRe = _mm512_loadu_pd(bRe + i), yIm = _mm512_loadu_pd(bIm + i);
+        __m512d norm = _mm512_add_pd(_mm512_mul_pd(yRe, yRe), _mm512_mul_pd(yIm, yIm));
+        __m512d re = _mm512_add_pd(_mm512_mul_pd(xRe, yRe), _mm512_mul_pd(xIm, yIm));
+        __m512d im = _mm512_sub_pd(_mm512_mul_pd(xIm, yRe), _mm512_mul_pd(xRe, yIm));
+        _mm512_storeu_pd(outRe + i, _mm512_div_pd(re, norm));
+        _mm512_storeu_pd(outIm + i, _mm512_div_pd(im, norm));
+    }
+    divideScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx512f")))
+double horizontalSumAvx512(__m512d value)
+{
+    double lanes[8];
+    _mm512_storeu_pd(lanes, value);
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+void sumBlockAvx512(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m512d accRe0 = _mm512_setzero_pd(), accIm0 = _mm512_setzero_pd();
+    __m512d accRe1 = _mm512_setzero_pd(), accIm1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        accRe0 = _mm512_add_pd(accRe0, _mm512_loadu_pd(re + i));
+        accIm0 = _mm512_add_pd(accIm0, _mm512_loadu_pd(im + i));
+        accRe1 = _mm512_add_pd(accRe1, _mm512_loadu_pd(re + i + 8));
+        accIm1 = _mm512_add_pd(accIm1, _mm512_loadu_pd(im + i + 8));
+    }
+    sumRe += horizontalSumAvx512(_mm512_add_pd(accRe0, accRe1));
+    sumIm += horizontalSumAvx512(_mm512_add_pd(accIm0, accIm1));
+    sumBlockScalar(re, im, count, sumRe, sumIm, i);
+}
+
+__attribute__((target("avx512f")))
+bool sumReciprocalsBlockAvx512(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    __m512d accRe = _mm512_setzero_pd(), accIm = _mm512_setzero_pd();
+    __mmask8 outOfRange = 0;
+    __m512d lowest = _mm512_set1_pd(minNorm), highest = _mm512_set1_pd(maxNorm), one = _mm512_set1_pd(1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m512d zRe = _mm512_loadu_pd(re + i), zIm = _mm512_loadu_pd(im + i);
+        __m512d norm = _mm512_add_pd(_mm512_mul_pd(zRe, zRe), _mm512_mul_pd(zIm, zIm));
+        outOfRange |= _mm512_cmp_pd_mask(norm, lowest, _CMP_LT_OQ) | _mm512_cmp_pd_mask(norm, highest, _CMP_GT_OQ);
+        __m512d inverse = _mm512_div_pd(one, norm);
+        accRe = _mm512_add_pd(accRe, _mm512_mul_pd(zRe, inverse));
+        accIm = _mm512_sub_pd(accIm, _mm512_mul_pd(zIm, inverse));
+    }
+    sumRe += horizontalSumAvx512(accRe);
+    sumIm += horizontalSumAvx512(accIm);
+
+    bool inRange = outOfRange == 0;
+    return sumReciprocalsBlockScalar(re, im, count, sumRe, sumIm, i) && inRange;
+}
+
+const ComplexKernels avx512Kernels = { ComplexKernels::SimdLevel::avx512, addAvx512, addReciprocalAvx512, reciprocalAvx512, multiplyAvx512,
+                                       divideAvx512, sumBlockAvx512, sumReciprocalsBlockAvx512 };
+
+__attribute__((target("avx512f")))
+void addFloatAvx512(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        _mm512_storeu_ps(dstRe + i, _mm512_add_ps(_mm512_loadu_ps(dstRe + i), _mm512_loadu_ps(re + i)));
+        _mm512_storeu_ps(dstIm + i, _mm512_add_ps(_mm512_loadu_ps(dstIm + i), _mm512_loadu_ps(im + i)));
+    }
+    addFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void addReciprocalFloatAvx512(float* dstRe, float* dstIm, float const * re, float const * im, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 zRe = _mm512_loadu_ps(re + i), zIm = _mm512_loadu_ps(im + i);
+        __m512 norm = _mm512_add_ps(_mm512_mul_ps(zRe, zRe), _mm512_mul_ps(zIm, zIm));
+        _mm512_storeu_ps(dstRe + i, _mm512_add_ps(_mm512_loadu_ps(dstRe + i), _mm512_div_ps(zRe, norm)));
+        _mm512_storeu_ps(dstIm + i, _mm512_sub_ps(_mm512_loadu_ps(dstIm + i), _mm512_div_ps(zIm, norm)));
+    }
+    addReciprocalFloatScalar(dstRe, dstIm, re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void reciprocalFloatAvx512(float* re, float* im, size_t count)
+{
+    size_t i = 0;
+    __m512 zero = _mm512_setzero_ps();
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 zRe = _mm512_loadu_ps(re + i), zIm = _mm512_loadu_ps(im + i);
+        __m512 norm = _mm512_add_ps(_mm512_mul_ps(zRe, zRe), _mm512_mul_ps(zIm, zIm));
+        _mm512_storeu_ps(re + i, _mm512_div_ps(zRe, norm));
+        _mm512_storeu_ps(im + i, _mm512_div_ps(_mm512_sub_ps(zero, zIm), norm));
+    }
+    reciprocalFloatScalar(re, im, count, i);
+}
+
+__attribute__((target("avx512f")))
+void multiplyFloatAvx512(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                         float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 xRe = _mm512_loadu_ps(aRe + i), xIm = _mm512_loadu_ps(aIm + i);
+        __m512 yRe = _mm512_loadu_ps(bRe + i), yIm = _mm512_loadu_ps(bIm + i);
+        _mm512_storeu_ps(outRe + i, _mm512_sub_ps(_mm512_mul_ps(xRe, yRe), _mm512_mul_ps(xIm, yIm)));
+        _mm512_storeu_ps(outIm + i, _mm512_add_ps(_mm512_mul_ps(xRe, yIm), _mm512_mul_ps(xIm, yRe)));
+    }
+    multiplyFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx512f")))
+void divideFloatAvx512(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                       float const * bRe, float const * bIm, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 xRe = _mm512_loadu_ps(aRe + i), xIm = _mm512_loadu_ps(aIm + i);
+        __m512 yRe = _mm512_loadu_ps(bRe + i), yIm = _mm512_loadu_ps(bIm + i);
+        __m512 norm = _mm512_add_ps(_mm512_mul_ps(yRe, yRe), _mm512_mul_ps(yIm, yIm));
+        __m512 re = _mm512_add_ps(_mm512_mul_ps(xRe, yRe), _mm512_mul_ps(xIm, yIm));
+        __m512 im = _mm512_sub_ps(_mm512_mul_ps(xIm, yRe), _mm512_mul_ps(xRe, yIm));
+        _mm512_storeu_ps(outRe + i, _mm512_div_ps(re, norm));
+        _mm512_storeu_ps(outIm + i, _mm512_div_ps(im, norm));
+    }
+    divideFloatScalar(outRe, outIm, aRe, aIm, bRe, bIm, count, i);
+}
+
+__attribute__((target("avx512f")))
+void addBoundedFloatAvx512(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                           float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m512 add = _mm512_set1_ps(growth);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 zRe = _mm512_loadu_ps(re + i), zIm = _mm512_loadu_ps(im + i);
+        __m512 weight = _mm512_add_ps(_mm512_loadu_ps(termBound + i), add);
+        _mm512_storeu_ps(dstRe + i, _mm512_add_ps(_mm512_loadu_ps(dstRe + i), zRe));
+        _mm512_storeu_ps(dstIm + i, _mm512_add_ps(_mm512_loadu_ps(dstIm + i), zIm));
+        _mm512_storeu_ps(bound + i, _mm512_add_ps(_mm512_loadu_ps(bound + i), _mm512_mul_ps(_mm512_add_ps(_mm512_abs_ps(zRe), _mm512_abs_ps(zIm)), weight)));
+    }
+    addBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("avx512f")))
+void addReciprocalBoundedFloatAvx512(float* dstRe, float* dstIm, float* bound, float const * re, float const * im,
+                                     float const * termBound, float growth, size_t count)
+{
+    size_t i = 0;
+    __m512 add = _mm512_set1_ps(growth);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 zRe = _mm512_loadu_ps(re + i), zIm = _mm512_loadu_ps(im + i);
+        __m512 norm = _mm512_add_ps(_mm512_mul_ps(zRe, zRe), _mm512_mul_ps(zIm, zIm));
+        __m512 yRe = _mm512_div_ps(zRe, norm), yIm = _mm512_div_ps(zIm, norm);
+        __m512 weight = _mm512_add_ps(_mm512_loadu_ps(termBound + i), add);
+        _mm512_storeu_ps(dstRe + i, _mm512_add_ps(_mm512_loadu_ps(dstRe + i), yRe));
+        _mm512_storeu_ps(dstIm + i, _mm512_sub_ps(_mm512_loadu_ps(dstIm + i), yIm));
+        _mm512_storeu_ps(bound + i, _mm512_add_ps(_mm512_loadu_ps(bound + i), _mm512_mul_ps(_mm512_add_ps(_mm512_abs_ps(yRe), _mm512_abs_ps(yIm)), weight)));
+    }
+    addReciprocalBoundedFloatScalar(dstRe, dstIm, bound, re, im, termBound, growth, count, i);
+}
+
+__attribute__((target("avx512f")))
+void relativeBoundFloatAvx512(float* bound, float const * re, float const * im, float factor, float growth, size_t count)
+{
+    size_t i = 0;
+    __m512 scale = _mm512_set1_ps(factor), add = _mm512_set1_ps(growth);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 magnitude = _mm512_add_ps(_mm512_abs_ps(_mm512_loadu_ps(re + i)), _mm512_abs_ps(_mm512_loadu_ps(im + i)));
+        _mm512_storeu_ps(bound + i, _mm512_add_ps(_mm512_div_ps(_mm512_mul_ps(scale, _mm512_loadu_ps(bound + i)), magnitude), add));
+    }
+    relativeBoundFloatScalar(bound, re, im, factor, growth, count, i);
+}
+
+const FloatComplexKernels avx512FloatKernels = { ComplexKernels::SimdLevel::avx512, addFloatAvx512, addReciprocalFloatAvx512, reciprocalFloatAvx512,
+                                                 multiplyFloatAvx512, divideFloatAvx512,
+                                                 addBoundedFloatAvx512, addReciprocalBoundedFloatAvx512, relativeBoundFloatAvx512 };
+
+#endif // COMPLEX_KERNELS_X86
+
+/*!
+* \brief Сложить числа попарно: половины массива суммируются отдельно, пока не останется один блок
+* \param[in] kernel - сумма блока, возвращает false, если результат нужно пересчитать точно
+* \param[in] re - действительные части
+* \param[in] im - мнимые части
+* \param[in] count - количество чисел
+* \param[out] result - сумма
+* \return - false, если сумму какого-либо блока нужно пересчитать точно
+*/
+template <typename Kernel>
+bool pairwiseSum(Kernel kernel, double const * re, double const * im, size_t count, std::complex<double>& result)
+{
+    if (count <= ComplexKernels::pairwiseBlock)
+    {
+        double sumRe = 0, sumIm = 0;
+        bool isExact = kernel(re, im, count, sumRe, sumIm);
+        result = std::complex<double>(sumRe, sumIm);
+        return isExact;
+    }
+
+    size_t half = count / 2;
+    std::complex<double> left, right;
+    bool isLeftExact = pairwiseSum(kernel, re, im, half, left);
+    bool isRightExact = pairwiseSum(kernel, re + half, im + half, count - half, right);
+    result = left + right;
+    return isLeftExact && isRightExact;
+}
+
+/*!
+* \brief Сложить обратные значения делением std::complex, которое сохраняет точность при любых модулях
+* \param[in] re - действительные части
+* \param[in] im - мнимые части
+* \param[in] count - количество чисел
+* \param[in,out] sumRe - действительная часть суммы
+* \param[in,out] sumIm - мнимая часть суммы
+* \return - true
+*/
+bool sumReciprocalsBlockExact(double const * re, double const * im, size_t count, double& sumRe, double& sumIm)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        std::complex<double> reciprocal = 1.0 / std::complex<double>(re[i], im[i]);
+        sumRe += reciprocal.real();
+        sumIm += reciprocal.imag();
+    }
+    return true;
+}
+
+} // namespace
+
+ComplexKernels const & ComplexKernels::forLevel(SimdLevel level)
+{
+    level = resolve(level);
+#ifdef COMPLEX_KERNELS_X86
+    if (level == SimdLevel::avx512)
+        return avx512Kernels;
+    if (level == SimdLevel::avx2)
+        return avx2Kernels;
+    if (level == SimdLevel::sse2)
+        return sse2Kernels;
+#endif
+    return scalarKernels;
+}
+
+FloatComplexKernels const & FloatComplexKernels::forLevel(ComplexKernels::SimdLevel level)
+{
+    level = ComplexKernels::resolve(level);
+#ifdef COMPLEX_KERNELS_X86
+    if (level == ComplexKernels::SimdLevel::avx512)
+        return avx512FloatKernels;
+    if (level == ComplexKernels::SimdLevel::avx2)
+        return avx2FloatKernels;
+    if (level == ComplexKernels::SimdLevel::sse2)
+        return sse2FloatKernels;
+#endif
+    return scalarFloatKernels;
+}
+
+ComplexKernels::SimdLevel ComplexKernels::detectSimdLevel()
+{
+#ifdef COMPLEX_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SimdLevel::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::sse2;
+#endif
+    return SimdLevel::scalar;
+}
+
+ComplexKernels::SimdLevel ComplexKernels::resolve(SimdLevel level)
+{
+    static const SimdLevel supported = detectSimdLevel();
+    if (level == SimdLevel::automatic || static_cast<int>(level) > static_cast<int>(supported))
+        return supported;
+    return level;
+}
+
+std::string ComplexKernels::levelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::avx512:
+        return "avx512";
+    case SimdLevel::avx2:
+        return "avx2";
+    case SimdLevel::sse2:
+        return "sse2";
+    case SimdLevel::scalar:
+        return "scalar";
+    default:
+        return "automatic";
+    }
+}
+
+std::complex<double> ComplexKernels::sum(double const * re, double const * im, size_t count, SimdLevel level)
+{
+    ComplexKernels const & kernels = forLevel(level);
+    std::complex<double> result;
+    pairwiseSum([&kernels](double const * blockRe, double const * blockIm, size_t blockCount, double& sumRe, double& sumIm)
+                {
+                    kernels.sumBlock(blockRe, blockIm, blockCount, sumRe, sumIm);
+                    return true;
+                }, re, im, count, result);
+    return result;
+}
+
+std::complex<double> ComplexKernels::sumReciprocals(double const * re, double const * im, size_t count, SimdLevel level)
+{
+    ComplexKernels const & kernels = forLevel(level);
+    std::complex<double> result;
+    if (pairwiseSum(kernels.sumReciprocalsBlock, re, im, count, result) && std::isfinite(result.real()) && std::isfinite(result.imag()))
+        return result;
+
+    // Слишком большие или малые по модулю числа (и NaN) дают неверный квадрат модуля
+    pairwiseSum(sumReciprocalsBlockExact, re, im, count, result);
+    return result;
+}
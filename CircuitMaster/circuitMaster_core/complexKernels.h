@@ -0,0 +1,142 @@
+#ifndef COMPLEXKERNELS_H
+#define COMPLEXKERNELS_H
+#include <complex>
+#include <cstddef>
+#include <string>
+
+/*!
+*\file
+*\brief Заголовки функций над массивами комплексных чисел с векторными командами
+*/
+
+/*!
+*\class ComplexKernels
+*\brief Действия над массивами комплексных чисел, хранящихся отдельно действительными и мнимыми частями
+*
+* Каждый объект - набор действий для одного набора векторных команд (SSE2, AVX2 или AVX-512). Набор
+* выбирается функцией forLevel по возможностям процессора, поэтому программа, собранная без
+* -march, использует лучшие доступные команды. Деление и обратное значение считаются через квадрат
+* модуля, без проверок NaN и бесконечностей, которые выполняет деление std::complex.
+*
+* Суммы (sum, sumReciprocals) считаются попарно: блоками по pairwiseBlock слагаемых, суммы блоков
+* складываются деревом, поэтому погрешность растет как логарифм количества слагаемых, а не линейно
+*/
+class ComplexKernels
+{
+    public:
+    /*!
+    *\enum SimdLevel
+    *\brief Набор векторных команд
+    */
+    enum class SimdLevel
+    {
+        automatic, /*!< Лучший из доступных процессору */
+        scalar, /*!< Без векторных команд */
+        sse2, /*!< SSE2 */
+        avx2, /*!< AVX2 */
+        avx512 /*!< AVX-512F */
+    };
+
+    static const size_t wideCount = 64; /*!< Количество слагаемых, начиная с которого соединение рассчитывается векторными суммами */
+    static const size_t pairwiseBlock = 256; /*!< Количество слагаемых, суммируемых подряд перед попарным сложением */
+
+    SimdLevel level; /*!< Набор векторных команд */
+    void (*add)(double* dstRe, double* dstIm, double const * re, double const * im, size_t count); /*!< dst += src */
+    void (*addReciprocal)(double* dstRe, double* dstIm, double const * re, double const * im, size_t count); /*!< dst += 1 / src */
+    void (*reciprocal)(double* re, double* im, size_t count); /*!< z = 1 / z */
+    void (*multiply)(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                     double const * bRe, double const * bIm, size_t count); /*!< out = a * b */
+    void (*divide)(double* outRe, double* outIm, double const * aRe, double const * aIm,
+                   double const * bRe, double const * bIm, size_t count); /*!< out = a / b */
+    void (*sumBlock)(double const * re, double const * im, size_t count, double& sumRe, double& sumIm); /*!< sum += сумма z */
+    bool (*sumReciprocalsBlock)(double const * re, double const * im, size_t count,
+                                double& sumRe, double& sumIm); /*!< sum += сумма 1 / z, false - квадрат модуля вне пределов double */
+
+    /*!
+    * \brief Получить действия над массивами для набора векторных команд
+    * \param[in] level - набор векторных команд. Если процессор его не поддерживает, используется лучший из доступных
+    * \return - действия над массивами
+    */
+    static ComplexKernels const & forLevel(SimdLevel level = SimdLevel::automatic);
+
+    /*!
+    * \brief Получить лучший набор векторных команд, поддерживаемый процессором
+    * \return - набор векторных команд
+    */
+    static SimdLevel detectSimdLevel();
+
+    /*!
+    * \brief Получить набор векторных команд, который будет использован вместо запрошенного
+    * \param[in] level - запрошенный набор. Если процессор его не поддерживает, выбирается лучший из доступных
+    * \return - набор векторных команд
+    */
+    static SimdLevel resolve(SimdLevel level);
+
+    /*!
+    * \brief Получить название набора векторных команд
+    * \param[in] level - набор векторных команд
+    * \return - "avx512", "avx2", "sse2", "scalar" или "automatic"
+    */
+    static std::string levelName(SimdLevel level);
+
+    /*!
+    * \brief Сложить комплексные числа
+    * \param[in] re - действительные части
+    * \param[in] im - мнимые части
+    * \param[in] count - количество чисел
+    * \param[in] level - набор векторных команд
+    * \return - сумма
+    */
+    static std::complex<double> sum(double const * re, double const * im, size_t count, SimdLevel level = SimdLevel::automatic);
+
+    /*!
+    * \brief Сложить обратные значения комплексных чисел (проводимости по сопротивлениям)
+    *
+    * Обратное значение считается как сопряженное, деленное на квадрат модуля. Если квадрат модуля
+    * выходит за пределы double, сумма пересчитывается делением std::complex
+    * \param[in] re - действительные части
+    * \param[in] im - мнимые части
+    * \param[in] count - количество чисел
+    * \param[in] level - набор векторных команд
+    * \return - сумма обратных значений
+    */
+    static std::complex<double> sumReciprocals(double const * re, double const * im, size_t count, SimdLevel level = SimdLevel::automatic);
+};
+
+/*!
+*\class FloatComplexKernels
+*\brief Те же действия над массивами, что и в ComplexKernels, для чисел float
+*
+* Регистр вмещает вдвое больше чисел float, чем double, поэтому действия выполняются примерно
+* вдвое быстрее ценой точности около 7 значащих цифр
+*/
+class FloatComplexKernels
+{
+    public:
+    ComplexKernels::SimdLevel level; /*!< Набор векторных команд */
+    void (*add)(float* dstRe, float* dstIm, float const * re, float const * im, size_t count); /*!< dst += src */
+    void (*addReciprocal)(float* dstRe, float* dstIm, float const * re, float const * im, size_t count); /*!< dst += 1 / src */
+    void (*reciprocal)(float* re, float* im, size_t count); /*!< z = 1 / z */
+    void (*multiply)(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                     float const * bRe, float const * bIm, size_t count); /*!< out = a * b */
+    void (*divide)(float* outRe, float* outIm, float const * aRe, float const * aIm,
+                   float const * bRe, float const * bIm, size_t count); /*!< out = a / b */
+
+    // Действия с оценкой погрешности слагаемых. Модуль числа заменяется суммой модулей действительной и мнимой частей
+
+    void (*addBounded)(float* dstRe, float* dstIm, float* bound, float const * re, float const * im, float const * termBound,
+                       float growth, size_t count); /*!< dst += z, bound += |z| * (termBound + growth) */
+    void (*addReciprocalBounded)(float* dstRe, float* dstIm, float* bound, float const * re, float const * im, float const * termBound,
+                                 float growth, size_t count); /*!< dst += 1 / z, bound += |1 / z| * (termBound + growth) */
+    void (*relativeBound)(float* bound, float const * re, float const * im, float factor, float growth,
+                          size_t count); /*!< bound = factor * bound / |z| + growth */
+
+    /*!
+    * \brief Получить действия над массивами для набора векторных команд
+    * \param[in] level - набор векторных команд. Если процессор его не поддерживает, используется лучший из доступных
+    * \return - действия над массивами
+    */
+    static FloatComplexKernels const & forLevel(ComplexKernels::SimdLevel level = ComplexKernels::SimdLevel::automatic);
+};
+
+#endif // COMPLEXKERNELS_H
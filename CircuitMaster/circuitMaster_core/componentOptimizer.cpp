@@ -0,0 +1,313 @@
+#include "componentOptimizer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "circuitState.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "pathEvaluator.h"
+
+/*!
+*\file
+*\brief Реализация функций класса ComponentOptimizer
+*/
+
+namespace {
+
+const double e3Series[] = { 1.0, 2.2, 4.7 };
+const double e6Series[] = { 1.0, 1.5, 2.2, 3.3, 4.7, 6.8 };
+const double e12Series[] = { 1.0, 1.2, 1.5, 1.8, 2.2, 2.7, 3.3, 3.9, 4.7, 5.6, 6.8, 8.2 };
+const double e24Series[] = { 1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0,
+                             3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1 };
+
+// Доля элементов, значения которых случайно изменяются перед следующим локальным поиском
+const size_t perturbationDivisor = 3;
+
+/*!
+*\class LocalSearch
+*\brief Локальный поиск одного потока со своей копией значений цепи
+*/
+class LocalSearch
+{
+    public:
+    LocalSearch(CircuitTopology const & topology, std::vector<OptimizationVariable> const & variables,
+                std::vector<CurrentTarget> const & targets)
+        : source(topology), variables(variables), targets(targets), circuit(topology), evaluator(circuit, state)
+    {
+    }
+
+    CircuitTopology const & source; /*!< Исходная топология со значениями входных данных */
+    std::vector<OptimizationVariable> const & variables; /*!< Подбираемые элементы */
+    std::vector<CurrentTarget> const & targets; /*!< Требуемые силы тока */
+    CircuitTopology circuit; /*!< Топология со значениями текущего набора */
+    CircuitState state; /*!< Расчет текущего набора */
+    PathEvaluator evaluator; /*!< Оценка замены одного элемента */
+    std::vector<size_t> choices; /*!< Номера значений текущего набора */
+    double objective = 0; /*!< Отклонение текущего набора */
+    size_t evaluationCount = 0; /*!< Количество оцененных наборов */
+
+    /*!
+    * \brief Рассчитать цепь с набором значений
+    * \param[in] newChoices - номера значений элементов
+    * \return - false, если цепь с этим набором не рассчитывается
+    */
+    bool assign(std::vector<size_t> const & newChoices)
+    {
+        this->choices = newChoices;
+        for (size_t v = 0; v < this->variables.size(); v++)
+        {
+            OptimizationVariable const & variable = this->variables[v];
+            this->circuit.elementResistances[variable.element] = variable.resistance(this->source, variable.values[this->choices[v]]);
+        }
+        try {
+            this->state.evaluate(this->circuit);
+        } catch (std::string const &) {
+            this->objective = std::numeric_limits<double>::infinity();
+            return false;
+        }
+        this->evaluator.reset();
+        this->objective = this->score();
+        return true;
+    }
+
+    /*!
+    * \brief Выполнить спуск до локального минимума
+    * \param[in] deadline - время окончания подбора
+    */
+    void descend(std::chrono::steady_clock::time_point deadline)
+    {
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            // Лучшая замена значения одного элемента
+            size_t bestVariable = 0, bestChoice = 0;
+            double bestObjective = this->objective;
+            for (size_t v = 0; v < this->variables.size(); v++)
+            {
+                OptimizationVariable const & variable = this->variables[v];
+                for (size_t c = 0; c < variable.values.size(); c++)
+                {
+                    if (c == this->choices[v])
+                        continue;
+                    this->evaluator.reset();
+                    this->evaluator.setElementResistance(variable.element, variable.resistance(this->source, variable.values[c]));
+                    double candidate = this->score();
+                    if (candidate < bestObjective)
+                    {
+                        bestObjective = candidate;
+                        bestVariable = v;
+                        bestChoice = c;
+                    }
+                }
+            }
+            if (!(bestObjective < this->objective))
+                return;
+
+            // Принятая замена: вся цепь рассчитывается заново, следующие замены оцениваются относительно неё
+            std::vector<size_t> newChoices = this->choices;
+            newChoices[bestVariable] = bestChoice;
+            std::vector<size_t> oldChoices = this->choices;
+            if (!this->assign(newChoices))
+            {
+                this->assign(oldChoices);
+                return;
+            }
+        }
+    }
+
+    private:
+    /*!
+    * \brief Оценить отклонение сил тока с учетом изменений в evaluator
+    * \return - сумма квадратов относительных отклонений, бесконечность - цепь не рассчитывается
+    */
+    double score()
+    {
+        this->evaluationCount++;
+        double sum = 0;
+        try {
+            for (auto iter = this->targets.cbegin(); iter != this->targets.cend(); iter++)
+            {
+                double deviation = (std::abs(this->evaluator.current(iter->node)) - iter->current) / iter->current;
+                sum += deviation * deviation;
+            }
+        } catch (std::string const &) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return std::isnan(sum) ? std::numeric_limits<double>::infinity() : sum;
+    }
+};
+
+}
+
+std::complex<double> OptimizationVariable::resistance(CircuitTopology const & topology, double value) const
+{
+    std::complex<double> nominalResistance = topology.elementResistances[this->element];
+    if (topology.elementTypes[this->element] == CoreElement::ElemType::C)
+        return nominalResistance * (this->nominal / value);
+    return nominalResistance * (value / this->nominal);
+}
+
+std::vector<double> ComponentOptimizer::seriesValues(std::string const & series, double min, double max)
+{
+    double const * begin;
+    size_t count;
+    if (series == "E3")
+        begin = e3Series, count = sizeof(e3Series) / sizeof(double);
+    else if (series == "E6")
+        begin = e6Series, count = sizeof(e6Series) / sizeof(double);
+    else if (series == "E12")
+        begin = e12Series, count = sizeof(e12Series) / sizeof(double);
+    else if (series == "E24")
+        begin = e24Series, count = sizeof(e24Series) / sizeof(double);
+    else
+        throw formatStr("Неизвестный ряд номиналов \"%1\". Допустимые ряды: \"E3\", \"E6\", \"E12\", \"E24\".", { series });
+
+    if (!(min > 0) || !(max >= min))
+        throw formatStr("Недопустимый диапазон номиналов от %1 до %2.", { numberToStr(min), numberToStr(max) });
+
+    // Значения ряда повторяются в каждой декаде. Номинал собирается из двух значащих цифр и точной степени 10,
+    // поэтому совпадает с числом, записанным в десятичном виде
+    std::vector<double> values;
+    int firstDecade = static_cast<int>(std::floor(std::log10(min)));
+    int lastDecade = static_cast<int>(std::ceil(std::log10(max)));
+    for (int decade = firstDecade; decade <= lastDecade; decade++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            double digits = std::round(begin[i] * 10);
+            double value = decade >= 1 ? digits * std::pow(10.0, decade - 1) : digits / std::pow(10.0, 1 - decade);
+            if (value >= min * (1 - 1e-12) && value <= max * (1 + 1e-12))
+                values.push_back(value);
+        }
+    }
+    return values;
+}
+
+OptimizationResult ComponentOptimizer::optimize(CircuitTopology const & topology, std::vector<OptimizationVariable> const & variables,
+                                                std::vector<CurrentTarget> const & targets, OptimizationOptions const & options)
+{
+    CORE_TRACE_SPAN("ComponentOptimizer::optimize");
+    if (variables.empty())
+        throw std::string("Не указаны элементы для подбора номиналов. Укажите ряд номиналов атрибутом \"series\" элемента.");
+    if (targets.empty())
+        throw std::string("Не указаны требуемые силы тока. Укажите силу тока атрибутом \"target\" именованного соединения.");
+    for (auto iter = variables.cbegin(); iter != variables.cend(); iter++)
+    {
+        if (iter->values.empty())
+            throw formatStr("Для элемента %1 соединения %2 нет значений ряда в указанном диапазоне.",
+                            { numberToStr(iter->position), topology.nodes[iter->node].displayName() });
+    }
+
+    unsigned threadCount = options.threadCount;
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (options.maxSearches != 0)
+        threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, options.maxSearches));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(options.seconds));
+
+    // Лучший набор всех потоков
+    std::mutex bestMutex;
+    std::vector<size_t> bestChoices;
+    double bestObjective = std::numeric_limits<double>::infinity();
+    std::atomic<size_t> searchCount(0);
+    std::atomic<size_t> evaluationCount(0);
+
+    auto worker = [&](unsigned thread) {
+        std::mt19937 random(options.seed + thread);
+        LocalSearch search(topology, variables, targets);
+
+        // Первый поток начинает с ближайших к входным данным значений, остальные - со случайных
+        std::vector<size_t> start(variables.size());
+        for (size_t v = 0; v < variables.size(); v++)
+        {
+            std::vector<double> const & values = variables[v].values;
+            if (thread == 0)
+            {
+                auto nearest = std::min_element(values.cbegin(), values.cend(), [&](double left, double right) {
+                    return std::abs(std::log(left / variables[v].nominal)) < std::abs(std::log(right / variables[v].nominal));
+                });
+                start[v] = static_cast<size_t>(nearest - values.cbegin());
+            }
+            else
+                start[v] = random() % values.size();
+        }
+
+        std::vector<size_t> threadBest;
+        double threadBestObjective = std::numeric_limits<double>::infinity();
+        for (;;)
+        {
+            if (searchCount++ >= options.maxSearches && options.maxSearches != 0)
+                break;
+            if (search.assign(start))
+                search.descend(deadline);
+            if (search.objective < threadBestObjective)
+            {
+                threadBestObjective = search.objective;
+                threadBest = search.choices;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+                break;
+
+            // Следующий поиск начинается с лучшего набора потока, в котором изменена часть элементов
+            start = threadBest.empty() ? search.choices : threadBest;
+            size_t perturbed = std::max<size_t>(1, variables.size() / perturbationDivisor);
+            for (size_t i = 0; i < perturbed; i++)
+            {
+                size_t v = random() % variables.size();
+                start[v] = random() % variables[v].values.size();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(bestMutex);
+        evaluationCount += search.evaluationCount;
+        if (!threadBest.empty() && (threadBestObjective < bestObjective || bestChoices.empty()))
+        {
+            bestObjective = threadBestObjective;
+            bestChoices = threadBest;
+        }
+    };
+
+    if (threadCount == 1)
+        worker(0);
+    else
+    {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]() {
+                if (Trace::isEnabled())
+                    Trace::setThreadName("optimizer " + std::to_string(t + 1));
+                worker(t);
+            });
+        }
+        for (auto iter = threads.begin(); iter != threads.end(); iter++)
+            iter->join();
+    }
+
+    if (bestChoices.empty() || std::isinf(bestObjective))
+        throw std::string("Не удалось подобрать номиналы: цепь не рассчитывается ни с одним из проверенных наборов.");
+
+    // Силы тока лучшего набора рассчитываются по всей цепи
+    CircuitTopology best = topology;
+    OptimizationResult result;
+    for (size_t v = 0; v < variables.size(); v++)
+    {
+        double value = variables[v].values[bestChoices[v]];
+        result.values.push_back(value);
+        best.elementResistances[variables[v].element] = variables[v].resistance(topology, value);
+    }
+    CircuitState state;
+    state.evaluate(best);
+    for (auto iter = targets.cbegin(); iter != targets.cend(); iter++)
+        result.currents.push_back(state.currents[iter->node]);
+    result.objective = bestObjective;
+    result.evaluationCount = evaluationCount;
+    result.searchCount = options.maxSearches == 0 ? searchCount.load() : std::min(searchCount.load(), options.maxSearches);
+    return result;
+}
@@ -0,0 +1,112 @@
+#ifndef COMPONENTOPTIMIZER_H
+#define COMPONENTOPTIMIZER_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций подбора номиналов элементов из стандартных рядов
+*/
+
+/*!
+*\class OptimizationVariable
+*\brief Элемент, номинал которого подбирается из стандартного ряда
+*/
+class OptimizationVariable
+{
+    public:
+    size_t element; /*!< Номер элемента в топологии */
+    int node; /*!< Номер соединения, которому принадлежит элемент */
+    int position; /*!< Номер элемента в соединении, начиная с 1 */
+    double nominal; /*!< Значение элемента во входных данных: сопротивление, индуктивность или емкость */
+    std::vector<double> values; /*!< Допустимые значения по возрастанию */
+
+    /*!
+    * \brief Получить комплексное сопротивление элемента с другим значением
+    *
+    * Сопротивление резистора и катушки пропорционально значению, конденсатора - обратно пропорционально
+    * \param[in] topology - топология цепи
+    * \param[in] value - значение элемента
+    * \return - комплексное сопротивление
+    */
+    std::complex<double> resistance(CircuitTopology const & topology, double value) const;
+};
+
+/*!
+*\class CurrentTarget
+*\brief Требуемое действующее значение силы тока соединения
+*/
+class CurrentTarget
+{
+    public:
+    int node; /*!< Номер соединения в топологии */
+    double current; /*!< Требуемый модуль силы тока */
+};
+
+/*!
+*\class OptimizationOptions
+*\brief Параметры подбора номиналов
+*/
+class OptimizationOptions
+{
+    public:
+    double seconds = 1; /*!< Ограничение времени подбора в секундах */
+    unsigned threadCount = 0; /*!< Количество потоков, 0 - по числу ядер */
+    size_t maxSearches = 0; /*!< Наибольшее количество локальных поисков, 0 - до окончания времени */
+    unsigned seed = 1; /*!< Начальное значение генератора случайных чисел */
+};
+
+/*!
+*\class OptimizationResult
+*\brief Лучший найденный набор номиналов
+*/
+class OptimizationResult
+{
+    public:
+    std::vector<double> values; /*!< Значения элементов в порядке списка подбираемых элементов */
+    std::vector<std::complex<double>> currents; /*!< Силы тока соединений в порядке списка требований */
+    double objective = 0; /*!< Сумма квадратов относительных отклонений модулей сил тока от требуемых */
+    size_t evaluationCount = 0; /*!< Количество оцененных наборов номиналов */
+    size_t searchCount = 0; /*!< Количество выполненных локальных поисков */
+};
+
+/*!
+*\class ComponentOptimizer
+*\brief Подбор номиналов элементов из стандартных рядов для получения требуемых сил тока
+*
+* Подбор выполняется локальным поиском: на каждом шаге перебираются все допустимые значения каждого
+* элемента и выбирается замена, сильнее всего уменьшающая отклонение сил тока от требуемых. Наборы
+* оцениваются без расчета всей цепи: изменение одного элемента пересчитывает только путь до корня
+* (см. PathEvaluator), а вся цепь рассчитывается только после принятой замены. Из найденного
+* локального минимума поиск продолжается со случайно измененной частью элементов. Потоки ищут
+* независимо, с разных начальных наборов, пока не истечет время
+*/
+class ComponentOptimizer
+{
+    public:
+    /*!
+    * \brief Получить значения стандартного ряда в диапазоне
+    * \param[in] series - название ряда: "E3", "E6", "E12" или "E24"
+    * \param[in] min - наименьшее значение
+    * \param[in] max - наибольшее значение
+    * \return - значения по возрастанию
+    */
+    static std::vector<double> seriesValues(std::string const & series, double min, double max);
+
+    /*!
+    * \brief Подобрать номиналы элементов
+    *
+    * Ошибки входных данных сообщаются исключением std::string
+    * \param[in] topology - топология цепи
+    * \param[in] variables - подбираемые элементы
+    * \param[in] targets - требуемые силы тока
+    * \param[in] options - параметры подбора
+    * \return - лучший найденный набор
+    */
+    static OptimizationResult optimize(CircuitTopology const & topology, std::vector<OptimizationVariable> const & variables,
+                                       std::vector<CurrentTarget> const & targets, OptimizationOptions const & options);
+};
+
+#endif // COMPONENTOPTIMIZER_H
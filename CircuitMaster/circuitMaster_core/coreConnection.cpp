@@ -0,0 +1,421 @@
+#include "coreConnection.h"
+#include "allocationStats.h"
+#include "complexKernels.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "perfCounters.h"
+
+/*!
+*\file
+*\brief Реализация конструкторов и функций класса CoreConnection
+*/
+
+namespace {
+
+/*! Действительные и мнимые части слагаемых широкого соединения. Заполняются после расчета детей,
+ *  поэтому один буфер на поток используется всеми уровнями рекурсии и выделяется один раз */
+thread_local std::vector<double> wideRe, wideIm;
+
+}
+
+CoreConnection::CoreConnection()
+{
+
+}
+
+CoreConnection::CoreConnection(allocator_type const & allocator)
+    : name(allocator), elements(allocator), children(allocator)
+{
+
+}
+
+CoreConnection::CoreConnection(CoreConnection const & other, allocator_type const & allocator)
+    : id(other.id), lineNumber(other.lineNumber), isParTag(other.isParTag), name(other.name, allocator), type(other.type), elements(other.elements, allocator),
+      children(other.children, allocator), parent(other.parent), resistance(other.resistance), voltage(other.voltage),
+      current(other.current), hasCustomName(other.hasCustomName), isVoltageSet(other.isVoltageSet), isCurrentSet(other.isCurrentSet)
+{
+
+}
+
+CoreConnection::CoreConnection(ConnectionType startType)
+{
+    this->type = startType;
+}
+
+CoreConnection::CoreConnection(ConnectionType startType, std::string const & startName)
+{
+    this->type = startType;
+    this->name.assign(startName.data(), startName.size());
+    this->hasCustomName = true;
+}
+
+CoreConnection::CoreConnection(ConnectionType startType, CoreElement const & startElem)
+{
+    this->type = startType;
+    this->addElement(startElem);
+}
+
+std::string CoreConnection::getName() const
+{
+    if (this->hasCustomName || this->id == 0)
+        return std::string(this->name.data(), this->name.size());
+
+    // Имя без указания пользователем нужно только для сообщений об ошибках, поэтому не хранится
+    return generatedName(this->isParTag, this->id, this->lineNumber);
+}
+
+std::string CoreConnection::generatedName(bool isParTag, int id, int lineNumber)
+{
+    const char* tag = isParTag ? "par" : "seq";
+    return formatStr("%1_%2 на строке %3", { tag, numberToStr(id), numberToStr(lineNumber) });
+}
+
+int CoreConnection::getId() const
+{
+    return this->id;
+}
+
+int CoreConnection::getLineNumber() const
+{
+    return this->lineNumber;
+}
+
+bool CoreConnection::isParTagged() const
+{
+    return this->isParTag;
+}
+
+bool CoreConnection::isNameCustom() const
+{
+    return this->hasCustomName;
+}
+
+CoreConnection::ConnectionType CoreConnection::getType() const
+{
+    return this->type;
+}
+
+std::pmr::vector<CoreElement> const & CoreConnection::getElements() const
+{
+    return this->elements;
+}
+
+std::pmr::vector<CoreConnection*> const & CoreConnection::getChildren() const
+{
+    return this->children;
+}
+
+std::complex<double> CoreConnection::getResistance() const
+{
+    return this->resistance;
+}
+
+std::complex<double> CoreConnection::getCurrent() const
+{
+    return this->current;
+}
+
+std::complex<double> CoreConnection::getVoltage() const
+{
+    return this->voltage;
+}
+
+void CoreConnection::setVoltage(std::complex<double> newVolt)
+{
+    this->voltage = newVolt;
+    isVoltageSet = true;
+}
+
+void CoreConnection::setCurrent(std::complex<double> newCurr)
+{
+    this->current = newCurr;
+    isCurrentSet = true;
+}
+
+std::complex<double> CoreConnection::calculateResistance()
+{
+    CORE_TRACE_RECURSIVE_SPAN("CoreConnection::calculateResistance");
+    CORE_ALLOCATION_PHASE(evaluate);
+    CORE_PERF_PHASE(calculateResistance);
+
+    // Считаем сопротивление равным нулю
+    this->resistance = 0;
+
+    // Для простого последовательного соединения
+    if (this->type == ConnectionType::sequential)
+    {
+        // Сопротивление цепи равно сумме сопротивлений её элементов
+        if (this->elements.size() < ComplexKernels::wideCount)
+        {
+            for (auto iter = this->elements.cbegin(); iter != this->elements.cend(); iter++)
+                this->resistance += iter->getElemResistance();
+        }
+        // Длинную цепочку элементов складываем векторными командами
+        else
+        {
+            wideRe.resize(this->elements.size());
+            wideIm.resize(this->elements.size());
+            for (size_t i = 0; i < this->elements.size(); i++)
+            {
+                std::complex<double> elemResistance = this->elements[i].getElemResistance();
+                wideRe[i] = elemResistance.real();
+                wideIm[i] = elemResistance.imag();
+            }
+            this->resistance = ComplexKernels::sum(wideRe.data(), wideIm.data(), this->elements.size());
+        }
+    }
+    // Для сложного последовательного соединения
+    else if (this->type == ConnectionType::sequentialComplex)
+    {
+        // Сопротивление цепи равно сумме сопротивлений её соединений-детей
+        for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+            this->resistance += (*iter)->calculateResistance();
+    }
+    // Для параллельного соединения
+    else if (this->type == ConnectionType::parallel)
+    {
+        // Находим сумму обратных значений сопротивления соединений-детей
+        std::complex<double> reverseSum = 0;
+        if (this->children.size() < ComplexKernels::wideCount)
+        {
+            for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+                reverseSum += 1.0 / (*iter)->calculateResistance();
+        }
+        // Для широкого соединения (например, шины из тысяч ветвей) сначала рассчитываем детей,
+        // затем складываем проводимости векторными командами
+        else
+        {
+            for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+                (*iter)->calculateResistance();
+
+            wideRe.resize(this->children.size());
+            wideIm.resize(this->children.size());
+            for (size_t i = 0; i < this->children.size(); i++)
+            {
+                wideRe[i] = this->children[i]->resistance.real();
+                wideIm[i] = this->children[i]->resistance.imag();
+            }
+            reverseSum = ComplexKernels::sumReciprocals(wideRe.data(), wideIm.data(), this->children.size());
+        }
+
+        // Ошибка, если обратное сопротивление меньше 0
+        if (reverseSum.real() == 0 && reverseSum.imag() == 0)
+            throw formatStr("При расчете сопротивления параллельного соединения %1 получено недопустимое значение. "
+                            "Проверьте правильность входных данных.", { this->getName() });
+
+        // Находим сопротивление параллельной цепи
+        this->resistance = 1.0 / reverseSum;
+    }
+
+    // Ошибка, если сопротивление меньше 0
+    if (this->resistance.real() == 0 && this->resistance.imag() == 0)
+        throw formatStr("При расчете сопротивления соединения %1 был получен 0. Проверьте правильность входных данных.", { this->getName() });
+
+    return this->resistance;
+}
+
+void CoreConnection::calculateCurrentAndVoltage()
+{
+    CORE_TRACE_RECURSIVE_SPAN("CoreConnection::calculateCurrentAndVoltage");
+    CORE_ALLOCATION_PHASE(evaluate);
+    CORE_PERF_PHASE(calculateCurrentAndVoltage);
+
+    // Если есть соединение-родитель - "наследуем" значения тока или напряжения
+    if (this->parent != nullptr)
+    {
+        // Наследуем силу тока если родитель - последовательное соединение
+        if (this->parent->type == CoreConnection::ConnectionType::sequentialComplex)
+            this->setCurrent(this->parent->current);
+        // Наследуем напряжение если родитель - параллельное соединение
+        else if (this->parent->type == CoreConnection::ConnectionType::parallel)
+            this->setVoltage(this->parent->voltage);
+    }
+
+    if (!this->isCurrentSet && !this->isVoltageSet)
+        throw formatStr("Недостаточно данных для вычисления силы тока и напряжения в соединении %1.", { this->getName() });
+
+    // Вычисляем оставшуюся неизвестную величину
+    if (!this->isCurrentSet)
+        this->setCurrent(this->voltage / this->resistance);
+    else if (!this->isVoltageSet)
+        this->setVoltage(this->current * this->resistance);
+
+    // Рекурсивно вычисляем силу тока и напряжение всех детей, если они имеются
+    for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+        (*iter)->calculateCurrentAndVoltage();
+}
+
+size_t CoreConnection::normalize(CircuitMap& map)
+{
+    CORE_TRACE_SPAN("CoreConnection::normalize");
+    CORE_ALLOCATION_PHASE(treeBuild);
+
+    std::vector<int> removedIds;
+    this->normalizeSubtree(removedIds);
+
+    for (auto iter = removedIds.cbegin(); iter != removedIds.cend(); iter++)
+        map.erase(*iter);
+    return removedIds.size();
+}
+
+bool CoreConnection::isCollapsible() const
+{
+    return !this->hasCustomName && !this->isVoltageSet;
+}
+
+void CoreConnection::normalizeSubtree(std::vector<int>& removedIds)
+{
+    // Сначала упрощаем детей, чтобы подставлять уже упрощенные поддеревья
+    for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+        (*iter)->normalizeSubtree(removedIds);
+
+    // Заменяем детей того же вида их детьми: сила тока (напряжение) у них общая с текущим соединением
+    bool hasSameKindChild = false;
+    for (auto iter = this->children.cbegin(); iter != this->children.cend(); iter++)
+        hasSameKindChild = hasSameKindChild || ((*iter)->type == this->type && (*iter)->isCollapsible());
+
+    if (hasSameKindChild)
+    {
+        std::pmr::vector<CoreConnection*> flatChildren(this->children.get_allocator());
+        for (auto iter = this->children.cbegin(); iter != this->children.cend(); iter++)
+        {
+            CoreConnection* child = *iter;
+            if (child->type != this->type || !child->isCollapsible())
+            {
+                flatChildren.push_back(child);
+                continue;
+            }
+
+            for (auto grandchild = child->children.cbegin(); grandchild != child->children.cend(); grandchild++)
+            {
+                (*grandchild)->parent = this;
+                flatChildren.push_back(*grandchild);
+            }
+            removedIds.push_back(child->id);
+        }
+        this->children.swap(flatChildren);
+    }
+
+    // Соединение с единственным ребёнком равно этому ребёнку
+    while (this->children.size() == 1 && this->children[0]->isCollapsible())
+    {
+        CoreConnection* child = this->children[0];
+        this->type = child->type;
+        this->elements.swap(child->elements);
+        this->children.swap(child->children);
+        for (auto iter = this->children.begin(); iter != this->children.end(); iter++)
+            (*iter)->parent = this;
+        removedIds.push_back(child->id);
+    }
+}
+
+void CoreConnection::addElement(CoreElement const & newElem)
+{
+    this->elements.push_back(newElem);
+}
+
+void CoreConnection::addChild(CoreConnection* newChildConnectionPtr)
+{
+    this->children.push_back(newChildConnectionPtr);
+    newChildConnectionPtr->parent = this;
+}
+
+CoreConnection::ConnectionType CoreConnection::strToConnectionType(std::string const & strType)
+{
+    CoreConnection::ConnectionType type;
+    if (strType == "seq")
+        type = CoreConnection::ConnectionType::sequential;
+    else if (strType == "par")
+        type = CoreConnection::ConnectionType::parallel;
+    else
+        type = CoreConnection::ConnectionType::invalid;
+    return type;
+}
+
+double CoreConnection::voltageFromDocElement(DocumentNode const & node)
+{
+    double voltageAtr = strToDouble(node.attribute("voltage", "-1"));
+
+    // Ошибка, если значение меньше нуля
+    if (voltageAtr != -1 && voltageAtr <= 0)
+        throw formatStr("Недопустимое значение напряжения у соединения на строке %1. Значение напряжения должно "
+                        "быть больше 0.", { numberToStr(node.lineNumber) });
+
+    return voltageAtr;
+}
+
+CoreConnection* CoreConnection::connectionFromDocElement(CircuitMap& map, DocumentNode const & node, double frequency,
+                                                         bool reserveChildren)
+{
+    CORE_TRACE_RECURSIVE_SPAN("CoreConnection::connectionFromDocElement");
+
+    // Основные переменные
+    std::string const & nodeType = node.tagName;
+    std::vector<DocumentNode> const & children = node.children;
+
+    //Обработка ошибок
+    if (nodeType == "elem")
+        throw formatStr("Неверное расположение элемента цепи на строке %1. Элементы могут "
+                        "располагаться только внутри простых последовательных соединений.", { numberToStr(node.lineNumber) });
+
+    if (nodeType != "seq" && nodeType != "par")
+        throw formatStr("Неизвестный тэг на строке %1.", { numberToStr(node.lineNumber) });
+
+    // Присваиваем идентификатор и создаём новый объект соединения сразу в контейнере
+    int newId = static_cast<int>(map.size()) + 1;
+    CoreConnection* newConnectionPtr = &map[newId];
+    newConnectionPtr->id = newId;
+    newConnectionPtr->lineNumber = node.lineNumber;
+    newConnectionPtr->isParTag = nodeType == "par";
+
+    // Сохраняем название соединения, если оно указано пользователем. Иначе имя формируется в getName при необходимости
+    std::string const * newName = node.findAttribute("name");
+    newConnectionPtr->hasCustomName = newName != nullptr && !newName->empty();
+    if (newConnectionPtr->hasCustomName)
+        newConnectionPtr->name.assign(newName->data(), newName->size());
+
+    // Получаем значение напряжения, если указано
+    double voltageAtr = voltageFromDocElement(node);
+    if (voltageAtr != -1)
+        newConnectionPtr->setVoltage(voltageAtr);
+
+    // Определить тип соединения
+    CoreConnection::ConnectionType circuitType = CoreConnection::strToConnectionType(nodeType);
+    bool hasSeqInside = node.firstChildElement("seq") != nullptr;
+    bool hasParInside = node.firstChildElement("par") != nullptr;
+    if (circuitType == CoreConnection::ConnectionType::sequential && (hasSeqInside || hasParInside))
+        circuitType = CoreConnection::ConnectionType::sequentialComplex;
+
+    newConnectionPtr->type = circuitType;
+
+    // Для сложного последовательного соединения
+    if (circuitType == CoreConnection::ConnectionType::sequentialComplex || circuitType == CoreConnection::ConnectionType::parallel)
+    {
+        // Ошибка, если нет соединений-детей
+        if (children.empty())
+            throw formatStr("Пустое соединение на строке %1.", { numberToStr(node.lineNumber) });
+
+        // Список детей выделяется до их создания: в арене соединения и их списки располагаются в порядке
+        // обхода в глубину, и поддерево каждого соединения занимает непрерывный участок памяти
+        if (reserveChildren)
+            newConnectionPtr->children.reserve(children.size());
+
+        // Рекурсивно обрабатываем каждого ребёнка текущей цепи
+        for (auto iter = children.cbegin(); iter != children.cend(); iter++)
+            newConnectionPtr->addChild(connectionFromDocElement(map, *iter, frequency, reserveChildren));
+    }
+    // Для простого последовательного соединения
+    else if (circuitType == CoreConnection::ConnectionType::sequential)
+    {
+        // Ошибка, если нет элементов
+        if (children.empty())
+            throw formatStr("Отсутсвуют элементы соединения на строке %1.", { numberToStr(node.lineNumber) });
+
+        // Добавляем все элементы в соединение
+        newConnectionPtr->elements.reserve(children.size());
+        for (auto iter = children.cbegin(); iter != children.cend(); iter++)
+            newConnectionPtr->addElement(CoreElement(*iter, frequency));
+    }
+
+    return newConnectionPtr;
+}
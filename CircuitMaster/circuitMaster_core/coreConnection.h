@@ -0,0 +1,274 @@
+#ifndef CORECONNECTION_H
+#define CORECONNECTION_H
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "coreElement.h"
+#include "documentNode.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса CoreConnection
+*/
+
+class CoreConnection;
+
+/*!
+* Контейнер соединений цепи по id. Соединения и их данные размещаются в источнике памяти,
+* переданном в конструктор контейнера (см. CircuitArena), по умолчанию - в общей памяти
+*/
+using CircuitMap = std::pmr::map<int, CoreConnection>;
+
+/*!
+*\class CoreConnection
+*\brief Соединение цепи переменного тока, не зависящее от Qt
+*
+* Аналог класса CircuitConnection для сборки без Qt. Соединение цепи имеет название, тип,
+* напряжение, силу тока и сопротивление. Оно также может содержать элементы класса CoreElement,
+* указатели на вложенные соединения и указатель на соединения-родителя. Ошибки сообщаются
+* исключением std::string
+*
+* Имя, элементы и список детей хранятся в памяти, из которой выделен сам объект: при создании
+* в CircuitMap, связанном с CircuitArena, всё дерево соединений находится в арене
+*/
+class CoreConnection
+{
+    public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>; /*!< Источник памяти для имени, элементов и детей */
+
+    enum class ConnectionType
+    {
+        invalid, /*!< Неверный тип соединения */
+        parallel, /*!< Параллельное соединение */
+        sequential, /*!< Последовательное соединение */
+        sequentialComplex /*!< Последовательное соединение со вложенными соединениями */
+    };
+
+    /*!
+    * \brief Конструктор по умолчанию
+    */
+    CoreConnection();
+
+    /*!
+    * \brief Конструктор пустого соединения в заданной памяти
+    * \param[in] allocator - источник памяти для имени, элементов и детей
+    */
+    explicit CoreConnection(allocator_type const & allocator);
+
+    /*!
+    * \brief Конструктор копии в заданной памяти
+    * \param[in] other - копируемое соединение
+    * \param[in] allocator - источник памяти для имени, элементов и детей
+    */
+    CoreConnection(CoreConnection const & other, allocator_type const & allocator);
+
+    CoreConnection(CoreConnection const &) = default;
+    CoreConnection& operator=(CoreConnection const &) = default;
+
+    /*!
+    * \brief Конструктор соединения определенного типа
+    * \param[in] startType - тип соединения
+    */
+    CoreConnection(ConnectionType startType);
+
+    /*!
+    * \brief Конструктор соединения определенного типа и имени
+    * \param[in] startType - тип соединения
+    * \param[in] startName - название соединения
+    */
+    CoreConnection(ConnectionType startType, std::string const & startName);
+
+    /*!
+    * \brief Конструктор соединения определенного типа с элементом
+    * \param[in] startType - тип соединения
+    * \param[in] startElem - элемент соединения
+    */
+    CoreConnection(ConnectionType startType, CoreElement const & startElem);
+
+    private:
+    int id = 0; /*!< id соединения */
+    int lineNumber = -1; /*!< Номер строки тэга соединения во входном файле */
+    bool isParTag = false; /*!< Задано ли соединение тэгом <par>. Тип соединения может измениться при нормализации дерева */
+    std::pmr::string name; /*!< Название соединения, заданное пользователем. Для остальных соединений имя формируется в getName */
+    ConnectionType type = ConnectionType::invalid; /*!< Тип соединения */
+    std::pmr::vector<CoreElement> elements; /*!< Элементы соединения */
+    std::pmr::vector<CoreConnection*> children; /*!< Указатели на соединения-детей */
+    CoreConnection* parent = nullptr; /*!< Указатель на соединение-родителя */
+    std::complex<double> resistance; /*!< Комплексное сопротивление соединения */
+    std::complex<double> voltage; /*!< Комплексное напряжение соединения */
+    std::complex<double> current; /*!< Комплексная сила тока соединения */
+    bool hasCustomName = false; /*!< Указано ли имя пользователем */
+    bool isVoltageSet = false; /*!< Известно ли напряжение */
+    bool isCurrentSet = false; /*!< Известна ли сила тока */
+    public:
+
+    /*!
+    * \brief Получить имя соединения цепи. Если имя не задано пользователем, оно формируется
+    * по типу, id и номеру строки соединения, например "seq_2 на строке 5"
+    * \return - имя соединения цепи
+    */
+    std::string getName() const;
+
+    /*!
+    * \brief Сформировать имя соединения, не заданное пользователем, например "seq_2 на строке 5"
+    * \param[in] isParTag - задано ли соединение тэгом <par>
+    * \param[in] id - id соединения
+    * \param[in] lineNumber - номер строки тэга соединения во входном файле
+    * \return - имя соединения
+    */
+    static std::string generatedName(bool isParTag, int id, int lineNumber);
+
+    /*!
+    * \brief Получить id соединения
+    * \return - id соединения, 0 у корня
+    */
+    int getId() const;
+
+    /*!
+    * \brief Получить номер строки тэга соединения во входном файле
+    * \return - номер строки, -1 если неизвестен
+    */
+    int getLineNumber() const;
+
+    /*!
+    * \brief Узнать, задано ли соединение тэгом <par>
+    * \return - true для тэга <par>, даже если тип соединения изменился при нормализации дерева
+    */
+    bool isParTagged() const;
+
+    /*!
+    * \brief Узнать, задано ли имя пользователем
+    * \return - true, если имя задано пользователем
+    */
+    bool isNameCustom() const;
+
+    /*!
+    * \brief Получить тип соединения
+    * \return - тип соединения
+    */
+    ConnectionType getType() const;
+
+    /*!
+    * \brief Получить элементы соединения
+    * \return - элементы соединения
+    */
+    std::pmr::vector<CoreElement> const & getElements() const;
+
+    /*!
+    * \brief Получить указатели на соединения-детей
+    * \return - указатели на соединения-детей
+    */
+    std::pmr::vector<CoreConnection*> const & getChildren() const;
+
+    /*!
+    * \brief Получить рассчитанное комплексное сопротивление соединения
+    * \return - комплексное сопротивление соединения
+    */
+    std::complex<double> getResistance() const;
+
+    /*!
+    * \brief Получить комплексную силу тока соединения цепи
+    * \return - комплексная сила тока соединения цепи
+    */
+    std::complex<double> getCurrent() const;
+
+    /*!
+    * \brief Получить комплексное напряжение соединения цепи
+    * \return - комплексное напряжение соединения цепи
+    */
+    std::complex<double> getVoltage() const;
+
+    /*!
+    * \brief Установить значение напряжения соединения
+    * \param[in] newVolt - новое значение напряжения
+    */
+    void setVoltage(std::complex<double> newVolt);
+
+    /*!
+    * \brief Установить значение силы тока соединения
+    * \param[in] newCurr - новое значение силы тока
+    */
+    void setCurrent(std::complex<double> newCurr);
+
+    /*!
+    * \brief Рассчитывает сопротивление соединения цепи в виде комплексного числа
+    * \return - полученное сопротивление
+    */
+    std::complex<double> calculateResistance();
+
+    /*!
+    * \brief Рассчитывает силу тока и напряжение в виде комплексного числа для соединеия и всех его вложенных соединений
+    * \return - результаты записываются в объекты класса
+    */
+    void calculateCurrentAndVoltage();
+
+    /*!
+    * \brief Упростить дерево соединений без изменения результата расчета
+    *
+    * Соединения без имени, заданного пользователем, и без напряжения убираются из дерева:
+    * - последовательное соединение внутри последовательного и параллельное внутри параллельного
+    *   заменяются своими детьми;
+    * - единственный ребёнок соединения передаёт ему свой тип, элементы и детей.
+    *
+    * Соединения с именами остаются в дереве, поэтому их силы тока выводятся как обычно. Ошибки
+    * расчета, которые возникли бы в убранных соединениях (нулевое сопротивление), не проверяются
+    * отдельно для них. Убранные соединения удаляются из контейнера
+    * \param[in,out] map - контейнер, в котором создано дерево
+    * \return - количество убранных соединений
+    */
+    size_t normalize(CircuitMap& map);
+
+    /*!
+    * \brief Добавить элемент в соединение
+    * \param[in] newElem - новый элемент
+    */
+    void addElement(CoreElement const & newElem);
+
+    /*!
+    * \brief Добавить соединение-ребенка
+    * \param[in] newChildConnectionPtr - указатель на соединение-ребенка
+    */
+    void addChild(CoreConnection* newChildConnectionPtr);
+
+    /*!
+    * \brief Получить тип соединение на основе его текстового представления
+    * \param[in] strType - строка, содержащая название типа
+    * \return - тип соединения
+    */
+    static ConnectionType strToConnectionType(std::string const & strType);
+
+    /*!
+    * \brief Получить напряжение, указанное у соединения в узле документа
+    * \param[in] node - узел документа соединения
+    * \return - значение напряжения или -1, если напряжение не указано
+    */
+    static double voltageFromDocElement(DocumentNode const & node);
+
+    /*!
+    * \brief Получить объекты класса из корневого узла документа и записать в контейнер
+    * \param[in,out] map - контейнер для записи соединений
+    * \param[in] node - узел документа, по которому создается запись
+    * \param[in] frequency - частота перемнного тока, если неизвестна передать значение -1
+    * \param[in] reserveChildren - выделять ли список детей до их создания (поддеревья подряд в порядке обхода
+    * в глубину). false - список растет по мере добавления детей, используется для сравнения размещений в замерах
+    * \return - указатель на созданный в map объект класса
+    */
+    static CoreConnection* connectionFromDocElement(CircuitMap& map, DocumentNode const & node, double frequency,
+                                                    bool reserveChildren = true);
+
+    private:
+    /*!
+    * \brief Узнать, можно ли убрать соединение из дерева при нормализации
+    * \return - true, если у соединения нет имени, заданного пользователем, и напряжения
+    */
+    bool isCollapsible() const;
+
+    /*!
+    * \brief Нормализовать соединение и всех его потомков
+    * \param[in,out] removedIds - id убранных соединений
+    */
+    void normalizeSubtree(std::vector<int>& removedIds);
+};
+
+#endif // CORECONNECTION_H
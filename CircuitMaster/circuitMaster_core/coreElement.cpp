@@ -0,0 +1,189 @@
+#include "coreElement.h"
+#include "coreStrings.h"
+
+/*!
+*\file
+*\brief Реализация конструкторов и функций класса CoreElement
+*/
+
+CoreElement::CoreElement(ElemType startType, std::complex<double> startValue)
+{
+    this->type = startType;
+    this->resistance = startValue;
+}
+
+CoreElement::CoreElement(DocumentNode const & node, double frequency)
+{
+    // Инициализация основных переменных
+    bool isFrequencyKnown = frequency != -1;
+    DocumentNode const * typeElem = node.firstChildElement("type");
+    DocumentNode const * resistanceElem = node.firstChildElement("res");
+    DocumentNode const * inductivityElem = node.firstChildElement("ind");
+    DocumentNode const * capacityElem = node.firstChildElement("cap");
+
+    // Определение типа элемента
+    this->type = elemTypeFromStr(typeElem != nullptr ? typeElem->textContent() : "");
+
+    // Обработка ошибок ввода
+    std::string lineNumStr = numberToStr(node.lineNumber);
+
+    // Ошибка, если полученный тэг не является тэгом элемента
+    std::string const & elemTag = node.tagName;
+    if (elemTag != "elem")
+        throw formatStr("На строке %1 ожидался тэг элемента \"<elem>\", а был получен тэг \"<%2>\".", { lineNumStr, elemTag });
+
+    // Ошибки указания данных
+    switch (this->type){
+    // Неверный тип элемента
+    case CoreElement::ElemType::invalid:
+        throw formatStr("Неверный тип элемента на строке %1. Допустимые типы: \"R\", \"L\", \"C\".", { lineNumStr });
+        break;
+
+    // Для резистора
+    case CoreElement::ElemType::R:
+        if (inductivityElem != nullptr)
+            throw formatStr("Для резистора на строке %1 недопустимо указание индуктивности \"<ind>\". "
+                            "Допускается только указание сопротивления \"<res>\".", { lineNumStr });
+        if (capacityElem != nullptr)
+            throw formatStr("Для резистора на строке %1 недопустимо указание емкости \"<cap>\". "
+                            "Допускается только указание сопротивления \"<res>\".", { lineNumStr });
+        if (resistanceElem == nullptr)
+            throw formatStr("Для резистора на строке %1 не указаны данные о сопротивлении. "
+                            "Необходимо указание сопротивления \"<res>\".", { lineNumStr });
+        break;
+
+    // Для катушки
+    case CoreElement::ElemType::L:
+        if (capacityElem != nullptr)
+            throw formatStr("Для катушки индуктивности на строке %1 недопустимо указание емкости \"<cap>\". "
+                            "Допускается указание сопротивления \"<res>\" или индуктивности \"<ind>\".", { lineNumStr });
+        if (inductivityElem != nullptr && resistanceElem != nullptr)
+            throw formatStr("Для катушки индуктивности на строке %1 указано и сопротивление \"<res>\", и индуктивность \"<ind>\". "
+                            "Допускается указание только одного из них.", { lineNumStr });
+        if (inductivityElem == nullptr && resistanceElem == nullptr)
+            throw formatStr("Для катушки индуктивности на строке %1 не указаны данные о сопротивлении. "
+                            "Необходимо указание сопротивления \"<res>\" или индуктивности \"<ind>\".", { lineNumStr });
+        if (!isFrequencyKnown && inductivityElem != nullptr)
+            throw formatStr("Для катушки индуктивности на строке %1 указана индуктивность \"<ind>\", однако "
+                            "неизвестна частота переменного тока. Укажите сопротивления элемента \"<res>\" или "
+                            "частоту \"frequency\" как атрибут корневого элемента цепи.", { lineNumStr });
+        break;
+
+    // Для конденсатора
+    case CoreElement::ElemType::C:
+        if (inductivityElem != nullptr)
+            throw formatStr("Для конденсатора на строке %1 недопустимо указание индуктивности \"<ind>\". "
+                            "Допускается указание сопротивления \"<res>\" или емкости \"<cap>\".", { lineNumStr });
+        if (capacityElem != nullptr && resistanceElem != nullptr)
+            throw formatStr("Для конденсатора индуктивности на строке %1 указано и сопротивление \"<res>\", и индуктивность \"<ind>\". "
+                            "Допускается указание только одного из них.", { lineNumStr });
+        if (capacityElem == nullptr && resistanceElem == nullptr)
+            throw formatStr("Для конденсатора на строке %1 не указаны данные о сопротивлении. Необходимо указание "
+                            "сопротивления \"<res>\" или емкости \"<cap>\".", { lineNumStr });
+        if (!isFrequencyKnown && capacityElem != nullptr)
+            throw formatStr("Для конденсатора на строке %1 указана емкость \"<cap>\", однако неизвестна частота "
+                            "переменного тока. Укажите сопротивления элемента \"<res>\" или частоту \"frequency\" "
+                            "как атрибут корневого элемента цепи.", { lineNumStr });
+        break;
+    }
+
+    // Проверка на наличие лишних тэгов
+    size_t expectedChildCount = (typeElem != nullptr) + (resistanceElem != nullptr) + (inductivityElem != nullptr) + (capacityElem != nullptr);
+    if (node.children.size() != expectedChildCount)
+        throw formatStr("Количество тэгов элемента на строке %1 не соответсвует ожидаемому. "
+                        "Возможно использованы неизвестные тэги или какой-то из тэгов написан несколько раз.", { lineNumStr });
+
+    // Получение значений и обработка ошибок конвертации
+    double inductivity = 0, capacity = 0, resistance = 0;
+    // Для индуктивности
+    if (inductivityElem != nullptr)
+    {
+        bool indCorrectValue;
+        inductivity = strToDouble(inductivityElem->textContent(), &indCorrectValue);
+        std::string indLineStr = numberToStr(inductivityElem->lineNumber);
+        if (!indCorrectValue)
+            throw formatStr("Неверный формат значения индуктивности на строке %1.", { indLineStr });
+        if (inductivity <= 0)
+            throw formatStr("Недопустимое значение индуктивности на строке %1. Значение индуктивности должно быть больше 0.", { indLineStr });
+    }
+    // Для емкости
+    else if (capacityElem != nullptr)
+    {
+        bool capCorrectValue;
+        capacity = strToDouble(capacityElem->textContent(), &capCorrectValue);
+        std::string capLineStr = numberToStr(capacityElem->lineNumber);
+        if (!capCorrectValue)
+            throw formatStr("Неверный формат значения емкости на строке %1.", { capLineStr });
+        if (capacity <= 0)
+            throw formatStr("Недопустимое значение емкости на строке %1. Значение емкости должно быть больше 0.", { capLineStr });
+    }
+    // Для сопротивления
+    else if (resistanceElem != nullptr)
+    {
+        bool resCorrectValue;
+        resistance = strToDouble(resistanceElem->textContent(), &resCorrectValue);
+        std::string resLineStr = numberToStr(resistanceElem->lineNumber);
+        if (!resCorrectValue)
+            throw formatStr("Неверный формат значения сопротивления на строке %1.", { resLineStr });
+        if (resistance <= 0)
+            throw formatStr("Недопустимое значение сопротивления на строке %1. Значение сопротивления должно быть больше 0.", { resLineStr });
+    }
+
+    // Рассчёт активного сопротивления
+    // Тип float и значение 3.14 сохранены для совпадения результатов со сборкой на Qt
+    float activeResistance = 0;
+    if (resistanceElem != nullptr)
+    {
+        activeResistance = resistance;
+    }
+    else
+    {
+        switch (this->type){
+        case CoreElement::ElemType::L:
+            activeResistance = 2 * 3.14 * frequency * inductivity;
+            break;
+        case CoreElement::ElemType::C:
+            activeResistance = 1 / (2 * 3.14 * frequency * capacity);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Преобразование в комплексное сопротивление, в зависимости от типа элемента
+    switch (this->type) {
+    case ElemType::R:
+        this->resistance = {activeResistance, 0};
+        break;
+    case ElemType::L:
+        this->resistance = {0, activeResistance};
+        break;
+    case ElemType::C:
+        this->resistance = {0, -activeResistance};
+        break;
+    default:
+        break;
+    }
+}
+
+std::complex<double> CoreElement::getElemResistance() const
+{
+    return this->resistance;
+}
+
+CoreElement::ElemType CoreElement::getType() const
+{
+    return this->type;
+}
+
+CoreElement::ElemType CoreElement::elemTypeFromStr(std::string const & typeStr)
+{
+    if (typeStr == "R")
+        return ElemType::R;
+    else if (typeStr == "L")
+        return ElemType::L;
+    else if (typeStr == "C")
+        return ElemType::C;
+    else
+        return ElemType::invalid;
+}
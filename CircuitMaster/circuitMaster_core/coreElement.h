@@ -0,0 +1,69 @@
+#ifndef COREELEMENT_H
+#define COREELEMENT_H
+#include <complex>
+#include <string>
+#include "documentNode.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса CoreElement
+*/
+
+/*!
+*\class CoreElement
+*\brief Элемент цепи переменного тока, не зависящий от Qt
+*
+* Аналог класса CircuitElement для сборки без Qt. Элемент цепи имеет тип и сопротивление.
+* Ошибки входных данных сообщаются исключением std::string
+*/
+class CoreElement
+{
+    public:
+    enum class ElemType
+    {
+        invalid, /*!< Неверный тип элемента */
+        R, /*!< Резистор */
+        L, /*!< Катушка индуктивности */
+        C /*!< Конденсатор */
+    };
+
+    /*!
+    * \brief Конструктор элемента определенного типа с известным сопротивлением
+    * \param[in] startType - тип элемента
+    * \param[in] startValue - сопротивление элемента
+    */
+    CoreElement(ElemType startType, std::complex<double> startValue);
+
+    /*!
+    * \brief Конструктор элемента на основе узла документа
+    * \param[in] node - узел документа тэга \c <elem>
+    * \param[in] frequency - частота переменного тока, если указана индуктивность или емкость. Если частота неизвестна, передавать -1
+    */
+    CoreElement(DocumentNode const & node, double frequency);
+
+    private:
+    std::complex<double> resistance; /*!< Комплексное сопротивление элемента */
+    ElemType type; /*!< Тип элемента */
+
+    public:
+    /*!
+    * \brief Получить комплексное сопротивление элемента
+    * \return - комплексное сопротивление элемента
+    */
+    std::complex<double> getElemResistance() const;
+
+    /*!
+    * \brief Получить тип элемента
+    * \return - тип элемента
+    */
+    ElemType getType() const;
+
+    /*!
+    * \brief Получить тип элемента на основе его текстового представления
+    * \param[in] typeStr - строка, содержащая название типа
+    * \return - тип элемента
+    */
+    static ElemType elemTypeFromStr(std::string const & typeStr);
+};
+
+#endif // COREELEMENT_H
@@ -0,0 +1,614 @@
+#include "coreIo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "allocationStats.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций для работы с файлами без использования Qt
+*/
+
+std::string complexToString(std::complex<double> num)
+{
+    // Основные переменные
+    std::string str;
+    double real = num.real();
+    double imag = num.imag();
+
+    // Если нет мнимой части
+    if (imag == 0)
+        str = numberToStr(real);
+    // Если есть мнимая часть
+    else
+    {
+        // Знак между дейтвительной и мнимой частью
+        std::string sign = imag > 0 ? "+" : "-";
+
+        str = formatStr("%1 %2 %3i", { numberToStr(real), sign, numberToStr(std::abs(imag)) });
+    }
+    return str;
+}
+
+double frequencyFromDocument(DocumentNode const & rootElement)
+{
+    std::string frequencyStr = rootElement.attribute("frequency", "");
+    // Значение -1 означает, что частота неизвестна
+    double frequency = -1;
+    if (frequencyStr.length() > 0)
+    {
+        // Пытаемся конвертировать в double
+        bool convertedOk;
+        frequency = strToDouble(frequencyStr, &convertedOk);
+
+        // Ошибка, если не удалось конверертировать
+        if (!convertedOk)
+            throw std::string("Неверный формат значения частоты у корневого элемента.");
+
+        // Ошибка, если значение меньше нуля
+        if (frequency <= 0)
+            throw std::string("Недопустимое значение частоты у корневого элемента. Значение частоты должно быть больше 0.");
+    }
+    return frequency;
+}
+
+std::vector<Harmonic> harmonicsFromDocument(DocumentNode const & rootElement)
+{
+    // Первая гармоника - напряжение корневого элемента
+    std::vector<Harmonic> harmonics;
+    bool convertedOk;
+    double voltage = strToDouble(rootElement.attribute("voltage", ""), &convertedOk);
+    if (!convertedOk)
+        throw std::string("У корневого элемента должно быть указано напряжение.");
+    harmonics.push_back({ 1, voltage });
+
+    // Гармоники разделены точкой с запятой, значения гармоники - двоеточием
+    std::string list = rootElement.attribute("harmonics", "");
+    size_t start = 0;
+    while (start < list.size())
+    {
+        size_t end = std::min(list.find(';', start), list.size());
+        std::string item = list.substr(start, end - start);
+        start = end + 1;
+        if (item.find_first_not_of(' ') == std::string::npos)
+            continue;
+
+        std::vector<double> values;
+        size_t valueStart = 0;
+        while (valueStart <= item.size())
+        {
+            size_t valueEnd = std::min(item.find(':', valueStart), item.size());
+            double value = strToDouble(item.substr(valueStart, valueEnd - valueStart), &convertedOk);
+            if (!convertedOk)
+                throw formatStr("Неверный формат гармоники \"%1\" у корневого элемента. Гармоника указывается "
+                                "в виде \"номер:напряжение:фаза\".", { item });
+            values.push_back(value);
+            valueStart = valueEnd + 1;
+        }
+
+        if (values.size() < 2 || values.size() > 3)
+            throw formatStr("Неверный формат гармоники \"%1\" у корневого элемента. Гармоника указывается "
+                            "в виде \"номер:напряжение:фаза\".", { item });
+        if (values[0] <= 0 || values[1] <= 0)
+            throw formatStr("Недопустимое значение гармоники \"%1\" у корневого элемента. Номер и напряжение гармоники "
+                            "должны быть больше 0.", { item });
+        for (auto iter = harmonics.cbegin(); iter != harmonics.cend(); iter++)
+        {
+            if (iter->order == values[0])
+                throw formatStr("Повтор гармоники %1 у корневого элемента. Первая гармоника задается напряжением "
+                                "\"voltage\".", { numberToStr(values[0]) });
+        }
+
+        double phase = values.size() == 3 ? values[2] * std::acos(-1.0) / 180 : 0;
+        harmonics.push_back({ values[0], std::polar(values[1], phase) });
+    }
+    return harmonics;
+}
+
+/*!
+* \brief Получить положительное значение атрибута узла документа
+* \param[in] node - узел документа
+* \param[in] name - название атрибута
+* \param[in] defaultValue - значение, если атрибут не указан
+* \return - значение атрибута
+*/
+static double positiveAttribute(DocumentNode const & node, std::string const & name, double defaultValue)
+{
+    std::string const * valueStr = node.findAttribute(name);
+    if (valueStr == nullptr)
+        return defaultValue;
+
+    bool convertedOk;
+    double value = strToDouble(*valueStr, &convertedOk);
+    if (!convertedOk)
+        throw formatStr("Неверный формат значения атрибута \"%1\" на строке %2.", { name, numberToStr(node.lineNumber) });
+    if (value <= 0)
+        throw formatStr("Недопустимое значение атрибута \"%1\" на строке %2. Значение должно быть больше 0.",
+                        { name, numberToStr(node.lineNumber) });
+    return value;
+}
+
+/*!
+* \brief Получить соединения документа в порядке нумерации соединений топологии
+* \param[in] rootElement - корневой узел документа
+* \return - узлы соединений документа
+*/
+static std::vector<DocumentNode const *> documentConnections(DocumentNode const & rootElement)
+{
+    // Соединения документа нумеруются в том же порядке обхода в глубину, что и в топологии
+    std::vector<DocumentNode const *> connections;
+    std::vector<DocumentNode const *> stack = { &rootElement };
+    while (!stack.empty())
+    {
+        DocumentNode const & connection = *stack.back();
+        stack.pop_back();
+        connections.push_back(&connection);
+        for (auto iter = connection.children.crbegin(); iter != connection.children.crend(); iter++)
+        {
+            if (iter->isElement() && iter->tagName != "elem")
+                stack.push_back(&(*iter));
+        }
+    }
+    return connections;
+}
+
+/*!
+* \brief Получить значение элемента во входных данных: сопротивление, индуктивность или емкость
+* \param[in] elem - узел элемента документа
+* \param[in] type - тип элемента
+* \return - значение элемента
+*/
+static double elementValue(DocumentNode const & elem, CoreElement::ElemType type)
+{
+    DocumentNode const * valueElem = elem.firstChildElement("res");
+    if (valueElem == nullptr)
+        valueElem = elem.firstChildElement(type == CoreElement::ElemType::L ? "ind" : "cap");
+    return strToDouble(valueElem->textContent());
+}
+
+/*!
+* \brief Получить требуемую силу тока соединения, если она указана атрибутом "target"
+* \param[in] connection - узел соединения документа
+* \param[in] topology - топология цепи
+* \param[in] node - номер соединения в топологии
+* \param[out] targets - требуемые силы тока, к которым добавляется найденная
+*/
+static void readTarget(DocumentNode const & connection, CircuitTopology const & topology, int node, std::vector<CurrentTarget>& targets)
+{
+    if (connection.findAttribute("target") == nullptr)
+        return;
+    if (!topology.nodes[node].hasCustomName)
+        throw formatStr("Требуемая сила тока на строке %1 указана для соединения без имени.", { numberToStr(connection.lineNumber) });
+    targets.push_back({ node, positiveAttribute(connection, "target", 0) });
+}
+
+void optimizationFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology,
+                              std::vector<OptimizationVariable>& variables, std::vector<CurrentTarget>& targets)
+{
+    std::vector<DocumentNode const *> connections = documentConnections(rootElement);
+    size_t elementIndex = 0;
+    for (size_t n = 0; n < connections.size(); n++)
+    {
+        DocumentNode const & connection = *connections[n];
+        int node = static_cast<int>(n);
+        readTarget(connection, topology, node, targets);
+
+        int position = 0;
+        for (auto iter = connection.children.cbegin(); iter != connection.children.cend(); iter++)
+        {
+            if (!iter->isElement() || iter->tagName != "elem")
+                continue;
+            position++;
+            size_t element = elementIndex++;
+            std::string const * series = iter->findAttribute("series");
+            if (series == nullptr)
+                continue;
+
+            double nominal = elementValue(*iter, topology.elementTypes[element]);
+            OptimizationVariable variable;
+            variable.element = element;
+            variable.node = node;
+            variable.position = position;
+            variable.nominal = nominal;
+            variable.values = ComponentOptimizer::seriesValues(*series, positiveAttribute(*iter, "min", nominal / 10),
+                                                               positiveAttribute(*iter, "max", nominal * 10));
+            variables.push_back(variable);
+        }
+    }
+}
+
+CurrentTarget goalSeekTargetFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology)
+{
+    std::vector<DocumentNode const *> connections = documentConnections(rootElement);
+    std::vector<CurrentTarget> targets;
+    for (size_t n = 0; n < connections.size(); n++)
+        readTarget(*connections[n], topology, static_cast<int>(n), targets);
+    if (targets.size() != 1)
+        throw formatStr("Для подбора значения должна быть указана ровно одна требуемая сила тока атрибутом \"target\" "
+                        "именованного соединения, указано: %1.", { numberToStr(static_cast<int>(targets.size())) });
+    return targets.front();
+}
+
+OptimizationVariable goalSeekElementFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology,
+                                                 std::string const & reference)
+{
+    size_t separator = reference.rfind(':');
+    int node = separator == std::string::npos ? -1 : topology.findNode(reference.substr(0, separator));
+    if (node < 0)
+        throw formatStr("Не найдено соединение для подбора значения \"%1\". Укажите элемент в виде \"имя соединения:номер элемента\".",
+                        { reference });
+
+    // Номер элемента в соединении начинается с 1
+    bool convertedOk;
+    double position = strToDouble(reference.substr(separator + 1), &convertedOk);
+    CircuitTopology::Node const & topologyNode = topology.nodes[node];
+    if (!convertedOk || position != std::floor(position) || position < 1 || position > topologyNode.elementCount)
+        throw formatStr("В соединении %1 нет элемента с номером \"%2\".", { topologyNode.displayName(), reference.substr(separator + 1) });
+
+    OptimizationVariable variable;
+    variable.node = node;
+    variable.position = static_cast<int>(position);
+    variable.element = static_cast<size_t>(topologyNode.firstElement + variable.position - 1);
+
+    DocumentNode const & connection = *documentConnections(rootElement)[node];
+    int elementPosition = 0;
+    for (auto iter = connection.children.cbegin(); iter != connection.children.cend(); iter++)
+    {
+        if (iter->isElement() && iter->tagName == "elem" && ++elementPosition == variable.position)
+            variable.nominal = elementValue(*iter, topology.elementTypes[variable.element]);
+    }
+    return variable;
+}
+
+/*!
+* \brief Получить относительный допуск из атрибута "tolerance" узла документа
+* \param[in] node - узел документа
+* \param[in] defaultValue - значение, если атрибут не указан
+* \return - допуск в долях
+*/
+static double toleranceAttribute(DocumentNode const & node, double defaultValue)
+{
+    std::string const * valueStr = node.findAttribute("tolerance");
+    if (valueStr == nullptr)
+        return defaultValue;
+
+    // Значение в процентах указывается со знаком % в конце
+    bool isPercent = !valueStr->empty() && valueStr->back() == '%';
+    bool convertedOk;
+    double value = strToDouble(isPercent ? valueStr->substr(0, valueStr->size() - 1) : *valueStr, &convertedOk);
+    if (!convertedOk)
+        throw formatStr("Неверный формат значения атрибута \"tolerance\" на строке %1.", { numberToStr(node.lineNumber) });
+    if (isPercent)
+        value /= 100;
+    if (!(value >= 0 && value < 1))
+        throw formatStr("Недопустимое значение атрибута \"tolerance\" на строке %1. Допуск должен быть не меньше 0 и меньше 100%.",
+                        { numberToStr(node.lineNumber) });
+    return value;
+}
+
+std::vector<ElementTolerance> tolerancesFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology)
+{
+    double defaultTolerance = toleranceAttribute(rootElement, 0);
+    std::vector<DocumentNode const *> connections = documentConnections(rootElement);
+    std::vector<ElementTolerance> tolerances;
+    tolerances.reserve(topology.elementTypes.size());
+    for (auto connection = connections.cbegin(); connection != connections.cend(); connection++)
+    {
+        for (auto iter = (*connection)->children.cbegin(); iter != (*connection)->children.cend(); iter++)
+        {
+            if (!iter->isElement() || iter->tagName != "elem")
+                continue;
+            bool isReciprocal = topology.elementTypes[tolerances.size()] == CoreElement::ElemType::C && iter->firstChildElement("res") == nullptr;
+            tolerances.push_back(ElementTolerance::relative(toleranceAttribute(*iter, defaultTolerance), isReciprocal));
+        }
+    }
+    return tolerances;
+}
+
+void circuitFromDocument(DocumentNode const & rootElement, CircuitMap& circuitMap, bool reserveChildren)
+{
+    CORE_TRACE_SPAN("circuitFromDocument");
+    CORE_ALLOCATION_PHASE(treeBuild);
+
+    // Обработка ошибок корневого элемента
+    std::string const & rootTag = rootElement.tagName;
+    if (rootTag != "seq" && rootTag != "par")
+        throw std::string("Корневым элементом должно быть последовательное \"<seq>\" или параллельное \"<par>\" соединение.");
+
+    std::string voltageStr = rootElement.attribute("voltage", "");
+    if (voltageStr.length() == 0)
+        throw std::string("У корневого элемента должно быть указано напряжение.");
+
+    double frequency = frequencyFromDocument(rootElement);
+
+    // Элементы всех соединений цепи, кроме корневого
+    std::vector<DocumentNode const *> seqConnections, parConnections;
+    rootElement.elementsByTagName("seq", seqConnections);
+    rootElement.elementsByTagName("par", parConnections);
+    auto conns = { &seqConnections, &parConnections };
+
+    // Использованные имена с номером строки
+    std::map<std::string, int> usedNames;
+
+    // Обработка ошибок связанных с указанием напряжения или частоты у других соединений
+    for (auto connGroup = conns.begin(); connGroup != conns.end(); connGroup++)
+    {
+        // Для каждого соединения
+        for (auto connIter = (*connGroup)->cbegin(); connIter != (*connGroup)->cend(); connIter++)
+        {
+            DocumentNode const & connectionElement = **connIter;
+
+            // Ошибка, если указано напряжение
+            if (connectionElement.attribute("voltage", "").length() != 0)
+                throw formatStr("Неверное указание напряжения цепи на строке %1. "
+                                "Напряжение указывается только для корневого элемента схемы.", { numberToStr(connectionElement.lineNumber) });
+
+            // Ошибка, если указана частота
+            if (connectionElement.attribute("frequency", "").length() != 0)
+                throw formatStr("Неверное указание частоты переменного тока на строке %1. "
+                                "Частота указывается только для корневого элемента схемы.", { numberToStr(connectionElement.lineNumber) });
+
+            // Ошибка, если указаны гармоники
+            if (connectionElement.attribute("harmonics", "").length() != 0)
+                throw formatStr("Неверное указание гармоник напряжения на строке %1. "
+                                "Гармоники указываются только для корневого элемента схемы.", { numberToStr(connectionElement.lineNumber) });
+
+            // Проверка уникальности имен соединений
+            std::string connectionName = connectionElement.attribute("name", "");
+            if (connectionName != "")
+            {
+                auto usedName = usedNames.find(connectionName);
+                if (usedName != usedNames.end())
+                    throw formatStr("Повтор имени соединения на строке %1 и строке %2. Имя соединения должно быть "
+                                    "уникальным.", { numberToStr(usedName->second), numberToStr(connectionElement.lineNumber) });
+                usedNames[connectionName] = connectionElement.lineNumber;
+            }
+        }
+    }
+
+    // Создаем дерево соединений в контейнере
+    CoreConnection::connectionFromDocElement(circuitMap, rootElement, frequency, reserveChildren);
+}
+
+void readInputFromFile(std::string const & inputPath, CircuitMap& circuitMap, DocumentParser const & parser)
+{
+    CORE_TRACE_SPAN("readInputFromFile");
+    circuitFromDocument(parser.parseFile(inputPath), circuitMap);
+}
+
+std::string formatOutput(CircuitMap const & circuitMap)
+{
+    CORE_ALLOCATION_PHASE(output);
+
+    // Список строк для вывода
+    std::vector<std::string> outputLines;
+
+    // Для каждого соединения
+    for (auto connectionIter = circuitMap.cbegin(); connectionIter != circuitMap.cend(); connectionIter++)
+    {
+        // Если имя указано пользователем
+        CoreConnection const & connection = connectionIter->second;
+        if (connection.isNameCustom())
+            outputLines.push_back(formatStr("%1 = %2\n", { connection.getName(), complexToString(connection.getCurrent()) }));
+    }
+
+    // Сортируем в алфавитном порядке
+    std::sort(outputLines.begin(), outputLines.end());
+
+    std::string output;
+    for (auto lineIter = outputLines.cbegin(); lineIter != outputLines.cend(); lineIter++)
+        output += *lineIter;
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, VariantResults const & results, size_t instance)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::vector<std::string> outputLines;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            outputLines.push_back(formatStr("%1 = %2\n", { topology.nodes[n].displayName(), complexToString(results.current(n, instance)) }));
+    }
+
+    std::sort(outputLines.begin(), outputLines.end());
+
+    std::string output;
+    for (auto lineIter = outputLines.cbegin(); lineIter != outputLines.cend(); lineIter++)
+        output += *lineIter;
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, CircuitState const & state)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::vector<std::string> outputLines;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            outputLines.push_back(formatStr("%1 = %2\n", { topology.nodes[n].displayName(), complexToString(state.currents[n]) }));
+    }
+
+    std::sort(outputLines.begin(), outputLines.end());
+
+    std::string output;
+    for (auto lineIter = outputLines.cbegin(); lineIter != outputLines.cend(); lineIter++)
+        output += *lineIter;
+    return output;
+}
+
+std::string formatOutput(FrequencySweep const & sweep)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::string output;
+    for (size_t f = 0; f < sweep.frequencies.size(); f++)
+    {
+        std::vector<std::string> outputLines;
+        for (size_t i = 0; i < sweep.names.size(); i++)
+            outputLines.push_back(formatStr("%1 = %2\n", { sweep.names[i], complexToString(sweep.currents[f][i]) }));
+        std::sort(outputLines.begin(), outputLines.end());
+
+        if (f != 0)
+            output += "\n";
+        output += formatStr("frequency = %1\n", { numberToStr(sweep.frequencies[f]) });
+        for (auto lineIter = outputLines.cbegin(); lineIter != outputLines.cend(); lineIter++)
+            output += *lineIter;
+    }
+    return output;
+}
+
+std::string formatOutput(HarmonicAnalysis const & analysis)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::string output;
+    for (size_t h = 0; h <= analysis.orders.size(); h++)
+    {
+        // После гармоник выводятся действующие значения
+        bool isTotal = h == analysis.orders.size();
+        std::vector<std::string> outputLines;
+        for (size_t i = 0; i < analysis.names.size(); i++)
+        {
+            std::string value = isTotal ? numberToStr(analysis.rmsCurrent(i)) : complexToString(analysis.current(i, h));
+            outputLines.push_back(formatStr("%1 = %2\n", { analysis.names[i], value }));
+        }
+        std::sort(outputLines.begin(), outputLines.end());
+
+        if (h != 0)
+            output += "\n";
+        output += isTotal ? std::string("rms\n") : formatStr("harmonic = %1\n", { numberToStr(analysis.orders[h]) });
+        for (auto lineIter = outputLines.cbegin(); lineIter != outputLines.cend(); lineIter++)
+            output += *lineIter;
+    }
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, FaultAnalysis const & analysis)
+{
+    CORE_ALLOCATION_PHASE(output);
+
+    // Порядок соединений одинаков во всех разделах, поэтому сортируется один раз
+    std::vector<size_t> order(analysis.names.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&analysis](size_t left, size_t right) {
+        return analysis.names[left] < analysis.names[right];
+    });
+
+    std::string output;
+    for (size_t s = 0; s <= analysis.scenarios.size(); s++)
+    {
+        // Перед авариями выводятся силы тока исходной цепи
+        bool isBase = s == 0;
+        if (isBase)
+            output += "fault = none\n";
+        else
+        {
+            FaultAnalysis::Scenario const & scenario = analysis.scenarios[s - 1];
+            output += formatStr("\nfault = %1 %2:%3\n", { scenario.type == FaultAnalysis::FaultType::open ? "open" : "short",
+                                                           topology.nodes[scenario.node].displayName(),
+                                                           numberToStr(scenario.position) });
+            if (!scenario.error.empty())
+            {
+                output += formatStr("error = %1\n", { scenario.error });
+                continue;
+            }
+        }
+
+        for (auto iter = order.cbegin(); iter != order.cend(); iter++)
+        {
+            std::complex<double> current = isBase ? analysis.baseCurrents[*iter] : analysis.current(s - 1, *iter);
+            output += analysis.names[*iter];
+            output += " = ";
+            output += complexToString(current);
+            output += "\n";
+        }
+    }
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, std::vector<OptimizationVariable> const & variables,
+                         std::vector<CurrentTarget> const & targets, OptimizationResult const & result)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::vector<std::string> valueLines;
+    for (size_t v = 0; v < variables.size(); v++)
+    {
+        valueLines.push_back(formatStr("%1:%2 = %3\n", { topology.nodes[variables[v].node].displayName(), numberToStr(variables[v].position),
+                                                         numberToStr(result.values[v]) }));
+    }
+    std::sort(valueLines.begin(), valueLines.end());
+
+    std::vector<std::string> currentLines;
+    for (size_t t = 0; t < targets.size(); t++)
+        currentLines.push_back(formatStr("%1 = %2\n", { topology.nodes[targets[t].node].displayName(), complexToString(result.currents[t]) }));
+    std::sort(currentLines.begin(), currentLines.end());
+
+    std::string output = formatStr("objective = %1\n", { numberToStr(result.objective) });
+    for (auto lineIter = valueLines.cbegin(); lineIter != valueLines.cend(); lineIter++)
+        output += *lineIter;
+    output += "\ncurrents\n";
+    for (auto lineIter = currentLines.cbegin(); lineIter != currentLines.cend(); lineIter++)
+        output += *lineIter;
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, GoalSeek const & result)
+{
+    return formatStr("value = %1\niterations = %2\n\n", { numberToStr(result.value), numberToStr(result.iterations) }) +
+           formatOutput(topology, result.state);
+}
+
+std::string formatOutput(CircuitTopology const & topology, ResonanceAnalysis const & analysis)
+{
+    CORE_ALLOCATION_PHASE(output);
+    if (analysis.resonances.empty())
+        return "resonance = none\n";
+
+    std::string output;
+    for (auto iter = analysis.resonances.cbegin(); iter != analysis.resonances.cend(); iter++)
+    {
+        if (!output.empty())
+            output += "\n";
+        std::string signal = iter->node < 0 ? "impedance" : "current " + topology.nodes[iter->node].displayName();
+        output += formatStr("resonance = %1 %2\nfrequency = %3\nq = %4\ncurrent = %5\n",
+                            { signal, iter->isMaximum ? "max" : "min", numberToStr(iter->frequency), numberToStr(iter->q),
+                              complexToString(iter->current) });
+    }
+    return output;
+}
+
+std::string formatOutput(CircuitTopology const & topology, WorstCaseAnalysis const & analysis)
+{
+    CORE_ALLOCATION_PHASE(output);
+    std::string output;
+    for (size_t i = 0; i < analysis.outputNodes.size(); i++)
+    {
+        double maximum = analysis.maximums[i];
+        output += formatStr("%1 = %2 .. %3\n", { topology.nodes[analysis.outputNodes[i]].displayName(), numberToStr(analysis.minimums[i]),
+                                                 std::isfinite(maximum) ? numberToStr(maximum) : std::string("inf") });
+    }
+    return output;
+}
+
+void writeTextToFile(std::string const & outputPath, std::string const & output)
+{
+    // Попытатья открыть файл
+    // Ошибка, если не удалось открыть
+    FILE* outFile = std::fopen(outputPath.c_str(), "w");
+    if (outFile == nullptr)
+        throw std::string("Неверно указан файл для выходных данных. Возможно указанного расположения не существует или нет прав на запись.");
+
+    // Записываем в файл и закрываем его
+    std::fwrite(output.data(), 1, output.size(), outFile);
+    std::fclose(outFile);
+}
+
+void writeOutputToFile(std::string const & outputPath, CircuitMap const & circuitMap)
+{
+    CORE_TRACE_SPAN("writeOutputToFile");
+    CORE_ALLOCATION_PHASE(output);
+    writeTextToFile(outputPath, formatOutput(circuitMap));
+}
@@ -0,0 +1,220 @@
+#ifndef COREIO_H
+#define COREIO_H
+#include <complex>
+#include <map>
+#include <string>
+#include "circuitState.h"
+#include "circuitTopology.h"
+#include "componentOptimizer.h"
+#include "coreConnection.h"
+#include "documentParser.h"
+#include "faultAnalysis.h"
+#include "goalSeek.h"
+#include "harmonicAnalysis.h"
+#include "resonanceAnalysis.h"
+#include "transferFunction.h"
+#include "variantEvaluator.h"
+#include "worstCaseAnalysis.h"
+
+/*!
+*\file
+*\brief Заголовки функций для работы с файлами без использования Qt
+*/
+
+/*!
+* \brief Получить строчное отображение комплексного числа (аналог complexToStr)
+* \param[in] num - комплексное число
+* \return - строчное отображение комплексного числа
+*/
+std::string complexToString(std::complex<double> num);
+
+/*!
+* \brief Получить частоту переменного тока, указанную у корневого узла документа
+* \param[in] rootElement - корневой узел документа
+* \return - значение частоты или -1, если частота не указана
+*/
+double frequencyFromDocument(DocumentNode const & rootElement);
+
+/*!
+* \brief Получить гармоники напряжения источника, указанные у корневого узла документа
+*
+* Первая гармоника - напряжение "voltage" корневого узла. Высшие гармоники указываются атрибутом
+* "harmonics" через точку с запятой в виде "номер:напряжение:фаза", фаза в градусах необязательна:
+* \c harmonics="3:20:30; 5:10"
+* \param[in] rootElement - корневой узел документа
+* \return - гармоники, начиная с первой
+*/
+std::vector<Harmonic> harmonicsFromDocument(DocumentNode const & rootElement);
+
+/*!
+* \brief Получить подбираемые элементы и требуемые силы тока, указанные в документе
+*
+* Подбираемый элемент отмечается атрибутом "series" с названием ряда номиналов, диапазон значений -
+* атрибутами "min" и "max" (по умолчанию от 0.1 до 10 значений элемента во входных данных):
+* \c <elem series="E24" min="100" max="10000">. Требуемый модуль силы тока указывается атрибутом
+* "target" именованного соединения: \c <seq name="load" target="0.5">
+* \param[in] rootElement - корневой узел документа
+* \param[in] topology - топология цепи, построенная по документу без упрощения
+* \param[out] variables - подбираемые элементы в порядке следования в документе
+* \param[out] targets - требуемые силы тока в порядке следования в документе
+*/
+void optimizationFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology,
+                              std::vector<OptimizationVariable>& variables, std::vector<CurrentTarget>& targets);
+
+/*!
+* \brief Получить требуемую силу тока для подбора одного значения
+*
+* Требуемая сила тока указывается атрибутом "target" ровно у одного именованного соединения
+* \param[in] rootElement - корневой узел документа
+* \param[in] topology - топология цепи, построенная по документу без упрощения
+* \return - требуемая сила тока
+*/
+CurrentTarget goalSeekTargetFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology);
+
+/*!
+* \brief Получить элемент, значение которого подбирается
+* \param[in] rootElement - корневой узел документа
+* \param[in] topology - топология цепи, построенная по документу без упрощения
+* \param[in] reference - элемент в виде "имя соединения:номер элемента", номер начинается с 1
+* \return - элемент и его значение во входных данных
+*/
+OptimizationVariable goalSeekElementFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology,
+                                                 std::string const & reference);
+
+/*!
+* \brief Получить допуски элементов, указанные в документе
+*
+* Относительный допуск значения элемента указывается атрибутом "tolerance" в долях или процентах:
+* \c <elem tolerance="5%">. Атрибут корневого узла задает допуск элементов, у которых он не указан.
+* У конденсатора, заданного емкостью, сопротивление обратно пропорционально значению
+* \param[in] rootElement - корневой узел документа
+* \param[in] topology - топология цепи, построенная по документу без упрощения
+* \return - допуски элементов в порядке топологии
+*/
+std::vector<ElementTolerance> tolerancesFromDocument(DocumentNode const & rootElement, CircuitTopology const & topology);
+
+/*!
+* \brief Создать дерево соединений на основе корневого узла документа
+* \param[in] rootElement - корневой узел документа
+* \param[in,out] circuitMap - контейнер для записи дерева соединений
+* \param[in] reserveChildren - выделять ли списки детей до их создания, см. CoreConnection::connectionFromDocElement
+*/
+void circuitFromDocument(DocumentNode const & rootElement, CircuitMap& circuitMap, bool reserveChildren = true);
+
+/*!
+* \brief Создать дерево соединений на основе xml файла
+* \param[in] inputPath - путь к файлу
+* \param[in,out] circuitMap - контейнер для записи дерева соединений
+* \param[in] parser - разборщик входного файла
+*/
+void readInputFromFile(std::string const & inputPath, CircuitMap& circuitMap, DocumentParser const & parser);
+
+/*!
+* \brief Сформировать текст вывода: силы тока для соединений с известным именем в алфавитном порядке
+* \param[in] circuitMap - контейнер с деревом соединений
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitMap const & circuitMap);
+
+/*!
+* \brief Сформировать текст вывода для одного из рассчитанных вариантов цепи
+* \param[in] topology - топология цепи
+* \param[in] results - результаты расчета, в которых сохранены значения соединений с известным именем
+* \param[in] instance - номер варианта
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, VariantResults const & results, size_t instance);
+
+/*!
+* \brief Сформировать текст вывода по состоянию расчета цепи
+* \param[in] topology - топология цепи
+* \param[in] state - рассчитанное состояние
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, CircuitState const & state);
+
+/*!
+* \brief Сформировать текст вывода для расчета на нескольких частотах: для каждой частоты строка
+* "frequency = f" и силы тока выбранных соединений в алфавитном порядке, частоты разделены пустой строкой
+* \param[in] sweep - силы тока на частотах
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(FrequencySweep const & sweep);
+
+/*!
+* \brief Сформировать текст вывода для расчета на гармониках: для каждой гармоники строка "harmonic = N"
+* и силы тока выбранных соединений в алфавитном порядке, затем строка "rms" и действующие значения
+* сил тока по всем гармоникам. Разделы разделены пустой строкой
+* \param[in] analysis - силы тока на гармониках
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(HarmonicAnalysis const & analysis);
+
+/*!
+* \brief Сформировать текст вывода для расчета аварий: строка "fault = none" и силы тока исходной цепи,
+* затем для каждой аварии строка "fault = open|short соединение:номер элемента" и силы тока выбранных
+* соединений в алфавитном порядке или строка "error = текст ошибки". Разделы разделены пустой строкой
+* \param[in] topology - топология цепи
+* \param[in] analysis - силы тока при авариях
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, FaultAnalysis const & analysis);
+
+/*!
+* \brief Сформировать текст вывода для подбора номиналов: строка "objective = отклонение", подобранные
+* значения в виде "соединение:номер элемента = значение", затем строка "currents" и силы тока соединений
+* с требуемой силой тока. Строки разделов в алфавитном порядке, разделы разделены пустой строкой
+* \param[in] topology - топология цепи
+* \param[in] variables - подбираемые элементы
+* \param[in] targets - требуемые силы тока
+* \param[in] result - лучший найденный набор
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, std::vector<OptimizationVariable> const & variables,
+                         std::vector<CurrentTarget> const & targets, OptimizationResult const & result);
+
+/*!
+* \brief Сформировать текст вывода для подбора одного значения: строки "value = значение" и
+* "iterations = количество итераций", пустая строка, затем силы тока соединений с известным именем
+* в алфавитном порядке
+* \param[in] topology - топология цепи
+* \param[in] result - найденное значение
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, GoalSeek const & result);
+
+/*!
+* \brief Сформировать текст вывода для поиска резонансов: для каждого экстремума строки
+* "resonance = impedance max|min" или "resonance = current имя max|min", "frequency = частота",
+* "q = добротность" и "current = сила тока", экстремумы разделены пустой строкой. Если экстремумов
+* нет, записывается строка "resonance = none"
+* \param[in] topology - топология цепи
+* \param[in] analysis - найденные резонансы
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, ResonanceAnalysis const & analysis);
+
+/*!
+* \brief Сформировать текст вывода для расчета наихудших сил тока: для соединений с известным именем
+* в алфавитном порядке строки "имя = наименьший модуль .. наибольший модуль", неограниченный модуль - "inf"
+* \param[in] topology - топология цепи
+* \param[in] analysis - границы модулей сил тока
+* \return - текст для записи в выходной файл
+*/
+std::string formatOutput(CircuitTopology const & topology, WorstCaseAnalysis const & analysis);
+
+/*!
+* \brief Записать текст в выходной файл
+* \param[in] outputPath - путь к файлу
+* \param[in] output - текст
+*/
+void writeTextToFile(std::string const & outputPath, std::string const & output);
+
+/*!
+* \brief Записать силы тока для соединений с известным именем в файл
+* \param[in] outputPath - путь к файлу
+* \param[in] circuitMap - контейнер с деревом соединений
+*/
+void writeOutputToFile(std::string const & outputPath, CircuitMap const & circuitMap);
+
+#endif // COREIO_H
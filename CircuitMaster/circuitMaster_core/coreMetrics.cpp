@@ -0,0 +1,277 @@
+#include "coreMetrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <locale>
+#include <sstream>
+
+/*!
+*\file
+*\brief Реализация функций счетчиков и гистограмм для длительной работы программы
+*/
+
+MetricHistogram::MetricHistogram(std::vector<double> const & upperBounds)
+    : bounds(upperBounds), buckets(new std::atomic<uint64_t>[upperBounds.size() + 1])
+{
+    this->reset();
+}
+
+void MetricHistogram::observe(double value)
+{
+    size_t bucket = std::lower_bound(this->bounds.cbegin(), this->bounds.cend(), value) - this->bounds.cbegin();
+    this->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    this->count.fetch_add(1, std::memory_order_relaxed);
+
+    double current = this->sum.load(std::memory_order_relaxed);
+    while (!this->sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::vector<double> const & MetricHistogram::getBounds() const
+{
+    return this->bounds;
+}
+
+uint64_t MetricHistogram::getBucketCount(size_t bucket) const
+{
+    return this->buckets[bucket].load(std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::getCount() const
+{
+    return this->count.load(std::memory_order_relaxed);
+}
+
+double MetricHistogram::getSum() const
+{
+    return this->sum.load(std::memory_order_relaxed);
+}
+
+void MetricHistogram::reset()
+{
+    for (size_t i = 0; i <= this->bounds.size(); i++)
+        this->buckets[i].store(0, std::memory_order_relaxed);
+    this->count.store(0, std::memory_order_relaxed);
+    this->sum.store(0, std::memory_order_relaxed);
+}
+
+namespace {
+
+const size_t phaseCount = static_cast<size_t>(Metrics::Phase::count); /*!< Количество этапов */
+
+/*!
+*\brief Набор метрик программы
+*/
+struct MetricSet
+{
+    MetricCounter requests[2]; /*!< Обработано файлов: [0] - с ошибками, [1] - без ошибок */
+    MetricCounter errors[phaseCount]; /*!< Ошибки по этапам */
+    MetricCounter planCacheLookups[2]; /*!< Обращения к кэшу топологий: [0] - промахи, [1] - попадания */
+    std::unique_ptr<MetricHistogram> durations[phaseCount]; /*!< Длительность этапов в секундах */
+    MetricHistogram connections; /*!< Количество соединений в цепи */
+    MetricHistogram elements; /*!< Количество элементов в цепи */
+
+    MetricSet()
+        : connections({ 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 10000 }),
+          elements({ 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 10000 })
+    {
+        // От 10 мкс до 10 с
+        std::vector<double> latencyBounds = { 0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+                                              0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+        for (size_t i = 0; i < phaseCount; i++)
+            this->durations[i].reset(new MetricHistogram(latencyBounds));
+    }
+};
+
+/*!
+* \brief Получить набор метрик, создав его при первом обращении
+* \return - набор метрик
+*/
+MetricSet& metricSet()
+{
+    static MetricSet set;
+    return set;
+}
+
+/*!
+* \brief Сформировать строчное отображение числа для формата Prometheus независимо от локали
+* \param[in] value - число
+* \return - строчное отображение
+*/
+std::string prometheusNumber(double value)
+{
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    stream.precision(15);
+    stream << value;
+    return stream.str();
+}
+
+/*!
+* \brief Добавить заголовок метрики
+* \param[in,out] text - текст метрик
+* \param[in] name - имя метрики
+* \param[in] type - тип метрики: counter или histogram
+* \param[in] help - описание метрики
+*/
+void appendHeader(std::string& text, std::string const & name, std::string const & type, std::string const & help)
+{
+    text += "# HELP " + name + " " + help + "\n";
+    text += "# TYPE " + name + " " + type + "\n";
+}
+
+/*!
+* \brief Добавить значения гистограммы
+* \param[in,out] text - текст метрик
+* \param[in] name - имя метрики
+* \param[in] labels - метки в виде name="value", пустая строка - без меток
+* \param[in] histogram - гистограмма
+*/
+void appendHistogram(std::string& text, std::string const & name, std::string const & labels, MetricHistogram const & histogram)
+{
+    std::string prefix = labels.empty() ? "" : labels + ",";
+    std::vector<double> const & bounds = histogram.getBounds();
+
+    // Интервалы в формате Prometheus накопленные
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bounds.size(); i++)
+    {
+        cumulative += histogram.getBucketCount(i);
+        text += name + "_bucket{" + prefix + "le=\"" + prometheusNumber(bounds[i]) + "\"} " + std::to_string(cumulative) + "\n";
+    }
+    cumulative += histogram.getBucketCount(bounds.size());
+    text += name + "_bucket{" + prefix + "le=\"+Inf\"} " + std::to_string(cumulative) + "\n";
+
+    std::string labelBlock = labels.empty() ? "" : "{" + labels + "}";
+    text += name + "_sum" + labelBlock + " " + prometheusNumber(histogram.getSum()) + "\n";
+    text += name + "_count" + labelBlock + " " + std::to_string(cumulative) + "\n";
+}
+
+}
+
+const char* Metrics::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::read:
+        return "read";
+    case Phase::parse:
+        return "parse";
+    case Phase::evaluate:
+        return "evaluate";
+    case Phase::write:
+        return "write";
+    default:
+        return "";
+    }
+}
+
+void Metrics::countRequest(bool succeeded)
+{
+    metricSet().requests[succeeded ? 1 : 0].add();
+}
+
+void Metrics::countError(Phase stage)
+{
+    metricSet().errors[static_cast<size_t>(stage)].add();
+}
+
+void Metrics::observeDuration(Phase phase, double seconds)
+{
+    metricSet().durations[static_cast<size_t>(phase)]->observe(seconds);
+}
+
+void Metrics::observeCircuitSize(size_t connections, size_t elements)
+{
+    MetricSet& set = metricSet();
+    set.connections.observe(static_cast<double>(connections));
+    set.elements.observe(static_cast<double>(elements));
+}
+
+void Metrics::countPlanCacheLookup(bool hit)
+{
+    metricSet().planCacheLookups[hit ? 1 : 0].add();
+}
+
+uint64_t Metrics::getErrorCount(Phase stage)
+{
+    return metricSet().errors[static_cast<size_t>(stage)].get();
+}
+
+uint64_t Metrics::getRequestCount(bool succeeded)
+{
+    return metricSet().requests[succeeded ? 1 : 0].get();
+}
+
+MetricHistogram const & Metrics::getDurationHistogram(Phase phase)
+{
+    return *metricSet().durations[static_cast<size_t>(phase)];
+}
+
+void Metrics::reset()
+{
+    MetricSet& set = metricSet();
+    for (size_t i = 0; i < 2; i++)
+    {
+        set.requests[i].reset();
+        set.planCacheLookups[i].reset();
+    }
+    for (size_t i = 0; i < phaseCount; i++)
+    {
+        set.errors[i].reset();
+        set.durations[i]->reset();
+    }
+    set.connections.reset();
+    set.elements.reset();
+}
+
+std::string Metrics::prometheusText()
+{
+    MetricSet& set = metricSet();
+    std::string text;
+
+    appendHeader(text, "circuitmaster_requests_total", "counter", "Processed input files by result.");
+    text += "circuitmaster_requests_total{result=\"success\"} " + std::to_string(set.requests[1].get()) + "\n";
+    text += "circuitmaster_requests_total{result=\"error\"} " + std::to_string(set.requests[0].get()) + "\n";
+
+    appendHeader(text, "circuitmaster_errors_total", "counter", "Errors by the processing stage that raised them.");
+    for (size_t i = 0; i < phaseCount; i++)
+        text += std::string("circuitmaster_errors_total{stage=\"") + phaseName(static_cast<Phase>(i)) + "\"} " + std::to_string(set.errors[i].get()) + "\n";
+
+    appendHeader(text, "circuitmaster_phase_duration_seconds", "histogram", "Duration of processing phases.");
+    for (size_t i = 0; i < phaseCount; i++)
+        appendHistogram(text, "circuitmaster_phase_duration_seconds", std::string("phase=\"") + phaseName(static_cast<Phase>(i)) + "\"", *set.durations[i]);
+
+    appendHeader(text, "circuitmaster_circuit_connections", "histogram", "Number of connections per evaluated circuit.");
+    appendHistogram(text, "circuitmaster_circuit_connections", "", set.connections);
+
+    appendHeader(text, "circuitmaster_circuit_elements", "histogram", "Number of elements per evaluated circuit.");
+    appendHistogram(text, "circuitmaster_circuit_elements", "", set.elements);
+
+    appendHeader(text, "circuitmaster_plan_cache_lookups_total", "counter", "Topology cache lookups by result.");
+    text += "circuitmaster_plan_cache_lookups_total{result=\"hit\"} " + std::to_string(set.planCacheLookups[1].get()) + "\n";
+    text += "circuitmaster_plan_cache_lookups_total{result=\"miss\"} " + std::to_string(set.planCacheLookups[0].get()) + "\n";
+
+    return text;
+}
+
+void Metrics::writeToFile(std::string const & path)
+{
+    std::string text = prometheusText();
+    std::string tempPath = path + ".tmp";
+
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr)
+        throw std::string("Не удалось открыть файл для записи метрик: \"" + path + "\".");
+    bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    written = std::fclose(file) == 0 && written;
+
+    std::error_code errorCode;
+    if (written)
+        std::filesystem::rename(tempPath, path, errorCode);
+    if (!written || errorCode)
+    {
+        std::filesystem::remove(tempPath, errorCode);
+        throw std::string("Не удалось записать метрики в файл: \"" + path + "\".");
+    }
+}
@@ -0,0 +1,258 @@
+#ifndef COREMETRICS_H
+#define COREMETRICS_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций счетчиков и гистограмм для длительной работы программы
+*
+* Значения обновляются атомарными операциями без блокировок. Набор метрик фиксирован (см. Metrics),
+* поэтому при записи значения не нужен поиск по реестру
+*/
+
+/*!
+*\class MetricCounter
+*\brief Монотонно возрастающий счетчик
+*
+* Выровнен по строке кэша, чтобы обновление разных счетчиков из разных потоков не мешало друг другу
+*/
+class alignas(64) MetricCounter
+{
+    public:
+    /*!
+    * \brief Увеличить счетчик
+    * \param[in] amount - величина увеличения
+    */
+    void add(uint64_t amount = 1)
+    {
+        this->value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /*!
+    * \brief Получить значение счетчика
+    * \return - значение
+    */
+    uint64_t get() const
+    {
+        return this->value.load(std::memory_order_relaxed);
+    }
+
+    /*!
+    * \brief Обнулить счетчик
+    */
+    void reset()
+    {
+        this->value.store(0, std::memory_order_relaxed);
+    }
+
+    private:
+    std::atomic<uint64_t> value{0}; /*!< Значение */
+};
+
+/*!
+*\class MetricHistogram
+*\brief Гистограмма наблюдаемых значений с фиксированными верхними границами интервалов
+*/
+class MetricHistogram
+{
+    public:
+    /*!
+    * \brief Конструктор гистограммы
+    * \param[in] upperBounds - верхние границы интервалов по возрастанию, интервал +Inf добавляется автоматически
+    */
+    MetricHistogram(std::vector<double> const & upperBounds);
+
+    MetricHistogram(MetricHistogram const &) = delete;
+    MetricHistogram& operator=(MetricHistogram const &) = delete;
+
+    /*!
+    * \brief Учесть значение
+    * \param[in] value - значение
+    */
+    void observe(double value);
+
+    /*!
+    * \brief Получить верхние границы интервалов без +Inf
+    * \return - границы
+    */
+    std::vector<double> const & getBounds() const;
+
+    /*!
+    * \brief Получить количество значений в интервале (не накопленное)
+    * \param[in] bucket - номер интервала, последний - +Inf
+    * \return - количество значений
+    */
+    uint64_t getBucketCount(size_t bucket) const;
+
+    /*!
+    * \brief Получить количество учтенных значений
+    * \return - количество значений
+    */
+    uint64_t getCount() const;
+
+    /*!
+    * \brief Получить сумму учтенных значений
+    * \return - сумма
+    */
+    double getSum() const;
+
+    /*!
+    * \brief Обнулить гистограмму
+    */
+    void reset();
+
+    private:
+    std::vector<double> bounds; /*!< Верхние границы интервалов */
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets; /*!< Количество значений в интервалах, последний - +Inf */
+    std::atomic<uint64_t> count{0}; /*!< Количество значений */
+    std::atomic<double> sum{0}; /*!< Сумма значений */
+};
+
+/*!
+*\class Metrics
+*\brief Метрики обработки файлов и их выгрузка в текстовом формате Prometheus
+*/
+class Metrics
+{
+    public:
+    /*!
+    *\enum Phase
+    *\brief Этап обработки файла
+    */
+    enum class Phase
+    {
+        read, /*!< Чтение файла */
+        parse, /*!< Разбор xml */
+        evaluate, /*!< Построение дерева соединений, расчет и формирование результата */
+        write, /*!< Запись результата */
+        count /*!< Количество этапов */
+    };
+
+    /*!
+    * \brief Получить название этапа для метки phase или stage
+    * \param[in] phase - этап
+    * \return - название
+    */
+    static const char* phaseName(Phase phase);
+
+    /*!
+    * \brief Учесть обработанный файл
+    * \param[in] succeeded - true, если файл обработан без ошибок
+    */
+    static void countRequest(bool succeeded);
+
+    /*!
+    * \brief Учесть ошибку
+    * \param[in] stage - этап, на котором получена ошибка
+    */
+    static void countError(Phase stage);
+
+    /*!
+    * \brief Учесть длительность этапа
+    * \param[in] phase - этап
+    * \param[in] seconds - длительность в секундах
+    */
+    static void observeDuration(Phase phase, double seconds);
+
+    /*!
+    * \brief Учесть размер цепи
+    * \param[in] connections - количество соединений
+    * \param[in] elements - количество элементов
+    */
+    static void observeCircuitSize(size_t connections, size_t elements);
+
+    /*!
+    * \brief Учесть обращение к кэшу топологий
+    * \param[in] hit - true, если топология найдена в кэше
+    */
+    static void countPlanCacheLookup(bool hit);
+
+    /*!
+    * \brief Получить количество ошибок на этапе
+    * \param[in] stage - этап
+    * \return - количество ошибок
+    */
+    static uint64_t getErrorCount(Phase stage);
+
+    /*!
+    * \brief Получить количество обработанных файлов
+    * \param[in] succeeded - true - без ошибок, false - с ошибками
+    * \return - количество файлов
+    */
+    static uint64_t getRequestCount(bool succeeded);
+
+    /*!
+    * \brief Получить гистограмму длительности этапа
+    * \param[in] phase - этап
+    * \return - гистограмма
+    */
+    static MetricHistogram const & getDurationHistogram(Phase phase);
+
+    /*!
+    * \brief Обнулить все метрики
+    */
+    static void reset();
+
+    /*!
+    * \brief Сформировать текст метрик в формате Prometheus
+    * \return - текст
+    */
+    static std::string prometheusText();
+
+    /*!
+    * \brief Записать метрики в файл в формате Prometheus. Файл заменяется целиком, чтобы читатель не увидел неполный текст
+    * \param[in] path - путь к файлу
+    */
+    static void writeToFile(std::string const & path);
+};
+
+/*!
+*\class MetricsTimer
+*\brief Измерение длительности этапа от создания объекта до вызова stop или выхода из области видимости
+*/
+class MetricsTimer
+{
+    public:
+    /*!
+    * \brief Конструктор, начинает измерение
+    * \param[in] timedPhase - этап
+    */
+    MetricsTimer(Metrics::Phase timedPhase)
+        : phase(timedPhase), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    /*!
+    * \brief Деструктор, учитывает длительность, если она ещё не учтена
+    */
+    ~MetricsTimer()
+    {
+        this->stop();
+    }
+
+    /*!
+    * \brief Закончить измерение и учесть длительность
+    */
+    void stop()
+    {
+        if (this->stopped)
+            return;
+        this->stopped = true;
+        Metrics::observeDuration(this->phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - this->start).count());
+    }
+
+    MetricsTimer(MetricsTimer const &) = delete;
+    MetricsTimer& operator=(MetricsTimer const &) = delete;
+
+    private:
+    Metrics::Phase phase; /*!< Этап */
+    std::chrono::steady_clock::time_point start; /*!< Начало измерения */
+    bool stopped = false; /*!< Учтена ли длительность */
+};
+
+#endif // COREMETRICS_H
@@ -0,0 +1,79 @@
+#include "coreStrings.h"
+#include <charconv>
+#include <cstdio>
+#include <vector>
+
+/*!
+*\file
+*\brief Реализация вспомогательных функций для работы со строками без использования Qt
+*/
+
+std::string formatStr(std::string const & pattern, std::initializer_list<std::string> args)
+{
+    std::vector<std::string const *> argPtrs;
+    for (auto iter = args.begin(); iter != args.end(); iter++)
+        argPtrs.push_back(&(*iter));
+
+    std::string result;
+    result.reserve(pattern.size() + 16 * argPtrs.size());
+
+    // Заменяем %N на N-ый аргумент, остальные символы копируем как есть
+    for (size_t i = 0; i < pattern.size(); i++)
+    {
+        if (pattern[i] == '%' && i + 1 < pattern.size() && pattern[i + 1] >= '1' && pattern[i + 1] <= '9')
+        {
+            size_t argIndex = pattern[i + 1] - '1';
+            if (argIndex < argPtrs.size())
+            {
+                result += *argPtrs[argIndex];
+                i++;
+                continue;
+            }
+        }
+        result += pattern[i];
+    }
+    return result;
+}
+
+std::string numberToStr(double num)
+{
+    // QString::number не выводит знак у отрицательного нуля
+    if (num == 0)
+        num = 0;
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%g", num);
+    return buf;
+}
+
+std::string numberToStr(int num)
+{
+    return std::to_string(num);
+}
+
+double strToDouble(std::string const & str, bool* ok)
+{
+    // Пропускаем пробельные символы в начале и в конце строки
+    size_t begin = str.find_first_not_of(" \t\r\n");
+    size_t end = str.find_last_not_of(" \t\r\n");
+    bool converted = false;
+    double value = 0;
+
+    if (begin != std::string::npos)
+    {
+        // std::from_chars не допускает знак "+", в отличие от QString::toDouble
+        if (str[begin] == '+' && begin < end && str[begin + 1] != '-')
+            begin++;
+
+        char const * first = str.data() + begin;
+        char const * last = str.data() + end + 1;
+        auto result = std::from_chars(first, last, value);
+        converted = result.ec == std::errc() && result.ptr == last;
+    }
+
+    if (!converted)
+        value = 0;
+    if (ok != nullptr)
+        *ok = converted;
+    return value;
+}
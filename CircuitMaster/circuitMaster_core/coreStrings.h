@@ -0,0 +1,41 @@
+#ifndef CORESTRINGS_H
+#define CORESTRINGS_H
+#include <string>
+#include <initializer_list>
+
+/*!
+*\file
+*\brief Заголовки вспомогательных функций для работы со строками без использования Qt
+*/
+
+/*!
+* \brief Аналог QString::arg - подставить аргументы на места %1, %2, ... %9
+* \param[in] pattern - строка-шаблон
+* \param[in] args - аргументы для подстановки
+* \return - строка с подставленными аргументами
+*/
+std::string formatStr(std::string const & pattern, std::initializer_list<std::string> args);
+
+/*!
+* \brief Аналог QString::number для вещественного числа (формат 'g', точность 6)
+* \param[in] num - число
+* \return - строчное отображение числа
+*/
+std::string numberToStr(double num);
+
+/*!
+* \brief Аналог QString::number для целого числа
+* \param[in] num - число
+* \return - строчное отображение числа
+*/
+std::string numberToStr(int num);
+
+/*!
+* \brief Аналог QString::toDouble - преобразовать строку в вещественное число
+* \param[in] str - строка, пробельные символы в начале и в конце игнорируются
+* \param[out] ok - true, если преобразование прошло успешно. Можно передать nullptr
+* \return - полученное число или 0, если преобразовать не удалось
+*/
+double strToDouble(std::string const & str, bool* ok = nullptr);
+
+#endif // CORESTRINGS_H
@@ -0,0 +1,50 @@
+#include "coreTestFunctions.h"
+#include "coreIo.h"
+#include "liteXmlParser.h"
+
+/*!
+*\file
+*\brief Реализация функций для упрощения тестирования ядра без Qt
+*/
+
+void CORE_COMPARE_COMPLEX(std::complex<double> expected, std::complex<double> actual, double epsilon)
+{
+    double realDelta = std::abs(expected.real() - actual.real());
+    double imagDelta = std::abs(expected.imag() - actual.imag());
+    std::string message = "Expected = " + complexToString(expected) + " Got = " + complexToString(actual);
+    QVERIFY2(realDelta < epsilon && imagDelta < epsilon, message.c_str());
+}
+
+CoreConnection* coreCircuitFromText(std::string const & xml, CircuitMap& circuitMap)
+{
+    circuitFromDocument(LiteXmlParser().parseText(xml), circuitMap);
+    return &circuitMap.begin()->second;
+}
+
+CircuitTopology topologyFromText(std::string const & xml, DocumentNode& rootElement)
+{
+    rootElement = LiteXmlParser().parseText(xml);
+    CircuitMap circuitMap;
+    circuitFromDocument(rootElement, circuitMap);
+    return CircuitTopology::fromConnection(circuitMap.begin()->second, frequencyFromDocument(rootElement));
+}
+
+CircuitState evaluateWithResistances(CircuitTopology const & topology, std::vector<std::pair<int, std::complex<double>>> const & resistances)
+{
+    CircuitTopology changed = topology;
+    for (auto iter = resistances.cbegin(); iter != resistances.cend(); iter++)
+        changed.elementResistances[iter->first] = iter->second;
+    CircuitState state;
+    state.evaluate(changed);
+    return state;
+}
+
+CoreConnection const * findCoreConnection(CircuitMap const & circuitMap, std::string const & name)
+{
+    for (auto iter = circuitMap.cbegin(); iter != circuitMap.cend(); iter++)
+    {
+        if (iter->second.getName() == name)
+            return &iter->second;
+    }
+    return nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef CORETESTFUNCTIONS_H
+#define CORETESTFUNCTIONS_H
+#include <QtTest>
+#include <complex>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "circuitState.h"
+#include "circuitTopology.h"
+#include "coreConnection.h"
+#include "documentNode.h"
+
+/*!
+*\file
+*\brief Заголовки функций для упрощения тестирования ядра без Qt
+*/
+
+/*!
+* \brief Аналог QCOMPARE для комплексного числа
+* \param[in] expected - ожидаемое комплексное число
+* \param[in] actual - полученное комплексное число
+* \param[in] epsilon - допустимая погрешность
+*/
+void CORE_COMPARE_COMPLEX(std::complex<double> expected, std::complex<double> actual, double epsilon);
+
+/*!
+* \brief Создать дерево соединений из текста xml с помощью LiteXmlParser
+* \param[in] xml - текст документа
+* \param[in,out] circuitMap - контейнер для записи дерева соединений
+* \return - указатель на корневое соединение
+*/
+CoreConnection* coreCircuitFromText(std::string const & xml, CircuitMap& circuitMap);
+
+/*!
+* \brief Создать топологию цепи из текста xml с помощью LiteXmlParser
+* \param[in] xml - текст документа
+* \param[out] rootElement - корневой узел документа
+* \return - топология цепи на частоте документа
+*/
+CircuitTopology topologyFromText(std::string const & xml, DocumentNode& rootElement);
+
+/*!
+* \brief Рассчитать цепь заново с измененными сопротивлениями элементов
+* \param[in] topology - топология исходной цепи
+* \param[in] resistances - номера элементов в топологии и их новые сопротивления
+* \return - состояние измененной цепи
+*/
+CircuitState evaluateWithResistances(CircuitTopology const & topology, std::vector<std::pair<int, std::complex<double>>> const & resistances);
+
+/*!
+* \brief Найти соединение по имени
+* \param[in] circuitMap - контейнер с деревом соединений
+* \param[in] name - имя соединения
+* \return - указатель на соединение или nullptr, если соединение не найдено
+*/
+CoreConnection const * findCoreConnection(CircuitMap const & circuitMap, std::string const & name);
+
+#endif // CORETESTFUNCTIONS_H
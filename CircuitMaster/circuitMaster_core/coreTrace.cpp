@@ -0,0 +1,197 @@
+#include "coreTrace.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*!
+*\file
+*\brief Реализация функций трассировки этапов расчета
+*/
+
+namespace {
+
+/*!
+*\brief Записанный участок
+*/
+struct TraceEvent
+{
+    const char* name; /*!< Название участка */
+    int64_t startNs; /*!< Время начала от начала записи */
+    int64_t durationNs; /*!< Длительность */
+};
+
+/*!
+*\brief Буфер участков одного потока. Пишет в него только поток-владелец
+*/
+struct ThreadBuffer
+{
+    int threadId = 0; /*!< Номер потока в трассировке */
+    std::string threadName; /*!< Имя потока */
+    std::vector<TraceEvent> events; /*!< Записанные участки */
+};
+
+std::mutex registryMutex; /*!< Защита списка буферов */
+std::vector<std::shared_ptr<ThreadBuffer>> registry; /*!< Буферы всех потоков, писавших участки */
+std::atomic<int> maxDepthValue(1); /*!< Наибольшая глубина рекурсивных участков */
+std::atomic<int64_t> epochNs(0); /*!< Начало записи */
+thread_local std::shared_ptr<ThreadBuffer> localBuffer; /*!< Буфер текущего потока */
+
+/*!
+* \brief Получить время монотонных часов в наносекундах
+* \return - время
+*/
+int64_t clockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+* \brief Получить буфер текущего потока, зарегистрировав его при первом обращении
+* \return - буфер
+*/
+ThreadBuffer& currentBuffer()
+{
+    if (localBuffer == nullptr)
+    {
+        localBuffer = std::make_shared<ThreadBuffer>();
+        localBuffer->events.reserve(4096);
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(localBuffer);
+        localBuffer->threadId = static_cast<int>(registry.size());
+    }
+    return *localBuffer;
+}
+
+/*!
+* \brief Добавить строку в JSON, экранировав специальные символы
+* \param[in,out] json - текст JSON
+* \param[in] str - строка
+*/
+void appendJsonString(std::string& json, std::string const & str)
+{
+    json += '"';
+    for (char symbol : str)
+    {
+        if (symbol == '"' || symbol == '\\')
+            json += '\\';
+        if (static_cast<unsigned char>(symbol) < 0x20)
+            json += ' ';
+        else
+            json += symbol;
+    }
+    json += '"';
+}
+
+}
+
+std::atomic<bool> Trace::enabled(false);
+
+void Trace::start(int maxDepth)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto iter = registry.begin(); iter != registry.end(); iter++)
+        (*iter)->events.clear();
+
+    maxDepthValue.store(maxDepth, std::memory_order_relaxed);
+    epochNs.store(clockNs(), std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_release);
+}
+
+void Trace::stop()
+{
+    enabled.store(false, std::memory_order_release);
+}
+
+bool Trace::isCompiledIn()
+{
+#ifdef CIRCUITMASTER_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+int Trace::getMaxDepth()
+{
+    return maxDepthValue.load(std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(std::string const & name)
+{
+    currentBuffer().threadName = name;
+}
+
+size_t Trace::eventCount()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t count = 0;
+    for (auto iter = registry.cbegin(); iter != registry.cend(); iter++)
+        count += (*iter)->events.size();
+    return count;
+}
+
+std::string Trace::chromeTraceJson()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+
+    for (auto iter = registry.cbegin(); iter != registry.cend(); iter++)
+    {
+        ThreadBuffer const & buffer = **iter;
+        if (buffer.events.empty())
+            continue;
+
+        // Имя потока передаётся событием метаданных
+        if (!first)
+            json += ',';
+        first = false;
+        std::snprintf(number, sizeof(number), "%d", buffer.threadId);
+        json += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        json += number;
+        json += ",\"args\":{\"name\":";
+        appendJsonString(json, buffer.threadName.empty() ? "thread " + std::string(number) : buffer.threadName);
+        json += "}}";
+
+        // Завершённые участки ("ph":"X"), время в микросекундах
+        for (auto event = buffer.events.cbegin(); event != buffer.events.cend(); event++)
+        {
+            json += ",\n{\"name\":";
+            appendJsonString(json, event->name);
+            std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d", buffer.threadId);
+            json += number;
+            std::snprintf(number, sizeof(number), ",\"ts\":%.3f", event->startNs / 1000.0);
+            json += number;
+            std::snprintf(number, sizeof(number), ",\"dur\":%.3f}", event->durationNs / 1000.0);
+            json += number;
+        }
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+void Trace::writeChromeTrace(std::string const & path)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+        throw std::string("Не удалось записать файл трассировки \"" + path + "\".");
+
+    std::string json = chromeTraceJson();
+    std::fwrite(json.data(), 1, json.size(), file);
+    std::fclose(file);
+}
+
+void Trace::record(const char* name, int64_t startNs, int64_t durationNs)
+{
+    currentBuffer().events.push_back(TraceEvent{ name, startNs, durationNs });
+}
+
+int64_t Trace::now()
+{
+    return clockNs() - epochNs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,174 @@
+#ifndef CORETRACE_H
+#define CORETRACE_H
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций трассировки этапов расчета
+*
+* Участки кода отмечаются макросами CORE_TRACE_SPAN и CORE_TRACE_RECURSIVE_SPAN. Без
+* CIRCUITMASTER_TRACE (CONFIG += trace) макросы не создают кода. В сборке с трассировкой, но
+* при выключенной записи каждый участок стоит одной проверки флага
+*/
+
+/*!
+*\class Trace
+*\brief Запись участков выполнения и выгрузка в формате Chrome trace (chrome://tracing, Perfetto)
+*
+* Каждый поток пишет участки в собственный буфер без блокировок. Блокировка берётся только при
+* первой записи потока, чтобы зарегистрировать его буфер. Начинать запись, очищать и выгружать
+* буферы нужно, когда отмеченный код не выполняется
+*/
+class Trace
+{
+    public:
+    /*!
+    * \brief Начать запись, удалив ранее записанные участки
+    * \param[in] maxDepth - наибольшая записываемая глубина рекурсивных участков (CORE_TRACE_RECURSIVE_SPAN), начиная с 1
+    */
+    static void start(int maxDepth);
+
+    /*!
+    * \brief Остановить запись
+    */
+    static void stop();
+
+    /*!
+    * \brief Проверить, идёт ли запись
+    * \return - true, если запись идёт
+    */
+    static bool isEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+    * \brief Проверить, собрана ли программа с отметками участков
+    * \return - true, если определен CIRCUITMASTER_TRACE
+    */
+    static bool isCompiledIn();
+
+    /*!
+    * \brief Получить наибольшую записываемую глубину рекурсивных участков
+    * \return - глубина
+    */
+    static int getMaxDepth();
+
+    /*!
+    * \brief Задать имя текущего потока, отображаемое при просмотре
+    * \param[in] name - имя потока
+    */
+    static void setThreadName(std::string const & name);
+
+    /*!
+    * \brief Получить количество записанных участков во всех потоках
+    * \return - количество участков
+    */
+    static size_t eventCount();
+
+    /*!
+    * \brief Сформировать текст JSON в формате Chrome trace
+    * \return - текст JSON
+    */
+    static std::string chromeTraceJson();
+
+    /*!
+    * \brief Записать участки в файл в формате Chrome trace
+    * \param[in] path - путь к файлу
+    */
+    static void writeChromeTrace(std::string const & path);
+
+    /*!
+    * \brief Записать участок в буфер текущего потока
+    * \param[in] name - название участка, строка должна существовать до выгрузки
+    * \param[in] startNs - время начала в наносекундах от начала записи
+    * \param[in] durationNs - длительность в наносекундах
+    */
+    static void record(const char* name, int64_t startNs, int64_t durationNs);
+
+    /*!
+    * \brief Получить время в наносекундах от начала записи
+    * \return - время
+    */
+    static int64_t now();
+
+    private:
+    static std::atomic<bool> enabled; /*!< Идёт ли запись */
+};
+
+/*!
+*\class TraceSpan
+*\brief Участок выполнения от создания объекта до выхода из области видимости
+*/
+class TraceSpan
+{
+    public:
+    /*!
+    * \brief Конструктор участка
+    * \param[in] spanName - название участка, строковый литерал
+    */
+    TraceSpan(const char* spanName)
+    {
+        if (Trace::isEnabled())
+        {
+            this->name = spanName;
+            this->startNs = Trace::now();
+        }
+    }
+
+    /*!
+    * \brief Конструктор рекурсивного участка
+    * \param[in] spanName - название участка, строковый литерал
+    * \param[in,out] depth - текущая глубина рекурсии этого участка в потоке
+    */
+    TraceSpan(const char* spanName, int& depth)
+    {
+        if (Trace::isEnabled())
+        {
+            this->depthCounter = &depth;
+            depth++;
+            if (depth <= Trace::getMaxDepth())
+            {
+                this->name = spanName;
+                this->startNs = Trace::now();
+            }
+        }
+    }
+
+    /*!
+    * \brief Деструктор, записывает участок
+    */
+    ~TraceSpan()
+    {
+        if (this->depthCounter != nullptr)
+            (*this->depthCounter)--;
+        if (this->name != nullptr)
+            Trace::record(this->name, this->startNs, Trace::now() - this->startNs);
+    }
+
+    TraceSpan(TraceSpan const &) = delete;
+    TraceSpan& operator=(TraceSpan const &) = delete;
+
+    private:
+    const char* name = nullptr; /*!< Название, nullptr - участок не записывается */
+    int64_t startNs = 0; /*!< Время начала */
+    int* depthCounter = nullptr; /*!< Глубина рекурсии, уменьшаемая при выходе */
+};
+
+#ifdef CIRCUITMASTER_TRACE
+#define CORE_TRACE_CONCAT_IMPL(a, b) a##b
+#define CORE_TRACE_CONCAT(a, b) CORE_TRACE_CONCAT_IMPL(a, b)
+/*! Отметить участок до конца текущей области видимости */
+#define CORE_TRACE_SPAN(name) TraceSpan CORE_TRACE_CONCAT(coreTraceSpan, __LINE__)(name)
+/*! Отметить участок рекурсивной функции: записываются только вызовы до глубины Trace::getMaxDepth() */
+#define CORE_TRACE_RECURSIVE_SPAN(name) \
+    static thread_local int CORE_TRACE_CONCAT(coreTraceDepth, __LINE__) = 0; \
+    TraceSpan CORE_TRACE_CONCAT(coreTraceSpan, __LINE__)(name, CORE_TRACE_CONCAT(coreTraceDepth, __LINE__))
+#else
+#define CORE_TRACE_SPAN(name) ((void)0)
+#define CORE_TRACE_RECURSIVE_SPAN(name) ((void)0)
+#endif
+
+#endif // CORETRACE_H
@@ -0,0 +1,62 @@
+#include "documentNode.h"
+
+/*!
+*\file
+*\brief Реализация функций класса DocumentNode
+*/
+
+bool DocumentNode::isElement() const
+{
+    return !this->tagName.empty();
+}
+
+std::string DocumentNode::attribute(std::string const & name, std::string const & defaultValue) const
+{
+    for (auto iter = this->attributes.cbegin(); iter != this->attributes.cend(); iter++)
+    {
+        if (iter->first == name)
+            return iter->second;
+    }
+    return defaultValue;
+}
+
+std::string const * DocumentNode::findAttribute(std::string const & name) const
+{
+    for (auto iter = this->attributes.cbegin(); iter != this->attributes.cend(); iter++)
+    {
+        if (iter->first == name)
+            return &iter->second;
+    }
+    return nullptr;
+}
+
+DocumentNode const * DocumentNode::firstChildElement(std::string const & tag) const
+{
+    for (auto iter = this->children.cbegin(); iter != this->children.cend(); iter++)
+    {
+        if (iter->tagName == tag)
+            return &(*iter);
+    }
+    return nullptr;
+}
+
+std::string DocumentNode::textContent() const
+{
+    if (!this->isElement())
+        return this->text;
+
+    std::string result;
+    for (auto iter = this->children.cbegin(); iter != this->children.cend(); iter++)
+        result += iter->textContent();
+    return result;
+}
+
+void DocumentNode::elementsByTagName(std::string const & tag, std::vector<DocumentNode const *>& found) const
+{
+    for (auto iter = this->children.cbegin(); iter != this->children.cend(); iter++)
+    {
+        if (iter->tagName == tag)
+            found.push_back(&(*iter));
+        iter->elementsByTagName(tag, found);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef DOCUMENTNODE_H
+#define DOCUMENTNODE_H
+#include <string>
+#include <vector>
+#include <utility>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса DocumentNode
+*/
+
+/*!
+*\class DocumentNode
+*\brief Узел документа с описанием цепи, не зависящий от библиотеки разбора
+*
+* Узел является либо тэгом (имеет название, атрибуты и детей), либо текстом. Любой
+* разборщик документа (см. DocumentParser) преобразует входные данные в дерево таких узлов,
+* по которому затем строится дерево соединений цепи
+*/
+class DocumentNode
+{
+    public:
+    std::string tagName; /*!< Название тэга, пустое для текстового узла */
+    std::string text; /*!< Содержимое текстового узла */
+    int lineNumber = -1; /*!< Номер строки во входном файле */
+    std::vector<std::pair<std::string, std::string>> attributes; /*!< Атрибуты тэга в порядке следования */
+    std::vector<DocumentNode> children; /*!< Вложенные узлы */
+
+    /*!
+    * \brief Узнать, является ли узел тэгом
+    * \return - true, если узел является тэгом
+    */
+    bool isElement() const;
+
+    /*!
+    * \brief Получить значение атрибута тэга
+    * \param[in] name - название атрибута
+    * \param[in] defaultValue - значение, возвращаемое если атрибут не указан
+    * \return - значение атрибута
+    */
+    std::string attribute(std::string const & name, std::string const & defaultValue = "") const;
+
+    /*!
+    * \brief Найти значение атрибута тэга без копирования
+    * \param[in] name - название атрибута
+    * \return - указатель на значение атрибута или nullptr, если атрибут не указан
+    */
+    std::string const * findAttribute(std::string const & name) const;
+
+    /*!
+    * \brief Получить первый вложенный тэг с заданным названием
+    * \param[in] tag - название тэга
+    * \return - указатель на найденный тэг или nullptr, если такого тэга нет
+    */
+    DocumentNode const * firstChildElement(std::string const & tag) const;
+
+    /*!
+    * \brief Получить текст узла и всех вложенных в него узлов (аналог QDomElement::text)
+    * \return - объединенный текст
+    */
+    std::string textContent() const;
+
+    /*!
+    * \brief Найти все вложенные на любую глубину тэги с заданным названием (аналог QDomElement::elementsByTagName)
+    * \param[in] tag - название тэга
+    * \param[in,out] found - контейнер для записи указателей на найденные тэги в порядке следования в документе
+    */
+    void elementsByTagName(std::string const & tag, std::vector<DocumentNode const *>& found) const;
+};
+
+#endif // DOCUMENTNODE_H
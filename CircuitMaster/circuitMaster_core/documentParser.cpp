@@ -0,0 +1,71 @@
+#include "documentParser.h"
+#include <cstdio>
+#include <map>
+#include "allocationStats.h"
+#include "liteXmlParser.h"
+#include "perfCounters.h"
+#ifdef CIRCUITMASTER_QT_PARSER
+#include "qtDomParser.h"
+#endif
+
+/*!
+*\file
+*\brief Реализация функций класса DocumentParser
+*/
+
+/*!
+* \brief Получить реестр разборщиков, при первом обращении в него добавляются встроенные разборщики
+* \return - реестр разборщиков по имени
+*/
+static std::map<std::string, std::function<std::unique_ptr<DocumentParser>()>>& parserRegistry()
+{
+    static std::map<std::string, std::function<std::unique_ptr<DocumentParser>()>> registry = {
+        { "lite", []() { return std::unique_ptr<DocumentParser>(new LiteXmlParser()); } },
+#ifdef CIRCUITMASTER_QT_PARSER
+        { "qt", []() { return std::unique_ptr<DocumentParser>(new QtDomParser()); } },
+#endif
+    };
+    return registry;
+}
+
+DocumentNode DocumentParser::parseFile(std::string const & path) const
+{
+    CORE_ALLOCATION_PHASE(documentLoad);
+    CORE_PERF_PHASE(documentLoad);
+    std::string content;
+    if (!readWholeFile(path, content))
+        throw std::string("Неверно указан файл для входных данных. Возможно указанного расположения не существует или нет прав на запись.");
+    return this->parseText(content);
+}
+
+void DocumentParser::registerParser(std::string const & name, std::function<std::unique_ptr<DocumentParser>()> factory)
+{
+    parserRegistry()[name] = factory;
+}
+
+std::unique_ptr<DocumentParser> DocumentParser::create(std::string const & name)
+{
+    std::string parserName = name.empty() ? "lite" : name;
+    auto found = parserRegistry().find(parserName);
+    if (found == parserRegistry().end())
+        throw std::string("Неизвестный разборщик входных данных \"" + parserName + "\".");
+    return found->second();
+}
+
+bool readWholeFile(std::string const & path, std::string& content)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    // Читаем файл блоками, размер файла заранее не запрашиваем
+    content.clear();
+    char buf[65536];
+    size_t readCount;
+    while ((readCount = std::fread(buf, 1, sizeof(buf), file)) > 0)
+        content.append(buf, readCount);
+
+    bool isOk = std::ferror(file) == 0;
+    std::fclose(file);
+    return isOk;
+}
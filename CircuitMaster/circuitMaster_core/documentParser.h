@@ -0,0 +1,63 @@
+#ifndef DOCUMENTPARSER_H
+#define DOCUMENTPARSER_H
+#include <string>
+#include <memory>
+#include <functional>
+#include "documentNode.h"
+
+/*!
+*\file
+*\brief Заголовки функций класса DocumentParser
+*/
+
+/*!
+*\class DocumentParser
+*\brief Разборщик документа с описанием цепи
+*
+* Преобразует входной файл в дерево DocumentNode. Конкретные разборщики регистрируются
+* по имени и выбираются во время выполнения, что позволяет собирать ядро программы
+* как с Qt, так и без него. При синтаксической ошибке разборщик выбрасывает std::string
+*/
+class DocumentParser
+{
+    public:
+    virtual ~DocumentParser() = default;
+
+    /*!
+    * \brief Разобрать текст документа
+    * \param[in] content - текст документа
+    * \return - корневой тэг документа
+    */
+    virtual DocumentNode parseText(std::string const & content) const = 0;
+
+    /*!
+    * \brief Разобрать файл. По умолчанию читает файл целиком и вызывает parseText
+    * \param[in] path - путь к файлу
+    * \return - корневой тэг документа
+    */
+    virtual DocumentNode parseFile(std::string const & path) const;
+
+    /*!
+    * \brief Зарегистрировать разборщик
+    * \param[in] name - имя разборщика
+    * \param[in] factory - функция создания разборщика
+    */
+    static void registerParser(std::string const & name, std::function<std::unique_ptr<DocumentParser>()> factory);
+
+    /*!
+    * \brief Создать разборщик по имени
+    * \param[in] name - имя разборщика, пустая строка означает разборщик по умолчанию ("lite")
+    * \return - созданный разборщик
+    */
+    static std::unique_ptr<DocumentParser> create(std::string const & name = "");
+};
+
+/*!
+* \brief Прочитать файл целиком
+* \param[in] path - путь к файлу
+* \param[out] content - содержимое файла
+* \return - true, если файл удалось прочитать
+*/
+bool readWholeFile(std::string const & path, std::string& content);
+
+#endif // DOCUMENTPARSER_H
@@ -0,0 +1,110 @@
+#include "faultAnalysis.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "circuitState.h"
+#include "coreTrace.h"
+#include "pathEvaluator.h"
+
+/*!
+*\file
+*\brief Реализация функций класса FaultAnalysis
+*/
+
+namespace {
+
+// Количество аварий, которые поток берет за один раз
+const size_t scenarioChunk = 64;
+
+}
+
+FaultAnalysis FaultAnalysis::evaluate(CircuitTopology const & topology, unsigned threadCount)
+{
+    std::vector<int> outputNodes;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            outputNodes.push_back(static_cast<int>(n));
+    }
+    return evaluate(topology, outputNodes, threadCount);
+}
+
+FaultAnalysis FaultAnalysis::evaluate(CircuitTopology const & topology, std::vector<int> const & outputNodes, unsigned threadCount)
+{
+    CORE_TRACE_SPAN("FaultAnalysis::evaluate");
+    CircuitState base;
+    base.evaluate(topology);
+
+    FaultAnalysis analysis;
+    for (size_t o = 0; o < outputNodes.size(); o++)
+    {
+        analysis.names.push_back(topology.nodes[outputNodes[o]].displayName());
+        analysis.baseCurrents.push_back(base.currents[outputNodes[o]]);
+    }
+
+    // Обрыв и замыкание каждого элемента. Элементы хранятся в порядке соединений, поэтому аварии идут по номерам элементов
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        CircuitTopology::Node const & node = topology.nodes[n];
+        for (int e = 0; e < node.elementCount; e++)
+        {
+            for (FaultType type : { FaultType::open, FaultType::shorted })
+                analysis.scenarios.push_back({ static_cast<size_t>(node.firstElement + e), static_cast<int>(n), e + 1, type, std::string() });
+        }
+    }
+
+    size_t scenarioCount = analysis.scenarios.size();
+    size_t outputCount = outputNodes.size();
+    analysis.currents.assign(scenarioCount * outputCount, 0);
+    if (scenarioCount == 0)
+        return analysis;
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = (scenarioCount + scenarioChunk - 1) / scenarioChunk;
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, chunkCount));
+
+    // Каждая авария записывается на своё место, поэтому результат не зависит от потоков
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        PathEvaluator evaluator(topology, base);
+        for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+        {
+            for (size_t s = chunk * scenarioChunk; s < std::min(scenarioCount, (chunk + 1) * scenarioChunk); s++)
+            {
+                Scenario& scenario = analysis.scenarios[s];
+                evaluator.reset();
+                evaluator.setElementResistance(scenario.element, scenario.type == FaultType::open ? PathEvaluator::openResistance() : 0);
+                try {
+                    for (size_t o = 0; o < outputCount; o++)
+                        analysis.currents[s * outputCount + o] = evaluator.current(outputNodes[o]);
+                } catch (std::string const & str) {
+                    scenario.error = str;
+                }
+            }
+        }
+    };
+
+    if (threadCount == 1)
+        worker();
+    else
+    {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]() {
+                if (Trace::isEnabled())
+                    Trace::setThreadName("faults " + std::to_string(t + 1));
+                worker();
+            });
+        }
+        for (auto iter = threads.begin(); iter != threads.end(); iter++)
+            iter->join();
+    }
+    return analysis;
+}
+
+std::complex<double> FaultAnalysis::current(size_t scenario, size_t output) const
+{
+    return this->currents[scenario * this->names.size() + output];
+}
@@ -0,0 +1,82 @@
+#ifndef FAULTANALYSIS_H
+#define FAULTANALYSIS_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета цепи при замыкании или обрыве каждого элемента
+*/
+
+/*!
+*\class FaultAnalysis
+*\brief Силы тока выбранных соединений при замыкании и обрыве каждого элемента цепи по очереди
+*
+* Исходная цепь рассчитывается один раз. Для каждой аварии пересчитываются только сопротивления
+* соединений на пути от элемента до корня и силы тока на путях от корня до выбранных соединений
+* (см. PathEvaluator), поэтому время расчета одной аварии зависит от глубины дерева, а не от
+* количества элементов. Аварии рассчитываются параллельно
+*/
+class FaultAnalysis
+{
+    public:
+    /*!
+    *\enum FaultType
+    *\brief Вид аварии
+    */
+    enum class FaultType
+    {
+        open, /*!< Обрыв: сопротивление элемента бесконечно */
+        shorted /*!< Замыкание: сопротивление элемента равно 0 */
+    };
+
+    /*!
+    *\class Scenario
+    *\brief Авария одного элемента
+    */
+    class Scenario
+    {
+        public:
+        size_t element; /*!< Номер элемента в топологии */
+        int node; /*!< Номер соединения, которому принадлежит элемент */
+        int position; /*!< Номер элемента в соединении, начиная с 1 */
+        FaultType type; /*!< Вид аварии */
+        std::string error; /*!< Ошибка расчета, пустая строка - расчет выполнен */
+    };
+
+    std::vector<std::string> names; /*!< Имена выбранных соединений */
+    std::vector<std::complex<double>> baseCurrents; /*!< Силы тока выбранных соединений в исходной цепи */
+    std::vector<Scenario> scenarios; /*!< Аварии: обрыв и замыкание каждого элемента по порядку */
+    std::vector<std::complex<double>> currents; /*!< Силы тока: [номер аварии * количество выбранных соединений + номер соединения] */
+
+    /*!
+    * \brief Рассчитать силы тока выбранных соединений при авариях всех элементов
+    *
+    * Ошибка расчета исходной цепи сообщается исключением std::string, ошибки аварий сохраняются в Scenario::error
+    * \param[in] topology - топология цепи
+    * \param[in] outputNodes - номера соединений, силы тока которых нужно рассчитывать
+    * \param[in] threadCount - количество потоков, 0 - по числу ядер
+    * \return - силы тока при авариях
+    */
+    static FaultAnalysis evaluate(CircuitTopology const & topology, std::vector<int> const & outputNodes, unsigned threadCount = 0);
+
+    /*!
+    * \brief Рассчитать силы тока соединений с указанным именем при авариях всех элементов
+    * \param[in] topology - топология цепи
+    * \param[in] threadCount - количество потоков, 0 - по числу ядер
+    * \return - силы тока при авариях
+    */
+    static FaultAnalysis evaluate(CircuitTopology const & topology, unsigned threadCount = 0);
+
+    /*!
+    * \brief Получить силу тока выбранного соединения при аварии
+    * \param[in] scenario - номер аварии
+    * \param[in] output - номер соединения среди выбранных
+    * \return - комплексная сила тока
+    */
+    std::complex<double> current(size_t scenario, size_t output) const;
+};
+
+#endif // FAULTANALYSIS_H
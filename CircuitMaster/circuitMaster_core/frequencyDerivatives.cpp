@@ -0,0 +1,73 @@
+#include "frequencyDerivatives.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций класса FrequencyDerivatives
+*/
+
+void FrequencyDerivatives::evaluate(CircuitTopology const & topology, CircuitState const & state)
+{
+    CORE_TRACE_SPAN("FrequencyDerivatives::evaluate");
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    std::vector<std::complex<double>> const & resistances = state.resistances;
+    size_t nodeCount = nodes.size();
+    this->resistances.assign(nodeCount, 0);
+    this->voltages.assign(nodeCount, 0);
+    this->currents.assign(nodeCount, 0);
+
+    // Производные сопротивлений: дети расположены после родителя, поэтому обходим соединения с конца
+    for (size_t n = nodeCount; n-- > 0;)
+    {
+        CircuitTopology::Node const & node = nodes[n];
+        std::complex<double> sum = 0;
+        if (node.type == CoreConnection::ConnectionType::sequential)
+        {
+            for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+            {
+                if (topology.elementTypes[e] == CoreElement::ElemType::L)
+                    sum += state.elementResistances[e];
+                else if (topology.elementTypes[e] == CoreElement::ElemType::C)
+                    sum -= state.elementResistances[e];
+            }
+        }
+        else
+        {
+            bool isParallel = node.type == CoreConnection::ConnectionType::parallel;
+            for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+            {
+                int child = topology.childIndices[c];
+                sum += isParallel ? this->resistances[child] / (resistances[child] * resistances[child]) : this->resistances[child];
+            }
+            if (isParallel)
+                sum *= resistances[n] * resistances[n];
+        }
+        this->resistances[n] = sum;
+    }
+
+    // Напряжение корневого соединения от частоты не зависит
+    this->currents[0] = -state.voltages[0] * this->resistances[0] / (resistances[0] * resistances[0]);
+
+    // Дети последовательного соединения получают силу тока родителя, параллельного - напряжение
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        CircuitTopology::Node const & node = nodes[n];
+        bool isParallel = node.type == CoreConnection::ConnectionType::parallel;
+        for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+        {
+            int child = topology.childIndices[c];
+            std::complex<double> resistance = resistances[child];
+            if (isParallel)
+            {
+                this->voltages[child] = this->voltages[n];
+                this->currents[child] = this->voltages[n] / resistance -
+                                        state.voltages[n] * this->resistances[child] / (resistance * resistance);
+            }
+            else
+            {
+                this->currents[child] = this->currents[n];
+                this->voltages[child] = this->currents[n] * resistance + state.currents[n] * this->resistances[child];
+            }
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef FREQUENCYDERIVATIVES_H
+#define FREQUENCYDERIVATIVES_H
+#include <complex>
+#include <vector>
+#include "circuitState.h"
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета производных цепи по частоте
+*/
+
+/*!
+*\class FrequencyDerivatives
+*\brief Производные сопротивлений и сил тока всех соединений по логарифму частоты
+*
+* Производная сопротивления катушки по логарифму частоты равна её сопротивлению, конденсатора -
+* её сопротивлению с минусом, резистора - 0. Производные соединений считаются по тем же правилам, что
+* и сопротивления: у последовательного - сумма производных детей, у параллельного - сумма производных
+* детей, умноженных на (Z / Z ребенка)^2. Затем производные силы тока и напряжения передаются от корня
+* к детям. Расчет занимает один обход топологии в каждую сторону
+*/
+class FrequencyDerivatives
+{
+    public:
+    std::vector<std::complex<double>> resistances; /*!< Производные сопротивлений соединений в порядке топологии */
+    std::vector<std::complex<double>> currents; /*!< Производные сил тока соединений в порядке топологии */
+
+    /*!
+    * \brief Рассчитать производные по рассчитанной цепи
+    * \param[in] topology - топология цепи
+    * \param[in] state - расчет цепи на частоте, для которой нужны производные
+    */
+    void evaluate(CircuitTopology const & topology, CircuitState const & state);
+
+    private:
+    std::vector<std::complex<double>> voltages; /*!< Производные напряжений соединений в порядке топологии */
+};
+
+#endif // FREQUENCYDERIVATIVES_H
@@ -0,0 +1,182 @@
+#include "goalSeek.h"
+#include <algorithm>
+#include <cmath>
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "frequencyDerivatives.h"
+#include "pathEvaluator.h"
+
+/*!
+*\file
+*\brief Реализация функций класса GoalSeek
+*/
+
+namespace {
+
+// Наибольшее изменение логарифма значения за одну итерацию: значение изменяется не более чем в 10 раз
+const double maxLogStep = std::log(10.0);
+
+}
+
+std::complex<double> GoalSeek::currentWithDerivative(CircuitTopology const & topology, std::vector<std::complex<double>> const & resistances,
+                                                     std::vector<std::complex<double>> const & derivatives, std::complex<double> voltage,
+                                                     int node, std::complex<double>& derivative)
+{
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    std::vector<int> path;
+    for (int n = node; n >= 0; n = nodes[n].parent)
+        path.push_back(n);
+
+    // Корневому соединению задано напряжение, не зависящее от подбираемого значения
+    std::complex<double> rootResistance = resistances[0];
+    std::complex<double> current = voltage / rootResistance;
+    std::complex<double> currentDerivative = -voltage * derivatives[0] / (rootResistance * rootResistance);
+    std::complex<double> voltageDerivative = 0;
+
+    for (size_t i = path.size() - 1; i-- > 0;)
+    {
+        int child = path[i];
+        std::complex<double> resistance = resistances[child];
+        std::complex<double> resistanceDerivative = derivatives[child];
+
+        // Дети последовательного соединения получают силу тока родителя, параллельного - напряжение
+        if (nodes[nodes[child].parent].type == CoreConnection::ConnectionType::sequentialComplex)
+        {
+            voltageDerivative = currentDerivative * resistance + current * resistanceDerivative;
+            voltage = current * resistance;
+        }
+        else
+        {
+            currentDerivative = voltageDerivative / resistance - voltage * resistanceDerivative / (resistance * resistance);
+            current = voltage / resistance;
+        }
+    }
+    derivative = currentDerivative;
+    return current;
+}
+
+bool GoalSeek::newtonStep(std::complex<double> current, std::complex<double> derivative, CurrentTarget const & target,
+                          double tolerance, double& logValue)
+{
+    double magnitude = std::abs(current);
+    double residual = magnitude - target.current;
+    if (std::abs(residual) <= tolerance * target.current)
+        return true;
+
+    // Производная модуля - проекция производной силы тока на её направление
+    double slope = magnitude > 0 ? std::real(std::conj(current) * derivative) / magnitude : std::abs(derivative);
+    if (slope == 0 || !std::isfinite(slope))
+        throw std::string("Сила тока не зависит от подбираемого значения: производная равна 0.");
+
+    logValue += std::max(-maxLogStep, std::min(maxLogStep, -residual / slope));
+    return false;
+}
+
+GoalSeek GoalSeek::solveElement(CircuitTopology const & topology, OptimizationVariable const & variable, CurrentTarget const & target,
+                                double tolerance)
+{
+    CORE_TRACE_SPAN("GoalSeek::solveElement");
+    if (!(variable.nominal > 0))
+        throw formatStr("Значение элемента %1 соединения %2 должно быть больше 0, чтобы начать подбор.",
+                        { numberToStr(variable.position), topology.nodes[variable.node].displayName() });
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    CircuitState base;
+    base.evaluate(topology);
+    PathEvaluator evaluator(topology, base);
+
+    std::vector<int> elementPath;
+    for (int n = evaluator.elementNode(variable.element); n >= 0; n = nodes[n].parent)
+        elementPath.push_back(n);
+    std::vector<int> outputPath;
+    for (int n = target.node; n >= 0; n = nodes[n].parent)
+        outputPath.push_back(n);
+
+    // Производные не равны 0 только на пути от элемента до корня
+    std::vector<std::complex<double>> resistances(nodes.size());
+    std::vector<std::complex<double>> derivatives(nodes.size());
+    bool isCapacitor = topology.elementTypes[variable.element] == CoreElement::ElemType::C;
+    double logValue = std::log(variable.nominal);
+
+    for (int iteration = 1; iteration <= maxIterations; iteration++)
+    {
+        double value = std::exp(logValue);
+        std::complex<double> elementResistance = variable.resistance(topology, value);
+        evaluator.reset();
+        evaluator.setElementResistance(variable.element, elementResistance);
+
+        // Производная сопротивления элемента по логарифму значения равна его сопротивлению (для конденсатора - с минусом)
+        for (size_t i = 0; i < elementPath.size(); i++)
+        {
+            int node = elementPath[i];
+            resistances[node] = evaluator.resistance(node);
+            if (i == 0)
+                derivatives[node] = isCapacitor ? -elementResistance : elementResistance;
+            else if (nodes[node].type == CoreConnection::ConnectionType::parallel)
+            {
+                std::complex<double> ratio = resistances[node] / resistances[elementPath[i - 1]];
+                derivatives[node] = derivatives[elementPath[i - 1]] * ratio * ratio;
+            }
+            else
+                derivatives[node] = derivatives[elementPath[i - 1]];
+        }
+        for (auto iter = outputPath.cbegin(); iter != outputPath.cend(); iter++)
+            resistances[*iter] = evaluator.resistance(*iter);
+
+        std::complex<double> derivative;
+        std::complex<double> current = currentWithDerivative(topology, resistances, derivatives, base.voltages[0], target.node, derivative);
+        if (newtonStep(current, derivative, target, tolerance, logValue))
+        {
+            GoalSeek result;
+            result.value = value;
+            result.iterations = iteration;
+            CircuitTopology changed = topology;
+            changed.elementResistances[variable.element] = elementResistance;
+            result.state.evaluate(changed);
+            return result;
+        }
+    }
+    throw formatStr("Не удалось подобрать значение за %1 итераций. Возможно, требуемая сила тока недостижима.", { numberToStr(maxIterations) });
+}
+
+GoalSeek GoalSeek::solveVoltage(CircuitTopology const & topology, CurrentTarget const & target)
+{
+    CORE_TRACE_SPAN("GoalSeek::solveVoltage");
+    CircuitState base;
+    base.evaluate(topology);
+    double current = std::abs(base.currents[target.node]);
+    if (current == 0)
+        throw std::string("Сила тока не зависит от подбираемого значения: производная равна 0.");
+
+    // Сила тока пропорциональна напряжению: шаг метода Ньютона сразу дает решение
+    double voltage = std::abs(topology.rootVoltage);
+    GoalSeek result;
+    result.value = voltage * target.current / current;
+    result.iterations = 1;
+    result.state.evaluate(topology, topology.rootVoltage * (result.value / voltage));
+    return result;
+}
+
+GoalSeek GoalSeek::solveFrequency(CircuitTopology const & topology, CurrentTarget const & target, double tolerance)
+{
+    CORE_TRACE_SPAN("GoalSeek::solveFrequency");
+    if (topology.frequency <= 0)
+        throw std::string("Для подбора частоты необходимо указать частоту \"frequency\" как атрибут корневого элемента цепи.");
+
+    GoalSeek result;
+    FrequencyDerivatives derivatives;
+    double logValue = std::log(topology.frequency);
+
+    for (int iteration = 1; iteration <= maxIterations; iteration++)
+    {
+        double frequency = std::exp(logValue);
+        result.state.evaluate(topology, topology.rootVoltage, frequency);
+        derivatives.evaluate(topology, result.state);
+        if (newtonStep(result.state.currents[target.node], derivatives.currents[target.node], target, tolerance, logValue))
+        {
+            result.value = frequency;
+            result.iterations = iteration;
+            return result;
+        }
+    }
+    throw formatStr("Не удалось подобрать значение за %1 итераций. Возможно, требуемая сила тока недостижима.", { numberToStr(maxIterations) });
+}
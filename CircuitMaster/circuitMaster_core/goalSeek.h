@@ -0,0 +1,96 @@
+#ifndef GOALSEEK_H
+#define GOALSEEK_H
+#include <complex>
+#include <vector>
+#include "circuitState.h"
+#include "circuitTopology.h"
+#include "componentOptimizer.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций подбора одного значения цепи под требуемую силу тока
+*/
+
+/*!
+*\class GoalSeek
+*\brief Значение элемента, напряжения или частоты, при котором модуль силы тока соединения равен требуемому
+*
+* Уравнение |I(x)| = I требуемое решается методом Ньютона по логарифму значения, поэтому значение
+* остается положительным, а шаг ограничен изменением в 10 раз. Производная силы тока считается
+* точно, по тем же правилам, что и расчет цепи: производная сопротивления последовательного
+* соединения - сумма производных детей, параллельного - сумма производных детей, умноженных на
+* (Z / Z ребенка)^2, затем производные силы тока и напряжения передаются от корня к соединению.
+*
+* Для элемента на каждой итерации пересчитываются только соединения на пути от элемента до корня
+* и на пути от корня до соединения (см. PathEvaluator). Изменение частоты меняет все катушки и
+* конденсаторы, поэтому итерация рассчитывает всю цепь (см. FrequencyDerivatives). Сила тока пропорциональна напряжению,
+* поэтому напряжение находится за одну итерацию
+*/
+class GoalSeek
+{
+    public:
+    static const int maxIterations = 50; /*!< Наибольшее количество итераций */
+
+    double value = 0; /*!< Найденное значение */
+    int iterations = 0; /*!< Количество выполненных итераций */
+    CircuitState state; /*!< Расчет цепи с найденным значением */
+
+    /*!
+    * \brief Подобрать значение элемента
+    *
+    * Ошибки сообщаются исключением std::string, в том числе если метод не сошелся
+    * \param[in] topology - топология цепи
+    * \param[in] variable - элемент и его значение во входных данных, с которого начинается поиск. Список values не используется
+    * \param[in] target - требуемая сила тока
+    * \param[in] tolerance - допустимое относительное отклонение модуля силы тока
+    * \return - найденное значение
+    */
+    static GoalSeek solveElement(CircuitTopology const & topology, OptimizationVariable const & variable, CurrentTarget const & target,
+                                 double tolerance = 1e-10);
+
+    /*!
+    * \brief Подобрать действующее значение напряжения корневого соединения, фаза напряжения сохраняется
+    * \param[in] topology - топология цепи
+    * \param[in] target - требуемая сила тока
+    * \return - найденное значение
+    */
+    static GoalSeek solveVoltage(CircuitTopology const & topology, CurrentTarget const & target);
+
+    /*!
+    * \brief Подобрать частоту переменного тока
+    * \param[in] topology - топология цепи с известной частотой, с которой начинается поиск
+    * \param[in] target - требуемая сила тока
+    * \param[in] tolerance - допустимое относительное отклонение модуля силы тока
+    * \return - найденное значение
+    */
+    static GoalSeek solveFrequency(CircuitTopology const & topology, CurrentTarget const & target, double tolerance = 1e-10);
+
+    private:
+    /*!
+    * \brief Рассчитать силу тока соединения и её производную на пути от корня
+    * \param[in] topology - топология цепи
+    * \param[in] resistances - сопротивления соединений на пути
+    * \param[in] derivatives - производные сопротивлений соединений на пути
+    * \param[in] voltage - напряжение корневого соединения
+    * \param[in] node - номер соединения
+    * \param[out] derivative - производная силы тока
+    * \return - сила тока
+    */
+    static std::complex<double> currentWithDerivative(CircuitTopology const & topology, std::vector<std::complex<double>> const & resistances,
+                                                      std::vector<std::complex<double>> const & derivatives, std::complex<double> voltage,
+                                                      int node, std::complex<double>& derivative);
+
+    /*!
+    * \brief Выполнить шаг метода Ньютона по логарифму значения
+    * \param[in] current - сила тока при текущем значении
+    * \param[in] derivative - производная силы тока по логарифму значения
+    * \param[in] target - требуемая сила тока
+    * \param[in] tolerance - допустимое относительное отклонение
+    * \param[in,out] logValue - логарифм значения
+    * \return - true, если требуемая сила тока достигнута и шаг не нужен
+    */
+    static bool newtonStep(std::complex<double> current, std::complex<double> derivative, CurrentTarget const & target,
+                           double tolerance, double& logValue);
+};
+
+#endif // GOALSEEK_H
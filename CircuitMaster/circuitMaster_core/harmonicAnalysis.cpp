@@ -0,0 +1,84 @@
+#include "harmonicAnalysis.h"
+#include <cmath>
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "variantEvaluator.h"
+
+/*!
+*\file
+*\brief Реализация функций класса HarmonicAnalysis
+*/
+
+HarmonicAnalysis HarmonicAnalysis::evaluate(CircuitTopology const & topology, std::vector<Harmonic> const & harmonics)
+{
+    std::vector<int> outputNodes;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            outputNodes.push_back(static_cast<int>(n));
+    }
+    return evaluate(topology, harmonics, outputNodes);
+}
+
+HarmonicAnalysis HarmonicAnalysis::evaluate(CircuitTopology const & topology, std::vector<Harmonic> const & harmonics,
+                                            std::vector<int> const & outputNodes)
+{
+    CORE_TRACE_SPAN("HarmonicAnalysis::evaluate");
+    size_t count = harmonics.size();
+
+    // Каждая гармоника - вариант цепи со своими сопротивлениями катушек и конденсаторов и своим напряжением
+    VariantBatch batch(topology, count);
+    for (size_t h = 0; h < count; h++)
+    {
+        if (harmonics[h].order <= 0)
+            throw formatStr("Недопустимый номер гармоники %1. Номер гармоники должен быть больше 0.", { numberToStr(harmonics[h].order) });
+        batch.setVoltage(h, harmonics[h].voltage);
+    }
+
+    for (size_t e = 0; e < topology.elementResistances.size(); e++)
+    {
+        CoreElement::ElemType type = topology.elementTypes[e];
+        if (type != CoreElement::ElemType::L && type != CoreElement::ElemType::C)
+            continue;
+
+        if (topology.frequency <= 0)
+            throw std::string("Для расчета цепи на гармониках необходимо указать частоту \"frequency\" "
+                              "как атрибут корневого элемента цепи.");
+        for (size_t h = 0; h < count; h++)
+        {
+            double order = harmonics[h].order;
+            batch.setElementResistance(e, h, topology.elementResistances[e] * (type == CoreElement::ElemType::L ? order : 1 / order));
+        }
+    }
+
+    VariantResults results = VariantEvaluator(topology).evaluate(batch, outputNodes);
+    for (size_t h = 0; h < count; h++)
+    {
+        if (!results.errors[h].empty())
+            throw formatStr("Гармоника %1: %2", { numberToStr(harmonics[h].order), results.errors[h] });
+    }
+
+    HarmonicAnalysis analysis;
+    for (size_t h = 0; h < count; h++)
+        analysis.orders.push_back(harmonics[h].order);
+    for (size_t o = 0; o < outputNodes.size(); o++)
+    {
+        analysis.names.push_back(topology.nodes[outputNodes[o]].displayName());
+        for (size_t h = 0; h < count; h++)
+            analysis.currents.push_back(results.current(outputNodes[o], h));
+    }
+    return analysis;
+}
+
+std::complex<double> HarmonicAnalysis::current(size_t output, size_t harmonic) const
+{
+    return this->currents[output * this->orders.size() + harmonic];
+}
+
+double HarmonicAnalysis::rmsCurrent(size_t output) const
+{
+    double sum = 0;
+    for (size_t h = 0; h < this->orders.size(); h++)
+        sum += std::norm(this->current(output, h));
+    return std::sqrt(sum);
+}
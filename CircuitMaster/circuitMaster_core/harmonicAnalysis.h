@@ -0,0 +1,77 @@
+#ifndef HARMONICANALYSIS_H
+#define HARMONICANALYSIS_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета цепи с несинусоидальным напряжением
+*/
+
+/*!
+*\class Harmonic
+*\brief Гармоника напряжения источника
+*/
+class Harmonic
+{
+    public:
+    double order; /*!< Номер гармоники: отношение её частоты к частоте исходной цепи */
+    std::complex<double> voltage; /*!< Комплексное действующее значение напряжения гармоники */
+};
+
+/*!
+*\class HarmonicAnalysis
+*\brief Силы тока выбранных соединений на каждой гармонике напряжения источника и их действующие значения
+*
+* Несинусоидальное напряжение раскладывается на гармоники, и цепь рассчитывается на каждой из них
+* отдельно: сопротивления катушек умножаются на номер гармоники, конденсаторов - делятся на него.
+* Гармоники рассчитываются как варианты одной топологии (см. VariantEvaluator) за один обход
+* соединений, векторными командами. Действующее значение силы тока - корень из суммы квадратов
+* действующих значений гармоник
+*/
+class HarmonicAnalysis
+{
+    public:
+    std::vector<double> orders; /*!< Номера гармоник */
+    std::vector<std::string> names; /*!< Имена выбранных соединений */
+    std::vector<std::complex<double>> currents; /*!< Силы тока: [номер соединения среди выбранных * количество гармоник + номер гармоники] */
+
+    /*!
+    * \brief Рассчитать силы тока выбранных соединений на гармониках
+    *
+    * Ошибки расчета сообщаются исключением std::string с номером гармоники
+    * \param[in] topology - топология цепи
+    * \param[in] harmonics - гармоники напряжения источника
+    * \param[in] outputNodes - номера соединений, силы тока которых нужно рассчитывать
+    * \return - силы тока на гармониках
+    */
+    static HarmonicAnalysis evaluate(CircuitTopology const & topology, std::vector<Harmonic> const & harmonics,
+                                     std::vector<int> const & outputNodes);
+
+    /*!
+    * \brief Рассчитать силы тока соединений с указанным именем на гармониках
+    * \param[in] topology - топология цепи
+    * \param[in] harmonics - гармоники напряжения источника
+    * \return - силы тока на гармониках
+    */
+    static HarmonicAnalysis evaluate(CircuitTopology const & topology, std::vector<Harmonic> const & harmonics);
+
+    /*!
+    * \brief Получить силу тока выбранного соединения на гармонике
+    * \param[in] output - номер соединения среди выбранных
+    * \param[in] harmonic - номер гармоники в списке гармоник
+    * \return - комплексная сила тока
+    */
+    std::complex<double> current(size_t output, size_t harmonic) const;
+
+    /*!
+    * \brief Получить действующее значение силы тока выбранного соединения по всем гармоникам
+    * \param[in] output - номер соединения среди выбранных
+    * \return - действующее значение силы тока
+    */
+    double rmsCurrent(size_t output) const;
+};
+
+#endif // HARMONICANALYSIS_H
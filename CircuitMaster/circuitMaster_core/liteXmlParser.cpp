@@ -0,0 +1,337 @@
+#include "liteXmlParser.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include "allocationStats.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "perfCounters.h"
+
+/*!
+*\file
+*\brief Реализация функций класса LiteXmlParser
+*/
+
+namespace
+{
+
+/*!
+*\class LiteXmlReader
+*\brief Состояние разбора одного документа
+*/
+class LiteXmlReader
+{
+    public:
+    LiteXmlReader(std::string const & startContent) : content(startContent) {}
+
+    std::string const & content; /*!< Текст документа */
+    size_t pos = 0; /*!< Текущая позиция */
+    int line = 1; /*!< Текущая строка */
+
+    /*!
+    * \brief Выбросить ошибку разбора с указанием текущей строки
+    * \param[in] message - описание ошибки
+    */
+    [[noreturn]] void fail(std::string const & message) const
+    {
+        throw formatStr("Получена ошибка разбора xml файла: \"%1\" на строке %2.", { message, numberToStr(this->line) });
+    }
+
+    bool atEnd() const
+    {
+        return this->pos >= this->content.size();
+    }
+
+    bool startsWith(char const * str) const
+    {
+        return this->content.compare(this->pos, std::strlen(str), str) == 0;
+    }
+
+    /*!
+    * \brief Сдвинуть позицию на count символов с подсчетом строк
+    */
+    void advance(size_t count)
+    {
+        for (size_t i = 0; i < count && !this->atEnd(); i++, this->pos++)
+        {
+            if (this->content[this->pos] == '\n')
+                this->line++;
+        }
+    }
+
+    /*!
+    * \brief Пропустить всё до строки terminator включительно
+    */
+    void skipPast(char const * terminator, char const * what)
+    {
+        size_t found = this->content.find(terminator, this->pos);
+        if (found == std::string::npos)
+            this->fail(formatStr("незавершенный %1", { what }));
+        this->advance(found - this->pos + std::strlen(terminator));
+    }
+
+    void skipSpaces()
+    {
+        while (!this->atEnd() && std::strchr(" \t\r\n", this->content[this->pos]) != nullptr)
+            this->advance(1);
+    }
+
+    static bool isNameChar(char ch)
+    {
+        return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '-' || ch == '.' || ch == ':'
+               || static_cast<unsigned char>(ch) >= 0x80;
+    }
+
+    std::string readName()
+    {
+        size_t start = this->pos;
+        while (!this->atEnd() && isNameChar(this->content[this->pos]))
+            this->pos++;
+        if (start == this->pos)
+            this->fail("ожидалось имя");
+        return this->content.substr(start, this->pos - start);
+    }
+
+    /*!
+    * \brief Заменить стандартные сущности и ссылки на символы в строке
+    */
+    std::string decodeEntities(std::string const & raw) const
+    {
+        if (raw.find('&') == std::string::npos)
+            return raw;
+
+        std::string result;
+        result.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); i++)
+        {
+            if (raw[i] != '&')
+            {
+                result += raw[i];
+                continue;
+            }
+
+            size_t semicolon = raw.find(';', i);
+            if (semicolon == std::string::npos)
+                this->fail("незавершенная ссылка на сущность");
+            std::string entity = raw.substr(i + 1, semicolon - i - 1);
+
+            if (entity == "lt")
+                result += '<';
+            else if (entity == "gt")
+                result += '>';
+            else if (entity == "amp")
+                result += '&';
+            else if (entity == "quot")
+                result += '"';
+            else if (entity == "apos")
+                result += '\'';
+            else if (entity.size() > 1 && entity[0] == '#')
+            {
+                // Ссылка на символ, записываем его в кодировке UTF-8
+                unsigned long code = entity[1] == 'x' ? std::strtoul(entity.c_str() + 2, nullptr, 16)
+                                                      : std::strtoul(entity.c_str() + 1, nullptr, 10);
+                if (code < 0x80)
+                    result += static_cast<char>(code);
+                else if (code < 0x800)
+                {
+                    result += static_cast<char>(0xC0 | (code >> 6));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    result += static_cast<char>(0xE0 | (code >> 12));
+                    result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    result += static_cast<char>(0xF0 | (code >> 18));
+                    result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+            else
+                this->fail(formatStr("неизвестная сущность \"%1\"", { entity }));
+
+            i = semicolon;
+        }
+        return result;
+    }
+
+    /*!
+    * \brief Пропустить объявление xml, комментарии, инструкции обработки и DOCTYPE
+    * \return - true, если что-то было пропущено
+    */
+    bool skipMisc()
+    {
+        if (this->startsWith("<?"))
+            this->skipPast("?>", "инструкция обработки");
+        else if (this->startsWith("<!--"))
+            this->skipPast("-->", "комментарий");
+        else if (this->startsWith("<!DOCTYPE"))
+        {
+            if (this->content.find('[', this->pos) < this->content.find('>', this->pos))
+                this->fail("внутренние определения DOCTYPE не поддерживаются");
+            this->skipPast(">", "DOCTYPE");
+        }
+        else
+            return false;
+        return true;
+    }
+
+    /*!
+    * \brief Разобрать тэг, начинающийся с текущей позиции, и всё его содержимое
+    */
+    void readElement(DocumentNode& node)
+    {
+        node.lineNumber = this->line;
+        this->advance(1);
+        node.tagName = this->readName();
+
+        // Атрибуты
+        while (true)
+        {
+            this->skipSpaces();
+            if (this->atEnd())
+                this->fail("незавершенный тэг");
+
+            char ch = this->content[this->pos];
+            if (ch == '/')
+            {
+                if (!this->startsWith("/>"))
+                    this->fail("ожидался символ '>'");
+                this->advance(2);
+                return;
+            }
+            if (ch == '>')
+            {
+                this->advance(1);
+                break;
+            }
+
+            std::string attrName = this->readName();
+            this->skipSpaces();
+            if (this->atEnd() || this->content[this->pos] != '=')
+                this->fail("ожидался символ '='");
+            this->advance(1);
+            this->skipSpaces();
+            if (this->atEnd() || (this->content[this->pos] != '"' && this->content[this->pos] != '\''))
+                this->fail("ожидалось значение атрибута в кавычках");
+
+            char quote = this->content[this->pos];
+            this->advance(1);
+            size_t valueEnd = this->content.find(quote, this->pos);
+            if (valueEnd == std::string::npos)
+                this->fail("незавершенное значение атрибута");
+            std::string rawValue = this->content.substr(this->pos, valueEnd - this->pos);
+            this->advance(valueEnd - this->pos + 1);
+
+            for (auto iter = node.attributes.cbegin(); iter != node.attributes.cend(); iter++)
+            {
+                if (iter->first == attrName)
+                    this->fail(formatStr("повтор атрибута \"%1\"", { attrName }));
+            }
+            node.attributes.emplace_back(attrName, this->decodeEntities(rawValue));
+        }
+
+        // Содержимое тэга
+        std::string pendingText;
+        int pendingTextLine = this->line;
+        auto flushText = [&]() {
+            if (pendingText.find_first_not_of(" \t\r\n") != std::string::npos)
+            {
+                DocumentNode textNode;
+                textNode.text = pendingText;
+                textNode.lineNumber = pendingTextLine;
+                node.children.push_back(std::move(textNode));
+            }
+            pendingText.clear();
+        };
+
+        while (true)
+        {
+            if (this->atEnd())
+                this->fail(formatStr("отсутствует закрывающий тэг \"</%1>\"", { node.tagName }));
+
+            if (this->startsWith("</"))
+            {
+                flushText();
+                this->advance(2);
+                std::string closingName = this->readName();
+                if (closingName != node.tagName)
+                    this->fail(formatStr("ожидался закрывающий тэг \"</%1>\", а был получен \"</%2>\"", { node.tagName, closingName }));
+                this->skipSpaces();
+                if (this->atEnd() || this->content[this->pos] != '>')
+                    this->fail("ожидался символ '>'");
+                this->advance(1);
+                return;
+            }
+            else if (this->startsWith("<![CDATA["))
+            {
+                this->advance(9);
+                size_t cdataEnd = this->content.find("]]>", this->pos);
+                if (cdataEnd == std::string::npos)
+                    this->fail("незавершенный раздел CDATA");
+                if (pendingText.empty())
+                    pendingTextLine = this->line;
+                pendingText += this->content.substr(this->pos, cdataEnd - this->pos);
+                this->advance(cdataEnd - this->pos + 3);
+            }
+            else if (this->startsWith("<!--") || this->startsWith("<?"))
+            {
+                this->skipMisc();
+            }
+            else if (this->content[this->pos] == '<')
+            {
+                flushText();
+                node.children.emplace_back();
+                this->readElement(node.children.back());
+            }
+            else
+            {
+                size_t textEnd = this->content.find('<', this->pos);
+                if (textEnd == std::string::npos)
+                    textEnd = this->content.size();
+                if (pendingText.empty())
+                    pendingTextLine = this->line;
+                pendingText += this->decodeEntities(this->content.substr(this->pos, textEnd - this->pos));
+                this->advance(textEnd - this->pos);
+            }
+        }
+    }
+};
+
+}
+
+DocumentNode LiteXmlParser::parseText(std::string const & content) const
+{
+    CORE_TRACE_SPAN("LiteXmlParser::parseText");
+    CORE_ALLOCATION_PHASE(documentLoad);
+    CORE_PERF_PHASE(documentLoad);
+    LiteXmlReader reader(content);
+
+    // Пропускаем метку порядка байтов UTF-8
+    if (reader.startsWith("\xEF\xBB\xBF"))
+        reader.pos += 3;
+
+    // Пролог документа
+    reader.skipSpaces();
+    while (reader.skipMisc())
+        reader.skipSpaces();
+
+    if (reader.atEnd() || content[reader.pos] != '<')
+        reader.fail("отсутствует корневой тэг");
+
+    DocumentNode root;
+    reader.readElement(root);
+
+    // После корневого тэга допускаются только комментарии и пробельные символы
+    reader.skipSpaces();
+    while (reader.skipMisc())
+        reader.skipSpaces();
+    if (!reader.atEnd())
+        reader.fail("лишние данные после корневого тэга");
+
+    return root;
+}
@@ -0,0 +1,29 @@
+#ifndef LITEXMLPARSER_H
+#define LITEXMLPARSER_H
+#include "documentParser.h"
+
+/*!
+*\file
+*\brief Заголовки функций класса LiteXmlParser
+*/
+
+/*!
+*\class LiteXmlParser
+*\brief Простой разборщик xml, использующий только стандартную библиотеку
+*
+* Поддерживает подмножество xml, достаточное для описания цепи: объявление xml, комментарии,
+* DOCTYPE без внутренних определений, тэги с атрибутами, текст, CDATA и стандартные
+* сущности. Как и QDomDocument, пропускает текстовые узлы, состоящие только из пробельных символов
+*/
+class LiteXmlParser : public DocumentParser
+{
+    public:
+    /*!
+    * \brief Разобрать текст документа
+    * \param[in] content - текст документа
+    * \return - корневой тэг документа
+    */
+    DocumentNode parseText(std::string const & content) const override;
+};
+
+#endif // LITEXMLPARSER_H
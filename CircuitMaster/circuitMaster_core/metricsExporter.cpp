@@ -0,0 +1,233 @@
+#include "metricsExporter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "coreMetrics.h"
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/*!
+*\file
+*\brief Реализация функций класса MetricsExporter
+*/
+
+#ifndef _WIN32
+
+namespace {
+
+/*!
+* \brief Наибольшее время обслуживания одного подключения в миллисекундах. Подключения обслуживаются
+* по очереди, поэтому медленный клиент не должен задерживать остальных дольше этого времени
+*/
+const int connectionTimeoutMs = 500;
+
+/*!
+* \brief Отправить данные целиком
+* \param[in] fd - дескриптор сокета
+* \param[in] data - данные
+*/
+void sendAll(int fd, std::string const & data)
+{
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t result = send(fd, data.data() + sent, data.size() - sent, flags);
+        if (result <= 0)
+            return;
+        sent += static_cast<size_t>(result);
+    }
+}
+
+/*!
+* \brief Прочитать начало запроса клиента, не дольше 200 мс ожидания очередной части
+* и не дольше connectionTimeoutMs всего
+* \param[in] fd - дескриптор подключения
+* \return - прочитанные данные, пустая строка - клиент ничего не отправил
+*/
+std::string readRequestHead(int fd)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectionTimeoutMs);
+    std::string request;
+    char buffer[1024];
+    while (request.size() < 8192 && request.find("\r\n\r\n") == std::string::npos)
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+            break;
+        pollfd pollFd = { fd, POLLIN, 0 };
+        if (poll(&pollFd, 1, static_cast<int>(std::min<long long>(remaining, 200))) <= 0)
+            break;
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            break;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+    return request;
+}
+
+}
+
+#endif
+
+MetricsExporter::MetricsExporter()
+    : listenFd(-1), wakeFds{ -1, -1 }, stopping(false)
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    this->stop();
+}
+
+bool MetricsExporter::isSupported()
+{
+#ifndef _WIN32
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MetricsExporter::serveSocket(std::string const & path)
+{
+#ifndef _WIN32
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+        throw std::string("Неверно указан путь к сокету для метрик: \"" + path + "\".");
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw std::string("Не удалось создать сокет для метрик.");
+
+    // Файл сокета мог остаться от предыдущего запуска. Удаляется только сокет: другой файл по этому пути - ошибка
+    struct stat status;
+    bool isOtherFile = lstat(path.c_str(), &status) == 0 && !S_ISSOCK(status.st_mode);
+    if (!isOtherFile)
+        unlink(path.c_str());
+    if (isOtherFile || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0 || pipe(this->wakeFds) != 0)
+    {
+        close(fd);
+        throw std::string("Не удалось открыть сокет для метрик: \"" + path + "\".");
+    }
+
+    this->listenFd = fd;
+    this->socketPath = path;
+    this->socketThread = std::thread(&MetricsExporter::socketLoop, this);
+#else
+    throw std::string("Выгрузка метрик через сокет не поддерживается в этой системе: \"" + path + "\".");
+#endif
+}
+
+void MetricsExporter::dumpOnSignal(std::string const & path)
+{
+#ifndef _WIN32
+    // Сигнал блокируется в текущем потоке и наследуется всеми потоками, созданными после этого.
+    // Его получает только поток ожидания через sigwait
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    this->dumpPath = path;
+    this->signalThread = std::thread(&MetricsExporter::signalLoop, this);
+#else
+    throw std::string("Запись метрик по сигналу не поддерживается в этой системе: \"" + path + "\".");
+#endif
+}
+
+void MetricsExporter::stop()
+{
+    if (this->stopping.exchange(true))
+        return;
+
+#ifndef _WIN32
+    if (this->socketThread.joinable())
+    {
+        char wake = 0;
+        if (write(this->wakeFds[1], &wake, 1) < 0)
+            shutdown(this->listenFd, SHUT_RDWR);
+        this->socketThread.join();
+        close(this->listenFd);
+        close(this->wakeFds[0]);
+        close(this->wakeFds[1]);
+        unlink(this->socketPath.c_str());
+    }
+
+    if (this->signalThread.joinable())
+    {
+        pthread_kill(this->signalThread.native_handle(), SIGUSR1);
+        this->signalThread.join();
+
+        // Итоговые значения записываются и при остановке
+        try {
+            Metrics::writeToFile(this->dumpPath);
+        } catch (std::string const & str) {
+            fprintf(stderr, "%s\n", str.c_str());
+        }
+    }
+#endif
+}
+
+void MetricsExporter::socketLoop()
+{
+#ifndef _WIN32
+    while (!this->stopping.load())
+    {
+        pollfd pollFds[2] = { { this->listenFd, POLLIN, 0 }, { this->wakeFds[0], POLLIN, 0 } };
+        if (poll(pollFds, 2, -1) < 0 || (pollFds[1].revents & POLLIN) != 0)
+            continue;
+
+        int client = accept(this->listenFd, nullptr, nullptr);
+        if (client < 0)
+            continue;
+
+        // Клиент, который не принимает ответ, не задерживает следующие подключения
+        timeval sendTimeout = { 0, connectionTimeoutMs * 1000 };
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+        // Текст метрик формируется заново для каждого подключения
+        std::string text = Metrics::prometheusText();
+        if (readRequestHead(client).rfind("GET ", 0) == 0)
+            text = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(text.size()) +
+                   "\r\nConnection: close\r\n\r\n" + text;
+        sendAll(client, text);
+        close(client);
+    }
+#endif
+}
+
+void MetricsExporter::signalLoop()
+{
+#ifndef _WIN32
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+
+    int received;
+    while (sigwait(&signals, &received) == 0 && !this->stopping.load())
+    {
+        try {
+            Metrics::writeToFile(this->dumpPath);
+        } catch (std::string const & str) {
+            fprintf(stderr, "%s\n", str.c_str());
+        }
+    }
+#endif
+}
@@ -0,0 +1,80 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+#include <atomic>
+#include <string>
+#include <thread>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций выгрузки метрик во время работы программы
+*/
+
+/*!
+*\class MetricsExporter
+*\brief Выгрузка метрик (см. Metrics) в формате Prometheus через локальный сокет или в файл по сигналу
+*
+* Выгрузка выполняется в отдельных потоках и только читает атомарные значения метрик, поэтому
+* не задерживает потоки расчета. Доступна только в системах семейства Unix
+*/
+class MetricsExporter
+{
+    public:
+    /*!
+    * \brief Конструктор, выгрузка не начинается до вызова serveSocket или dumpOnSignal
+    */
+    MetricsExporter();
+
+    /*!
+    * \brief Деструктор, останавливает выгрузку
+    */
+    ~MetricsExporter();
+
+    MetricsExporter(MetricsExporter const &) = delete;
+    MetricsExporter& operator=(MetricsExporter const &) = delete;
+
+    /*!
+    * \brief Проверить, поддерживается ли выгрузка в текущей системе
+    * \return - true для систем семейства Unix
+    */
+    static bool isSupported();
+
+    /*!
+    * \brief Начать отдавать метрики через Unix-сокет. На запрос HTTP GET отвечает как HTTP-сервер,
+    * на любое другое подключение - текстом метрик
+    * \param[in] path - путь к сокету, существующий файл сокета заменяется
+    */
+    void serveSocket(std::string const & path);
+
+    /*!
+    * \brief Записывать метрики в файл при получении SIGUSR1 и при остановке. Вызывать до создания
+    * других потоков, чтобы сигнал был заблокирован во всех потоках программы
+    * \param[in] path - путь к файлу
+    */
+    void dumpOnSignal(std::string const & path);
+
+    /*!
+    * \brief Остановить выгрузку и удалить файл сокета
+    */
+    void stop();
+
+    private:
+    std::string socketPath; /*!< Путь к сокету, пустой - сокет не используется */
+    std::string dumpPath; /*!< Путь к файлу для записи по сигналу, пустой - запись не используется */
+    int listenFd; /*!< Дескриптор слушающего сокета */
+    int wakeFds[2]; /*!< Канал для пробуждения потока сокета при остановке */
+    std::thread socketThread; /*!< Поток, обслуживающий сокет */
+    std::thread signalThread; /*!< Поток, ожидающий сигнал */
+    std::atomic<bool> stopping; /*!< Идёт ли остановка */
+
+    /*!
+    * \brief Принимать подключения к сокету до остановки
+    */
+    void socketLoop();
+
+    /*!
+    * \brief Ожидать сигналы до остановки
+    */
+    void signalLoop();
+};
+
+#endif // METRICSEXPORTER_H
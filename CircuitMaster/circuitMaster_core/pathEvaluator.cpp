@@ -0,0 +1,236 @@
+#include "pathEvaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "coreStrings.h"
+
+/*!
+*\file
+*\brief Реализация функций класса PathEvaluator
+*/
+
+namespace {
+
+// Если при вычитании слагаемого результат меньше суммы модулей операндов в столько раз, соединение пересчитывается по всем детям
+const double cancellationRatio = 1e-6;
+
+/*!
+* \brief Проверить, потеряна ли точность при замене слагаемого суммы
+* \param[in] result - новая сумма
+* \param[in] sum - старая сумма
+* \param[in] term - замененное слагаемое
+* \return - true, если значащие цифры результата потеряны при вычитании
+*/
+bool isCancelled(std::complex<double> result, std::complex<double> sum, std::complex<double> term)
+{
+    return std::abs(result) <= cancellationRatio * (std::abs(sum) + std::abs(term));
+}
+
+}
+
+PathEvaluator::PathEvaluator(CircuitTopology const & topology, CircuitState const & base)
+    : topology(topology), base(base)
+{
+    this->elementNodes.resize(topology.elementResistances.size());
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        CircuitTopology::Node const & node = topology.nodes[n];
+        std::fill_n(this->elementNodes.begin() + node.firstElement, node.elementCount, static_cast<int>(n));
+    }
+
+    this->changedResistances.resize(topology.nodes.size());
+    this->nodeStamps.assign(topology.nodes.size(), 0);
+    this->changedElements.resize(topology.elementResistances.size());
+    this->elementStamps.assign(topology.elementResistances.size(), 0);
+}
+
+std::complex<double> PathEvaluator::openResistance()
+{
+    return std::complex<double>(std::numeric_limits<double>::infinity(), 0);
+}
+
+bool PathEvaluator::isOpen(std::complex<double> resistance)
+{
+    return std::isinf(resistance.real());
+}
+
+void PathEvaluator::reset()
+{
+    // Номер изменения увеличивается, поэтому значения прошлых изменений больше не используются
+    this->stamp++;
+    if (this->stamp == 0)
+    {
+        std::fill(this->nodeStamps.begin(), this->nodeStamps.end(), 0);
+        std::fill(this->elementStamps.begin(), this->elementStamps.end(), 0);
+        this->stamp = 1;
+    }
+}
+
+std::complex<double> PathEvaluator::elementResistance(size_t element) const
+{
+    return this->elementStamps[element] == this->stamp ? this->changedElements[element] : this->base.elementResistances[element];
+}
+
+std::complex<double> PathEvaluator::resistance(int node) const
+{
+    return this->nodeStamps[node] == this->stamp ? this->changedResistances[node] : this->base.resistances[node];
+}
+
+int PathEvaluator::elementNode(size_t element) const
+{
+    return this->elementNodes[element];
+}
+
+void PathEvaluator::setResistance(int node, std::complex<double> resistance)
+{
+    this->changedResistances[node] = resistance;
+    this->nodeStamps[node] = this->stamp;
+}
+
+void PathEvaluator::setElementResistance(size_t element, std::complex<double> resistance)
+{
+    std::vector<CircuitTopology::Node> const & nodes = this->topology.nodes;
+    std::complex<double> oldElement = this->elementResistance(element);
+    this->changedElements[element] = resistance;
+    this->elementStamps[element] = this->stamp;
+
+    // Простое последовательное соединение элемента
+    int child = this->elementNodes[element];
+    std::complex<double> childOld = this->resistance(child);
+    std::complex<double> childNew;
+    if (isOpen(resistance))
+        childNew = openResistance();
+    else if (isOpen(oldElement) || isOpen(childOld))
+        childNew = this->recalculate(child);
+    else
+    {
+        childNew = childOld - oldElement + resistance;
+        if (isCancelled(childNew, childOld, oldElement))
+            childNew = this->recalculate(child);
+    }
+    this->setResistance(child, childNew);
+
+    // Соединения на пути до корня, пока сопротивление изменяется
+    for (int parent = nodes[child].parent; parent >= 0 && childNew != childOld; parent = nodes[child].parent)
+    {
+        std::complex<double> parentOld = this->resistance(parent);
+        std::complex<double> parentNew;
+        if (nodes[parent].type == CoreConnection::ConnectionType::sequentialComplex)
+        {
+            if (isOpen(childNew))
+                parentNew = openResistance();
+            else if (isOpen(childOld) || isOpen(parentOld))
+                parentNew = this->recalculate(parent);
+            else
+            {
+                parentNew = parentOld - childOld + childNew;
+                if (isCancelled(parentNew, parentOld, childOld))
+                    parentNew = this->recalculate(parent);
+            }
+        }
+        // Параллельное соединение с замкнутой ветвью замкнуто
+        else if (childNew == 0.0)
+            parentNew = 0;
+        else if (childOld == 0.0 || parentOld == 0.0)
+            parentNew = this->recalculate(parent);
+        else
+        {
+            std::complex<double> conductanceOld = isOpen(parentOld) ? 0 : 1.0 / parentOld;
+            std::complex<double> termOld = isOpen(childOld) ? 0 : 1.0 / childOld;
+            std::complex<double> conductance = conductanceOld - termOld + (isOpen(childNew) ? 0 : 1.0 / childNew);
+            if (isCancelled(conductance, conductanceOld, termOld))
+                parentNew = this->recalculate(parent);
+            else
+                parentNew = 1.0 / conductance;
+        }
+        this->setResistance(parent, parentNew);
+
+        child = parent;
+        childOld = parentOld;
+        childNew = parentNew;
+    }
+}
+
+std::complex<double> PathEvaluator::recalculate(int node) const
+{
+    CircuitTopology::Node const & connection = this->topology.nodes[node];
+    std::complex<double> sum = 0;
+
+    if (connection.type == CoreConnection::ConnectionType::sequential)
+    {
+        for (int e = connection.firstElement; e < connection.firstElement + connection.elementCount; e++)
+        {
+            std::complex<double> value = this->elementResistance(e);
+            if (isOpen(value))
+                return openResistance();
+            sum += value;
+        }
+        return sum;
+    }
+
+    if (connection.type == CoreConnection::ConnectionType::sequentialComplex)
+    {
+        for (int c = connection.firstChild; c < connection.firstChild + connection.childCount; c++)
+        {
+            std::complex<double> value = this->resistance(this->topology.childIndices[c]);
+            if (isOpen(value))
+                return openResistance();
+            sum += value;
+        }
+        return sum;
+    }
+
+    // Параллельное соединение: разомкнутые ветви не проводят ток, замкнутая ветвь замыкает всё соединение
+    for (int c = connection.firstChild; c < connection.firstChild + connection.childCount; c++)
+    {
+        std::complex<double> value = this->resistance(this->topology.childIndices[c]);
+        if (value == 0.0)
+            return 0;
+        if (!isOpen(value))
+            sum += 1.0 / value;
+    }
+    return sum == 0.0 ? openResistance() : 1.0 / sum;
+}
+
+std::complex<double> PathEvaluator::current(int node)
+{
+    std::vector<CircuitTopology::Node> const & nodes = this->topology.nodes;
+    this->path.clear();
+    for (int n = node; n >= 0; n = nodes[n].parent)
+        this->path.push_back(n);
+
+    // Корневому соединению задано напряжение
+    std::complex<double> rootResistance = this->resistance(0);
+    if (rootResistance == 0.0)
+        throw formatStr("При расчете сопротивления соединения %1 был получен 0. Проверьте правильность входных данных.", { nodes[0].displayName() });
+    std::complex<double> voltage = this->base.voltages[0];
+    std::complex<double> current = isOpen(rootResistance) ? 0 : voltage / rootResistance;
+
+    // Силы тока и напряжения от корня до соединения. Ток через разомкнутое соединение равен 0,
+    // поэтому равны 0 и токи всех соединений внутри него
+    for (size_t i = this->path.size() - 1; i-- > 0;)
+    {
+        int child = this->path[i];
+        int parent = nodes[child].parent;
+        std::complex<double> resistance = this->resistance(child);
+
+        if (nodes[parent].type == CoreConnection::ConnectionType::sequentialComplex)
+            voltage = isOpen(resistance) ? 0 : current * resistance;
+        // Ток замкнутого параллельного соединения делится между его замкнутыми ветвями
+        else if (this->resistance(parent) == 0.0)
+        {
+            int shortedCount = 0;
+            CircuitTopology::Node const & connection = nodes[parent];
+            for (int c = connection.firstChild; c < connection.firstChild + connection.childCount; c++)
+            {
+                if (this->resistance(this->topology.childIndices[c]) == 0.0)
+                    shortedCount++;
+            }
+            current = resistance == 0.0 ? current / static_cast<double>(shortedCount) : 0;
+            voltage = 0;
+        }
+        else
+            current = isOpen(resistance) ? 0 : voltage / resistance;
+    }
+    return current;
+}
@@ -0,0 +1,121 @@
+#ifndef PATHEVALUATOR_H
+#define PATHEVALUATOR_H
+#include <complex>
+#include <vector>
+#include "circuitState.h"
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций пересчета цепи после изменения отдельных элементов
+*/
+
+/*!
+*\class PathEvaluator
+*\brief Пересчет цепи после изменения сопротивлений нескольких элементов без расчета всего дерева
+*
+* Изменение сопротивления элемента меняет сопротивления только соединений на пути от его
+* соединения до корня. Они пересчитываются по рассчитанной исходной цепи через разность старого
+* и нового слагаемого (сопротивления для последовательного соединения, проводимости для
+* параллельного), поэтому обход не зависит от количества детей. Если при вычитании теряется
+* точность, соединение пересчитывается по всем детям. Силы тока рассчитываются только на пути от
+* корня до запрошенного соединения.
+*
+* Элемент может быть замкнут (сопротивление 0) или разомкнут (бесконечное сопротивление,
+* см. openResistance). Ток параллельного соединения с замкнутой ветвью полностью проходит через неё.
+* Измененные значения хранятся отдельно от исходной цепи с номером изменения, поэтому сброс
+* изменений (reset) не требует копирования массивов
+*/
+class PathEvaluator
+{
+    public:
+    /*!
+    * \brief Конструктор
+    * \param[in] topology - топология цепи
+    * \param[in] base - состояние рассчитанной исходной цепи. Топология и состояние не копируются
+    * и не должны изменяться, пока используется объект
+    */
+    PathEvaluator(CircuitTopology const & topology, CircuitState const & base);
+
+    /*!
+    * \brief Получить бесконечное сопротивление разомкнутого элемента
+    * \return - сопротивление
+    */
+    static std::complex<double> openResistance();
+
+    /*!
+    * \brief Проверить, является ли сопротивление бесконечным
+    * \param[in] resistance - сопротивление
+    * \return - true, если сопротивление бесконечно
+    */
+    static bool isOpen(std::complex<double> resistance);
+
+    /*!
+    * \brief Отменить все изменения
+    */
+    void reset();
+
+    /*!
+    * \brief Изменить сопротивление элемента и пересчитать сопротивления соединений на пути до корня
+    * \param[in] element - номер элемента в топологии
+    * \param[in] resistance - новое сопротивление, openResistance() - разомкнутый элемент
+    */
+    void setElementResistance(size_t element, std::complex<double> resistance);
+
+    /*!
+    * \brief Получить сопротивление элемента с учетом изменений
+    * \param[in] element - номер элемента в топологии
+    * \return - сопротивление
+    */
+    std::complex<double> elementResistance(size_t element) const;
+
+    /*!
+    * \brief Получить сопротивление соединения с учетом изменений
+    * \param[in] node - номер соединения в топологии
+    * \return - сопротивление
+    */
+    std::complex<double> resistance(int node) const;
+
+    /*!
+    * \brief Рассчитать силу тока соединения с учетом изменений
+    *
+    * Ошибка сообщается исключением std::string, если сопротивление всей цепи стало равно 0
+    * \param[in] node - номер соединения в топологии
+    * \return - комплексная сила тока
+    */
+    std::complex<double> current(int node);
+
+    /*!
+    * \brief Получить номер соединения, которому принадлежит элемент
+    * \param[in] element - номер элемента в топологии
+    * \return - номер соединения
+    */
+    int elementNode(size_t element) const;
+
+    private:
+    CircuitTopology const & topology; /*!< Топология цепи */
+    CircuitState const & base; /*!< Состояние исходной цепи */
+    std::vector<int> elementNodes; /*!< Номера соединений элементов */
+    std::vector<std::complex<double>> changedResistances; /*!< Измененные сопротивления соединений */
+    std::vector<unsigned> nodeStamps; /*!< Номер изменения, в котором изменено сопротивление соединения */
+    std::vector<std::complex<double>> changedElements; /*!< Измененные сопротивления элементов */
+    std::vector<unsigned> elementStamps; /*!< Номер изменения, в котором изменено сопротивление элемента */
+    unsigned stamp = 1; /*!< Номер текущего изменения */
+    std::vector<int> path; /*!< Путь от соединения до корня при расчете силы тока */
+
+    /*!
+    * \brief Сохранить измененное сопротивление соединения
+    * \param[in] node - номер соединения
+    * \param[in] resistance - сопротивление
+    */
+    void setResistance(int node, std::complex<double> resistance);
+
+    /*!
+    * \brief Рассчитать сопротивление соединения по всем его элементам или детям
+    * \param[in] node - номер соединения
+    * \return - сопротивление
+    */
+    std::complex<double> recalculate(int node) const;
+};
+
+#endif // PATHEVALUATOR_H
@@ -0,0 +1,302 @@
+#include "perfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include "coreStrings.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*!
+*\file
+*\brief Реализация функций сбора аппаратных счетчиков производительности по этапам расчета
+*/
+
+std::atomic<bool> PerfCounters::enabled(false);
+
+namespace {
+
+const int phaseCount = static_cast<int>(PerfCounters::Phase::count); /*!< Количество этапов */
+const int eventCount = static_cast<int>(PerfCounters::Event::count); /*!< Количество событий */
+
+std::atomic<uint64_t> callCounts[phaseCount]; /*!< Количество измеренных выполнений по этапам */
+std::atomic<uint64_t> eventTotals[phaseCount][eventCount]; /*!< Сумма значений событий по этапам */
+std::atomic<bool> eventAvailable[eventCount]; /*!< Удалось ли открыть счетчик события хотя бы в одном потоке */
+std::atomic<int> openError(0); /*!< Код первой ошибки открытия счетчика */
+std::atomic<int> openErrorEvent(-1); /*!< Событие, счетчик которого не удалось открыть первым */
+thread_local int phaseDepth[phaseCount] = {}; /*!< Глубина вложенности этапов в текущем потоке */
+
+/*!
+*\brief Счетчики текущего потока. Закрываются при завершении потока
+*/
+struct ThreadCounters
+{
+    int fds[eventCount]; /*!< Дескрипторы счетчиков, -1 - счетчик не открыт */
+    bool opened = false; /*!< Была ли попытка открыть счетчики */
+
+    ThreadCounters()
+    {
+        for (int i = 0; i < eventCount; i++)
+            this->fds[i] = -1;
+    }
+
+    ~ThreadCounters()
+    {
+#ifdef __linux__
+        for (int i = 0; i < eventCount; i++)
+            if (this->fds[i] >= 0)
+                close(this->fds[i]);
+#endif
+    }
+};
+
+thread_local ThreadCounters threadCounters; /*!< Счетчики текущего потока */
+
+/*!
+* \brief Получить английское название события для сообщений об ошибках
+* \param[in] event - номер события
+* \return - название
+*/
+const char* eventName(int event)
+{
+    static const char* names[eventCount] = { "cycles", "instructions", "cache-misses", "branch-misses" };
+    return event >= 0 && event < eventCount ? names[event] : "";
+}
+
+/*!
+* \brief Открыть счетчики текущего потока при первом обращении
+* \return - счетчики потока
+*/
+ThreadCounters& openThreadCounters()
+{
+    ThreadCounters& counters = threadCounters;
+    if (counters.opened)
+        return counters;
+    counters.opened = true;
+
+#ifdef __linux__
+    static const uint64_t configs[eventCount] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int i = 0; i < eventCount; i++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Счетчик текущего потока на любом процессоре
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0)
+        {
+            int expected = 0;
+            if (openError.compare_exchange_strong(expected, errno))
+                openErrorEvent.store(i);
+            continue;
+        }
+        counters.fds[i] = fd;
+        eventAvailable[i].store(true, std::memory_order_relaxed);
+    }
+#else
+    int expected = 0;
+    if (openError.compare_exchange_strong(expected, ENOSYS))
+        openErrorEvent.store(0);
+#endif
+
+    return counters;
+}
+
+/*!
+* \brief Снять показания открытых счетчиков текущего потока
+* \param[in] counters - счетчики потока
+* \param[out] reading - показания
+*/
+void readCounters(ThreadCounters const & counters, PerfCounters::Reading& reading)
+{
+#ifdef __linux__
+    for (int i = 0; i < eventCount; i++)
+    {
+        if (counters.fds[i] < 0)
+            continue;
+
+        // Формат чтения: значение, время включения, время счета
+        uint64_t data[3];
+        if (read(counters.fds[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)))
+        {
+            reading.values[i] = data[0];
+            reading.timeEnabled[i] = data[1];
+            reading.timeRunning[i] = data[2];
+        }
+    }
+#else
+    (void)counters;
+#endif
+    reading.valid = true;
+}
+
+/*!
+* \brief Сформировать строчное отображение значения события
+* \param[in] totals - значения этапа
+* \param[in] event - событие
+* \return - значение или "н/д", если счетчик недоступен
+*/
+std::string eventValueStr(PerfCounters::Totals const & totals, PerfCounters::Event event)
+{
+    int index = static_cast<int>(event);
+    return totals.available[index] ? std::to_string(totals.values[index]) : std::string("н/д");
+}
+
+/*!
+* \brief Сформировать строчное отображение отношения двух событий
+* \param[in] totals - значения этапа
+* \param[in] numerator - событие-числитель
+* \param[in] denominator - событие-знаменатель
+* \param[in] scale - множитель отношения
+* \return - значение или "н/д", если счетчик недоступен или знаменатель равен 0
+*/
+std::string ratioStr(PerfCounters::Totals const & totals, PerfCounters::Event numerator, PerfCounters::Event denominator, double scale)
+{
+    int top = static_cast<int>(numerator);
+    int bottom = static_cast<int>(denominator);
+    if (!totals.available[top] || !totals.available[bottom] || totals.values[bottom] == 0)
+        return "н/д";
+    return numberToStr(scale * static_cast<double>(totals.values[top]) / static_cast<double>(totals.values[bottom]));
+}
+
+}
+
+void PerfCounters::start()
+{
+    reset();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void PerfCounters::stop()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+bool PerfCounters::isCompiledIn()
+{
+#ifdef CIRCUITMASTER_PERF_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PerfCounters::reset()
+{
+    for (int phase = 0; phase < phaseCount; phase++)
+    {
+        callCounts[phase].store(0, std::memory_order_relaxed);
+        for (int event = 0; event < eventCount; event++)
+            eventTotals[phase][event].store(0, std::memory_order_relaxed);
+    }
+}
+
+PerfCounters::Totals PerfCounters::get(Phase phase)
+{
+    int index = static_cast<int>(phase);
+    Totals totals;
+    totals.calls = callCounts[index].load(std::memory_order_relaxed);
+    for (int event = 0; event < eventCount; event++)
+    {
+        totals.values[event] = eventTotals[index][event].load(std::memory_order_relaxed);
+        totals.available[event] = eventAvailable[event].load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+std::string PerfCounters::unavailableReason()
+{
+    int error = openError.load();
+    if (error == 0)
+        return "";
+    return formatStr("не удалось открыть счетчик %1: %2", { eventName(openErrorEvent.load()), std::strerror(error) });
+}
+
+std::string PerfCounters::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Phase::documentLoad:
+        return "чтение и разбор xml";
+    case Phase::calculateResistance:
+        return "calculateResistance";
+    case Phase::calculateCurrentAndVoltage:
+        return "calculateCurrentAndVoltage";
+    default:
+        return "";
+    }
+}
+
+std::string PerfCounters::report()
+{
+    std::string text = "Счетчики производительности по этапам:\n";
+    for (int index = 0; index < phaseCount; index++)
+    {
+        Phase phase = static_cast<Phase>(index);
+        Totals totals = get(phase);
+        text += formatStr("  %1: выполнений %2, тактов %3, инструкций %4, IPC %5, "
+                          "промахов кэша %6 (%7 на 1000 инструкций), ошибок предсказания переходов %8 (%9 на 1000 инструкций)\n",
+                          { phaseName(phase), std::to_string(totals.calls),
+                            eventValueStr(totals, Event::cycles), eventValueStr(totals, Event::instructions),
+                            ratioStr(totals, Event::instructions, Event::cycles, 1),
+                            eventValueStr(totals, Event::cacheMisses), ratioStr(totals, Event::cacheMisses, Event::instructions, 1000),
+                            eventValueStr(totals, Event::branchMisses), ratioStr(totals, Event::branchMisses, Event::instructions, 1000) });
+    }
+
+    std::string reason = unavailableReason();
+    if (!reason.empty())
+    {
+        bool anyAvailable = false;
+        for (int event = 0; event < eventCount; event++)
+            anyAvailable = anyAvailable || eventAvailable[event].load(std::memory_order_relaxed);
+        text += formatStr("  %1 (%2). Проверьте значение /proc/sys/kernel/perf_event_paranoid.\n",
+                          { anyAvailable ? "Часть счетчиков недоступна" : "Счетчики недоступны", reason });
+    }
+    return text;
+}
+
+void PerfCounters::enterPhase(Phase phase, Reading& begin)
+{
+    // Вложенные вызовы этапа уже входят в показания внешнего
+    if (phaseDepth[static_cast<int>(phase)]++ != 0)
+        return;
+
+    readCounters(openThreadCounters(), begin);
+}
+
+void PerfCounters::leavePhase(Phase phase, Reading const & begin)
+{
+    int index = static_cast<int>(phase);
+    phaseDepth[index]--;
+    if (!begin.valid)
+        return;
+
+    Reading end;
+    readCounters(threadCounters, end);
+
+    for (int event = 0; event < eventCount; event++)
+    {
+        if (threadCounters.fds[event] < 0)
+            continue;
+
+        uint64_t delta = end.values[event] - begin.values[event];
+        uint64_t enabledDelta = end.timeEnabled[event] - begin.timeEnabled[event];
+        uint64_t runningDelta = end.timeRunning[event] - begin.timeRunning[event];
+
+        // Если счетчик делил оборудование с другими, оцениваем значение за всё время этапа
+        if (runningDelta != 0 && runningDelta < enabledDelta)
+            delta = static_cast<uint64_t>(static_cast<double>(delta) * static_cast<double>(enabledDelta) / static_cast<double>(runningDelta));
+
+        eventTotals[index][event].fetch_add(delta, std::memory_order_relaxed);
+    }
+    callCounts[index].fetch_add(1, std::memory_order_relaxed);
+}
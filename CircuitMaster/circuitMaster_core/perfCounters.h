@@ -0,0 +1,198 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций сбора аппаратных счетчиков производительности по этапам расчета
+*
+* Этапы отмечаются макросом CORE_PERF_PHASE. Без CIRCUITMASTER_PERF_COUNTERS (CONFIG += perf_counters)
+* макрос не создает кода. Счетчики читаются через perf_event_open, поэтому доступны только в Linux
+*/
+
+/*!
+*\class PerfCounters
+*\brief Аппаратные счетчики производительности (такты, инструкции, промахи кэша и предсказания переходов) по этапам расчета
+*
+* Каждый поток открывает свои счетчики при первом отмеченном этапе после начала сбора. Рекурсивные
+* этапы учитываются только на внешнем уровне вложенности. Если ядро или права не позволяют открыть
+* счетчик, он пропускается, а причина выводится в отчете
+*/
+class PerfCounters
+{
+    public:
+    /*!
+    *\enum Phase
+    *\brief Отмечаемый этап
+    */
+    enum class Phase
+    {
+        documentLoad, /*!< Чтение и разбор xml */
+        calculateResistance, /*!< Расчет сопротивлений */
+        calculateCurrentAndVoltage, /*!< Расчет сил тока и напряжений */
+        count /*!< Количество этапов */
+    };
+
+    /*!
+    *\enum Event
+    *\brief Аппаратное событие
+    */
+    enum class Event
+    {
+        cycles, /*!< Такты процессора */
+        instructions, /*!< Выполненные инструкции */
+        cacheMisses, /*!< Промахи последнего уровня кэша */
+        branchMisses, /*!< Ошибки предсказания переходов */
+        count /*!< Количество событий */
+    };
+
+    /*!
+    *\class Reading
+    *\brief Показания счетчиков потока в один момент времени
+    */
+    class Reading
+    {
+        public:
+        uint64_t values[static_cast<int>(Event::count)] = {}; /*!< Значения счетчиков */
+        uint64_t timeEnabled[static_cast<int>(Event::count)] = {}; /*!< Время, в течение которого счетчик был включен */
+        uint64_t timeRunning[static_cast<int>(Event::count)] = {}; /*!< Время, в течение которого счетчик действительно считал */
+        bool valid = false; /*!< Сняты ли показания, false - этап не измеряется */
+    };
+
+    /*!
+    *\class Totals
+    *\brief Накопленные значения одного этапа
+    */
+    class Totals
+    {
+        public:
+        uint64_t calls = 0; /*!< Количество измеренных выполнений этапа */
+        uint64_t values[static_cast<int>(Event::count)] = {}; /*!< Сумма значений событий */
+        bool available[static_cast<int>(Event::count)] = {}; /*!< Удалось ли открыть счетчик события */
+    };
+
+    /*!
+    * \brief Начать сбор, обнулив накопленные значения
+    */
+    static void start();
+
+    /*!
+    * \brief Остановить сбор
+    */
+    static void stop();
+
+    /*!
+    * \brief Проверить, идёт ли сбор
+    * \return - true, если сбор идёт
+    */
+    static bool isEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+    * \brief Проверить, собрана ли программа с отметками этапов
+    * \return - true, если определен CIRCUITMASTER_PERF_COUNTERS
+    */
+    static bool isCompiledIn();
+
+    /*!
+    * \brief Обнулить накопленные значения всех этапов
+    */
+    static void reset();
+
+    /*!
+    * \brief Получить накопленные значения этапа
+    * \param[in] phase - этап
+    * \return - значения
+    */
+    static Totals get(Phase phase);
+
+    /*!
+    * \brief Получить причину, по которой не удалось открыть счетчики
+    * \return - описание ошибки или пустая строка, если все счетчики открыты
+    */
+    static std::string unavailableReason();
+
+    /*!
+    * \brief Получить название этапа
+    * \param[in] phase - этап
+    * \return - название
+    */
+    static std::string phaseName(Phase phase);
+
+    /*!
+    * \brief Сформировать таблицу счетчиков, IPC и долей промахов по этапам
+    * \return - текст таблицы
+    */
+    static std::string report();
+
+    /*!
+    * \brief Войти в этап в текущем потоке
+    * \param[in] phase - этап
+    * \param[out] begin - показания счетчиков на начало этапа, не заполняются для вложенного этапа
+    */
+    static void enterPhase(Phase phase, Reading& begin);
+
+    /*!
+    * \brief Выйти из этапа в текущем потоке и добавить разность показаний к этапу
+    * \param[in] phase - этап
+    * \param[in] begin - показания счетчиков на начало этапа
+    */
+    static void leavePhase(Phase phase, Reading const & begin);
+
+    private:
+    static std::atomic<bool> enabled; /*!< Идёт ли сбор */
+};
+
+/*!
+*\class PerfPhaseScope
+*\brief Этап от создания объекта до выхода из области видимости
+*/
+class PerfPhaseScope
+{
+    public:
+    /*!
+    * \brief Конструктор этапа
+    * \param[in] phase - этап
+    */
+    PerfPhaseScope(PerfCounters::Phase phase)
+        : phase(phase)
+    {
+        if (PerfCounters::isEnabled())
+        {
+            this->entered = true;
+            PerfCounters::enterPhase(phase, this->begin);
+        }
+    }
+
+    /*!
+    * \brief Деструктор, добавляет показания счетчиков к этапу
+    */
+    ~PerfPhaseScope()
+    {
+        if (this->entered)
+            PerfCounters::leavePhase(this->phase, this->begin);
+    }
+
+    PerfPhaseScope(PerfPhaseScope const &) = delete;
+    PerfPhaseScope& operator=(PerfPhaseScope const &) = delete;
+
+    private:
+    PerfCounters::Phase phase; /*!< Этап */
+    bool entered = false; /*!< Был ли выполнен вход в этап */
+    PerfCounters::Reading begin; /*!< Показания на начало этапа */
+};
+
+#ifdef CIRCUITMASTER_PERF_COUNTERS
+#define CORE_PERF_CONCAT_IMPL(a, b) a##b
+#define CORE_PERF_CONCAT(a, b) CORE_PERF_CONCAT_IMPL(a, b)
+/*! Отметить этап до конца текущей области видимости */
+#define CORE_PERF_PHASE(phase) PerfPhaseScope CORE_PERF_CONCAT(corePerfPhase, __LINE__)(PerfCounters::Phase::phase)
+#else
+#define CORE_PERF_PHASE(phase) ((void)0)
+#endif
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,251 @@
+#include "planCache.h"
+#include <map>
+#include <mutex>
+#include <vector>
+#include "allocationStats.h"
+#include "coreConnection.h"
+#include "coreElement.h"
+#include "coreIo.h"
+#include "coreMetrics.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация конструкторов и функций кэша топологий цепей
+*/
+
+namespace {
+
+/*!
+* \brief Добавить строку к описанию с указанием её длины, чтобы описание читалось однозначно
+* \param[in,out] signature - описание
+* \param[in] str - строка
+*/
+void appendToken(std::string& signature, std::string const & str)
+{
+    signature += std::to_string(str.size());
+    signature += ':';
+    signature += str;
+}
+
+/*!
+* \brief Добавить к описанию узел документа и всех его потомков
+* \param[in,out] signature - описание
+* \param[in] node - узел документа
+*/
+void appendNodeSignature(std::string& signature, DocumentNode const & node)
+{
+    appendToken(signature, node.tagName);
+
+    // Для элемента важен только тип: значения читаются при каждом расчете
+    if (node.tagName == "elem")
+    {
+        DocumentNode const * typeElem = node.firstChildElement("type");
+        appendToken(signature, typeElem != nullptr ? typeElem->textContent() : "");
+        return;
+    }
+
+    // Имя соединения попадает в выходной файл
+    std::string name = node.attribute("name", "");
+    appendToken(signature, name);
+
+    // От наличия напряжения и частоты зависит, пройдёт ли документ проверку
+    signature += node.attribute("voltage", "").empty() ? '-' : 'v';
+    signature += node.attribute("frequency", "").empty() ? '-' : 'f';
+
+    signature += '(';
+    for (auto iter = node.children.cbegin(); iter != node.children.cend(); iter++)
+        appendNodeSignature(signature, *iter);
+    signature += ')';
+}
+
+}
+
+CompiledPlan::CompiledPlan(std::string const & planSignature, CoreConnection const & root)
+    : signature(planSignature), topology(CircuitTopology::fromConnection(root))
+{
+}
+
+VariantBatch CompiledPlan::bind(DocumentNode const & rootElement) const
+{
+    CORE_ALLOCATION_PHASE(treeBuild);
+    VariantBatch batch(this->topology, 1);
+    this->bind(rootElement, batch, 0);
+    return batch;
+}
+
+void CompiledPlan::bind(DocumentNode const & rootElement, VariantBatch& batch, size_t instance) const
+{
+    CORE_TRACE_SPAN("CompiledPlan::bind");
+    double frequency = frequencyFromDocument(rootElement);
+    batch.setVoltage(instance, CoreConnection::voltageFromDocElement(rootElement));
+
+    // Элементы в документе расположены в том же порядке, что и в плоском представлении
+    size_t element = 0;
+    std::vector<DocumentNode const *> stack(1, &rootElement);
+    while (!stack.empty())
+    {
+        DocumentNode const * node = stack.back();
+        stack.pop_back();
+
+        if (node->tagName == "elem")
+        {
+            batch.setElementResistance(element, instance, CoreElement(*node, frequency).getElemResistance());
+            element++;
+            continue;
+        }
+
+        for (auto iter = node->children.crbegin(); iter != node->children.crend(); iter++)
+            stack.push_back(&*iter);
+    }
+}
+
+PlanCache::PlanCache(size_t maxPlans)
+    : capacity(maxPlans), hits(0), misses(0)
+{
+}
+
+std::shared_ptr<CompiledPlan const> PlanCache::find(std::string const & signature) const
+{
+    uint64_t fingerprint = topologyFingerprint(signature);
+
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    auto iter = this->plans.find(fingerprint);
+    if (iter == this->plans.end() || iter->second->signature != signature)
+        return nullptr;
+    return iter->second;
+}
+
+void PlanCache::insert(std::string const & signature, CoreConnection const & root)
+{
+    CORE_ALLOCATION_PHASE(treeBuild);
+    uint64_t fingerprint = topologyFingerprint(signature);
+    {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        if (this->plans.size() >= this->capacity || this->plans.count(fingerprint) != 0)
+            return;
+    }
+
+    // План строится вне блокировки, чтобы не задерживать другие потоки
+    std::shared_ptr<CompiledPlan const> plan = std::make_shared<CompiledPlan const>(signature, root);
+
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (this->plans.size() < this->capacity)
+        this->plans.emplace(fingerprint, plan);
+}
+
+std::string PlanCache::evaluateDocument(DocumentNode const & rootElement, std::pmr::memory_resource* resource, bool normalizeTree)
+{
+    std::string signature = topologySignature(rootElement);
+    std::shared_ptr<CompiledPlan const> plan = this->find(signature);
+
+    if (plan != nullptr)
+    {
+        try {
+            VariantResults results = VariantEvaluator(plan->topology).evaluate(plan->bind(rootElement));
+            if (results.failedCount == 0)
+            {
+                this->hits++;
+                Metrics::countPlanCacheLookup(true);
+                return formatOutput(plan->topology, results, 0);
+            }
+        } catch (std::string const &) {
+            // Сообщение об ошибке формирует обычный расчет ниже
+        }
+    }
+
+    this->misses++;
+    Metrics::countPlanCacheLookup(false);
+    CircuitMap circuitMap(resource);
+    circuitFromDocument(rootElement, circuitMap);
+
+    CoreConnection& rootConnection = circuitMap.begin()->second;
+    // Нормализация сохраняет порядок элементов, поэтому план по упрощенному дереву связывается с документом так же
+    if (normalizeTree)
+        rootConnection.normalize(circuitMap);
+    rootConnection.calculateResistance();
+    rootConnection.calculateCurrentAndVoltage();
+
+    // Сохраняются только топологии, расчет по которым прошел без ошибок
+    if (plan == nullptr)
+        this->insert(signature, rootConnection);
+
+    return formatOutput(circuitMap);
+}
+
+std::vector<bool> PlanCache::evaluateDocuments(std::string const & signature, std::vector<DocumentNode const *> const & rootElements,
+                                               std::vector<std::string>& outputs, VariantEvaluator::Precision precision,
+                                               double tolerance)
+{
+    std::vector<bool> evaluated(rootElements.size(), false);
+    outputs.assign(rootElements.size(), std::string());
+    std::shared_ptr<CompiledPlan const> plan = this->find(signature);
+    if (plan == nullptr || rootElements.empty())
+        return evaluated;
+
+    // Вариант документа с ошибкой в значениях рассчитывается со значениями исходной цепи, а его результат не используется
+    std::vector<bool> isBound(rootElements.size(), false);
+    VariantResults results;
+    try {
+        CORE_ALLOCATION_PHASE(treeBuild);
+        VariantBatch batch(plan->topology, rootElements.size());
+        for (size_t k = 0; k < rootElements.size(); k++)
+        {
+            try {
+                plan->bind(*rootElements[k], batch, k);
+                isBound[k] = true;
+            } catch (std::string const &) {
+                // Сообщение об ошибке формирует обычный расчет документа
+            }
+        }
+        results = VariantEvaluator(plan->topology, VariantEvaluator::SimdLevel::automatic, precision, tolerance).evaluate(batch);
+    } catch (std::string const &) {
+        return evaluated;
+    }
+
+    for (size_t k = 0; k < rootElements.size(); k++)
+    {
+        if (!isBound[k] || !results.errors[k].empty())
+            continue;
+        outputs[k] = formatOutput(plan->topology, results, k);
+        evaluated[k] = true;
+        this->hits++;
+        Metrics::countPlanCacheLookup(true);
+    }
+    return evaluated;
+}
+
+size_t PlanCache::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    return this->plans.size();
+}
+
+size_t PlanCache::getHits() const
+{
+    return this->hits;
+}
+
+size_t PlanCache::getMisses() const
+{
+    return this->misses;
+}
+
+std::string PlanCache::topologySignature(DocumentNode const & rootElement)
+{
+    CORE_ALLOCATION_PHASE(treeBuild);
+    std::string signature;
+    appendNodeSignature(signature, rootElement);
+    return signature;
+}
+
+uint64_t PlanCache::topologyFingerprint(std::string const & signature)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char symbol : signature)
+    {
+        hash ^= symbol;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
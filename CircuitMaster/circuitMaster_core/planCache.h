@@ -0,0 +1,159 @@
+#ifndef PLANCACHE_H
+#define PLANCACHE_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "circuitTopology.h"
+#include "documentNode.h"
+#include "variantEvaluator.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций кэша топологий цепей
+*/
+
+/*!
+*\class CompiledPlan
+*\brief Подготовленная к расчету топология цепи
+*
+* Создается по дереву соединений первого документа с такой топологией. Для следующих документов
+* достаточно прочитать значения элементов и напряжение (см. bind), не строя дерево соединений заново
+*/
+class CompiledPlan
+{
+    public:
+    /*!
+    * \brief Конструктор плана
+    * \param[in] planSignature - каноническое описание топологии (см. PlanCache::topologySignature)
+    * \param[in] root - корневое соединение построенного по документу дерева
+    */
+    CompiledPlan(std::string const & planSignature, CoreConnection const & root);
+
+    std::string signature; /*!< Каноническое описание топологии */
+    CircuitTopology topology; /*!< Плоское представление цепи */
+
+    /*!
+    * \brief Прочитать значения элементов и напряжение из документа с той же топологией
+    * \param[in] rootElement - корневой узел документа
+    * \return - значения для расчета одного варианта
+    */
+    VariantBatch bind(DocumentNode const & rootElement) const;
+
+    /*!
+    * \brief Прочитать значения элементов и напряжение из документа с той же топологией в вариант набора
+    * \param[in] rootElement - корневой узел документа
+    * \param[in,out] batch - набор вариантов этой топологии
+    * \param[in] instance - номер варианта
+    */
+    void bind(DocumentNode const & rootElement, VariantBatch& batch, size_t instance) const;
+};
+
+/*!
+*\class PlanCache
+*\brief Кэш подготовленных топологий, доступный из нескольких потоков
+*
+* Ключом служит отпечаток топологии - хэш канонического описания документа, в которое входят
+* теги, имена соединений, типы элементов и наличие атрибутов напряжения и частоты, но не значения.
+* Совпадение отпечатков дополнительно проверяется сравнением описаний
+*/
+class PlanCache
+{
+    public:
+    /*!
+    * \brief Конструктор кэша
+    * \param[in] maxPlans - наибольшее количество хранимых топологий. Новые топологии сверх этого количества не сохраняются
+    */
+    PlanCache(size_t maxPlans = 1024);
+
+    private:
+    size_t capacity; /*!< Наибольшее количество хранимых топологий */
+    mutable std::shared_mutex mutex; /*!< Защита plans */
+    std::unordered_map<uint64_t, std::shared_ptr<CompiledPlan const>> plans; /*!< Топологии по отпечатку */
+    std::atomic<size_t> hits; /*!< Количество расчетов по готовой топологии */
+    std::atomic<size_t> misses; /*!< Количество расчетов с построением дерева соединений */
+
+    public:
+    /*!
+    * \brief Найти топологию
+    * \param[in] signature - каноническое описание топологии
+    * \return - топология или nullptr, если её нет в кэше
+    */
+    std::shared_ptr<CompiledPlan const> find(std::string const & signature) const;
+
+    /*!
+    * \brief Сохранить топологию, если её ещё нет в кэше и в нём есть место
+    * \param[in] signature - каноническое описание топологии
+    * \param[in] root - корневое соединение построенного по документу дерева
+    */
+    void insert(std::string const & signature, CoreConnection const & root);
+
+    /*!
+    * \brief Рассчитать цепь, используя готовую топологию, если она есть в кэше
+    *
+    * При ошибке расчет повторяется с построением дерева соединений, чтобы сообщение об ошибке
+    * совпадало с обычным расчетом
+    * \param[in] rootElement - корневой узел документа
+    * \param[in] resource - источник памяти для дерева соединений, если его приходится строить
+    * \param[in] normalizeTree - упростить построенное дерево соединений перед расчетом. Сохраняемая топология
+    * строится по упрощенному дереву. Кэш должен использоваться с одним значением параметра
+    * \return - текст для записи в выходной файл
+    */
+    std::string evaluateDocument(DocumentNode const & rootElement, std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                 bool normalizeTree = false);
+
+    /*!
+    * \brief Рассчитать документы с одинаковой топологией из кэша одним набором вариантов (см. VariantEvaluator)
+    *
+    * Документы, которые не удалось рассчитать по готовой топологии (топологии нет в кэше, ошибка в значениях
+    * или при расчете), не учитываются в счетчиках кэша: их нужно рассчитать по одному (см. evaluateDocument)
+    * \param[in] signature - каноническое описание топологии документов
+    * \param[in] rootElements - корневые узлы документов
+    * \param[out] outputs - текст для записи в выходной файл каждого рассчитанного документа
+    * \param[in] precision - точность расчета
+    * \param[in] tolerance - допустимая относительная погрешность силы тока при расчете в float
+    * \return - рассчитан ли каждый документ
+    */
+    std::vector<bool> evaluateDocuments(std::string const & signature, std::vector<DocumentNode const *> const & rootElements,
+                                        std::vector<std::string>& outputs,
+                                        VariantEvaluator::Precision precision = VariantEvaluator::Precision::full,
+                                        double tolerance = 1e-4);
+
+    /*!
+    * \brief Получить количество хранимых топологий
+    * \return - количество топологий
+    */
+    size_t size() const;
+
+    /*!
+    * \brief Получить количество расчетов по готовой топологии
+    * \return - количество расчетов
+    */
+    size_t getHits() const;
+
+    /*!
+    * \brief Получить количество расчетов с построением дерева соединений
+    * \return - количество расчетов
+    */
+    size_t getMisses() const;
+
+    /*!
+    * \brief Получить каноническое описание топологии документа
+    * \param[in] rootElement - корневой узел документа
+    * \return - описание топологии
+    */
+    static std::string topologySignature(DocumentNode const & rootElement);
+
+    /*!
+    * \brief Получить отпечаток топологии
+    * \param[in] signature - каноническое описание топологии
+    * \return - 64-битный хэш FNV-1a описания
+    */
+    static uint64_t topologyFingerprint(std::string const & signature);
+};
+
+#endif // PLANCACHE_H
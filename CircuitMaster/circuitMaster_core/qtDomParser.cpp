@@ -0,0 +1,63 @@
+#include "qtDomParser.h"
+#include <QString>
+#include <QtXml/QDomDocument>
+#include "allocationStats.h"
+#include "perfCounters.h"
+
+/*!
+*\file
+*\brief Реализация функций класса QtDomParser
+*/
+
+/*!
+* \brief Рекурсивно преобразовать узел QDomDocument в узел DocumentNode
+* \param[in] domNode - узел QDomDocument
+* \param[out] node - узел для записи
+*/
+static void convertDomNode(QDomNode const & domNode, DocumentNode& node)
+{
+    node.lineNumber = domNode.lineNumber();
+
+    if (domNode.isElement())
+    {
+        QDomElement element = domNode.toElement();
+        node.tagName = element.tagName().toStdString();
+
+        QDomNamedNodeMap attributes = element.attributes();
+        for (int i = 0; i < attributes.count(); i++)
+        {
+            QDomAttr attr = attributes.item(i).toAttr();
+            node.attributes.emplace_back(attr.name().toStdString(), attr.value().toStdString());
+        }
+    }
+    else
+    {
+        // Текст, CDATA, комментарии и прочие узлы сохраняются как текстовые узлы,
+        // чтобы количество детей совпадало с QDomNode::childNodes
+        node.text = domNode.nodeValue().toStdString();
+    }
+
+    QDomNodeList children = domNode.childNodes();
+    node.children.resize(children.count());
+    for (int i = 0; i < children.count(); i++)
+        convertDomNode(children.at(i), node.children[i]);
+}
+
+DocumentNode QtDomParser::parseText(std::string const & content) const
+{
+    CORE_ALLOCATION_PHASE(documentLoad);
+    CORE_PERF_PHASE(documentLoad);
+    QDomDocument domDocument;
+
+    // Переменные для получения ошибки от QDomDoc
+    QString errorMes;
+    int errorLine;
+
+    // Ошибка, если не удалось создать QDomDoc
+    if (!domDocument.setContent(QByteArray::fromRawData(content.data(), static_cast<int>(content.size())), &errorMes, &errorLine))
+        throw QString("Получена ошибка QDomDoc при открытии xml файла: \"%1\" на строке %2.").arg(errorMes, QString::number(errorLine)).toStdString();
+
+    DocumentNode root;
+    convertDomNode(domDocument.documentElement(), root);
+    return root;
+}
@@ -0,0 +1,28 @@
+#ifndef QTDOMPARSER_H
+#define QTDOMPARSER_H
+#include "documentParser.h"
+
+/*!
+*\file
+*\brief Заголовки функций класса QtDomParser
+*/
+
+/*!
+*\class QtDomParser
+*\brief Разборщик xml на основе QDomDocument
+*
+* Доступен только в сборке с Qt (CONFIG += qt_parser). Позволяет получить в ядре без Qt
+* в точности те же номера строк и ту же обработку синтаксических ошибок, что и в программе на Qt
+*/
+class QtDomParser : public DocumentParser
+{
+    public:
+    /*!
+    * \brief Разобрать текст документа
+    * \param[in] content - текст документа
+    * \return - корневой тэг документа
+    */
+    DocumentNode parseText(std::string const & content) const override;
+};
+
+#endif // QTDOMPARSER_H
@@ -0,0 +1,336 @@
+#include "resonanceAnalysis.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "circuitState.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+#include "frequencyDerivatives.h"
+
+/*!
+*\file
+*\brief Реализация функций класса ResonanceAnalysis
+*/
+
+namespace {
+
+// Точность уточнения логарифма частоты: относительная точность частоты
+const double logFrequencyTolerance = 1e-10;
+
+// Наибольшее количество итераций уточнения одного корня
+const int maxRootIterations = 100;
+
+// Отличие логарифма модуля на границе полосы 3 дБ от экстремума: ln(sqrt(2))
+const double halfPowerLog = std::log(2.0) / 2;
+
+// Шаг по логарифму частоты для оценки кривизны в экстремуме
+const double curvatureStep = 1e-4;
+
+/*!
+*\class Sample
+*\brief Логарифмы модулей и их производные по логарифму частоты на одной частоте
+*
+* Сигнал 0 - сопротивление цепи, сигнал k - сила тока k-го выбранного соединения
+*/
+class Sample
+{
+    public:
+    double logFrequency; /*!< Логарифм частоты */
+    std::vector<double> values; /*!< Логарифмы модулей сигналов */
+    std::vector<double> slopes; /*!< Производные логарифмов модулей по логарифму частоты */
+};
+
+/*!
+*\class FrequencyScan
+*\brief Расчет цепи на отдельных частотах с подсчетом их количества
+*/
+class FrequencyScan
+{
+    public:
+    FrequencyScan(CircuitTopology const & topology, std::vector<int> const & outputNodes)
+        : topology(topology), outputNodes(outputNodes)
+    {
+    }
+
+    CircuitTopology const & topology; /*!< Топология цепи */
+    std::vector<int> const & outputNodes; /*!< Выбранные соединения */
+    CircuitState state; /*!< Расчет на последней частоте */
+    FrequencyDerivatives derivatives; /*!< Производные на последней частоте */
+    std::vector<Sample> refined; /*!< Частоты, рассчитанные при уточнении, по возрастанию */
+    size_t evaluationCount = 0; /*!< Количество рассчитанных частот */
+
+    /*!
+    * \brief Рассчитать цепь на частоте
+    * \param[in] logFrequency - логарифм частоты
+    * \return - логарифмы модулей сигналов и их производные
+    */
+    Sample sample(double logFrequency)
+    {
+        this->evaluationCount++;
+        this->state.evaluate(this->topology, this->topology.rootVoltage, std::exp(logFrequency));
+        this->derivatives.evaluate(this->topology, this->state);
+
+        // Производная логарифма модуля - действительная часть относительной производной
+        Sample result;
+        result.logFrequency = logFrequency;
+        result.values.reserve(this->outputNodes.size() + 1);
+        result.slopes.reserve(this->outputNodes.size() + 1);
+        result.values.push_back(std::log(std::abs(this->state.resistances[0])));
+        result.slopes.push_back(std::real(this->derivatives.resistances[0] / this->state.resistances[0]));
+        for (auto iter = this->outputNodes.cbegin(); iter != this->outputNodes.cend(); iter++)
+        {
+            result.values.push_back(std::log(std::abs(this->state.currents[*iter])));
+            result.slopes.push_back(std::real(this->derivatives.currents[*iter] / this->state.currents[*iter]));
+        }
+        return result;
+    }
+
+    /*!
+    * \brief Получить расчет на частоте уточнения, рассчитывая цепь только на новой частоте
+    * \param[in] logFrequency - логарифм частоты
+    * \return - логарифмы модулей сигналов и их производные, ссылка действительна до следующего вызова
+    */
+    Sample const & refine(double logFrequency)
+    {
+        auto position = std::lower_bound(this->refined.begin(), this->refined.end(), logFrequency, [](Sample const & sample, double x) {
+            return sample.logFrequency < x;
+        });
+        if (position != this->refined.end() && position->logFrequency == logFrequency)
+            return *position;
+        return *this->refined.insert(position, this->sample(logFrequency));
+    }
+
+    /*!
+    * \brief Рассчитать силу тока соединения на частоте
+    * \param[in] logFrequency - логарифм частоты
+    * \param[in] node - номер соединения
+    * \return - сила тока
+    */
+    std::complex<double> current(double logFrequency, int node)
+    {
+        this->evaluationCount++;
+        this->state.evaluate(this->topology, this->topology.rootVoltage, std::exp(logFrequency));
+        return this->state.currents[node];
+    }
+
+    /*!
+    * \brief Найти корень функции сигналов на отрезке по частотам уточнения
+    *
+    * Экстремумы разных сигналов часто находятся рядом, поэтому отрезок сначала сужается по частотам,
+    * уже рассчитанным при уточнении других сигналов
+    * \param[in] a - левый конец отрезка
+    * \param[in] fa - значение функции на левом конце
+    * \param[in] b - правый конец отрезка
+    * \param[in] fb - значение функции на правом конце
+    * \param[in] value - функция расчета на частоте
+    * \return - корень
+    */
+    template<typename Value>
+    double findRefinedRoot(double a, double fa, double b, double fb, Value value)
+    {
+        auto position = std::upper_bound(this->refined.cbegin(), this->refined.cend(), a, [](double x, Sample const & sample) {
+            return x < sample.logFrequency;
+        });
+        for (; position != this->refined.cend() && position->logFrequency < b; position++)
+        {
+            double sampleValue = value(*position);
+            if (sampleValue != 0 && (sampleValue > 0) == (fa > 0))
+                a = position->logFrequency, fa = sampleValue;
+            else
+            {
+                b = position->logFrequency, fb = sampleValue;
+                break;
+            }
+        }
+        return findRoot(a, fa, b, fb, [&](double x) { return value(this->refine(x)); });
+    }
+
+    /*!
+    * \brief Найти корень функции на отрезке, на концах которого она имеет разные знаки, методом хорд
+    *
+    * Используется модификация Illinois: если один конец отрезка не сдвигается два шага подряд,
+    * значение функции на нём уменьшается вдвое
+    * \param[in] a - левый конец отрезка
+    * \param[in] fa - значение функции на левом конце
+    * \param[in] b - правый конец отрезка
+    * \param[in] fb - значение функции на правом конце
+    * \param[in] function - функция
+    * \return - корень
+    */
+    template<typename Function>
+    static double findRoot(double a, double fa, double b, double fb, Function function)
+    {
+        if (fa == 0)
+            return a;
+        if (fb == 0)
+            return b;
+
+        int lastMoved = 0;
+        double x = (a + b) / 2;
+        for (int i = 0; i < maxRootIterations && b - a > logFrequencyTolerance; i++)
+        {
+            x = (a * fb - b * fa) / (fb - fa);
+            if (!(x > a && x < b))
+                x = (a + b) / 2;
+            double fx = function(x);
+            if (fx == 0)
+                return x;
+            if ((fx > 0) == (fb > 0))
+            {
+                b = x, fb = fx;
+                if (lastMoved == 1)
+                    fa /= 2;
+                lastMoved = 1;
+            }
+            else
+            {
+                a = x, fa = fx;
+                if (lastMoved == -1)
+                    fb /= 2;
+                lastMoved = -1;
+            }
+        }
+        return x;
+    }
+};
+
+/*!
+* \brief Найти границу полосы 3 дБ экстремума в одну сторону
+* \param[in] scan - расчет цепи на частотах
+* \param[in] samples - рассчитанные частоты по возрастанию
+* \param[in] signal - номер сигнала
+* \param[in] logFrequency - логарифм частоты экстремума
+* \param[in] value - логарифм модуля в экстремуме
+* \param[in] isMaximum - true - максимум, false - минимум
+* \param[in] start - номер первой рассчитанной частоты в направлении поиска
+* \param[in] direction - направление поиска: 1 - к большим частотам, -1 - к меньшим
+* \return - логарифм частоты границы, NaN - граница не найдена в диапазоне
+*/
+double halfPowerBound(FrequencyScan& scan, std::vector<Sample> const & samples, size_t signal, double logFrequency, double value,
+                      bool isMaximum, size_t start, int direction)
+{
+    // Функция положительна внутри полосы и отрицательна за её границей
+    double sign = isMaximum ? 1 : -1;
+    double target = value - sign * halfPowerLog;
+    auto bandFunction = [&](Sample const & sample) { return sign * (sample.values[signal] - target); };
+
+    double previous = logFrequency;
+    double previousValue = halfPowerLog;
+
+    // При поиске к меньшим частотам номер после 0 переполняется, и цикл завершается
+    for (size_t j = start; j < samples.size(); j = direction > 0 ? j + 1 : j - 1)
+    {
+        Sample const & sample = samples[j];
+        double current = bandFunction(sample);
+        if (current <= 0)
+        {
+            if (direction > 0)
+                return scan.findRefinedRoot(previous, previousValue, sample.logFrequency, current, bandFunction);
+            return scan.findRefinedRoot(sample.logFrequency, current, previous, previousValue, bandFunction);
+        }
+
+        // Модуль снова приближается к экстремуму: до границы полосы встретился другой экстремум
+        if (sign * sample.slopes[signal] * direction > 0)
+            break;
+        previous = sample.logFrequency;
+        previousValue = current;
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+}
+
+ResonanceAnalysis ResonanceAnalysis::evaluate(CircuitTopology const & topology, double from, double to, ResonanceOptions const & options)
+{
+    CORE_TRACE_SPAN("ResonanceAnalysis::evaluate");
+    if (topology.frequency <= 0)
+        throw std::string("Для поиска резонансов необходимо указать частоту \"frequency\" как атрибут корневого элемента цепи.");
+    if (!(from > 0) || !(to > from))
+        throw formatStr("Недопустимый диапазон частот от %1 до %2.", { numberToStr(from), numberToStr(to) });
+
+    ResonanceAnalysis analysis;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            analysis.outputNodes.push_back(static_cast<int>(n));
+    }
+    std::stable_sort(analysis.outputNodes.begin(), analysis.outputNodes.end(), [&](int left, int right) {
+        return topology.nodes[left].customName < topology.nodes[right].customName;
+    });
+    size_t signalCount = analysis.outputNodes.size() + 1;
+    FrequencyScan scan(topology, analysis.outputNodes);
+
+    // Начальная сетка с равным шагом по логарифму частоты
+    double logFrom = std::log(from), logTo = std::log(to);
+    size_t initialPoints = std::max<size_t>(2, options.initialPoints);
+    std::vector<Sample> samples;
+    for (size_t i = 0; i < initialPoints; i++)
+        samples.push_back(scan.sample(i + 1 == initialPoints ? logTo : logFrom + (logTo - logFrom) * i / (initialPoints - 1)));
+
+    // Промежутки делятся пополам, пока середина не совпадет с кубической интерполяцией по концам
+    std::vector<std::pair<size_t, size_t>> intervals;
+    for (size_t i = initialPoints - 1; i > 0; i--)
+        intervals.push_back({ i - 1, i });
+    while (!intervals.empty() && scan.evaluationCount < options.maxEvaluations)
+    {
+        size_t left = intervals.back().first, right = intervals.back().second;
+        intervals.pop_back();
+        double width = samples[right].logFrequency - samples[left].logFrequency;
+        if (width <= logFrequencyTolerance)
+            continue;
+
+        Sample middle = scan.sample(samples[left].logFrequency + width / 2);
+        bool isSmooth = true;
+        for (size_t k = 0; k < signalCount && isSmooth; k++)
+        {
+            double predicted = (samples[left].values[k] + samples[right].values[k]) / 2 +
+                               width / 8 * (samples[left].slopes[k] - samples[right].slopes[k]);
+            isSmooth = !(std::abs(predicted - middle.values[k]) > options.tolerance);
+        }
+        samples.push_back(std::move(middle));
+        if (!isSmooth)
+        {
+            intervals.push_back({ samples.size() - 1, right });
+            intervals.push_back({ left, samples.size() - 1 });
+        }
+    }
+    std::sort(samples.begin(), samples.end(), [](Sample const & left, Sample const & right) {
+        return left.logFrequency < right.logFrequency;
+    });
+
+    // Экстремум - между соседними частотами, на которых производная меняет знак
+    for (size_t k = 0; k < signalCount; k++)
+    {
+        int node = k == 0 ? -1 : analysis.outputNodes[k - 1];
+        for (size_t i = 0; i + 1 < samples.size(); i++)
+        {
+            double leftSlope = samples[i].slopes[k], rightSlope = samples[i + 1].slopes[k];
+            bool isMaximum = leftSlope > 0 && rightSlope <= 0;
+            if (!isMaximum && !(leftSlope < 0 && rightSlope >= 0))
+                continue;
+
+            double logFrequency = scan.findRefinedRoot(samples[i].logFrequency, leftSlope, samples[i + 1].logFrequency, rightSlope,
+                                                       [&](Sample const & sample) { return sample.slopes[k]; });
+            double value = scan.refine(logFrequency).values[k];
+            Resonance resonance;
+            resonance.node = node;
+            resonance.isMaximum = isMaximum;
+            resonance.frequency = std::exp(logFrequency);
+            resonance.current = scan.current(logFrequency, node < 0 ? 0 : node);
+
+            double lower = halfPowerBound(scan, samples, k, logFrequency, value, isMaximum, i, -1);
+            double upper = halfPowerBound(scan, samples, k, logFrequency, value, isMaximum, i + 1, 1);
+            if (!std::isnan(lower) && !std::isnan(upper))
+                resonance.q = resonance.frequency / (std::exp(upper) - std::exp(lower));
+            else
+            {
+                double upperSlope = scan.refine(logFrequency + curvatureStep).slopes[k];
+                double curvature = (upperSlope - scan.refine(logFrequency - curvatureStep).slopes[k]) / (2 * curvatureStep);
+                resonance.q = std::sqrt(std::abs(curvature)) / 2;
+            }
+            analysis.resonances.push_back(resonance);
+        }
+    }
+    analysis.evaluationCount = scan.evaluationCount;
+    return analysis;
+}
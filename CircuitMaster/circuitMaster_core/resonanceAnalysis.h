@@ -0,0 +1,73 @@
+#ifndef RESONANCEANALYSIS_H
+#define RESONANCEANALYSIS_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций поиска резонансов цепи в диапазоне частот
+*/
+
+/*!
+*\class ResonanceOptions
+*\brief Параметры поиска резонансов
+*/
+class ResonanceOptions
+{
+    public:
+    size_t initialPoints = 32; /*!< Количество частот начальной сетки */
+    double tolerance = 1e-3; /*!< Допустимая ошибка интерполяции логарифма модуля между соседними частотами */
+    size_t maxEvaluations = 10000; /*!< Наибольшее количество частот, на которых рассчитывается цепь */
+};
+
+/*!
+*\class Resonance
+*\brief Локальный экстремум модуля сопротивления цепи или силы тока соединения
+*/
+class Resonance
+{
+    public:
+    int node; /*!< Номер соединения, сила тока которого достигает экстремума, -1 - сопротивление цепи */
+    bool isMaximum; /*!< true - максимум, false - минимум */
+    double frequency; /*!< Частота экстремума */
+    double q; /*!< Добротность: частота, деленная на ширину полосы по уровню 3 дБ */
+    std::complex<double> current; /*!< Сила тока соединения на частоте экстремума, для сопротивления цепи - сила тока цепи */
+};
+
+/*!
+*\class ResonanceAnalysis
+*\brief Резонансы цепи: экстремумы модуля сопротивления цепи и сил тока именованных соединений по частоте
+*
+* Цепь рассчитывается на начальной сетке частот вместе с производными по частоте (см. FrequencyDerivatives).
+* Промежуток между соседними частотами делится пополам, пока логарифм модуля в середине отличается от
+* кубической интерполяции по значениям и производным на концах больше чем на tolerance, поэтому частоты
+* сгущаются только у резонансов. Экстремум находится между соседними частотами, на которых производная
+* меняет знак, и уточняется методом хорд до относительной точности частоты 1e-10. Добротность считается по
+* частотам, на которых модуль отличается от экстремума в sqrt(2) раз; если одна из них не найдена в диапазоне,
+* добротность оценивается по кривизне: у резонансного контура вторая производная логарифма модуля по
+* логарифму частоты в экстремуме равна -4Q^2 для максимума и 4Q^2 для минимума
+*/
+class ResonanceAnalysis
+{
+    public:
+    std::vector<int> outputNodes; /*!< Номера соединений с указанным именем, по алфавиту имен */
+    std::vector<Resonance> resonances; /*!< Экстремумы сопротивления цепи, затем сил тока соединений в порядке outputNodes, по возрастанию частоты */
+    size_t evaluationCount = 0; /*!< Количество частот, на которых рассчитана цепь */
+
+    /*!
+    * \brief Найти резонансы в диапазоне частот
+    *
+    * Ошибки расчета сообщаются исключением std::string
+    * \param[in] topology - топология цепи с известной частотой
+    * \param[in] from - начальная частота
+    * \param[in] to - конечная частота
+    * \param[in] options - параметры поиска
+    * \return - найденные резонансы
+    */
+    static ResonanceAnalysis evaluate(CircuitTopology const & topology, double from, double to,
+                                      ResonanceOptions const & options = ResonanceOptions());
+};
+
+#endif // RESONANCEANALYSIS_H
@@ -0,0 +1,476 @@
+#include "transferFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "circuitState.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций классов RationalFunction и TransferFunction
+*/
+
+namespace {
+
+using Polynomial = std::vector<std::complex<double>>;
+
+/*!
+* \brief Убрать нулевые коэффициенты при старших степенях, оставив хотя бы один коэффициент
+* \param[in,out] poly - многочлен
+*/
+void trim(Polynomial& poly)
+{
+    while (poly.size() > 1 && poly.back() == std::complex<double>(0))
+        poly.pop_back();
+}
+
+/*!
+* \brief Перемножить многочлены
+* \param[in] a - первый многочлен
+* \param[in] b - второй многочлен
+* \return - произведение
+*/
+Polynomial multiply(Polynomial const & a, Polynomial const & b)
+{
+    Polynomial result(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        for (size_t j = 0; j < b.size(); j++)
+            result[i + j] += a[i] * b[j];
+    }
+    trim(result);
+    return result;
+}
+
+/*!
+* \brief Сложить многочлены
+* \param[in] a - первый многочлен
+* \param[in] b - второй многочлен
+* \return - сумма
+*/
+Polynomial add(Polynomial const & a, Polynomial const & b)
+{
+    Polynomial result(std::max(a.size(), b.size()), 0);
+    for (size_t i = 0; i < a.size(); i++)
+        result[i] += a[i];
+    for (size_t i = 0; i < b.size(); i++)
+        result[i] += b[i];
+    trim(result);
+    return result;
+}
+
+/*!
+* \brief Умножить многочлен на число
+* \param[in,out] poly - многочлен
+* \param[in] factor - множитель
+*/
+void scale(Polynomial& poly, double factor)
+{
+    for (auto iter = poly.begin(); iter != poly.end(); iter++)
+        *iter *= factor;
+}
+
+/*!
+* \brief Получить множитель, приводящий наибольший по модулю коэффициент многочлена к единице
+* \param[in] poly - многочлен
+* \return - множитель, 1 для нулевого многочлена
+*/
+double normalizingFactor(Polynomial const & poly)
+{
+    double largest = 0;
+    for (auto iter = poly.cbegin(); iter != poly.cend(); iter++)
+        largest = std::max(largest, std::abs(*iter));
+    return largest > 0 ? 1 / largest : 1;
+}
+
+/*!
+* \brief Вычислить многочлен схемой Горнера
+* \param[in] poly - многочлен
+* \param[in] p - значение переменной
+* \return - значение многочлена
+*/
+std::complex<double> horner(Polynomial const & poly, std::complex<double> p)
+{
+    std::complex<double> value = 0;
+    for (auto iter = poly.crbegin(); iter != poly.crend(); iter++)
+        value = value * p + *iter;
+    return value;
+}
+
+/*!
+* \brief Номер сомножителя, обозначающий многочлен p
+*/
+const int variableFactor = -1;
+
+/*!
+*\brief Произведение положительного числа и многочленов, заданных номерами: номер соединения обозначает знаменатель
+* параллельного соединения или числитель последовательного, variableFactor - многочлен p
+*
+* Силы тока соединений записываются как отношения таких произведений, поэтому одинаковые многочлены
+* числителя и знаменателя сокращаются по номерам, без деления многочленов
+*/
+struct FactorProduct
+{
+    double log2Scale = 0; /*!< Двоичный логарифм числового множителя: множители глубоких цепей выходят за пределы double */
+    std::vector<int> factors; /*!< Номера многочленов-сомножителей */
+
+    /*!
+    * \brief Умножить на другое произведение
+    * \param[in] other - множитель
+    */
+    void multiply(FactorProduct const & other)
+    {
+        this->log2Scale += other.log2Scale;
+        this->factors.insert(this->factors.end(), other.factors.cbegin(), other.factors.cend());
+    }
+};
+
+/*!
+* \brief Сократить одинаковые сомножители числителя и знаменателя
+* \param[in,out] numerator - числитель
+* \param[in,out] denominator - знаменатель
+*/
+void cancelCommonFactors(FactorProduct& numerator, FactorProduct& denominator)
+{
+    std::sort(numerator.factors.begin(), numerator.factors.end());
+    std::sort(denominator.factors.begin(), denominator.factors.end());
+
+    std::vector<int> numeratorLeft, denominatorLeft;
+    std::set_difference(numerator.factors.cbegin(), numerator.factors.cend(), denominator.factors.cbegin(), denominator.factors.cend(),
+                        std::back_inserter(numeratorLeft));
+    std::set_difference(denominator.factors.cbegin(), denominator.factors.cend(), numerator.factors.cbegin(), numerator.factors.cend(),
+                        std::back_inserter(denominatorLeft));
+    numerator.factors.swap(numeratorLeft);
+    denominator.factors.swap(denominatorLeft);
+}
+
+}
+
+size_t RationalFunction::degree() const
+{
+    return std::max(this->numerator.size(), this->denominator.size()) - 1;
+}
+
+void RationalFunction::evaluate(std::complex<double> p, std::complex<double>& numeratorValue, std::complex<double>& denominatorValue) const
+{
+    numeratorValue = horner(this->numerator, p);
+    denominatorValue = horner(this->denominator, p);
+}
+
+TransferFunction TransferFunction::compile(CircuitTopology const & topology, double frequency)
+{
+    std::vector<int> outputNodes;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+            outputNodes.push_back(static_cast<int>(n));
+    }
+    return compile(topology, frequency, outputNodes);
+}
+
+TransferFunction TransferFunction::compile(CircuitTopology const & topology, double frequency, std::vector<int> const & outputNodes,
+                                           size_t maxDegree)
+{
+    CORE_TRACE_SPAN("TransferFunction::compile");
+    size_t nodeCount = topology.nodes.size();
+    const std::complex<double> j(0, 1);
+
+    TransferFunction function;
+    function.baseFrequency = frequency;
+    function.voltage = topology.rootVoltage;
+
+    // Сопротивление соединения n равно numerators[n] / denominators[n]. Те же многочлены записываются произведениями
+    // numeratorFactors[n] и denominatorFactors[n] (см. FactorProduct); parallelScales[n] - множитель, на который
+    // умножены числитель и знаменатель параллельного соединения
+    std::vector<Polynomial> numerators(nodeCount), denominators(nodeCount);
+    std::vector<FactorProduct> numeratorFactors(nodeCount), denominatorFactors(nodeCount);
+    std::vector<double> parallelScales(nodeCount, 1);
+
+    // Дети расположены после родителя, поэтому обход с конца рассчитывает детей раньше
+    for (size_t n = nodeCount; n-- > 0;)
+    {
+        CircuitTopology::Node const & node = topology.nodes[n];
+        Polynomial& numerator = numerators[n];
+        Polynomial& denominator = denominators[n];
+
+        if (node.type == CoreConnection::ConnectionType::sequential)
+        {
+            // Z = r + l * p + c / p, где p = j на частоте исходной цепи
+            std::complex<double> r = 0, l = 0, c = 0;
+            for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+            {
+                std::complex<double> resistance = topology.elementResistances[e];
+                switch (topology.elementTypes[e]) {
+                case CoreElement::ElemType::L:
+                    l += resistance / j;
+                    break;
+                case CoreElement::ElemType::C:
+                    c += resistance * j;
+                    break;
+                default:
+                    r += resistance;
+                    break;
+                }
+            }
+
+            if (frequency <= 0 && (l != std::complex<double>(0) || c != std::complex<double>(0)))
+                throw formatStr("Для расчета соединения %1 на других частотах необходимо указать частоту \"frequency\" "
+                                "как атрибут корневого элемента цепи.", { node.displayName() });
+
+            if (c != std::complex<double>(0))
+            {
+                numerator = { c, r, l };
+                denominator = { 0, 1 };
+                denominatorFactors[n].factors = { variableFactor };
+            }
+            else
+            {
+                numerator = { r, l };
+                denominator = { 1 };
+            }
+            trim(numerator);
+            numeratorFactors[n].factors = { static_cast<int>(n) };
+        }
+        else if (node.type == CoreConnection::ConnectionType::sequentialComplex)
+        {
+            numerator = { 0 };
+            denominator = { 1 };
+            for (int k = node.firstChild; k < node.firstChild + node.childCount; k++)
+            {
+                int child = topology.childIndices[k];
+                // Одинаковые знаменатели (например, у соединений из резисторов и катушек) не перемножаются
+                if (denominator == denominators[child])
+                    numerator = add(numerator, numerators[child]);
+                else
+                {
+                    numerator = add(multiply(numerator, denominators[child]), multiply(numerators[child], denominator));
+                    denominator = multiply(denominator, denominators[child]);
+                    denominatorFactors[n].multiply(denominatorFactors[child]);
+                }
+            }
+            numeratorFactors[n].factors = { static_cast<int>(n) };
+        }
+        else if (node.type == CoreConnection::ConnectionType::parallel)
+        {
+            // 1/Z = сумма denominators[i] / numerators[i]. Слагаемое ребёнка c в общем знаменателе -
+            // denominators[c], умноженный на числители остальных детей (произведения слева и справа)
+            std::vector<Polynomial> suffix(node.childCount + 1, Polynomial{ 1 });
+            for (int k = node.childCount; k-- > 0;)
+                suffix[k] = multiply(suffix[k + 1], numerators[topology.childIndices[node.firstChild + k]]);
+
+            Polynomial prefix = { 1 };
+            denominator = { 0 };
+            for (int k = 0; k < node.childCount; k++)
+            {
+                int child = topology.childIndices[node.firstChild + k];
+                denominator = add(denominator, multiply(multiply(prefix, suffix[k + 1]), denominators[child]));
+                prefix = multiply(prefix, numerators[child]);
+                numeratorFactors[n].multiply(numeratorFactors[child]);
+            }
+            numerator = prefix;
+
+            // Общий множитель не меняет сопротивление, но удерживает коэффициенты в пределах double
+            double factor = normalizingFactor(denominator);
+            scale(numerator, factor);
+            scale(denominator, factor);
+            parallelScales[n] = factor;
+            numeratorFactors[n].log2Scale += std::log2(factor);
+            denominatorFactors[n].factors = { static_cast<int>(n) };
+        }
+
+        if (std::max(numerator.size(), denominator.size()) - 1 > maxDegree)
+            throw formatStr("Степень передаточной функции соединения %1 больше %2. Цепь содержит слишком много катушек "
+                            "и конденсаторов для расчета по передаточным функциям.", { node.displayName(), numberToStr(static_cast<int>(maxDegree)) });
+    }
+
+    function.impedance.numerator = numerators[0];
+    function.impedance.denominator = denominators[0];
+
+    // Сила тока I[n] = U * currentNumerators[n] / currentDenominators[n]. Рассчитывается только для выбранных
+    // соединений и их предков: у детей последовательного соединения она та же, что у родителя, у ребёнка c
+    // параллельного соединения p - сила тока родителя, умноженная на Z[p] / Z[c] = denominators[c] * (числители
+    // остальных детей) / denominators[p]. Знаменатель родителя сокращается с denominators[c] внуков, поэтому
+    // степень силы тока растет как степень цепи, а не как сумма степеней всех предков
+    std::vector<bool> isNeeded(nodeCount, false);
+    for (auto iter = outputNodes.cbegin(); iter != outputNodes.cend(); iter++)
+    {
+        for (int n = *iter; n >= 0 && !isNeeded[n]; n = topology.nodes[n].parent)
+            isNeeded[n] = true;
+    }
+
+    auto factorPolynomial = [&](int factor) -> Polynomial const & {
+        static const Polynomial variable = { 0, 1 };
+        if (factor == variableFactor)
+            return variable;
+        return topology.nodes[factor].type == CoreConnection::ConnectionType::parallel ? denominators[factor] : numerators[factor];
+    };
+    auto productDegree = [&](FactorProduct const & product) {
+        size_t degree = 0;
+        for (auto iter = product.factors.cbegin(); iter != product.factors.cend(); iter++)
+            degree += factorPolynomial(*iter).size() - 1;
+        return degree;
+    };
+
+    std::vector<FactorProduct> currentNumerators(nodeCount), currentDenominators(nodeCount);
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        if (!isNeeded[n])
+            continue;
+
+        int parent = topology.nodes[n].parent;
+        if (parent < 0)
+        {
+            currentNumerators[n] = denominatorFactors[n];
+            currentDenominators[n] = numeratorFactors[n];
+        }
+        else if (topology.nodes[parent].type == CoreConnection::ConnectionType::parallel)
+        {
+            CircuitTopology::Node const & parentNode = topology.nodes[parent];
+            currentNumerators[n] = currentNumerators[parent];
+            currentNumerators[n].multiply(denominatorFactors[n]);
+            for (int k = parentNode.firstChild; k < parentNode.firstChild + parentNode.childCount; k++)
+            {
+                int sibling = topology.childIndices[k];
+                if (sibling != static_cast<int>(n))
+                    currentNumerators[n].multiply(numeratorFactors[sibling]);
+            }
+            currentNumerators[n].log2Scale += std::log2(parallelScales[parent]);
+
+            currentDenominators[n] = currentDenominators[parent];
+            currentDenominators[n].factors.push_back(parent);
+            cancelCommonFactors(currentNumerators[n], currentDenominators[n]);
+        }
+        else
+        {
+            currentNumerators[n] = currentNumerators[parent];
+            currentDenominators[n] = currentDenominators[parent];
+        }
+
+        if (std::max(productDegree(currentNumerators[n]), productDegree(currentDenominators[n])) > maxDegree)
+            throw formatStr("Степень передаточной функции силы тока соединения %1 больше %2. Цепь содержит слишком много "
+                            "катушек и конденсаторов для расчета по передаточным функциям.",
+                            { topology.nodes[n].displayName(), numberToStr(static_cast<int>(maxDegree)) });
+    }
+
+    // Произведения раскрываются только для выбранных соединений. Коэффициенты приводятся к единице после каждого
+    // умножения, а накопленный множитель учитывается в логарифме, чтобы не выйти за пределы double
+    auto expand = [&](FactorProduct const & product, double& log2Scale) {
+        Polynomial result = { 1 };
+        log2Scale = product.log2Scale;
+        for (auto iter = product.factors.cbegin(); iter != product.factors.cend(); iter++)
+        {
+            result = multiply(result, factorPolynomial(*iter));
+            double factor = normalizingFactor(result);
+            scale(result, factor);
+            log2Scale -= std::log2(factor);
+        }
+        return result;
+    };
+
+    for (auto iter = outputNodes.cbegin(); iter != outputNodes.cend(); iter++)
+    {
+        double numeratorLog2 = 0, denominatorLog2 = 0;
+        RationalFunction current;
+        current.numerator = expand(currentNumerators[*iter], numeratorLog2);
+        current.denominator = expand(currentDenominators[*iter], denominatorLog2);
+        scale(current.numerator, std::exp2(numeratorLog2 - denominatorLog2));
+        function.names.push_back(topology.nodes[*iter].displayName());
+        function.currents.push_back(current);
+    }
+    return function;
+}
+
+std::complex<double> TransferFunction::evaluateImpedance(double frequency) const
+{
+    std::complex<double> numeratorValue, denominatorValue;
+    this->impedance.evaluate(this->variableAt(frequency), numeratorValue, denominatorValue);
+
+    if (numeratorValue == std::complex<double>(0) || denominatorValue == std::complex<double>(0))
+        throw formatStr("При расчете сопротивления цепи на частоте %1 получено недопустимое значение.", { numberToStr(frequency) });
+    return numeratorValue / denominatorValue;
+}
+
+std::complex<double> TransferFunction::evaluateCurrent(size_t output, double frequency) const
+{
+    std::complex<double> numeratorValue, denominatorValue;
+    this->currents[output].evaluate(this->variableAt(frequency), numeratorValue, denominatorValue);
+
+    if (denominatorValue == std::complex<double>(0))
+        throw formatStr("При расчете силы тока соединения %1 на частоте %2 получено недопустимое значение.",
+                        { this->names[output], numberToStr(frequency) });
+    return this->voltage * numeratorValue / denominatorValue;
+}
+
+std::vector<double> TransferFunction::logFrequencies(double from, double to, size_t count)
+{
+    if (from <= 0 || to <= 0 || count == 0)
+        throw std::string("Неверно указан диапазон частот. Частоты должны быть больше 0, количество частот - не меньше 1.");
+
+    std::vector<double> frequencies;
+    for (size_t k = 0; k < count; k++)
+        frequencies.push_back(count == 1 ? from : from * std::pow(to / from, static_cast<double>(k) / (count - 1)));
+    return frequencies;
+}
+
+std::complex<double> TransferFunction::variableAt(double frequency) const
+{
+    if (frequency <= 0)
+        throw formatStr("Недопустимое значение частоты %1. Значение частоты должно быть больше 0.", { numberToStr(frequency) });
+
+    // Если частота исходной цепи неизвестна, в цепи только резисторы и значение p не влияет на результат
+    return std::complex<double>(0, this->baseFrequency > 0 ? frequency / this->baseFrequency : 1);
+}
+
+FrequencySweep FrequencySweep::evaluate(CircuitTopology const & topology, std::vector<double> const & frequencies)
+{
+    TransferFunction function;
+    try {
+        function = TransferFunction::compile(topology, topology.frequency);
+    } catch (std::string const &) {
+        return evaluateDirect(topology, frequencies);
+    }
+    return evaluate(function, frequencies);
+}
+
+FrequencySweep FrequencySweep::evaluate(TransferFunction const & function, std::vector<double> const & frequencies)
+{
+    CORE_TRACE_SPAN("FrequencySweep::evaluate");
+    FrequencySweep sweep;
+    sweep.frequencies = frequencies;
+    sweep.names = function.names;
+    sweep.currents.resize(frequencies.size());
+    for (size_t f = 0; f < frequencies.size(); f++)
+    {
+        for (size_t i = 0; i < function.names.size(); i++)
+            sweep.currents[f].push_back(function.evaluateCurrent(i, frequencies[f]));
+    }
+    return sweep;
+}
+
+FrequencySweep FrequencySweep::evaluateDirect(CircuitTopology const & topology, std::vector<double> const & frequencies)
+{
+    CORE_TRACE_SPAN("FrequencySweep::evaluateDirect");
+    FrequencySweep sweep;
+    sweep.frequencies = frequencies;
+    sweep.isDirect = true;
+    std::vector<int> outputNodes;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        if (topology.nodes[n].hasCustomName)
+        {
+            outputNodes.push_back(static_cast<int>(n));
+            sweep.names.push_back(topology.nodes[n].displayName());
+        }
+    }
+
+    CircuitState state;
+    sweep.currents.resize(frequencies.size());
+    for (size_t f = 0; f < frequencies.size(); f++)
+    {
+        state.evaluate(topology, topology.rootVoltage, frequencies[f]);
+        for (auto iter = outputNodes.cbegin(); iter != outputNodes.cend(); iter++)
+            sweep.currents[f].push_back(state.currents[*iter]);
+    }
+    return sweep;
+}
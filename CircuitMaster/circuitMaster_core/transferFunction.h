@@ -0,0 +1,153 @@
+#ifndef TRANSFERFUNCTION_H
+#define TRANSFERFUNCTION_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета цепи на любой частоте по передаточным функциям
+*/
+
+/*!
+*\class RationalFunction
+*\brief Отношение двух многочленов от p = j * f / f0, где f0 - частота исходной цепи
+*
+* Коэффициенты хранятся по возрастанию степени: coefficients[k] - коэффициент при p^k
+*/
+class RationalFunction
+{
+    public:
+    std::vector<std::complex<double>> numerator; /*!< Коэффициенты числителя */
+    std::vector<std::complex<double>> denominator; /*!< Коэффициенты знаменателя */
+
+    /*!
+    * \brief Получить наибольшую из степеней числителя и знаменателя
+    * \return - степень
+    */
+    size_t degree() const;
+
+    /*!
+    * \brief Вычислить числитель и знаменатель схемой Горнера
+    * \param[in] p - значение переменной
+    * \param[out] numeratorValue - значение числителя
+    * \param[out] denominatorValue - значение знаменателя
+    */
+    void evaluate(std::complex<double> p, std::complex<double>& numeratorValue, std::complex<double>& denominatorValue) const;
+};
+
+/*!
+*\class TransferFunction
+*\brief Сопротивление цепи и силы тока выбранных соединений как функции частоты
+*
+* Сопротивления элементов равны R, jwL и 1/(jwC), поэтому сопротивление цепи и отношение силы тока
+* любого соединения к напряжению цепи - рациональные функции частоты. Они строятся один раз по
+* топологии (см. compile), после чего расчет на любой частоте занимает время, пропорциональное
+* степени многочленов, и не зависит от количества соединений. Сопротивления катушек и конденсаторов
+* пересчитываются с частоты исходной цепи, даже если они указаны через \c <res>.
+*
+* Многочлены сопротивлений не сокращаются, поэтому их степень растет с количеством катушек и конденсаторов;
+* в силах тока сокращаются общие сомножители предков. Подходит для небольших и средних цепей (см. maxDegree у compile)
+*/
+class TransferFunction
+{
+    public:
+    double baseFrequency = -1; /*!< Частота исходной цепи, -1 - неизвестна (в цепи только резисторы) */
+    std::complex<double> voltage; /*!< Напряжение корневого соединения */
+    RationalFunction impedance; /*!< Сопротивление корневого соединения */
+    std::vector<std::string> names; /*!< Имена выбранных соединений */
+    std::vector<RationalFunction> currents; /*!< Отношения силы тока выбранных соединений к напряжению цепи */
+
+    /*!
+    * \brief Построить передаточные функции по топологии цепи
+    * \param[in] topology - топология цепи
+    * \param[in] frequency - частота, на которой заданы сопротивления элементов топологии, -1 - неизвестна
+    * \param[in] outputNodes - номера соединений, силы тока которых нужно рассчитывать
+    * \param[in] maxDegree - наибольшая допустимая степень многочленов. Многочлены вычисляются по степеням p, поэтому
+    * при большей степени на диапазоне в несколько декад теряется точность
+    * \return - передаточные функции
+    */
+    static TransferFunction compile(CircuitTopology const & topology, double frequency, std::vector<int> const & outputNodes,
+                                    size_t maxDegree = 24);
+
+    /*!
+    * \brief Построить передаточные функции для соединений с указанным именем
+    * \param[in] topology - топология цепи
+    * \param[in] frequency - частота, на которой заданы сопротивления элементов топологии, -1 - неизвестна
+    * \return - передаточные функции
+    */
+    static TransferFunction compile(CircuitTopology const & topology, double frequency);
+
+    /*!
+    * \brief Рассчитать сопротивление цепи на частоте
+    * \param[in] frequency - частота переменного тока
+    * \return - комплексное сопротивление
+    */
+    std::complex<double> evaluateImpedance(double frequency) const;
+
+    /*!
+    * \brief Рассчитать силу тока выбранного соединения на частоте
+    * \param[in] output - номер соединения среди выбранных
+    * \param[in] frequency - частота переменного тока
+    * \return - комплексная сила тока
+    */
+    std::complex<double> evaluateCurrent(size_t output, double frequency) const;
+
+    /*!
+    * \brief Получить частоты, равномерно распределенные в логарифмическом масштабе
+    * \param[in] from - начальная частота
+    * \param[in] to - конечная частота
+    * \param[in] count - количество частот
+    * \return - частоты от from до to
+    */
+    static std::vector<double> logFrequencies(double from, double to, size_t count);
+
+    private:
+    /*!
+    * \brief Получить значение переменной p для частоты
+    * \param[in] frequency - частота переменного тока
+    * \return - значение p
+    */
+    std::complex<double> variableAt(double frequency) const;
+};
+
+/*!
+*\class FrequencySweep
+*\brief Силы тока соединений с указанным именем на нескольких частотах
+*/
+class FrequencySweep
+{
+    public:
+    std::vector<double> frequencies; /*!< Частоты */
+    std::vector<std::string> names; /*!< Имена соединений */
+    std::vector<std::vector<std::complex<double>>> currents; /*!< Силы тока: currents[f][i] - соединения i на частоте f */
+    bool isDirect = false; /*!< true - цепь рассчитана заново на каждой частоте, без передаточных функций */
+
+    /*!
+    * \brief Рассчитать цепь на частотах по передаточным функциям. Если их построить нельзя (например, степень
+    * многочленов больше допустимой), цепь рассчитывается заново на каждой частоте (см. evaluateDirect)
+    * \param[in] topology - топология цепи
+    * \param[in] frequencies - частоты
+    * \return - силы тока на частотах
+    */
+    static FrequencySweep evaluate(CircuitTopology const & topology, std::vector<double> const & frequencies);
+
+    /*!
+    * \brief Рассчитать силы тока по готовым передаточным функциям
+    * \param[in] function - передаточные функции
+    * \param[in] frequencies - частоты
+    * \return - силы тока на частотах
+    */
+    static FrequencySweep evaluate(TransferFunction const & function, std::vector<double> const & frequencies);
+
+    /*!
+    * \brief Рассчитать цепь заново на каждой частоте (см. CircuitState)
+    * \param[in] topology - топология цепи
+    * \param[in] frequencies - частоты
+    * \return - силы тока на частотах
+    */
+    static FrequencySweep evaluateDirect(CircuitTopology const & topology, std::vector<double> const & frequencies);
+};
+
+#endif // TRANSFERFUNCTION_H
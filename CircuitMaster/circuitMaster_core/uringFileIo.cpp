@@ -0,0 +1,425 @@
+#include "uringFileIo.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*!
+*\file
+*\brief Реализация функций класса UringFileIo
+*/
+
+static int ioUringSetup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+static int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned argCount)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, argCount));
+}
+
+UringFileIo::~UringFileIo()
+{
+    if (this->sqes != nullptr)
+        munmap(this->sqes, this->sqesSize);
+    if (this->cqRing != nullptr && this->cqRing != this->sqRing)
+        munmap(this->cqRing, this->cqRingSize);
+    if (this->sqRing != nullptr)
+        munmap(this->sqRing, this->sqRingSize);
+    if (this->ringFd >= 0)
+        close(this->ringFd);
+}
+
+std::unique_ptr<BatchFileIo> UringFileIo::tryCreate(unsigned entries)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = ioUringSetup(entries, &params);
+    if (fd < 0)
+        return nullptr;
+
+    std::unique_ptr<UringFileIo> uring(new UringFileIo());
+    uring->ringFd = fd;
+    uring->sqEntries = params.sq_entries;
+
+    // Отображаем кольца в память процесса
+    uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool isSingleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (isSingleMmap)
+        uring->sqRingSize = uring->cqRingSize = std::max(uring->sqRingSize, uring->cqRingSize);
+
+    void* sqRing = mmap(nullptr, uring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        return nullptr;
+    uring->sqRing = sqRing;
+
+    void* cqRing = sqRing;
+    if (!isSingleMmap)
+    {
+        cqRing = mmap(nullptr, uring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            return nullptr;
+    }
+    uring->cqRing = cqRing;
+
+    uring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, uring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return nullptr;
+    uring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sqBase = static_cast<char*>(sqRing);
+    uring->sqHead = reinterpret_cast<unsigned*>(sqBase + params.sq_off.head);
+    uring->sqTail = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+    uring->sqMask = reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+    uring->sqArray = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+
+    char* cqBase = static_cast<char*>(cqRing);
+    uring->cqHead = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+    uring->cqTail = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+    uring->cqMask = reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+    uring->cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+    // Проверяем, что ядро поддерживает все используемые операции
+    const unsigned probeOps = 256;
+    std::vector<char> probeBuf(sizeof(io_uring_probe) + probeOps * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeBuf.data());
+    if (ioUringRegister(fd, IORING_REGISTER_PROBE, probe, probeOps) < 0)
+        return nullptr;
+
+    const unsigned requiredOps[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE };
+    for (unsigned op : requiredOps)
+    {
+        if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+            return nullptr;
+    }
+
+    return std::unique_ptr<BatchFileIo>(uring.release());
+}
+
+size_t UringFileIo::submitAndWait(std::vector<io_uring_sqe> const & operations, std::vector<int>& results)
+{
+    results.assign(operations.size(), -EIO);
+    if (this->isFailed)
+        return 0;
+
+    // Отправляем операции частями по размеру очереди отправки
+    for (size_t chunkStart = 0; chunkStart < operations.size(); chunkStart += this->sqEntries)
+    {
+        unsigned chunkSize = static_cast<unsigned>(std::min<size_t>(this->sqEntries, operations.size() - chunkStart));
+
+        unsigned tail = __atomic_load_n(this->sqTail, __ATOMIC_RELAXED);
+        for (unsigned i = 0; i < chunkSize; i++)
+        {
+            unsigned index = (tail + i) & *this->sqMask;
+            this->sqes[index] = operations[chunkStart + i];
+            this->sqes[index].user_data = chunkStart + i;
+            this->sqArray[index] = index;
+        }
+        __atomic_store_n(this->sqTail, tail + chunkSize, __ATOMIC_RELEASE);
+
+        // Отправляем и ждём завершения всех операций части. Количество принятых ядром операций
+        // берётся из начала очереди отправки, а не из результата io_uring_enter
+        unsigned submitted = 0, completed = 0;
+        while (completed < chunkSize)
+        {
+            unsigned toSubmit = this->isFailed ? 0 : chunkSize - submitted;
+            int entered = ioUringEnter(this->ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+            if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY && !this->isFailed)
+            {
+                // Кольцо больше не используется: неотправленные операции убираются из очереди,
+                // отправленные дожидаются завершения, так как ядро ещё обращается к их буферам
+                this->isFailed = true;
+                submitted = __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE) - tail;
+                __atomic_store_n(this->sqTail, tail + submitted, __ATOMIC_RELEASE);
+                chunkSize = submitted;
+            }
+            else if (entered < 0 && this->isFailed)
+                usleep(1000);
+            else if (entered > 0)
+                submitted += static_cast<unsigned>(entered);
+
+            unsigned head = __atomic_load_n(this->cqHead, __ATOMIC_RELAXED);
+            unsigned cqTailValue = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+            for (; head != cqTailValue; head++, completed++)
+            {
+                io_uring_cqe const & cqe = this->cqes[head & *this->cqMask];
+                if (cqe.user_data < results.size())
+                    results[cqe.user_data] = cqe.res;
+            }
+            __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+        }
+
+        if (this->isFailed)
+            return chunkStart + chunkSize;
+    }
+    return operations.size();
+}
+
+void UringFileIo::closeAll(std::vector<int> const & fds)
+{
+    std::vector<io_uring_sqe> operations;
+    std::vector<int> closing;
+    for (int fd : fds)
+    {
+        if (fd < 0)
+            continue;
+        io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_CLOSE;
+        sqe.fd = fd;
+        operations.push_back(sqe);
+        closing.push_back(fd);
+    }
+
+    // Дескрипторы, не принятые кольцом, закрываются синхронно
+    std::vector<int> results;
+    for (size_t i = this->submitAndWait(operations, results); i < closing.size(); i++)
+        close(closing[i]);
+}
+
+void UringFileIo::restartSynchronously(std::vector<FileRequest*> const & requests, std::vector<int> const & fds, bool isRead)
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    for (auto iter = requests.cbegin(); iter != requests.cend(); iter++)
+    {
+        (*iter)->error.clear();
+        if (isRead)
+            (*iter)->content.clear();
+    }
+
+    if (isRead)
+        this->fallback.readFiles(requests);
+    else
+        this->fallback.writeFiles(requests);
+}
+
+void UringFileIo::readFiles(std::vector<FileRequest*> const & requests)
+{
+    if (this->isFailed)
+    {
+        this->fallback.readFiles(requests);
+        return;
+    }
+
+    size_t count = requests.size();
+    std::vector<io_uring_sqe> operations(count);
+    std::vector<int> results;
+
+    // Этап 1: открытие всех файлов
+    for (size_t i = 0; i < count; i++)
+    {
+        std::memset(&operations[i], 0, sizeof(io_uring_sqe));
+        operations[i].opcode = IORING_OP_OPENAT;
+        operations[i].fd = AT_FDCWD;
+        operations[i].addr = reinterpret_cast<uint64_t>(requests[i]->path.c_str());
+        operations[i].open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    this->submitAndWait(operations, results);
+    std::vector<int> fds(results);
+    if (this->isFailed)
+    {
+        this->restartSynchronously(requests, fds, true);
+        return;
+    }
+
+    // Этап 2: получение размеров открытых файлов
+    std::vector<struct statx> stats(count);
+    std::vector<size_t> opened;
+    operations.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fds[i] < 0)
+            continue;
+        io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_STATX;
+        sqe.fd = fds[i];
+        sqe.addr = reinterpret_cast<uint64_t>("");
+        sqe.len = STATX_SIZE;
+        sqe.off = reinterpret_cast<uint64_t>(&stats[i]);
+        sqe.statx_flags = AT_EMPTY_PATH;
+        operations.push_back(sqe);
+        opened.push_back(i);
+    }
+    this->submitAndWait(operations, results);
+    if (this->isFailed)
+    {
+        this->restartSynchronously(requests, fds, true);
+        return;
+    }
+
+    // Этап 3: чтение файлов целиком
+    std::vector<size_t> reading;
+    operations.clear();
+    for (size_t j = 0; j < opened.size(); j++)
+    {
+        size_t i = opened[j];
+        if (results[j] < 0)
+        {
+            requests[i]->error = inputFileErrorMessage;
+            continue;
+        }
+
+        requests[i]->content.resize(stats[i].stx_size);
+        if (stats[i].stx_size == 0)
+            continue;
+
+        io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fds[i];
+        sqe.addr = reinterpret_cast<uint64_t>(&requests[i]->content[0]);
+        sqe.len = static_cast<unsigned>(stats[i].stx_size);
+        sqe.off = 0;
+        operations.push_back(sqe);
+        reading.push_back(i);
+    }
+    this->submitAndWait(operations, results);
+    if (this->isFailed)
+    {
+        this->restartSynchronously(requests, fds, true);
+        return;
+    }
+
+    for (size_t j = 0; j < reading.size(); j++)
+    {
+        FileRequest& request = *requests[reading[j]];
+        if (results[j] < 0)
+        {
+            request.error = inputFileErrorMessage;
+            continue;
+        }
+
+        // Файл прочитан не полностью - дочитываем синхронно
+        size_t done = static_cast<size_t>(results[j]);
+        while (done < request.content.size())
+        {
+            ssize_t readCount = pread(fds[reading[j]], &request.content[done], request.content.size() - done, done);
+            if (readCount < 0)
+                request.error = inputFileErrorMessage;
+            if (readCount <= 0)
+                break;
+            done += static_cast<size_t>(readCount);
+        }
+        request.content.resize(done);
+    }
+
+    // Ошибки открытия
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fds[i] < 0)
+            requests[i]->error = inputFileErrorMessage;
+    }
+
+    // Этап 4: закрытие файлов
+    this->closeAll(fds);
+}
+
+void UringFileIo::writeFiles(std::vector<FileRequest*> const & requests)
+{
+    if (this->isFailed)
+    {
+        this->fallback.writeFiles(requests);
+        return;
+    }
+
+    size_t count = requests.size();
+    std::vector<io_uring_sqe> operations(count);
+    std::vector<int> results;
+
+    // Этап 1: открытие или создание всех файлов
+    for (size_t i = 0; i < count; i++)
+    {
+        std::memset(&operations[i], 0, sizeof(io_uring_sqe));
+        operations[i].opcode = IORING_OP_OPENAT;
+        operations[i].fd = AT_FDCWD;
+        operations[i].addr = reinterpret_cast<uint64_t>(requests[i]->path.c_str());
+        operations[i].open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        operations[i].len = 0644;
+    }
+    this->submitAndWait(operations, results);
+    std::vector<int> fds(results);
+    if (this->isFailed)
+    {
+        this->restartSynchronously(requests, fds, false);
+        return;
+    }
+
+    // Этап 2: запись содержимого
+    std::vector<size_t> writing;
+    operations.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fds[i] < 0)
+        {
+            requests[i]->error = outputFileErrorMessage;
+            continue;
+        }
+        if (requests[i]->content.empty())
+            continue;
+
+        io_uring_sqe sqe;
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fds[i];
+        sqe.addr = reinterpret_cast<uint64_t>(requests[i]->content.data());
+        sqe.len = static_cast<unsigned>(requests[i]->content.size());
+        sqe.off = 0;
+        operations.push_back(sqe);
+        writing.push_back(i);
+    }
+    this->submitAndWait(operations, results);
+    if (this->isFailed)
+    {
+        this->restartSynchronously(requests, fds, false);
+        return;
+    }
+
+    for (size_t j = 0; j < writing.size(); j++)
+    {
+        FileRequest& request = *requests[writing[j]];
+        if (results[j] < 0)
+        {
+            request.error = outputFileErrorMessage;
+            continue;
+        }
+
+        // Файл записан не полностью - дописываем синхронно
+        size_t done = static_cast<size_t>(results[j]);
+        while (done < request.content.size())
+        {
+            ssize_t writeCount = pwrite(fds[writing[j]], request.content.data() + done, request.content.size() - done, done);
+            if (writeCount <= 0)
+            {
+                request.error = outputFileErrorMessage;
+                break;
+            }
+            done += static_cast<size_t>(writeCount);
+        }
+    }
+
+    // Этап 3: закрытие файлов
+    this->closeAll(fds);
+}
+
+std::string UringFileIo::name() const
+{
+    return this->isFailed ? "sync" : "uring";
+}
@@ -0,0 +1,90 @@
+#ifndef URINGFILEIO_H
+#define URINGFILEIO_H
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <linux/io_uring.h>
+#include "batchFileIo.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций класса UringFileIo
+*/
+
+/*!
+*\class UringFileIo
+*\brief Асинхронный ввод-вывод на основе io_uring (только Linux, CONFIG += io_uring)
+*
+* Группа файлов обрабатывается в несколько этапов, на каждом этапе запросы по всем файлам
+* группы отправляются в кольцо одним системным вызовом: открытие, получение размера (только
+* при чтении), чтение или запись, закрытие. Используются системные вызовы напрямую, без liburing.
+* Требуется ядро 5.6 или новее, иначе tryCreate возвращает nullptr. Если кольцо перестает
+* принимать операции, все отправленные операции дожидаются завершения, а группа и все следующие
+* группы обрабатываются синхронно (см. SyncFileIo)
+*/
+class UringFileIo : public BatchFileIo
+{
+    public:
+    ~UringFileIo() override;
+
+    /*!
+    * \brief Создать кольцо io_uring
+    * \param[in] entries - размер очереди отправки
+    * \return - созданный объект или nullptr, если io_uring или нужные операции не поддерживаются
+    */
+    static std::unique_ptr<BatchFileIo> tryCreate(unsigned entries = 256);
+
+    void readFiles(std::vector<FileRequest*> const & requests) override;
+    void writeFiles(std::vector<FileRequest*> const & requests) override;
+    std::string name() const override;
+
+    private:
+    UringFileIo() = default;
+
+    /*!
+    * \brief Отправить операции и дождаться завершения всех
+    *
+    * При ошибке io_uring_enter неотправленные операции убираются из очереди, отправленные
+    * дожидаются завершения, а кольцо больше не используется (isFailed)
+    * \param[in] operations - подготовленные операции, user_data заполняется автоматически
+    * \param[out] results - результаты операций в том же порядке, -EIO для неотправленных
+    * \return - количество отправленных и завершенных операций: все, кроме последних неотправленных
+    */
+    size_t submitAndWait(std::vector<io_uring_sqe> const & operations, std::vector<int>& results);
+
+    /*!
+    * \brief Закрыть дескрипторы файлов одной пакетной операцией
+    * \param[in] fds - дескрипторы, отрицательные пропускаются
+    */
+    void closeAll(std::vector<int> const & fds);
+
+    /*!
+    * \brief Закрыть открытые файлы группы и обработать её заново синхронно после отказа кольца
+    * \param[in,out] requests - запросы группы
+    * \param[in] fds - дескрипторы, открытые кольцом, отрицательные пропускаются
+    * \param[in] isRead - true для чтения, false для записи
+    */
+    void restartSynchronously(std::vector<FileRequest*> const & requests, std::vector<int> const & fds, bool isRead);
+
+    SyncFileIo fallback; /*!< Синхронный ввод-вывод, используемый после отказа кольца */
+    bool isFailed = false; /*!< Кольцо отказало, операции выполняются синхронно */
+
+    int ringFd = -1; /*!< Дескриптор кольца */
+    unsigned sqEntries = 0; /*!< Размер очереди отправки */
+    void* sqRing = nullptr; /*!< Отображение очереди отправки */
+    size_t sqRingSize = 0; /*!< Размер отображения очереди отправки */
+    void* cqRing = nullptr; /*!< Отображение очереди завершения */
+    size_t cqRingSize = 0; /*!< Размер отображения очереди завершения */
+    io_uring_sqe* sqes = nullptr; /*!< Массив операций */
+    size_t sqesSize = 0; /*!< Размер массива операций */
+    unsigned* sqHead = nullptr; /*!< Начало очереди отправки: первая операция, не принятая ядром */
+    unsigned* sqTail = nullptr; /*!< Конец очереди отправки */
+    unsigned* sqMask = nullptr; /*!< Маска очереди отправки */
+    unsigned* sqArray = nullptr; /*!< Индексы операций очереди отправки */
+    unsigned* cqHead = nullptr; /*!< Начало очереди завершения */
+    unsigned* cqTail = nullptr; /*!< Конец очереди завершения */
+    unsigned* cqMask = nullptr; /*!< Маска очереди завершения */
+    io_uring_cqe* cqes = nullptr; /*!< Массив завершенных операций */
+};
+
+#endif // URINGFILEIO_H
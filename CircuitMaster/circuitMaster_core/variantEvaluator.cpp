@@ -0,0 +1,529 @@
+#include "variantEvaluator.h"
+#include <algorithm>
+#include "allocationStats.h"
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций расчета вариантов цепи с одинаковой топологией
+*/
+
+namespace {
+
+/*! Количество вариантов, рассчитываемых за один проход по топологии. Промежуточные значения
+ *  блока для всех соединений должны помещаться в кэш процессора */
+const size_t blockSize = 256;
+
+/*!
+* \brief Отметить ошибку расчета варианта, если он ещё не отмечен
+* \param[in,out] results - результаты расчета
+* \param[in] instance - номер варианта
+* \param[in] message - сообщение об ошибке
+*/
+void markFailed(VariantResults& results, size_t instance, std::string const & message)
+{
+    if (!results.errors[instance].empty())
+        return;
+    results.errors[instance] = message;
+    results.failedCount++;
+}
+
+/*!
+* \brief Создать результаты расчета с массивами для выбранных соединений
+* \param[in] nodeCount - количество соединений топологии
+* \param[in] outputNodes - номера соединений, значения которых нужно сохранить
+* \param[in] count - количество вариантов
+* \return - результаты расчета
+*/
+VariantResults emptyResults(size_t nodeCount, std::vector<int> const & outputNodes, size_t count)
+{
+    VariantResults results;
+    results.instanceCount = count;
+    results.nodes = outputNodes;
+    results.positions.assign(nodeCount, -1);
+    for (size_t i = 0; i < outputNodes.size(); i++)
+        results.positions[outputNodes[i]] = static_cast<int>(i);
+
+    // Сохраняются только выбранные соединения: запись значений всех соединений всех вариантов
+    // в память занимает больше времени, чем сам расчет
+    size_t outputSize = outputNodes.size() * count;
+    results.resistanceRe.resize(outputSize);
+    results.resistanceIm.resize(outputSize);
+    results.currentRe.resize(outputSize);
+    results.currentIm.resize(outputSize);
+    results.voltageRe.resize(outputSize);
+    results.voltageIm.resize(outputSize);
+    results.errors.resize(count);
+    return results;
+}
+
+// Оценка погрешности расчета в float ведется в единицах округления float (относительная погрешность
+// одного действия). Константы - рост оценки при действиях над комплексными числами с запасом
+
+const float unitRoundoff = 5.96e-8f; /*!< Единица округления float, 2^-24 */
+const float reciprocalGrowth = 5; /*!< Рост оценки при обращении: квадрат модуля и деление */
+const float divisionGrowth = 6; /*!< Рост оценки при делении */
+const float multiplicationGrowth = 3; /*!< Рост оценки при умножении */
+
+/*! Отношение суммы модулей частей комплексного числа к его модулю не больше корня из 2:
+ *  оценка суммы через модули частей дополнительно умножается на этот множитель */
+const float magnitudeFactor = 1.5f;
+
+} // namespace
+
+VariantBatch::VariantBatch(CircuitTopology const & topology, size_t count)
+{
+    this->instanceCount = count;
+    size_t elementCount = topology.elementResistances.size();
+    this->elementRe.resize(elementCount * count);
+    this->elementIm.resize(elementCount * count);
+    for (size_t e = 0; e < elementCount; e++)
+    {
+        std::fill_n(this->elementRe.begin() + e * count, count, topology.elementResistances[e].real());
+        std::fill_n(this->elementIm.begin() + e * count, count, topology.elementResistances[e].imag());
+    }
+    this->voltageRe.assign(count, topology.rootVoltage.real());
+    this->voltageIm.assign(count, topology.rootVoltage.imag());
+}
+
+void VariantBatch::setElementResistance(size_t element, size_t instance, std::complex<double> resistance)
+{
+    this->elementRe[element * this->instanceCount + instance] = resistance.real();
+    this->elementIm[element * this->instanceCount + instance] = resistance.imag();
+}
+
+void VariantBatch::setVoltage(size_t instance, std::complex<double> voltage)
+{
+    this->voltageRe[instance] = voltage.real();
+    this->voltageIm[instance] = voltage.imag();
+}
+
+bool VariantResults::hasNode(size_t node) const
+{
+    return node < this->positions.size() && this->positions[node] >= 0;
+}
+
+std::complex<double> VariantResults::resistance(size_t node, size_t instance) const
+{
+    size_t index = this->positions[node] * this->instanceCount + instance;
+    return std::complex<double>(this->resistanceRe[index], this->resistanceIm[index]);
+}
+
+std::complex<double> VariantResults::current(size_t node, size_t instance) const
+{
+    size_t index = this->positions[node] * this->instanceCount + instance;
+    return std::complex<double>(this->currentRe[index], this->currentIm[index]);
+}
+
+std::complex<double> VariantResults::voltage(size_t node, size_t instance) const
+{
+    size_t index = this->positions[node] * this->instanceCount + instance;
+    return std::complex<double>(this->voltageRe[index], this->voltageIm[index]);
+}
+
+double VariantResults::currentErrorBound(size_t node, size_t instance) const
+{
+    if (this->currentErrorBounds.empty())
+        return 0;
+    return this->currentErrorBounds[this->positions[node] * this->instanceCount + instance];
+}
+
+VariantEvaluator::VariantEvaluator(CircuitTopology const & circuitTopology, SimdLevel level, Precision precision, double tolerance)
+    : topology(circuitTopology), precision(precision), tolerance(tolerance)
+{
+    this->simdLevel = ComplexKernels::resolve(level);
+}
+
+VariantEvaluator::SimdLevel VariantEvaluator::getSimdLevel() const
+{
+    return this->simdLevel;
+}
+
+std::string VariantEvaluator::simdLevelName() const
+{
+    return ComplexKernels::levelName(this->simdLevel);
+}
+
+VariantEvaluator::Precision VariantEvaluator::getPrecision() const
+{
+    return this->precision;
+}
+
+VariantEvaluator::SimdLevel VariantEvaluator::detectSimdLevel()
+{
+    return ComplexKernels::detectSimdLevel();
+}
+
+VariantResults VariantEvaluator::evaluate(VariantBatch const & batch) const
+{
+    std::vector<int> outputNodes;
+    for (size_t n = 0; n < this->topology.nodes.size(); n++)
+    {
+        if (n == 0 || this->topology.nodes[n].hasCustomName)
+            outputNodes.push_back(static_cast<int>(n));
+    }
+    return this->evaluate(batch, outputNodes);
+}
+
+VariantResults VariantEvaluator::evaluate(VariantBatch const & batch, std::vector<int> const & outputNodes) const
+{
+    if (this->precision == Precision::single)
+        return this->evaluateSingle(batch, outputNodes);
+
+    CORE_TRACE_SPAN("VariantEvaluator::evaluate");
+    CORE_ALLOCATION_PHASE(evaluate);
+    ComplexKernels const & kernels = ComplexKernels::forLevel(this->simdLevel);
+    std::vector<CircuitTopology::Node> const & nodes = this->topology.nodes;
+    size_t nodeCount = nodes.size();
+    size_t count = batch.instanceCount;
+
+    VariantResults results = emptyResults(nodeCount, outputNodes, count);
+
+    // Промежуточные значения блока вариантов: [соединение * stride + вариант блока].
+    // Для малого числа вариантов блок уменьшается, чтобы не выделять лишнюю память
+    size_t stride = std::max<size_t>(1, std::min(blockSize, count));
+    std::vector<double> zRe(nodeCount * stride), zIm(nodeCount * stride);
+    std::vector<double> iRe(nodeCount * stride), iIm(nodeCount * stride);
+    std::vector<double> uRe(nodeCount * stride), uIm(nodeCount * stride);
+
+    for (size_t start = 0; start < count; start += stride)
+    {
+        size_t width = std::min(stride, count - start);
+
+        // Сопротивления: дети расположены после родителя, поэтому обходим соединения с конца
+        for (size_t n = nodeCount; n-- > 0;)
+        {
+            CircuitTopology::Node const & node = nodes[n];
+            double* re = zRe.data() + n * stride;
+            double* im = zIm.data() + n * stride;
+            std::fill_n(re, width, 0.0);
+            std::fill_n(im, width, 0.0);
+
+            // Для простого последовательного соединения - сумма сопротивлений элементов
+            if (node.type == CoreConnection::ConnectionType::sequential)
+            {
+                for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+                    kernels.add(re, im, batch.elementRe.data() + e * count + start, batch.elementIm.data() + e * count + start, width);
+            }
+            // Для сложного последовательного соединения - сумма сопротивлений детей
+            else if (node.type == CoreConnection::ConnectionType::sequentialComplex)
+            {
+                for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                {
+                    size_t child = this->topology.childIndices[c];
+                    kernels.add(re, im, zRe.data() + child * stride, zIm.data() + child * stride, width);
+                }
+            }
+            // Для параллельного соединения - величина, обратная сумме обратных сопротивлений детей
+            else if (node.type == CoreConnection::ConnectionType::parallel)
+            {
+                for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                {
+                    size_t child = this->topology.childIndices[c];
+                    kernels.addReciprocal(re, im, zRe.data() + child * stride, zIm.data() + child * stride, width);
+                }
+
+                for (size_t k = 0; k < width; k++)
+                {
+                    if (re[k] == 0 && im[k] == 0)
+                        markFailed(results, start + k, formatStr("При расчете сопротивления параллельного соединения %1 получено недопустимое значение. "
+                                                                 "Проверьте правильность входных данных.", { node.displayName() }));
+                }
+                kernels.reciprocal(re, im, width);
+            }
+
+            for (size_t k = 0; k < width; k++)
+            {
+                if (re[k] == 0 && im[k] == 0)
+                    markFailed(results, start + k, formatStr("При расчете сопротивления соединения %1 был получен 0. "
+                                                             "Проверьте правильность входных данных.", { node.displayName() }));
+            }
+        }
+
+        // Силы тока и напряжения: родитель расположен раньше детей, поэтому обходим соединения с начала
+        for (size_t n = 0; n < nodeCount; n++)
+        {
+            CircuitTopology::Node const & node = nodes[n];
+            double* re = zRe.data() + n * stride;
+            double* im = zIm.data() + n * stride;
+            double* currentRe = iRe.data() + n * stride;
+            double* currentIm = iIm.data() + n * stride;
+            double* voltageRe = uRe.data() + n * stride;
+            double* voltageIm = uIm.data() + n * stride;
+
+            // Корневому соединению задано напряжение
+            if (node.parent < 0)
+            {
+                std::copy_n(batch.voltageRe.data() + start, width, voltageRe);
+                std::copy_n(batch.voltageIm.data() + start, width, voltageIm);
+                kernels.divide(currentRe, currentIm, voltageRe, voltageIm, re, im, width);
+            }
+            // Дети последовательного соединения получают силу тока родителя
+            else if (nodes[node.parent].type == CoreConnection::ConnectionType::sequentialComplex)
+            {
+                std::copy_n(iRe.data() + node.parent * stride, width, currentRe);
+                std::copy_n(iIm.data() + node.parent * stride, width, currentIm);
+                kernels.multiply(voltageRe, voltageIm, currentRe, currentIm, re, im, width);
+            }
+            // Дети параллельного соединения получают напряжение родителя
+            else
+            {
+                std::copy_n(uRe.data() + node.parent * stride, width, voltageRe);
+                std::copy_n(uIm.data() + node.parent * stride, width, voltageIm);
+                kernels.divide(currentRe, currentIm, voltageRe, voltageIm, re, im, width);
+            }
+
+            if (results.positions[n] < 0)
+                continue;
+
+            size_t offset = results.positions[n] * count + start;
+            std::copy_n(re, width, results.resistanceRe.data() + offset);
+            std::copy_n(im, width, results.resistanceIm.data() + offset);
+            std::copy_n(currentRe, width, results.currentRe.data() + offset);
+            std::copy_n(currentIm, width, results.currentIm.data() + offset);
+            std::copy_n(voltageRe, width, results.voltageRe.data() + offset);
+            std::copy_n(voltageIm, width, results.voltageIm.data() + offset);
+        }
+    }
+
+    return results;
+}
+
+VariantResults VariantEvaluator::evaluateSingle(VariantBatch const & batch, std::vector<int> const & outputNodes) const
+{
+    CORE_TRACE_SPAN("VariantEvaluator::evaluateSingle");
+    CORE_ALLOCATION_PHASE(evaluate);
+    FloatComplexKernels const & kernels = FloatComplexKernels::forLevel(this->simdLevel);
+    ComplexKernels const & fullKernels = ComplexKernels::forLevel(this->simdLevel);
+    std::vector<CircuitTopology::Node> const & nodes = this->topology.nodes;
+    size_t nodeCount = nodes.size();
+    size_t count = batch.instanceCount;
+
+    VariantResults results = emptyResults(nodeCount, outputNodes, count);
+    results.currentErrorBounds.resize(outputNodes.size() * count);
+
+    // Пути от корня к выбранным соединениям: по ним складываются оценки погрешности силы тока
+    std::vector<std::vector<int>> paths(outputNodes.size());
+    for (size_t o = 0; o < outputNodes.size(); o++)
+    {
+        for (int n = outputNodes[o]; n >= 0; n = nodes[n].parent)
+            paths[o].insert(paths[o].begin(), n);
+    }
+
+    // Те же массивы блока, что и при расчете в double, и оценки погрешности сопротивлений в единицах округления
+    size_t stride = std::max<size_t>(1, std::min(blockSize, count));
+    std::vector<double> sumRe(stride), sumIm(stride);
+    std::vector<float> zRe(nodeCount * stride), zIm(nodeCount * stride), zBound(nodeCount * stride);
+    std::vector<float> iRe(nodeCount * stride), iIm(nodeCount * stride);
+    std::vector<float> uRe(nodeCount * stride), uIm(nodeCount * stride);
+    std::vector<float> currentBound(stride), voltageBound(stride);
+
+    for (size_t start = 0; start < count; start += stride)
+    {
+        size_t width = std::min(stride, count - start);
+
+        // Сопротивления: дети расположены после родителя, поэтому обходим соединения с конца.
+        // Оценка суммы - сумма модулей слагаемых, умноженных на их оценки и количество сложений, деленная на модуль суммы
+        for (size_t n = nodeCount; n-- > 0;)
+        {
+            CircuitTopology::Node const & node = nodes[n];
+            float* re = zRe.data() + n * stride;
+            float* im = zIm.data() + n * stride;
+            float* bound = zBound.data() + n * stride;
+            std::fill_n(re, width, 0.0f);
+            std::fill_n(im, width, 0.0f);
+            std::fill_n(bound, width, 0.0f);
+
+            if (node.type == CoreConnection::ConnectionType::sequential)
+            {
+                // Сопротивления элементов складываются в double прямо из пакета: чтение пакета занимает больше
+                // времени, чем сложение, а сумма округляется до float один раз
+                std::fill_n(sumRe.data(), width, 0.0);
+                std::fill_n(sumIm.data(), width, 0.0);
+                for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+                    fullKernels.add(sumRe.data(), sumIm.data(), batch.elementRe.data() + e * count + start, batch.elementIm.data() + e * count + start, width);
+                for (size_t k = 0; k < width; k++)
+                {
+                    re[k] = static_cast<float>(sumRe[k]);
+                    im[k] = static_cast<float>(sumIm[k]);
+                    bound[k] = 1;
+                }
+            }
+            else if (node.type == CoreConnection::ConnectionType::sequentialComplex)
+            {
+                for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                {
+                    size_t child = this->topology.childIndices[c];
+                    float const * termRe = zRe.data() + child * stride;
+                    float const * termIm = zIm.data() + child * stride;
+                    float const * termBound = zBound.data() + child * stride;
+                    kernels.addBounded(re, im, bound, termRe, termIm, termBound, static_cast<float>(node.childCount), width);
+                }
+                kernels.relativeBound(bound, re, im, magnitudeFactor, 0, width);
+            }
+            else if (node.type == CoreConnection::ConnectionType::parallel)
+            {
+                for (int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+                {
+                    size_t child = this->topology.childIndices[c];
+                    float const * termRe = zRe.data() + child * stride;
+                    float const * termIm = zIm.data() + child * stride;
+                    float const * termBound = zBound.data() + child * stride;
+                    kernels.addReciprocalBounded(re, im, bound, termRe, termIm, termBound, reciprocalGrowth + node.childCount, width);
+                }
+
+                for (size_t k = 0; k < width; k++)
+                {
+                    if (re[k] == 0 && im[k] == 0)
+                        markFailed(results, start + k, formatStr("При расчете сопротивления параллельного соединения %1 получено недопустимое значение. "
+                                                                 "Проверьте правильность входных данных.", { node.displayName() }));
+                }
+                kernels.relativeBound(bound, re, im, magnitudeFactor, reciprocalGrowth, width);
+                kernels.reciprocal(re, im, width);
+            }
+
+            for (size_t k = 0; k < width; k++)
+            {
+                if (re[k] == 0 && im[k] == 0)
+                    markFailed(results, start + k, formatStr("При расчете сопротивления соединения %1 был получен 0. "
+                                                             "Проверьте правильность входных данных.", { node.displayName() }));
+            }
+        }
+
+        // Силы тока и напряжения
+        for (size_t n = 0; n < nodeCount; n++)
+        {
+            CircuitTopology::Node const & node = nodes[n];
+            float* re = zRe.data() + n * stride;
+            float* im = zIm.data() + n * stride;
+            float* currentRe = iRe.data() + n * stride;
+            float* currentIm = iIm.data() + n * stride;
+            float* voltageRe = uRe.data() + n * stride;
+            float* voltageIm = uIm.data() + n * stride;
+
+            // Корневому соединению задано напряжение
+            if (node.parent < 0)
+            {
+                for (size_t k = 0; k < width; k++)
+                {
+                    voltageRe[k] = static_cast<float>(batch.voltageRe[start + k]);
+                    voltageIm[k] = static_cast<float>(batch.voltageIm[start + k]);
+                }
+                kernels.divide(currentRe, currentIm, voltageRe, voltageIm, re, im, width);
+            }
+            // Дети последовательного соединения получают силу тока родителя
+            else if (nodes[node.parent].type == CoreConnection::ConnectionType::sequentialComplex)
+            {
+                std::copy_n(iRe.data() + node.parent * stride, width, currentRe);
+                std::copy_n(iIm.data() + node.parent * stride, width, currentIm);
+                kernels.multiply(voltageRe, voltageIm, currentRe, currentIm, re, im, width);
+            }
+            // Дети параллельного соединения получают напряжение родителя
+            else
+            {
+                std::copy_n(uRe.data() + node.parent * stride, width, voltageRe);
+                std::copy_n(uIm.data() + node.parent * stride, width, voltageIm);
+                kernels.divide(currentRe, currentIm, voltageRe, voltageIm, re, im, width);
+            }
+
+            if (results.positions[n] < 0)
+                continue;
+
+            size_t offset = results.positions[n] * count + start;
+            std::copy_n(re, width, results.resistanceRe.data() + offset);
+            std::copy_n(im, width, results.resistanceIm.data() + offset);
+            std::copy_n(currentRe, width, results.currentRe.data() + offset);
+            std::copy_n(currentIm, width, results.currentIm.data() + offset);
+            std::copy_n(voltageRe, width, results.voltageRe.data() + offset);
+            std::copy_n(voltageIm, width, results.voltageIm.data() + offset);
+        }
+
+        // Оценки силы тока выбранных соединений. Оценка произведения и частного - сумма оценок множителей
+        // и погрешности действия, поэтому оценка складывается из оценок сопротивлений на пути от корня
+        for (size_t o = 0; o < outputNodes.size(); o++)
+        {
+            for (int n : paths[o])
+            {
+                float const * resistanceBound = zBound.data() + n * stride;
+                if (nodes[n].parent < 0)
+                {
+                    for (size_t k = 0; k < width; k++)
+                    {
+                        voltageBound[k] = 1;
+                        currentBound[k] = voltageBound[k] + resistanceBound[k] + divisionGrowth;
+                    }
+                }
+                else if (nodes[nodes[n].parent].type == CoreConnection::ConnectionType::sequentialComplex)
+                {
+                    for (size_t k = 0; k < width; k++)
+                        voltageBound[k] = currentBound[k] + resistanceBound[k] + multiplicationGrowth;
+                }
+                else
+                {
+                    for (size_t k = 0; k < width; k++)
+                        currentBound[k] = voltageBound[k] + resistanceBound[k] + divisionGrowth;
+                }
+            }
+
+            for (size_t k = 0; k < width; k++)
+                results.currentErrorBounds[o * count + start + k] = currentBound[k] * unitRoundoff;
+        }
+    }
+
+    this->refineInaccurate(batch, results);
+    return results;
+}
+
+void VariantEvaluator::refineInaccurate(VariantBatch const & batch, VariantResults& results) const
+{
+    size_t count = batch.instanceCount;
+    size_t outputCount = results.nodes.size();
+
+    // Ошибка в float может быть вызвана переполнением или потерей точности, поэтому такие варианты тоже пересчитываются.
+    // Сравнение записано через !(<=), чтобы бесконечная или неопределенная оценка тоже приводила к пересчету
+    std::vector<size_t> inaccurate;
+    for (size_t k = 0; k < count; k++)
+    {
+        bool isAccurate = results.errors[k].empty();
+        for (size_t o = 0; o < outputCount && isAccurate; o++)
+            isAccurate = results.currentErrorBounds[o * count + k] <= this->tolerance;
+        if (!isAccurate)
+            inaccurate.push_back(k);
+    }
+    if (inaccurate.empty())
+        return;
+
+    CORE_TRACE_SPAN("VariantEvaluator::refineInaccurate");
+    size_t elementCount = this->topology.elementResistances.size();
+    VariantBatch refinedBatch(this->topology, inaccurate.size());
+    for (size_t r = 0; r < inaccurate.size(); r++)
+    {
+        size_t k = inaccurate[r];
+        for (size_t e = 0; e < elementCount; e++)
+            refinedBatch.setElementResistance(e, r, std::complex<double>(batch.elementRe[e * count + k], batch.elementIm[e * count + k]));
+        refinedBatch.setVoltage(r, std::complex<double>(batch.voltageRe[k], batch.voltageIm[k]));
+    }
+
+    VariantResults refined = VariantEvaluator(this->topology, this->simdLevel).evaluate(refinedBatch, results.nodes);
+    for (size_t r = 0; r < inaccurate.size(); r++)
+    {
+        size_t k = inaccurate[r];
+        for (size_t o = 0; o < outputCount; o++)
+        {
+            size_t index = o * count + k, refinedIndex = o * inaccurate.size() + r;
+            results.resistanceRe[index] = refined.resistanceRe[refinedIndex];
+            results.resistanceIm[index] = refined.resistanceIm[refinedIndex];
+            results.currentRe[index] = refined.currentRe[refinedIndex];
+            results.currentIm[index] = refined.currentIm[refinedIndex];
+            results.voltageRe[index] = refined.voltageRe[refinedIndex];
+            results.voltageIm[index] = refined.voltageIm[refinedIndex];
+            results.currentErrorBounds[index] = 0;
+        }
+        if (!results.errors[k].empty())
+            results.failedCount--;
+        results.errors[k] = refined.errors[r];
+    }
+    results.failedCount += refined.failedCount;
+    results.refinedCount = inaccurate.size();
+}
@@ -0,0 +1,223 @@
+#ifndef VARIANTEVALUATOR_H
+#define VARIANTEVALUATOR_H
+#include <complex>
+#include <string>
+#include <vector>
+#include "circuitTopology.h"
+#include "complexKernels.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета вариантов цепи с одинаковой топологией
+*/
+
+/*!
+*\class VariantBatch
+*\brief Сопротивления элементов и напряжения для K вариантов одной цепи
+*
+* Значения хранятся по столбцам (struct-of-arrays): значения одного элемента во всех вариантах
+* расположены подряд, что позволяет обрабатывать несколько вариантов одной векторной командой
+*/
+class VariantBatch
+{
+    public:
+    /*!
+    * \brief Конструктор набора вариантов, заполняет все варианты значениями исходной цепи
+    * \param[in] topology - топология цепи
+    * \param[in] count - количество вариантов
+    */
+    VariantBatch(CircuitTopology const & topology, size_t count);
+
+    size_t instanceCount; /*!< Количество вариантов */
+    std::vector<double> elementRe; /*!< Действительные части сопротивлений элементов, [элемент * instanceCount + вариант] */
+    std::vector<double> elementIm; /*!< Мнимые части сопротивлений элементов, [элемент * instanceCount + вариант] */
+    std::vector<double> voltageRe; /*!< Действительные части напряжения корневого соединения, [вариант] */
+    std::vector<double> voltageIm; /*!< Мнимые части напряжения корневого соединения, [вариант] */
+
+    /*!
+    * \brief Задать сопротивление элемента в варианте
+    * \param[in] element - номер элемента в топологии
+    * \param[in] instance - номер варианта
+    * \param[in] resistance - комплексное сопротивление элемента
+    */
+    void setElementResistance(size_t element, size_t instance, std::complex<double> resistance);
+
+    /*!
+    * \brief Задать напряжение корневого соединения в варианте
+    * \param[in] instance - номер варианта
+    * \param[in] voltage - комплексное напряжение
+    */
+    void setVoltage(size_t instance, std::complex<double> voltage);
+};
+
+/*!
+*\class VariantResults
+*\brief Результаты расчета вариантов цепи
+*
+* Хранятся только значения выбранных при расчете соединений, в том же порядке, что и в VariantBatch:
+* [номер среди выбранных * instanceCount + вариант]
+*/
+class VariantResults
+{
+    public:
+    size_t instanceCount = 0; /*!< Количество вариантов */
+    std::vector<int> nodes; /*!< Номера выбранных соединений в топологии */
+    std::vector<int> positions; /*!< Номер среди выбранных для каждого соединения топологии, -1 - значения не сохранены */
+    std::vector<double> resistanceRe; /*!< Действительные части сопротивлений соединений */
+    std::vector<double> resistanceIm; /*!< Мнимые части сопротивлений соединений */
+    std::vector<double> currentRe; /*!< Действительные части силы тока соединений */
+    std::vector<double> currentIm; /*!< Мнимые части силы тока соединений */
+    std::vector<double> voltageRe; /*!< Действительные части напряжения соединений */
+    std::vector<double> voltageIm; /*!< Мнимые части напряжения соединений */
+    std::vector<std::string> errors; /*!< Ошибка расчета варианта, пустая строка - вариант рассчитан */
+    size_t failedCount = 0; /*!< Количество вариантов, рассчитанных с ошибкой */
+    std::vector<double> currentErrorBounds; /*!< Оценка относительной погрешности модуля силы тока при расчете в float,
+                                                 0 - значение рассчитано в double. Пустой при расчете в double */
+    size_t refinedCount = 0; /*!< Количество вариантов, пересчитанных в double из-за большой погрешности float */
+
+    /*!
+    * \brief Проверить, сохранены ли значения соединения
+    * \param[in] node - номер соединения в топологии
+    * \return - true, если значения сохранены
+    */
+    bool hasNode(size_t node) const;
+
+    /*!
+    * \brief Получить сопротивление соединения в варианте
+    * \param[in] node - номер соединения в топологии, значения которого сохранены
+    * \param[in] instance - номер варианта
+    * \return - комплексное сопротивление
+    */
+    std::complex<double> resistance(size_t node, size_t instance) const;
+
+    /*!
+    * \brief Получить силу тока соединения в варианте
+    * \param[in] node - номер соединения в топологии, значения которого сохранены
+    * \param[in] instance - номер варианта
+    * \return - комплексная сила тока
+    */
+    std::complex<double> current(size_t node, size_t instance) const;
+
+    /*!
+    * \brief Получить напряжение соединения в варианте
+    * \param[in] node - номер соединения в топологии, значения которого сохранены
+    * \param[in] instance - номер варианта
+    * \return - комплексное напряжение
+    */
+    std::complex<double> voltage(size_t node, size_t instance) const;
+
+    /*!
+    * \brief Получить оценку относительной погрешности силы тока соединения в варианте
+    * \param[in] node - номер соединения в топологии, значения которого сохранены
+    * \param[in] instance - номер варианта
+    * \return - оценка погрешности, 0 - значение рассчитано в double
+    */
+    double currentErrorBound(size_t node, size_t instance) const;
+};
+
+/*!
+*\class VariantEvaluator
+*\brief Расчет многих вариантов цепи с одинаковой топологией
+*
+* Выполняет те же вычисления, что и CoreConnection::calculateResistance и
+* CoreConnection::calculateCurrentAndVoltage, но для всех вариантов сразу: каждое действие над
+* комплексными числами применяется к блоку вариантов векторными командами (см. ComplexKernels).
+* Набор команд выбирается при создании по возможностям процессора. Ошибка в одном варианте
+* не прерывает расчет остальных.
+*
+* При точности Precision::single расчет выполняется в float, что примерно вдвое увеличивает
+* количество вариантов на одну векторную команду. Вместе со значениями по каждому варианту
+* рассчитывается оценка погрешности первого порядка: относительная погрешность каждого сопротивления,
+* силы тока и напряжения в единицах округления float, растущая с каждым действием. Сокращение при
+* сложении (например, резонанс параллельного контура) увеличивает оценку пропорционально отношению
+* модулей слагаемых к модулю суммы. Варианты, у которых оценка силы тока какого-либо сохраняемого
+* соединения больше допустимой погрешности, пересчитываются в double
+*/
+class VariantEvaluator
+{
+    public:
+    using SimdLevel = ComplexKernels::SimdLevel; /*!< Набор векторных команд */
+
+    /*!
+    *\enum Precision
+    *\brief Точность расчета
+    */
+    enum class Precision
+    {
+        full, /*!< Расчет в double */
+        single /*!< Расчет в float с пересчетом в double вариантов с большой погрешностью */
+    };
+
+    /*!
+    * \brief Конструктор расчета
+    * \param[in] circuitTopology - топология цепи
+    * \param[in] level - набор векторных команд. Если процессор его не поддерживает, используется лучший из доступных
+    * \param[in] precision - точность расчета
+    * \param[in] tolerance - допустимая относительная погрешность силы тока при расчете в float
+    */
+    VariantEvaluator(CircuitTopology const & circuitTopology, SimdLevel level = SimdLevel::automatic,
+                     Precision precision = Precision::full, double tolerance = 1e-4);
+
+    private:
+    CircuitTopology const & topology; /*!< Топология цепи */
+    SimdLevel simdLevel; /*!< Используемый набор векторных команд */
+    Precision precision; /*!< Точность расчета */
+    double tolerance; /*!< Допустимая относительная погрешность силы тока при расчете в float */
+
+    /*!
+    * \brief Рассчитать варианты в float и пересчитать в double варианты с большой погрешностью
+    * \param[in] batch - значения вариантов
+    * \param[in] outputNodes - номера соединений, значения которых нужно сохранить
+    * \return - результаты расчета
+    */
+    VariantResults evaluateSingle(VariantBatch const & batch, std::vector<int> const & outputNodes) const;
+
+    /*!
+    * \brief Пересчитать в double варианты, рассчитанные в float с ошибкой или с погрешностью больше допустимой
+    * \param[in] batch - значения вариантов
+    * \param[in,out] results - результаты расчета в float
+    */
+    void refineInaccurate(VariantBatch const & batch, VariantResults& results) const;
+
+    public:
+    /*!
+    * \brief Получить используемый набор векторных команд
+    * \return - набор векторных команд
+    */
+    SimdLevel getSimdLevel() const;
+
+    /*!
+    * \brief Получить название используемого набора векторных команд
+    * \return - "avx512", "avx2", "sse2" или "scalar"
+    */
+    std::string simdLevelName() const;
+
+    /*!
+    * \brief Получить точность расчета
+    * \return - точность расчета
+    */
+    Precision getPrecision() const;
+
+    /*!
+    * \brief Рассчитать сопротивления, силы тока и напряжения во всех вариантах
+    * \param[in] batch - значения вариантов
+    * \param[in] outputNodes - номера соединений, значения которых нужно сохранить
+    * \return - результаты расчета
+    */
+    VariantResults evaluate(VariantBatch const & batch, std::vector<int> const & outputNodes) const;
+
+    /*!
+    * \brief Рассчитать варианты, сохранив значения корневого соединения и соединений с указанным именем
+    * \param[in] batch - значения вариантов
+    * \return - результаты расчета
+    */
+    VariantResults evaluate(VariantBatch const & batch) const;
+
+    /*!
+    * \brief Получить лучший набор векторных команд, поддерживаемый процессором
+    * \return - набор векторных команд
+    */
+    static SimdLevel detectSimdLevel();
+};
+
+#endif // VARIANTEVALUATOR_H
@@ -0,0 +1,562 @@
+#include "worstCaseAnalysis.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include "coreStrings.h"
+#include "coreTrace.h"
+
+/*!
+*\file
+*\brief Реализация функций классов ElementTolerance и WorstCaseAnalysis
+*/
+
+namespace {
+
+// Относительное расширение границ для учета ошибок округления: эмпирический запас, а не оценка по ошибкам операций
+const double roundingMargin = 1e-9;
+
+/*!
+* \brief Получить модуль комплексного числа без защиты от переполнения, которая есть в std::abs
+* \param[in] value - число
+* \return - модуль
+*/
+inline double magnitude(std::complex<double> value)
+{
+    return std::sqrt(std::norm(value));
+}
+
+/*!
+* \brief Переместить в начало массива kept элементов с наибольшими по модулю коэффициентами, по убыванию.
+* Количество сохраняемых слагаемых мало, поэтому выбор наибольшего повторяется kept раз
+* \param[in,out] items - элементы
+* \param[in] count - количество элементов
+* \param[in] kept - количество перемещаемых элементов
+* \param[in] coefficient - функция, возвращающая коэффициент элемента
+*/
+template <typename Item, typename Coefficient>
+void moveLargestForward(Item* items, size_t count, size_t kept, Coefficient coefficient)
+{
+    for (size_t i = 0; i < kept && i < count; i++)
+    {
+        size_t largest = i;
+        double largestNorm = std::norm(coefficient(items[i]));
+        for (size_t j = i + 1; j < count; j++)
+        {
+            double itemNorm = std::norm(coefficient(items[j]));
+            if (itemNorm > largestNorm)
+            {
+                largest = j;
+                largestNorm = itemNorm;
+            }
+        }
+        std::swap(items[i], items[largest]);
+    }
+}
+
+/*!
+*\class AffineTerm
+*\brief Слагаемое аффинной формы: коэффициент при отклонении одного элемента
+*/
+class AffineTerm
+{
+    public:
+    int symbol; /*!< Номер элемента в топологии */
+    std::complex<double> coefficient; /*!< Коэффициент при отклонении элемента */
+};
+
+/*!
+*\class AffineForm
+*\brief Множество комплексных значений: center + сумма coefficient * e по слагаемым + круг радиуса radius,
+* где e - отклонение элемента от -1 до 1. Бесконечный радиус - значение не ограничено.
+* Слагаемые хранятся в самой форме, их не больше Terms
+*/
+template <int Terms>
+class AffineForm
+{
+    public:
+    std::complex<double> center = 0; /*!< Центр */
+    AffineTerm terms[Terms]; /*!< Слагаемые */
+    int count = 0; /*!< Количество слагаемых */
+    double termSum = 0; /*!< Сумма модулей коэффициентов слагаемых */
+    double radius = 0; /*!< Радиус круга остальной ошибки */
+
+    /*!
+    * \brief Проверить, ограничено ли множество
+    * \return - true, если радиус конечен
+    */
+    bool isBounded() const
+    {
+        return std::isfinite(this->radius);
+    }
+
+    /*!
+    * \brief Проверить, состоит ли множество из одного нуля
+    * \return - true, если множество равно {0}
+    */
+    bool isZero() const
+    {
+        return this->center == 0.0 && this->count == 0 && this->radius == 0;
+    }
+
+    /*!
+    * \brief Получить радиус круга с центром center, содержащего всё множество
+    * \return - радиус
+    */
+    double spread() const
+    {
+        return this->termSum + this->radius;
+    }
+
+    /*!
+    * \brief Получить множество из одного значения
+    * \param[in] value - значение
+    * \return - форма без слагаемых
+    */
+    static AffineForm constant(std::complex<double> value)
+    {
+        AffineForm form;
+        form.center = value;
+        return form;
+    }
+
+    /*!
+    * \brief Получить неограниченное множество
+    * \return - форма с бесконечным радиусом
+    */
+    static AffineForm unbounded()
+    {
+        AffineForm form;
+        form.radius = std::numeric_limits<double>::infinity();
+        return form;
+    }
+
+    /*!
+    * \brief Получить форму из Terms наибольших слагаемых, остальные переносятся в радиус
+    * \param[in] center - центр
+    * \param[in,out] terms - слагаемые, порядок которых изменяется
+    * \param[in] count - количество слагаемых
+    * \param[in] radius - радиус круга остальной ошибки
+    * \return - форма
+    */
+    static AffineForm condense(std::complex<double> center, AffineTerm* terms, size_t count, double radius)
+    {
+        if (!std::isfinite(radius))
+            return AffineForm::unbounded();
+
+        AffineForm form;
+        form.center = center;
+        form.radius = radius;
+        size_t kept = std::min(count, static_cast<size_t>(Terms));
+        moveLargestForward(terms, count, kept, [](AffineTerm const & term) { return term.coefficient; });
+        for (size_t i = kept; i < count; i++)
+            form.radius += magnitude(terms[i].coefficient);
+        for (size_t i = 0; i < kept; i++)
+        {
+            form.terms[i] = terms[i];
+            form.termSum += magnitude(terms[i].coefficient);
+        }
+        form.count = static_cast<int>(kept);
+        return form;
+    }
+};
+
+/*!
+*\class FormBuilder
+*\brief Накопление слагаемых суммы аффинных форм, зависящих от разных элементов
+*/
+template <int Terms>
+class FormBuilder
+{
+    public:
+    std::complex<double> center; /*!< Центр */
+    double radius; /*!< Радиус круга остальной ошибки */
+    std::vector<AffineTerm> terms; /*!< Накопленные слагаемые */
+
+    /*!
+    * \brief Начать новую сумму
+    */
+    void reset()
+    {
+        this->center = 0;
+        this->radius = 0;
+        this->terms.clear();
+    }
+
+    /*!
+    * \brief Прибавить форму, слагаемые которой зависят от других элементов, чем уже накопленные
+    * \param[in] form - форма
+    */
+    void add(AffineForm<Terms> const & form)
+    {
+        this->center += form.center;
+        this->radius += form.radius;
+        this->terms.insert(this->terms.end(), form.terms, form.terms + form.count);
+    }
+
+    /*!
+    * \brief Получить сумму в виде формы из Terms наибольших слагаемых
+    * \return - форма
+    */
+    AffineForm<Terms> build()
+    {
+        return AffineForm<Terms>::condense(this->center, this->terms.data(), this->terms.size(), this->radius);
+    }
+};
+
+/*!
+* \brief Умножить множества: слагаемые одного элемента объединяются, произведение отклонений переносится в радиус
+* \param[in] left - первое множество
+* \param[in] right - второе множество
+* \return - произведение
+*/
+template <int Terms>
+AffineForm<Terms> multiply(AffineForm<Terms> const & left, AffineForm<Terms> const & right)
+{
+    if (!left.isBounded() || !right.isBounded())
+        return AffineForm<Terms>::unbounded();
+
+    AffineTerm terms[2 * Terms];
+    size_t count = 0;
+    for (int i = 0; i < left.count; i++)
+        terms[count++] = { left.terms[i].symbol, left.terms[i].coefficient * right.center };
+    for (int i = 0; i < right.count; i++)
+    {
+        std::complex<double> coefficient = right.terms[i].coefficient * left.center;
+        int j = 0;
+        while (j < left.count && terms[j].symbol != right.terms[i].symbol)
+            j++;
+        if (j < left.count)
+            terms[j].coefficient += coefficient;
+        else
+            terms[count++] = { right.terms[i].symbol, coefficient };
+    }
+    double radius = magnitude(left.center) * right.radius + magnitude(right.center) * left.radius + left.spread() * right.spread();
+    return AffineForm<Terms>::condense(left.center * right.center, terms, count, radius);
+}
+
+/*!
+* \brief Получить множество обратных значений линеаризацией в центре
+*
+* 1 / z = 1 / c - (z - c) / c^2 + (z - c)^2 / (c^2 * z): линейная часть сохраняет слагаемые, остаток при
+* |z - c| <= R не превышает R^2 / (|c|^2 * (|c| - R))
+* \param[in] form - множество
+* \return - обратные значения, неограниченное множество, если исходное содержит 0
+*/
+template <int Terms>
+AffineForm<Terms> inverse(AffineForm<Terms> const & form)
+{
+    double squared = std::norm(form.center);
+    double spread = form.spread();
+    if (!form.isBounded() || !(squared > spread * spread))
+        return AffineForm<Terms>::unbounded();
+
+    AffineForm<Terms> result;
+    result.center = std::conj(form.center) / squared;
+    std::complex<double> factor = -result.center * result.center;
+    double factorMagnitude = 1 / squared;
+    for (int i = 0; i < form.count; i++)
+        result.terms[i] = { form.terms[i].symbol, form.terms[i].coefficient * factor };
+    result.count = form.count;
+    result.termSum = form.termSum * factorMagnitude;
+    result.radius = form.radius * factorMagnitude + spread * spread * factorMagnitude / (std::sqrt(squared) - spread);
+    return result;
+}
+
+/*!
+* \brief Выбрать из двух множеств, содержащих одно значение, меньшее
+* \param[in] first - первое множество
+* \param[in] second - второе множество
+* \return - множество с меньшим радиусом описанного круга
+*/
+template <int Terms>
+AffineForm<Terms> const & tighter(AffineForm<Terms> const & first, AffineForm<Terms> const & second)
+{
+    return second.isBounded() && !(first.spread() <= second.spread()) ? second : first;
+}
+
+/*!
+* \brief Получить наименьший и наибольший модули значений множества
+*
+* Слагаемые проецируются на направление центра и перпендикулярное ему
+* \param[in] form - множество
+* \param[out] minimum - наименьший модуль
+* \param[out] maximum - наибольший модуль
+*/
+template <int Terms>
+void magnitudeBounds(AffineForm<Terms> const & form, double& minimum, double& maximum)
+{
+    if (!form.isBounded())
+    {
+        minimum = 0;
+        maximum = std::numeric_limits<double>::infinity();
+        return;
+    }
+
+    double centerMagnitude = magnitude(form.center);
+    double along = 0, across = 0;
+    std::complex<double> direction = centerMagnitude > 0 ? std::conj(form.center) / centerMagnitude : 1.0;
+    for (int i = 0; i < form.count; i++)
+    {
+        std::complex<double> projected = form.terms[i].coefficient * direction;
+        along += std::abs(projected.real());
+        across += std::abs(projected.imag());
+    }
+    minimum = std::max(0.0, centerMagnitude - along - form.radius) * (1 - roundingMargin);
+    maximum = (std::hypot(centerMagnitude + along, across) + form.radius) * (1 + roundingMargin);
+}
+
+/*!
+*\class SiblingTerm
+*\brief Слагаемое сопротивления или проводимости ребенка соединения
+*/
+class SiblingTerm
+{
+    public:
+    AffineTerm term; /*!< Слагаемое */
+    int child; /*!< Порядковый номер ребенка в соединении */
+};
+
+/*!
+*\class SiblingSum
+*\brief Сумма сопротивлений или проводимостей нескольких детей соединения без отдельных слагаемых
+*/
+class SiblingSum
+{
+    public:
+    std::complex<double> center = 0; /*!< Сумма центров */
+    double termSum = 0; /*!< Сумма модулей коэффициентов слагаемых */
+    double radius = 0; /*!< Сумма радиусов */
+
+    /*!
+    * \brief Прибавить значение ребенка
+    * \param[in] form - сопротивление или проводимость ребенка
+    * \return - новая сумма
+    */
+    template <int Terms>
+    SiblingSum plus(AffineForm<Terms> const & form) const
+    {
+        SiblingSum result;
+        result.center = this->center + form.center;
+        result.termSum = this->termSum + form.termSum;
+        result.radius = this->radius + form.radius;
+        return result;
+    }
+};
+
+
+/*!
+* \brief Рассчитать границы модулей сил тока выбранных соединений с формами из Terms слагаемых
+* \param[in] topology - топология цепи
+* \param[in] tolerances - допуски элементов в порядке топологии
+* \param[in,out] analysis - границы с указанными выбранными соединениями, в которые записываются модули
+*/
+template <int Terms>
+void evaluateBounds(CircuitTopology const & topology, std::vector<ElementTolerance> const & tolerances, WorstCaseAnalysis& analysis)
+{
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    size_t nodeCount = nodes.size();
+    std::vector<AffineForm<Terms>> resistances(nodeCount);
+    std::vector<AffineForm<Terms>> admittances(nodeCount);
+    FormBuilder<Terms> builder;
+
+    // Сопротивления и проводимости: дети расположены после родителя, поэтому обходим соединения с конца
+    for (size_t n = nodeCount; n-- > 0;)
+    {
+        CircuitTopology::Node const & node = nodes[n];
+        builder.reset();
+
+        // Сопротивление элемента при любом значении из допуска лежит на отрезке между крайними значениями
+        if (node.type == CoreConnection::ConnectionType::sequential)
+        {
+            for (int e = node.firstElement; e < node.firstElement + node.elementCount; e++)
+            {
+                std::complex<double> resistance = topology.elementResistances[e];
+                ElementTolerance const & tolerance = tolerances[e];
+                builder.center += resistance * ((tolerance.lower + tolerance.upper) / 2);
+                if (tolerance.upper != tolerance.lower)
+                    builder.terms.push_back({ e, resistance * ((tolerance.upper - tolerance.lower) / 2) });
+            }
+            resistances[n] = builder.build();
+            admittances[n] = inverse(resistances[n]);
+        }
+        else
+        {
+            // Последовательное соединение складывает сопротивления детей, параллельное - проводимости
+            bool isParallel = node.type == CoreConnection::ConnectionType::parallel;
+            std::vector<AffineForm<Terms>>& summed = isParallel ? admittances : resistances;
+            std::vector<AffineForm<Terms>>& reciprocal = isParallel ? resistances : admittances;
+            int const * children = topology.childIndices.data() + node.firstChild;
+            int unboundedChild = -1, unboundedCount = 0;
+            for (int c = 0; c < node.childCount; c++)
+            {
+                builder.add(summed[children[c]]);
+                if (!summed[children[c]].isBounded())
+                {
+                    unboundedChild = children[c];
+                    unboundedCount++;
+                }
+            }
+            summed[n] = builder.build();
+            if (isParallel && summed[n].isZero())
+                throw formatStr("При расчете сопротивления параллельного соединения %1 получено недопустимое значение. "
+                                "Проверьте правильность входных данных.", { node.displayName() });
+            reciprocal[n] = inverse(summed[n]);
+
+            // Если неограничено значение одного ребенка (например, контур в резонансе), обратное значение соединения
+            // рассчитывается через обратное значение этого ребенка: Z = Z_c / (1 + Z_c * Y_others), Y = Y_c / (1 + Y_c * Z_others)
+            if (unboundedCount == 1)
+            {
+                builder.reset();
+                for (int c = 0; c < node.childCount; c++)
+                {
+                    if (children[c] != unboundedChild)
+                        builder.add(summed[children[c]]);
+                }
+                AffineForm<Terms> divisor = multiply(reciprocal[unboundedChild], builder.build());
+                divisor.center += 1.0;
+                reciprocal[n] = multiply(reciprocal[unboundedChild], inverse(divisor));
+            }
+        }
+
+        if (resistances[n].isZero())
+            throw formatStr("При расчете сопротивления соединения %1 был получен 0. Проверьте правильность входных данных.", { node.displayName() });
+    }
+
+    // Силы тока и напряжения: родитель расположен раньше детей, поэтому обходим соединения с начала.
+    // Сопротивление и проводимость соединения нужны только при расчете долей детей его родителя, после чего
+    // на их место записываются напряжение и сила тока: памяти требуется вдвое меньше
+    std::vector<AffineForm<Terms>>& voltages = resistances;
+    std::vector<AffineForm<Terms>>& currents = admittances;
+    currents[0] = multiply(AffineForm<Terms>::constant(topology.rootVoltage), admittances[0]);
+    voltages[0] = AffineForm<Terms>::constant(topology.rootVoltage);
+
+    std::vector<AffineForm<Terms> const *> ownForms, siblingForms;
+    std::vector<SiblingTerm> siblingTerms;
+    std::vector<SiblingSum> before, after;
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+        CircuitTopology::Node const & node = nodes[n];
+        int const * children = topology.childIndices.data() + node.firstChild;
+        if (node.childCount == 1)
+        {
+            currents[children[0]] = currents[n];
+            voltages[children[0]] = voltages[n];
+        }
+        if (node.childCount <= 1)
+            continue;
+
+        // Дети параллельного соединения делят силу тока, последовательного - напряжение. Доля ребенка
+        // рассчитывается через его сопротивление (проводимость) и сумму проводимостей (сопротивлений) остальных детей
+        bool isParallel = node.type == CoreConnection::ConnectionType::parallel;
+        AffineForm<Terms> const & divided = isParallel ? currents[n] : voltages[n];
+        AffineForm<Terms> const & common = isParallel ? voltages[n] : currents[n];
+        size_t childCount = static_cast<size_t>(node.childCount);
+        ownForms.resize(childCount);
+        siblingForms.resize(childCount);
+        siblingTerms.clear();
+        for (size_t c = 0; c < childCount; c++)
+        {
+            ownForms[c] = isParallel ? &resistances[children[c]] : &admittances[children[c]];
+            siblingForms[c] = isParallel ? &admittances[children[c]] : &resistances[children[c]];
+            for (int i = 0; i < siblingForms[c]->count; i++)
+                siblingTerms.push_back({ siblingForms[c]->terms[i], static_cast<int>(c) });
+        }
+
+        // Среди 2 * Terms наибольших слагаемых всегда есть Terms не от одного ребенка
+        size_t selectedCount = std::min(siblingTerms.size(), static_cast<size_t>(2 * Terms));
+        moveLargestForward(siblingTerms.data(), siblingTerms.size(), selectedCount, [](SiblingTerm const & item) {
+            return item.term.coefficient;
+        });
+
+        // Суммы детей до и после каждого ребенка: сумма остальных детей получается без вычитания
+        before.assign(childCount + 1, SiblingSum());
+        after.assign(childCount + 1, SiblingSum());
+        for (size_t c = 0; c < childCount; c++)
+        {
+            before[c + 1] = before[c].plus(*siblingForms[c]);
+            after[childCount - 1 - c] = after[childCount - c].plus(*siblingForms[childCount - 1 - c]);
+        }
+
+        for (size_t c = 0; c < childCount; c++)
+        {
+            // Сумма остальных детей: их наибольшие слагаемые, остальные - в радиусе
+            AffineForm<Terms> others;
+            for (size_t i = 0; i < selectedCount && others.count < Terms; i++)
+            {
+                if (siblingTerms[i].child == static_cast<int>(c))
+                    continue;
+                others.terms[others.count++] = siblingTerms[i].term;
+                others.termSum += magnitude(siblingTerms[i].term.coefficient);
+            }
+            others.center = before[c].center + after[c + 1].center;
+            double droppedSum = before[c].termSum + after[c + 1].termSum - others.termSum;
+            others.radius = before[c].radius + after[c + 1].radius + std::max(0.0, droppedSum);
+
+            // I_c = I / (1 + Y_others * Z_c) или U_c = U / (1 + Z_others * Y_c): значение ребенка входит в формулу один раз.
+            // Вторая оценка - через общую величину: I_c = U * Y_c или U_c = I * Z_c, она остается ограниченной,
+            // если делитель может быть равен 0
+            AffineForm<Terms> divisor = multiply(others, *ownForms[c]);
+            divisor.center += 1.0;
+            AffineForm<Terms> viaDivider = multiply(divided, inverse(divisor));
+            AffineForm<Terms> viaCommon = multiply(common, *siblingForms[c]);
+            AffineForm<Terms> const & share = tighter(viaDivider, viaCommon);
+            AffineForm<Terms> kept = common.isBounded() ? common : multiply(share, *ownForms[c]);
+            currents[children[c]] = isParallel ? share : kept;
+            voltages[children[c]] = isParallel ? kept : share;
+        }
+    }
+
+    analysis.minimums.resize(analysis.outputNodes.size());
+    analysis.maximums.resize(analysis.outputNodes.size());
+    for (size_t i = 0; i < analysis.outputNodes.size(); i++)
+        magnitudeBounds(currents[analysis.outputNodes[i]], analysis.minimums[i], analysis.maximums[i]);
+}
+
+}
+
+ElementTolerance ElementTolerance::relative(double tolerance, bool isReciprocal)
+{
+    ElementTolerance result;
+    result.lower = isReciprocal ? 1 / (1 + tolerance) : 1 - tolerance;
+    result.upper = isReciprocal ? 1 / (1 - tolerance) : 1 + tolerance;
+    return result;
+}
+
+WorstCaseAnalysis WorstCaseAnalysis::evaluate(CircuitTopology const & topology, std::vector<ElementTolerance> const & tolerances, int termCount)
+{
+    CORE_TRACE_SPAN("WorstCaseAnalysis::evaluate");
+    if (tolerances.size() != topology.elementResistances.size())
+        throw formatStr("Количество допусков (%1) не совпадает с количеством элементов цепи (%2).",
+                        { numberToStr(static_cast<int>(tolerances.size())), numberToStr(static_cast<int>(topology.elementResistances.size())) });
+    if (termCount < 1 || termCount > maxTermCount)
+        throw formatStr("Количество слагаемых аффинной формы должно быть от 1 до %1.", { numberToStr(maxTermCount) });
+
+    std::vector<CircuitTopology::Node> const & nodes = topology.nodes;
+    WorstCaseAnalysis analysis;
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        if (nodes[n].hasCustomName)
+            analysis.outputNodes.push_back(static_cast<int>(n));
+    }
+    std::stable_sort(analysis.outputNodes.begin(), analysis.outputNodes.end(), [&](int left, int right) {
+        return nodes[left].customName < nodes[right].customName;
+    });
+
+    // Слагаемые хранятся в самих формах, поэтому для каждого их количества собирается своя реализация
+    switch (termCount) {
+    case 1:
+        evaluateBounds<1>(topology, tolerances, analysis);
+        break;
+    case 2:
+        evaluateBounds<2>(topology, tolerances, analysis);
+        break;
+    case 3:
+        evaluateBounds<3>(topology, tolerances, analysis);
+        break;
+    default:
+        evaluateBounds<4>(topology, tolerances, analysis);
+        break;
+    }
+    return analysis;
+}
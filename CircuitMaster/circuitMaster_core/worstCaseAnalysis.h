@@ -0,0 +1,81 @@
+#ifndef WORSTCASEANALYSIS_H
+#define WORSTCASEANALYSIS_H
+#include <vector>
+#include "circuitTopology.h"
+
+/*!
+*\file
+*\brief Переменные, заголовки конструкторов и функций расчета наихудших сил тока при допусках элементов
+*/
+
+/*!
+*\class ElementTolerance
+*\brief Допуск элемента: диапазон множителя его сопротивления
+*/
+class ElementTolerance
+{
+    public:
+    double lower = 1; /*!< Наименьший множитель сопротивления */
+    double upper = 1; /*!< Наибольший множитель сопротивления */
+
+    /*!
+    * \brief Получить диапазон множителя сопротивления по относительному допуску значения элемента
+    * \param[in] tolerance - относительный допуск, от 0 до 1 (не включая)
+    * \param[in] isReciprocal - true, если сопротивление обратно пропорционально значению (конденсатор, заданный емкостью)
+    * \return - допуск элемента
+    */
+    static ElementTolerance relative(double tolerance, bool isReciprocal);
+};
+
+/*!
+*\class WorstCaseAnalysis
+*\brief Наименьший и наибольший модули сил тока именованных соединений при допусках элементов, гарантированные
+* с точностью до ошибок округления
+*
+* Сопротивления, проводимости, силы тока и напряжения рассчитываются теми же проходами по топологии, что и
+* в CircuitState, но вместо комплексных чисел используются аффинные формы: центр, сумма слагаемых a_i * e_i, где
+* e_i - неизвестное отклонение i-го элемента от -1 до 1, и радиус круга, в который попадает остальная ошибка.
+* Сопротивление элемента при любом значении из допуска лежит на отрезке, поэтому задается формой точно. Слагаемые
+* одного элемента в разных величинах сокращаются, поэтому оценка расширяется меньше, чем при интервальной
+* арифметике. Форма хранит не больше termCount наибольших слагаемых, остальные переносятся в радиус, поэтому время
+* расчета пропорционально количеству соединений.
+*
+* termCount задает соотношение точности и времени. С одним слагаемым (по умолчанию) расчет примерно в 5-6 раз
+* дольше CircuitState, с двумя - в 7-11 раз, с четырьмя - в 10-17 раз. Оценка верна при любом termCount,
+* но чем меньше слагаемых, тем больше ошибки переносится в радиус и тем шире границы: на случайных цепях с
+* допуском 5% медианное отношение ширины границ к действительному диапазону 1.6 с одним слагаемым и 1.4 с четырьмя.
+*
+* Сила тока ребенка параллельного соединения рассчитывается как I / (1 + Y * Z), где Z - сопротивление ребенка,
+* Y - сумма проводимостей остальных детей: в этом виде сопротивление ребенка встречается в формуле один раз.
+* Напряжение ребенка последовательного соединения так же рассчитывается как U / (1 + Z * Y). Вторая оценка -
+* через общую величину детей (U * Y или I * Z), из двух выбирается более узкая. Если множество значений
+* сопротивления или проводимости содержит 0, сила тока может быть сколь угодно большой: наибольший модуль равен
+* бесконечности.
+*
+* Операции выполняются с обычным округлением к ближайшему, а не с направленным: ошибки округления не входят в
+* радиус, вместо этого итоговые границы расширяются на относительную величину 1e-9. Этого достаточно, пока
+* накопленная относительная ошибка расчета мала (как и у CircuitState, порядка глубины цепи, умноженной на 1e-16),
+* но строгой гарантии при почти нулевых делителях нет
+*/
+class WorstCaseAnalysis
+{
+    public:
+    static const int maxTermCount = 4; /*!< Наибольшее допустимое количество слагаемых аффинной формы */
+
+    std::vector<int> outputNodes; /*!< Номера соединений с указанным именем, по алфавиту имен */
+    std::vector<double> minimums; /*!< Наименьшие модули сил тока в порядке outputNodes */
+    std::vector<double> maximums; /*!< Наибольшие модули сил тока в порядке outputNodes, бесконечность - не ограничены */
+
+    /*!
+    * \brief Рассчитать границы модулей сил тока именованных соединений
+    *
+    * Ошибки расчета сообщаются исключением std::string с тем же текстом, что и у CircuitState
+    * \param[in] topology - топология цепи
+    * \param[in] tolerances - допуски элементов в порядке топологии
+    * \param[in] termCount - количество слагаемых, хранимых в аффинной форме, от 1 до maxTermCount
+    * \return - границы модулей сил тока
+    */
+    static WorstCaseAnalysis evaluate(CircuitTopology const & topology, std::vector<ElementTolerance> const & tolerances, int termCount = 1);
+};
+
+#endif // WORSTCASEANALYSIS_H
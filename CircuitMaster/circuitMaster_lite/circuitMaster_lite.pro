@@ -0,0 +1,24 @@
+# Программа без зависимости от Qt: ядро и разборщик xml на стандартной библиотеке.
+# CONFIG += qt_parser - дополнительно подключить разборщик на основе QDomDocument
+# CONFIG += static_cli - собрать полностью статический исполняемый файл
+
+TEMPLATE = app
+
+CONFIG += c++17 console warn_on
+CONFIG -= app_bundle
+CONFIG -= qt
+
+include(../circuitMaster_core/circuitMaster_core.pri)
+
+SOURCES += \
+        main.cpp
+
+static_cli {
+    unix: QMAKE_LFLAGS += -static
+    win32-g++: QMAKE_LFLAGS += -static -static-libgcc -static-libstdc++
+}
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,649 @@
+#include <clocale>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "allocationStats.h"
+#include "batchPipeline.h"
+#include "circuitArena.h"
+#include "circuitContainer.h"
+#include "circuitTopology.h"
+#include "componentOptimizer.h"
+#include "coreConnection.h"
+#include "coreIo.h"
+#include "coreTrace.h"
+#include "documentParser.h"
+#include "faultAnalysis.h"
+#include "goalSeek.h"
+#include "harmonicAnalysis.h"
+#include "metricsExporter.h"
+#include "perfCounters.h"
+#include "resonanceAnalysis.h"
+#include "transferFunction.h"
+#include "worstCaseAnalysis.h"
+
+/*!
+*\file
+*\brief Главная функция программы, собранной без Qt
+*
+* Принимает те же аргументы, что и circuitMaster_main: путь к файлу с входными данными
+* формата xml и путь к файлу для записи выходных данных.
+*\code
+circuitMaster_lite C:\input.xml C:\output.txt
+*\endcode
+* Входной файл может содержать контейнер \c <circuits> из нескольких цепей (см. CircuitContainer), они
+* рассчитываются параллельно в --threads потоках.
+* Дополнительные параметры:
+* - \c --parser=lite|qt - разборщик входных данных (по умолчанию lite)
+* - \c --batch - пакетная обработка: вместо путей к файлам указываются папка с входными файлами .xml
+*   и папка для выходных файлов
+* - \c --threads=N - количество потоков расчета при пакетной обработке и расчете контейнера цепей (по умолчанию по числу ядер)
+* - \c --queue=N - вместимость очередей между стадиями пакетной обработки
+* - \c --io=sync|uring - способ файлового ввода-вывода при пакетной обработке (uring доступен в сборке с CONFIG += io_uring)
+* - \c --io-batch=N - количество файлов, читаемых или записываемых за одно обращение
+* - \c --huge-pages - размещать деревья соединений в памяти на больших страницах (только Linux)
+* - \c --normalize - упрощать дерево соединений перед расчетом (вложенные соединения одного вида без имени)
+* - \c --sweep=FROM:TO:N - рассчитать силы тока на N частотах от FROM до TO (логарифмический шаг) по передаточным функциям цепи
+* - \c --harmonics - рассчитать силы тока на гармониках напряжения, указанных атрибутом \c harmonics корневого элемента, и их действующие значения
+* - \c --faults - рассчитать силы тока при обрыве и замыкании каждого элемента по очереди (аварии рассчитываются в --threads потоках)
+* - \c --optimize=SECONDS - подобрать номиналы элементов с атрибутом \c series из стандартного ряда для получения сил тока,
+*   указанных атрибутом \c target именованных соединений, за SECONDS секунд в --threads потоках
+* - \c --goal-seek=voltage|frequency|NAME:N - подобрать напряжение, частоту или значение N-го элемента соединения NAME,
+*   при котором сила тока соединения с атрибутом \c target равна требуемой
+* - \c --resonances=FROM:TO - найти экстремумы модуля сопротивления цепи и сил тока именованных соединений на частотах от FROM до TO,
+*   их частоты, добротность и силы тока
+* - \c --worst-case[=K] - рассчитать (с точностью до округления) наименьший и наибольший модули сил тока именованных соединений
+*   при допусках элементов, указанных атрибутом \c tolerance. K - количество слагаемых аффинных форм, от 1 до 4 (по умолчанию 1)
+* - \c --no-plan-cache - не использовать кэш топологий при пакетной обработке и расчете контейнера цепей: строить дерево соединений для каждой цепи
+* - \c --precision=double|float - точность совместного расчета файлов одной топологии при пакетной обработке (по умолчанию double).
+*   В float файлы, у которых оценка погрешности силы тока какого-либо именованного соединения больше --float-tolerance,
+*   пересчитываются в double
+* - \c --float-tolerance=T - допустимая относительная погрешность силы тока при расчете в float (по умолчанию 1e-4)
+* - \c --trace=FILE - записать длительность этапов в FILE в формате Chrome trace (сборка с CONFIG += trace)
+* - \c --trace-depth=N - наибольшая записываемая глубина рекурсивных этапов (по умолчанию 3)
+* - \c --alloc-stats - вывести количество выделений памяти по этапам (сборка с CONFIG += alloc_stats)
+* - \c --metrics-socket=PATH - отдавать метрики в формате Prometheus через Unix-сокет PATH во время работы
+* - \c --metrics-file=PATH - записывать метрики в формате Prometheus в файл PATH по сигналу SIGUSR1 и при завершении
+* - \c --perf-counters - вывести аппаратные счетчики производительности по этапам (сборка с CONFIG += perf_counters, только Linux)
+*/
+
+/*!
+* \brief Получить целое неотрицательное число из текста параметра
+*
+* В отличие от std::stoul не принимает знак и лишние символы после числа: "-1" и "3x" - ошибки
+* \param[in] text - текст числа
+* \return - число
+*/
+static unsigned long parseUnsigned(std::string const & text)
+{
+    if (text.empty() || text[0] < '0' || text[0] > '9')
+        throw std::invalid_argument(text);
+    size_t length = 0;
+    unsigned long value = std::stoul(text, &length);
+    if (length != text.size())
+        throw std::invalid_argument(text);
+    return value;
+}
+
+/*!
+* \brief Получить целое значение параметра вида --name=N
+* \param[in] arg - аргумент командной строки
+* \param[in] prefix - начало параметра вместе со знаком "="
+* \param[out] value - значение параметра
+* \return - true, если аргумент является этим параметром
+*/
+static bool readUnsignedOption(std::string const & arg, std::string const & prefix, unsigned long& value)
+{
+    if (arg.rfind(prefix, 0) != 0)
+        return false;
+    value = parseUnsigned(arg.substr(prefix.size()));
+    return true;
+}
+
+/*!
+* \brief Получить диапазон частот из параметра вида --sweep=FROM:TO:N
+* \param[in] arg - аргумент командной строки
+* \param[out] frequencies - частоты диапазона
+* \return - true, если аргумент является этим параметром
+*/
+static bool readSweepOption(std::string const & arg, std::vector<double>& frequencies)
+{
+    const std::string prefix = "--sweep=";
+    if (arg.rfind(prefix, 0) != 0)
+        return false;
+
+    std::string range = arg.substr(prefix.size());
+    size_t first = range.find(':');
+    size_t second = range.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos)
+        throw std::invalid_argument(arg);
+    frequencies = TransferFunction::logFrequencies(std::stod(range.substr(0, first)), std::stod(range.substr(first + 1, second - first - 1)),
+                                                   parseUnsigned(range.substr(second + 1)));
+    return true;
+}
+
+/*!
+* \brief Получить диапазон частот из параметра вида --resonances=FROM:TO
+* \param[in] arg - аргумент командной строки
+* \param[out] from - начальная частота
+* \param[out] to - конечная частота
+* \return - true, если аргумент является этим параметром
+*/
+static bool readResonanceOption(std::string const & arg, double& from, double& to)
+{
+    const std::string prefix = "--resonances=";
+    if (arg.rfind(prefix, 0) != 0)
+        return false;
+
+    std::string range = arg.substr(prefix.size());
+    size_t separator = range.find(':');
+    if (separator == std::string::npos)
+        throw std::invalid_argument(arg);
+    from = std::stod(range.substr(0, separator));
+    to = std::stod(range.substr(separator + 1));
+    if (!(from > 0) || !(to > from))
+        throw std::invalid_argument(arg);
+    return true;
+}
+
+/*!
+* \brief Выполнить пакетную обработку
+* \param[in] inputDir - папка с входными файлами
+* \param[in] outputDir - папка для выходных файлов
+* \param[in] options - параметры обработки
+* \return - код завершения программы
+*/
+static int runBatch(std::string const & inputDir, std::string const & outputDir, BatchOptions const & options)
+{
+    std::vector<BatchJob> jobs = BatchPipeline::jobsFromDirectory(inputDir, outputDir);
+    BatchSummary summary = BatchPipeline(options).run(jobs);
+
+    for (auto iter = summary.errors.cbegin(); iter != summary.errors.cend(); iter++)
+        std::cerr << *iter << std::endl;
+
+    std::cout << "Обработано файлов: " << summary.total << ", успешно: " << summary.succeeded
+              << ", с ошибками: " << summary.failed << ", время: " << summary.seconds << " с, ввод-вывод: " << summary.ioBackend
+              << ", рассчитано по кэшу топологий: " << summary.planCacheHits << std::endl;
+    return summary.failed == 0 ? 0 : 1;
+}
+
+/*!
+* \brief Рассчитать один файл
+* \param[in] inputPath - путь к файлу с входными данными
+* \param[in] outputPath - путь к файлу для записи выходных данных
+* \param[in] options - параметры обработки: разборщик, использование больших страниц, упрощение дерева,
+* а для контейнера цепей также количество потоков и кэш топологий
+* \return - код завершения программы
+*/
+static int runSingle(std::string const & inputPath, std::string const & outputPath, BatchOptions const & options)
+{
+    std::unique_ptr<DocumentParser> parser = DocumentParser::create(options.parserName);
+    DocumentNode rootElement = parser->parseFile(inputPath);
+
+    // Цепи контейнера рассчитываются параллельно, одинаковые топологии берутся из общего кэша
+    if (CircuitContainer::isContainer(rootElement))
+    {
+        std::unique_ptr<PlanCache> planCache;
+        if (options.usePlanCache)
+            planCache.reset(new PlanCache());
+        writeTextToFile(outputPath, CircuitContainer::evaluate(rootElement, options, planCache.get()));
+        return 0;
+    }
+
+    // Создаём дерево соединений схемы в арене, которая освобождается целиком после записи результата
+    CircuitArena arena(256 * 1024, options.useHugePages);
+    CircuitMap circuitMap(arena.resource());
+    circuitFromDocument(rootElement, circuitMap);
+
+    // Получаем корневое соединение
+    CoreConnection& rootConnection = circuitMap.begin()->second;
+
+    // Убираем лишнюю вложенность соединений
+    if (options.normalizeTree)
+        rootConnection.normalize(circuitMap);
+
+    // Вычисляем сопротивления для всех соединений рекурсивно
+    rootConnection.calculateResistance();
+
+    // Вычисляем силу тока и напряжение для всех соединений рекурсивно
+    rootConnection.calculateCurrentAndVoltage();
+
+    // Записываем результат в файл
+    writeOutputToFile(outputPath, circuitMap);
+    return 0;
+}
+
+/*!
+*\class CircuitFile
+*\brief Цепь одного входного файла, подготовленная для расчета в одном из режимов анализа
+*/
+class CircuitFile
+{
+    public:
+    DocumentNode rootElement; /*!< Корневой узел документа */
+    CircuitTopology topology; /*!< Топология цепи */
+    std::string outputPath; /*!< Путь к файлу для записи выходных данных */
+};
+
+/*!
+* \brief Прочитать файл и построить топологию цепи
+* \param[in] inputPath - путь к файлу с входными данными
+* \param[in] outputPath - путь к файлу для записи выходных данных
+* \param[in] options - параметры обработки: разборщик и упрощение дерева
+* \param[in] keepDocumentOrder - не упрощать дерево, даже если это указано в options: элементы и соединения
+* топологии нумеруются в порядке документа, по которому указываются подбираемые элементы и допуски
+* \return - цепь файла
+*/
+static CircuitFile loadCircuitFile(std::string const & inputPath, std::string const & outputPath, BatchOptions const & options,
+                                   bool keepDocumentOrder)
+{
+    CircuitFile circuit;
+    std::unique_ptr<DocumentParser> parser = DocumentParser::create(options.parserName);
+    circuit.rootElement = parser->parseFile(inputPath);
+
+    CircuitMap circuitMap;
+    circuitFromDocument(circuit.rootElement, circuitMap);
+    CoreConnection& rootConnection = circuitMap.begin()->second;
+    if (options.normalizeTree && !keepDocumentOrder)
+        rootConnection.normalize(circuitMap);
+
+    circuit.topology = CircuitTopology::fromConnection(rootConnection, frequencyFromDocument(circuit.rootElement));
+    circuit.outputPath = outputPath;
+    return circuit;
+}
+
+/*!
+* \brief Рассчитать цепь на нескольких частотах
+* \param[in] circuit - цепь файла
+* \param[in] frequencies - частоты
+* \return - текст для записи в выходной файл
+*/
+static std::string runSweep(CircuitFile const & circuit, std::vector<double> const & frequencies)
+{
+    // Дерево переводится в передаточные функции один раз, расчет на каждой частоте от размера цепи не зависит.
+    // Если передаточные функции построить нельзя (например, их степень слишком велика), цепь рассчитывается
+    // заново на каждой частоте
+    return formatOutput(FrequencySweep::evaluate(circuit.topology, frequencies));
+}
+
+/*!
+* \brief Рассчитать цепь на гармониках напряжения источника
+* \param[in] circuit - цепь файла
+* \return - текст для записи в выходной файл
+*/
+static std::string runHarmonics(CircuitFile const & circuit)
+{
+    // Все гармоники рассчитываются за один обход топологии
+    return formatOutput(HarmonicAnalysis::evaluate(circuit.topology, harmonicsFromDocument(circuit.rootElement)));
+}
+
+/*!
+* \brief Рассчитать цепь при обрыве и замыкании каждого элемента
+* \param[in] circuit - цепь файла
+* \param[in] options - параметры обработки: количество потоков
+* \return - текст для записи в выходной файл
+*/
+static std::string runFaults(CircuitFile const & circuit, BatchOptions const & options)
+{
+    // Исходная цепь рассчитывается один раз, каждая авария пересчитывает только пути до корня
+    return formatOutput(circuit.topology, FaultAnalysis::evaluate(circuit.topology, options.computeThreads));
+}
+
+/*!
+* \brief Найти резонансы цепи в диапазоне частот
+* \param[in] circuit - цепь файла
+* \param[in] from - начальная частота
+* \param[in] to - конечная частота
+* \return - текст для записи в выходной файл
+*/
+static std::string runResonances(CircuitFile const & circuit, double from, double to)
+{
+    // Частоты сгущаются только у резонансов, каждый экстремум уточняется по производным
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(circuit.topology, from, to);
+    std::cout << "Рассчитано частот: " << analysis.evaluationCount << std::endl;
+    return formatOutput(circuit.topology, analysis);
+}
+
+/*!
+* \brief Подобрать номиналы элементов цепи
+* \param[in] circuit - цепь файла
+* \param[in] options - параметры обработки: количество потоков
+* \param[in] seconds - ограничение времени подбора
+* \return - текст для записи в выходной файл
+*/
+static std::string runOptimize(CircuitFile const & circuit, BatchOptions const & options, double seconds)
+{
+    std::vector<OptimizationVariable> variables;
+    std::vector<CurrentTarget> targets;
+    optimizationFromDocument(circuit.rootElement, circuit.topology, variables, targets);
+
+    OptimizationOptions optimizationOptions;
+    optimizationOptions.seconds = seconds;
+    optimizationOptions.threadCount = options.computeThreads;
+    OptimizationResult result = ComponentOptimizer::optimize(circuit.topology, variables, targets, optimizationOptions);
+
+    std::cout << "Оценено наборов номиналов: " << result.evaluationCount << ", локальных поисков: " << result.searchCount << std::endl;
+    return formatOutput(circuit.topology, variables, targets, result);
+}
+
+/*!
+* \brief Подобрать одно значение цепи под требуемую силу тока
+* \param[in] circuit - цепь файла
+* \param[in] unknown - подбираемое значение: "voltage", "frequency" или элемент "имя соединения:номер элемента"
+* \return - текст для записи в выходной файл
+*/
+static std::string runGoalSeek(CircuitFile const & circuit, std::string const & unknown)
+{
+    CurrentTarget target = goalSeekTargetFromDocument(circuit.rootElement, circuit.topology);
+
+    GoalSeek result;
+    if (unknown == "voltage")
+        result = GoalSeek::solveVoltage(circuit.topology, target);
+    else if (unknown == "frequency")
+        result = GoalSeek::solveFrequency(circuit.topology, target);
+    else
+        result = GoalSeek::solveElement(circuit.topology, goalSeekElementFromDocument(circuit.rootElement, circuit.topology, unknown), target);
+    return formatOutput(circuit.topology, result);
+}
+
+/*!
+* \brief Рассчитать наихудшие силы тока цепи при допусках элементов
+* \param[in] circuit - цепь файла
+* \param[in] termCount - количество слагаемых аффинных форм
+* \return - текст для записи в выходной файл
+*/
+static std::string runWorstCase(CircuitFile const & circuit, int termCount)
+{
+    // Границы рассчитываются за один проход сопротивлений и один проход сил тока
+    std::vector<ElementTolerance> tolerances = tolerancesFromDocument(circuit.rootElement, circuit.topology);
+    return formatOutput(circuit.topology, WorstCaseAnalysis::evaluate(circuit.topology, tolerances, termCount));
+}
+
+/*!
+*\enum RunMode
+*\brief Режим работы программы, задаваемый параметром командной строки
+*/
+enum class RunMode
+{
+    single, /*!< Расчет одного файла (по умолчанию) */
+    batch, /*!< --batch */
+    sweep, /*!< --sweep */
+    harmonics, /*!< --harmonics */
+    resonances, /*!< --resonances */
+    faults, /*!< --faults */
+    optimize, /*!< --optimize */
+    goalSeek, /*!< --goal-seek */
+    worstCase /*!< --worst-case */
+};
+
+/*!
+*\class AnalysisOptions
+*\brief Параметры режимов анализа цепи одного файла
+*/
+class AnalysisOptions
+{
+    public:
+    std::vector<double> frequencies; /*!< Частоты для --sweep */
+    double resonanceFrom = 0; /*!< Начальная частота для --resonances */
+    double resonanceTo = 0; /*!< Конечная частота для --resonances */
+    double optimizeSeconds = -1; /*!< Ограничение времени для --optimize */
+    std::string goalSeekUnknown; /*!< Подбираемое значение для --goal-seek */
+    int worstCaseTerms = 1; /*!< Количество слагаемых аффинных форм для --worst-case */
+};
+
+/*!
+* \brief Установить режим работы. Режимы не сочетаются друг с другом, поэтому второй режим - ошибка
+* \param[in,out] mode - текущий режим
+* \param[in] newMode - режим, заданный аргументом
+* \param[in] arg - аргумент командной строки
+*/
+static void setRunMode(RunMode& mode, RunMode newMode, std::string const & arg)
+{
+    if (mode != RunMode::single && mode != newMode)
+        throw std::string("Параметр " + arg + " нельзя указать вместе с другим режимом расчета.");
+    mode = newMode;
+}
+
+/*!
+* \brief Выполнить режим анализа цепи одного файла
+* \param[in] mode - режим анализа
+* \param[in] inputPath - путь к файлу с входными данными
+* \param[in] outputPath - путь к файлу для записи выходных данных
+* \param[in] options - параметры обработки
+* \param[in] analysisOptions - параметры режима анализа
+* \return - код завершения программы
+*/
+static int runAnalysis(RunMode mode, std::string const & inputPath, std::string const & outputPath, BatchOptions const & options,
+                       AnalysisOptions const & analysisOptions)
+{
+    // Подбор и допуски указываются по номерам элементов в документе, поэтому их дерево не упрощается
+    bool keepDocumentOrder = mode == RunMode::optimize || mode == RunMode::goalSeek || mode == RunMode::worstCase;
+    CircuitFile circuit = loadCircuitFile(inputPath, outputPath, options, keepDocumentOrder);
+
+    std::string output;
+    switch (mode) {
+    case RunMode::sweep:
+        output = runSweep(circuit, analysisOptions.frequencies);
+        break;
+    case RunMode::harmonics:
+        output = runHarmonics(circuit);
+        break;
+    case RunMode::resonances:
+        output = runResonances(circuit, analysisOptions.resonanceFrom, analysisOptions.resonanceTo);
+        break;
+    case RunMode::faults:
+        output = runFaults(circuit, options);
+        break;
+    case RunMode::optimize:
+        output = runOptimize(circuit, options, analysisOptions.optimizeSeconds);
+        break;
+    case RunMode::goalSeek:
+        output = runGoalSeek(circuit, analysisOptions.goalSeekUnknown);
+        break;
+    default:
+        output = runWorstCase(circuit, analysisOptions.worstCaseTerms);
+        break;
+    }
+    writeTextToFile(circuit.outputPath, output);
+    return 0;
+}
+
+/*!
+*\brief Главная функция программы
+*\param[in] argv - пути к файлам с входными и выходными данными и необязательные параметры
+*\return 0 - запуск программы прошел успешно
+*/
+int main(int argc, char *argv[])
+{
+    // Устанавливаем кодировку для русских символов
+    setlocale(LC_ALL, "Russian");
+
+    // Разделяем параметры и пути к файлам
+    std::vector<std::string> paths;
+    BatchOptions batchOptions;
+    std::string tracePath;
+    unsigned long traceDepth = 3;
+    bool showAllocationStats = false;
+    bool showPerfCounters = false;
+    std::string metricsSocketPath;
+    std::string metricsFilePath;
+    RunMode mode = RunMode::single;
+    AnalysisOptions analysisOptions;
+    try {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg(argv[i]);
+            unsigned long value;
+            if (arg.rfind("--parser=", 0) == 0)
+                batchOptions.parserName = arg.substr(9);
+            else if (arg == "--batch")
+                setRunMode(mode, RunMode::batch, arg);
+            else if (readUnsignedOption(arg, "--threads=", value))
+            {
+                if (value > std::numeric_limits<unsigned>::max())
+                    throw std::invalid_argument(arg);
+                batchOptions.computeThreads = static_cast<unsigned>(value);
+            }
+            else if (readUnsignedOption(arg, "--queue=", value))
+                batchOptions.queueCapacity = value;
+            else if (arg.rfind("--io=", 0) == 0)
+                batchOptions.ioBackend = arg.substr(5);
+            else if (readUnsignedOption(arg, "--io-batch=", value))
+                batchOptions.ioBatchSize = value;
+            else if (arg == "--huge-pages")
+                batchOptions.useHugePages = true;
+            else if (arg == "--normalize")
+                batchOptions.normalizeTree = true;
+            else if (arg == "--no-plan-cache")
+                batchOptions.usePlanCache = false;
+            else if (arg == "--precision=double")
+                batchOptions.precision = VariantEvaluator::Precision::full;
+            else if (arg == "--precision=float")
+                batchOptions.precision = VariantEvaluator::Precision::single;
+            else if (arg.rfind("--float-tolerance=", 0) == 0)
+            {
+                batchOptions.floatTolerance = std::stod(arg.substr(18));
+                if (!(batchOptions.floatTolerance > 0))
+                    throw std::invalid_argument(arg);
+            }
+            else if (arg.rfind("--trace=", 0) == 0)
+                tracePath = arg.substr(8);
+            else if (readUnsignedOption(arg, "--trace-depth=", value))
+                traceDepth = value;
+            else if (arg == "--alloc-stats")
+                showAllocationStats = true;
+            else if (arg.rfind("--metrics-socket=", 0) == 0)
+                metricsSocketPath = arg.substr(17);
+            else if (arg.rfind("--metrics-file=", 0) == 0)
+                metricsFilePath = arg.substr(15);
+            else if (arg == "--perf-counters")
+                showPerfCounters = true;
+            else if (readSweepOption(arg, analysisOptions.frequencies))
+                setRunMode(mode, RunMode::sweep, arg);
+            else if (arg == "--harmonics")
+                setRunMode(mode, RunMode::harmonics, arg);
+            else if (readResonanceOption(arg, analysisOptions.resonanceFrom, analysisOptions.resonanceTo))
+                setRunMode(mode, RunMode::resonances, arg);
+            else if (arg == "--faults")
+                setRunMode(mode, RunMode::faults, arg);
+            else if (arg.rfind("--optimize=", 0) == 0)
+            {
+                analysisOptions.optimizeSeconds = std::stod(arg.substr(11));
+                if (!(analysisOptions.optimizeSeconds > 0))
+                    throw std::invalid_argument(arg);
+                setRunMode(mode, RunMode::optimize, arg);
+            }
+            else if (arg.rfind("--goal-seek=", 0) == 0)
+            {
+                analysisOptions.goalSeekUnknown = arg.substr(12);
+                if (analysisOptions.goalSeekUnknown.empty())
+                    throw std::invalid_argument(arg);
+                setRunMode(mode, RunMode::goalSeek, arg);
+            }
+            else if (arg == "--worst-case")
+                setRunMode(mode, RunMode::worstCase, arg);
+            else if (readUnsignedOption(arg, "--worst-case=", value))
+            {
+                if (value < 1 || value > static_cast<unsigned long>(WorstCaseAnalysis::maxTermCount))
+                    throw std::invalid_argument(arg);
+                analysisOptions.worstCaseTerms = static_cast<int>(value);
+                setRunMode(mode, RunMode::worstCase, arg);
+            }
+            else
+                paths.push_back(arg);
+        }
+    } catch (std::exception const &) {
+        std::cerr << "Неверное значение параметра." << std::endl;
+        return 1;
+    } catch (std::string const & str) {
+        std::cerr << str << std::endl;
+        return 1;
+    }
+
+    // Проверяем кол-во аргументов, завершаем программу, если их недостаточно
+    if (paths.size() != 2)
+    {
+        std::cerr << "Неверное количество аргументов." << std::endl;
+        return 1;
+    }
+
+    // Запись этапов включается до расчета и выгружается после него, в том числе при ошибке
+    if (!tracePath.empty())
+    {
+        if (!Trace::isCompiledIn())
+            std::cerr << "Трассировка недоступна: программа собрана без CONFIG += trace." << std::endl;
+        Trace::start(static_cast<int>(traceDepth));
+        Trace::setThreadName("main");
+    }
+
+    if (showAllocationStats)
+    {
+        if (!AllocationStats::isCompiledIn())
+            std::cerr << "Учет выделений памяти недоступен: программа собрана без CONFIG += alloc_stats." << std::endl;
+        AllocationStats::reset();
+    }
+
+    if (showPerfCounters)
+    {
+        if (!PerfCounters::isCompiledIn())
+            std::cerr << "Счетчики производительности недоступны: программа собрана без CONFIG += perf_counters." << std::endl;
+        PerfCounters::start();
+    }
+
+    // Выгрузка метрик работает в отдельных потоках до завершения расчета
+    MetricsExporter metricsExporter;
+    try {
+        if (!metricsFilePath.empty())
+            metricsExporter.dumpOnSignal(metricsFilePath);
+        if (!metricsSocketPath.empty())
+            metricsExporter.serveSocket(metricsSocketPath);
+    } catch (std::string const & str) {
+        std::cerr << str << std::endl;
+        return 1;
+    }
+
+    // Обработка ошибок
+    int exitCode;
+    try {
+        if (mode == RunMode::batch)
+            exitCode = runBatch(paths[0], paths[1], batchOptions);
+        else if (mode == RunMode::single)
+            exitCode = runSingle(paths[0], paths[1], batchOptions);
+        else
+            exitCode = runAnalysis(mode, paths[0], paths[1], batchOptions, analysisOptions);
+    } catch (std::string const & str) {
+        // В случае ошибки, вывести её в консоль и завершить выполнение программы
+        std::cerr << str << std::endl;
+        exitCode = 1;
+    } catch (std::exception const & error) {
+        std::cerr << "Ошибка расчета: " << error.what() << std::endl;
+        exitCode = 1;
+    }
+
+    metricsExporter.stop();
+
+    if (showAllocationStats && AllocationStats::isCompiledIn())
+        std::cout << AllocationStats::report();
+
+    if (showPerfCounters && PerfCounters::isCompiledIn())
+    {
+        PerfCounters::stop();
+        std::cout << PerfCounters::report();
+    }
+
+    if (!tracePath.empty())
+    {
+        Trace::stop();
+        try {
+            Trace::writeChromeTrace(tracePath);
+        } catch (std::string const & str) {
+            std::cerr << str << std::endl;
+            exitCode = 1;
+        }
+    }
+
+    return exitCode;
+}
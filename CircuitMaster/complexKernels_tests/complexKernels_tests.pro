@@ -0,0 +1,11 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+include(../circuitMaster_core/circuitMaster_core.pri)
+
+SOURCES +=  tst_complexkernels_tests.cpp
@@ -0,0 +1,329 @@
+#include <QtTest>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../circuitMaster_core/complexKernels.h"
+
+/*!
+*\file
+*\brief Тесты точности действий над массивами комплексных чисел по сравнению с std::complex
+*/
+
+class complexKernels_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void forLevel_notAboveSupported();
+
+    void add_matchesStdComplex();
+    void multiply_matchesStdComplex();
+    void divide_matchesStdComplex();
+    void reciprocal_matchesStdComplex();
+    void addReciprocal_matchesStdComplex();
+
+    void sum_pairwiseAccuracy();
+    void sumReciprocals_matchesStdComplex();
+    void sumReciprocals_extremeValues();
+
+    void floatKernels_matchStdComplex();
+    void floatKernels_boundedSums();
+};
+
+/*! Допустимая погрешность относительно модуля точного значения (несколько единиц младшего разряда) */
+static const double relativeEpsilon = 1e-14;
+
+/*!
+*\class Samples
+*\brief Случайные комплексные числа с модулями от 1e-50 до 1e50 в двух представлениях
+*/
+class Samples
+{
+    public:
+    std::vector<double> re; /*!< Действительные части */
+    std::vector<double> im; /*!< Мнимые части */
+
+    /*!
+    * \brief Сгенерировать числа
+    * \param[in] count - количество чисел
+    * \param[in] seed - начальное значение генератора
+    */
+    Samples(size_t count, unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> mantissa(-1, 1);
+        std::uniform_int_distribution<int> exponent(-50, 50);
+        for (size_t i = 0; i < count; i++)
+        {
+            double scale = std::pow(10.0, exponent(generator));
+            this->re.push_back(mantissa(generator) * scale);
+            this->im.push_back(mantissa(generator) * scale);
+        }
+    }
+
+    /*!
+    * \brief Получить число
+    * \param[in] i - номер числа
+    * \return - комплексное число
+    */
+    std::complex<double> at(size_t i) const
+    {
+        return std::complex<double>(this->re[i], this->im[i]);
+    }
+};
+
+/*!
+* \brief Получить наборы векторных команд, поддерживаемые процессором
+* \return - наборы векторных команд, начиная со скалярного
+*/
+static std::vector<ComplexKernels::SimdLevel> supportedLevels()
+{
+    std::vector<ComplexKernels::SimdLevel> levels;
+    ComplexKernels::SimdLevel all[] = { ComplexKernels::SimdLevel::scalar, ComplexKernels::SimdLevel::sse2,
+                                        ComplexKernels::SimdLevel::avx2, ComplexKernels::SimdLevel::avx512 };
+    for (ComplexKernels::SimdLevel level : all)
+    {
+        if (ComplexKernels::resolve(level) == level)
+            levels.push_back(level);
+    }
+    return levels;
+}
+
+/*!
+* \brief Проверить, что значение совпадает с точным с относительной погрешностью relativeEpsilon
+* \param[in] expected - точное значение
+* \param[in] actual - проверяемое значение
+* \param[in] level - набор векторных команд, для сообщения об ошибке
+* \return - true, если значения совпадают
+*/
+static bool isClose(std::complex<double> expected, std::complex<double> actual, ComplexKernels::SimdLevel level)
+{
+    if (std::abs(actual - expected) <= relativeEpsilon * std::abs(expected))
+        return true;
+    qWarning("%s: ожидалось %.17g%+.17gi, получено %.17g%+.17gi", ComplexKernels::levelName(level).c_str(),
+             expected.real(), expected.imag(), actual.real(), actual.imag());
+    return false;
+}
+
+// Количества чисел проверяют как основной цикл, так и досчет остатка каждой версией
+static const size_t counts[] = { 0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 33, 1000 };
+
+void complexKernels_tests::forLevel_notAboveSupported()
+{
+    ComplexKernels::SimdLevel supported = ComplexKernels::detectSimdLevel();
+    QCOMPARE(ComplexKernels::forLevel().level, supported);
+    QCOMPARE(ComplexKernels::forLevel(ComplexKernels::SimdLevel::scalar).level, ComplexKernels::SimdLevel::scalar);
+    QVERIFY(static_cast<int>(ComplexKernels::forLevel(ComplexKernels::SimdLevel::avx512).level) <= static_cast<int>(supported));
+    QCOMPARE(ComplexKernels::levelName(ComplexKernels::SimdLevel::sse2), std::string("sse2"));
+}
+
+void complexKernels_tests::add_matchesStdComplex()
+{
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        for (size_t count : counts)
+        {
+            Samples a(count, 1), b(count, 2);
+            ComplexKernels::forLevel(level).add(a.re.data(), a.im.data(), b.re.data(), b.im.data(), count);
+            Samples original(count, 1);
+            for (size_t i = 0; i < count; i++)
+                QVERIFY(isClose(original.at(i) + b.at(i), a.at(i), level));
+        }
+    }
+}
+
+void complexKernels_tests::multiply_matchesStdComplex()
+{
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        for (size_t count : counts)
+        {
+            Samples a(count, 3), b(count, 4), out(count, 5);
+            ComplexKernels::forLevel(level).multiply(out.re.data(), out.im.data(), a.re.data(), a.im.data(), b.re.data(), b.im.data(), count);
+            for (size_t i = 0; i < count; i++)
+                QVERIFY(isClose(a.at(i) * b.at(i), out.at(i), level));
+        }
+    }
+}
+
+void complexKernels_tests::divide_matchesStdComplex()
+{
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        for (size_t count : counts)
+        {
+            Samples a(count, 6), b(count, 7), out(count, 8);
+            ComplexKernels::forLevel(level).divide(out.re.data(), out.im.data(), a.re.data(), a.im.data(), b.re.data(), b.im.data(), count);
+            for (size_t i = 0; i < count; i++)
+                QVERIFY(isClose(a.at(i) / b.at(i), out.at(i), level));
+        }
+    }
+}
+
+void complexKernels_tests::reciprocal_matchesStdComplex()
+{
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        for (size_t count : counts)
+        {
+            Samples z(count, 9), original(count, 9);
+            ComplexKernels::forLevel(level).reciprocal(z.re.data(), z.im.data(), count);
+            for (size_t i = 0; i < count; i++)
+                QVERIFY(isClose(1.0 / original.at(i), z.at(i), level));
+        }
+    }
+}
+
+void complexKernels_tests::addReciprocal_matchesStdComplex()
+{
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        for (size_t count : counts)
+        {
+            // Слагаемые одного порядка, чтобы погрешность сложения не превышала погрешность деления
+            Samples z(count, 10);
+            std::vector<double> dstRe(count), dstIm(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                std::complex<double> start = 1.0 / z.at(i) * std::complex<double>(0.5, 0.25);
+                dstRe[i] = start.real();
+                dstIm[i] = start.imag();
+            }
+
+            ComplexKernels::forLevel(level).addReciprocal(dstRe.data(), dstIm.data(), z.re.data(), z.im.data(), count);
+            for (size_t i = 0; i < count; i++)
+            {
+                std::complex<double> expected = 1.0 / z.at(i) * std::complex<double>(0.5, 0.25) + 1.0 / z.at(i);
+                QVERIFY(isClose(expected, std::complex<double>(dstRe[i], dstIm[i]), level));
+            }
+        }
+    }
+}
+
+void complexKernels_tests::sum_pairwiseAccuracy()
+{
+    // Сумма миллиона одинаковых чисел: при последовательном сложении погрешность растет линейно
+    const size_t count = 1000000;
+    std::vector<double> re(count, 0.1), im(count, -0.3);
+    std::complex<double> expected(static_cast<double>(count * static_cast<long double>(0.1)),
+                                 static_cast<double>(count * static_cast<long double>(-0.3)));
+
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+        QVERIFY(isClose(expected, ComplexKernels::sum(re.data(), im.data(), count, level), level));
+}
+
+void complexKernels_tests::sumReciprocals_matchesStdComplex()
+{
+    // Сопротивления одного порядка, как у ветвей шины
+    const size_t count = 100000;
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> value(0.5, 20);
+    std::vector<double> re(count), im(count);
+    long double expectedRe = 0, expectedIm = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        re[i] = value(generator);
+        im[i] = value(generator) - 10;
+        std::complex<double> reciprocal = 1.0 / std::complex<double>(re[i], im[i]);
+        expectedRe += reciprocal.real();
+        expectedIm += reciprocal.imag();
+    }
+    std::complex<double> expected(static_cast<double>(expectedRe), static_cast<double>(expectedIm));
+
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        QVERIFY(isClose(expected, ComplexKernels::sumReciprocals(re.data(), im.data(), count, level), level));
+        for (size_t small : counts)
+        {
+            std::complex<double> smallExpected = 0;
+            for (size_t i = 0; i < small; i++)
+                smallExpected += 1.0 / std::complex<double>(re[i], im[i]);
+            QVERIFY(isClose(smallExpected, ComplexKernels::sumReciprocals(re.data(), im.data(), small, level), level));
+        }
+    }
+}
+
+void complexKernels_tests::sumReciprocals_extremeValues()
+{
+    // Квадраты модулей не помещаются в double, сумма пересчитывается делением std::complex
+    double scales[] = { 1e200, 1e-200 };
+    for (double scale : scales)
+    {
+        std::vector<double> re(100, 3 * scale), im(100, -4 * scale);
+        std::complex<double> expected = 100.0 / std::complex<double>(3 * scale, -4 * scale);
+        for (ComplexKernels::SimdLevel level : supportedLevels())
+            QVERIFY(isClose(expected, ComplexKernels::sumReciprocals(re.data(), im.data(), re.size(), level), level));
+    }
+}
+
+void complexKernels_tests::floatKernels_matchStdComplex()
+{
+    // Числа с модулями от 1e-10 до 1e10, чтобы квадраты модулей помещались в float
+    const float floatEpsilon = 1e-6f;
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        FloatComplexKernels const & kernels = FloatComplexKernels::forLevel(level);
+        QCOMPARE(kernels.level, level);
+        for (size_t count : counts)
+        {
+            std::mt19937 generator(12);
+            std::uniform_real_distribution<float> mantissa(-1, 1);
+            std::uniform_int_distribution<int> exponent(-10, 10);
+            std::vector<float> aRe(count), aIm(count), bRe(count), bIm(count), product(2 * count), quotient(2 * count);
+            for (size_t i = 0; i < count; i++)
+            {
+                float aScale = std::pow(10.0f, static_cast<float>(exponent(generator)));
+                float bScale = std::pow(10.0f, static_cast<float>(exponent(generator)));
+                aRe[i] = mantissa(generator) * aScale;
+                aIm[i] = mantissa(generator) * aScale;
+                bRe[i] = mantissa(generator) * bScale;
+                bIm[i] = mantissa(generator) * bScale;
+            }
+            kernels.multiply(product.data(), product.data() + count, aRe.data(), aIm.data(), bRe.data(), bIm.data(), count);
+            kernels.divide(quotient.data(), quotient.data() + count, aRe.data(), aIm.data(), bRe.data(), bIm.data(), count);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                std::complex<double> x(aRe[i], aIm[i]), y(bRe[i], bIm[i]);
+                QVERIFY(std::abs(std::complex<double>(product[i], product[count + i]) - x * y) <= floatEpsilon * std::abs(x * y));
+                QVERIFY(std::abs(std::complex<double>(quotient[i], quotient[count + i]) - x / y) <= floatEpsilon * std::abs(x / y));
+            }
+        }
+    }
+}
+
+void complexKernels_tests::floatKernels_boundedSums()
+{
+    // Оценка суммы - сумма модулей слагаемых (сумм модулей частей), умноженных на их оценки
+    const size_t count = 37;
+    std::vector<float> re(count), im(count), termBound(count, 2);
+    for (size_t i = 0; i < count; i++)
+    {
+        re[i] = 3.0f + i;
+        im[i] = -4.0f;
+    }
+
+    for (ComplexKernels::SimdLevel level : supportedLevels())
+    {
+        FloatComplexKernels const & kernels = FloatComplexKernels::forLevel(level);
+        std::vector<float> sumRe(count, 0), sumIm(count, 0), bound(count, 0);
+        kernels.addBounded(sumRe.data(), sumIm.data(), bound.data(), re.data(), im.data(), termBound.data(), 1, count);
+        kernels.addReciprocalBounded(sumRe.data(), sumIm.data(), bound.data(), re.data(), im.data(), termBound.data(), 1, count);
+        kernels.relativeBound(bound.data(), sumRe.data(), sumIm.data(), 2, 5, count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            std::complex<double> z(re[i], im[i]);
+            std::complex<double> sum = z + 1.0 / z;
+            double magnitude = std::abs(z.real()) + std::abs(z.imag());
+            double reciprocalMagnitude = std::abs((1.0 / z).real()) + std::abs((1.0 / z).imag());
+            double expectedBound = 2 * (magnitude * 3 + reciprocalMagnitude * 3) / (std::abs(sum.real()) + std::abs(sum.imag())) + 5;
+            QVERIFY(std::abs(std::complex<double>(sumRe[i], sumIm[i]) - sum) <= 1e-6 * std::abs(sum));
+            QVERIFY(std::abs(bound[i] - expectedBound) <= 1e-5 * expectedBound);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(complexKernels_tests)
+
+#include "tst_complexkernels_tests.moc"
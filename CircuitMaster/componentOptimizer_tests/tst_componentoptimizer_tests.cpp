@@ -0,0 +1,237 @@
+#include <QtTest>
+#include <cmath>
+#include <limits>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/componentOptimizer.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+
+/*!
+*\file
+*\brief Тесты для подбора номиналов элементов из стандартных рядов
+*/
+
+class componentOptimizer_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void seriesValues_ranges();
+    void seriesValues_errors();
+
+    void optimize_matchesExhaustiveSearch();
+    void optimize_reachesExactTargets();
+    void optimize_severalThreads();
+    void optimize_errors();
+
+    void optimizationFromDocument_values();
+    void optimizationFromDocument_errors();
+
+    void formatOutput_sections();
+};
+
+/*!
+* \brief Текст цепи с подбираемыми резистором и конденсатором
+* \return - текст документа
+*/
+static std::string optimizationCircuitText()
+{
+    return "<seq voltage=\"230\" frequency=\"50\">"
+           "<par name=\"p\">"
+           "<seq name=\"a\" target=\"1.2\"><elem series=\"E24\"><type>R</type><res>100</res></elem><elem><type>L</type><ind>0.1</ind></elem></seq>"
+           "<seq name=\"b\"><elem series=\"E12\" min=\"1e-6\" max=\"1e-3\"><type>C</type><cap>0.0001</cap></elem></seq>"
+           "</par>"
+           "<seq name=\"d\" target=\"3\"><elem><type>R</type><res>20</res></elem></seq>"
+           "</seq>";
+}
+
+/*!
+* \brief Подобрать номиналы цепи, указанные в тексте документа
+*/
+class OptimizationProblem
+{
+    public:
+    CircuitTopology topology; /*!< Топология цепи */
+    std::vector<OptimizationVariable> variables; /*!< Подбираемые элементы */
+    std::vector<CurrentTarget> targets; /*!< Требуемые силы тока */
+
+    explicit OptimizationProblem(std::string const & text)
+    {
+        DocumentNode rootElement;
+        this->topology = topologyFromText(text, rootElement);
+        optimizationFromDocument(rootElement, this->topology, this->variables, this->targets);
+    }
+
+    /*!
+    * \brief Рассчитать отклонение сил тока для набора значений по всей цепи
+    * \param[in] values - значения элементов
+    * \return - сумма квадратов относительных отклонений
+    */
+    double objective(std::vector<double> const & values) const
+    {
+        std::vector<std::pair<int, std::complex<double>>> resistances;
+        for (size_t v = 0; v < this->variables.size(); v++)
+            resistances.push_back({ this->variables[v].element, this->variables[v].resistance(this->topology, values[v]) });
+        CircuitState state = evaluateWithResistances(this->topology, resistances);
+
+        double sum = 0;
+        for (auto iter = this->targets.cbegin(); iter != this->targets.cend(); iter++)
+        {
+            double deviation = (std::abs(state.currents[iter->node]) - iter->current) / iter->current;
+            sum += deviation * deviation;
+        }
+        return sum;
+    }
+};
+
+void componentOptimizer_tests::seriesValues_ranges()
+{
+    std::vector<double> values = ComponentOptimizer::seriesValues("E12", 10, 100);
+    QCOMPARE(values.size(), size_t(13));
+    QCOMPARE(values.front(), 10.0);
+    QCOMPARE(values[8], 47.0);
+    QCOMPARE(values.back(), 100.0);
+
+    QCOMPARE(ComponentOptimizer::seriesValues("E3", 0.002, 0.05), std::vector<double>({ 0.0022, 0.0047, 0.01, 0.022, 0.047 }));
+    QCOMPARE(ComponentOptimizer::seriesValues("E24", 3.5, 4), std::vector<double>({ 3.6, 3.9 }));
+    QVERIFY(ComponentOptimizer::seriesValues("E6", 7, 9).empty());
+}
+
+void componentOptimizer_tests::seriesValues_errors()
+{
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::seriesValues("E48", 1, 10), std::string);
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::seriesValues("E12", 0, 10), std::string);
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::seriesValues("E12", 10, 1), std::string);
+}
+
+void componentOptimizer_tests::optimize_matchesExhaustiveSearch()
+{
+    OptimizationProblem problem(optimizationCircuitText());
+    QCOMPARE(problem.variables.size(), size_t(2));
+
+    // Полный перебор всех наборов
+    double bestObjective = std::numeric_limits<double>::infinity();
+    for (double first : problem.variables[0].values)
+    {
+        for (double second : problem.variables[1].values)
+            bestObjective = std::min(bestObjective, problem.objective({ first, second }));
+    }
+
+    OptimizationOptions options;
+    options.seconds = 60;
+    options.threadCount = 1;
+    options.maxSearches = 30;
+    OptimizationResult result = ComponentOptimizer::optimize(problem.topology, problem.variables, problem.targets, options);
+
+    QCOMPARE(result.searchCount, size_t(30));
+    QVERIFY(std::abs(result.objective - bestObjective) <= 1e-12 * bestObjective);
+    QVERIFY(std::abs(problem.objective(result.values) - bestObjective) <= 1e-12 * bestObjective);
+}
+
+void componentOptimizer_tests::optimize_reachesExactTargets()
+{
+    // Требуемые силы тока получены из набора значений ряда: R1 = 47, R2 = 150
+    double total = 100 / (47 + 1 / (1.0 / 150 + 1.0 / 100));
+    OptimizationProblem problem(formatStr(
+        "<seq voltage=\"100\">"
+        "<seq name=\"r1\" target=\"%1\"><elem series=\"E24\"><type>R</type><res>30</res></elem></seq>"
+        "<par><seq name=\"r2\" target=\"%2\"><elem series=\"E24\"><type>R</type><res>300</res></elem></seq>"
+        "<seq name=\"r3\"><elem><type>R</type><res>100</res></elem></seq></par>"
+        "</seq>", { numberToStr(total), numberToStr(total * 100 / 250) }));
+
+    OptimizationOptions options;
+    options.seconds = 60;
+    options.threadCount = 1;
+    options.maxSearches = 200;
+    OptimizationResult result = ComponentOptimizer::optimize(problem.topology, problem.variables, problem.targets, options);
+
+    QCOMPARE(result.values, std::vector<double>({ 47, 150 }));
+    QVERIFY(result.objective < 1e-10);
+}
+
+void componentOptimizer_tests::optimize_severalThreads()
+{
+    OptimizationProblem problem(optimizationCircuitText());
+    OptimizationOptions options;
+    options.seconds = 60;
+    options.threadCount = 4;
+    options.maxSearches = 40;
+    OptimizationResult result = ComponentOptimizer::optimize(problem.topology, problem.variables, problem.targets, options);
+
+    // Первый поток начинает с ближайших к входным данным значений, поэтому результат не хуже них
+    QCOMPARE(result.searchCount, size_t(40));
+    QVERIFY(result.objective <= problem.objective({ 100, 0.0001 }));
+
+    CircuitTopology changed = problem.topology;
+    for (size_t v = 0; v < problem.variables.size(); v++)
+        changed.elementResistances[problem.variables[v].element] = problem.variables[v].resistance(problem.topology, result.values[v]);
+    CircuitState state;
+    state.evaluate(changed);
+    for (size_t t = 0; t < problem.targets.size(); t++)
+        CORE_COMPARE_COMPLEX(state.currents[problem.targets[t].node], result.currents[t], 1e-12);
+}
+
+void componentOptimizer_tests::optimize_errors()
+{
+    OptimizationProblem problem(optimizationCircuitText());
+    OptimizationOptions options;
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::optimize(problem.topology, {}, problem.targets, options), std::string);
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::optimize(problem.topology, problem.variables, {}, options), std::string);
+
+    problem.variables[0].values.clear();
+    QVERIFY_EXCEPTION_THROWN(ComponentOptimizer::optimize(problem.topology, problem.variables, problem.targets, options), std::string);
+}
+
+void componentOptimizer_tests::optimizationFromDocument_values()
+{
+    OptimizationProblem problem(optimizationCircuitText());
+
+    QCOMPARE(problem.variables[0].element, size_t(0));
+    QCOMPARE(problem.variables[0].node, problem.topology.findNode("a"));
+    QCOMPARE(problem.variables[0].position, 1);
+    QCOMPARE(problem.variables[0].nominal, 100.0);
+    QCOMPARE(problem.variables[0].values, ComponentOptimizer::seriesValues("E24", 10, 1000));
+
+    QCOMPARE(problem.variables[1].element, size_t(2));
+    QCOMPARE(problem.variables[1].node, problem.topology.findNode("b"));
+    QCOMPARE(problem.variables[1].values, ComponentOptimizer::seriesValues("E12", 1e-6, 1e-3));
+
+    // Сопротивление конденсатора обратно пропорционально емкости
+    CORE_COMPARE_COMPLEX(problem.topology.elementResistances[2] / 2.0, problem.variables[1].resistance(problem.topology, 0.0002), 1e-15);
+    CORE_COMPARE_COMPLEX(problem.topology.elementResistances[0] * 2.0, problem.variables[0].resistance(problem.topology, 200), 1e-15);
+
+    QCOMPARE(problem.targets.size(), size_t(2));
+    QCOMPARE(problem.targets[0].node, problem.topology.findNode("a"));
+    QCOMPARE(problem.targets[0].current, 1.2);
+    QCOMPARE(problem.targets[1].node, problem.topology.findNode("d"));
+}
+
+void componentOptimizer_tests::optimizationFromDocument_errors()
+{
+    char const * wrongCircuits[] = {
+        "<seq voltage=\"10\"><seq target=\"1\"><elem series=\"E12\"><type>R</type><res>5</res></elem></seq></seq>",
+        "<seq voltage=\"10\"><seq name=\"a\" target=\"-1\"><elem series=\"E12\"><type>R</type><res>5</res></elem></seq></seq>",
+        "<seq voltage=\"10\"><seq name=\"a\" target=\"1\"><elem series=\"E12\" min=\"x\"><type>R</type><res>5</res></elem></seq></seq>",
+        "<seq voltage=\"10\"><seq name=\"a\" target=\"1\"><elem series=\"E7\"><type>R</type><res>5</res></elem></seq></seq>"
+    };
+    for (char const * text : wrongCircuits)
+        QVERIFY_EXCEPTION_THROWN(OptimizationProblem problem(text), std::string);
+}
+
+void componentOptimizer_tests::formatOutput_sections()
+{
+    OptimizationProblem problem("<seq voltage=\"10\"><seq name=\"r\" target=\"2\"><elem series=\"E24\"><type>R</type><res>4</res></elem></seq></seq>");
+    OptimizationOptions options;
+    options.threadCount = 1;
+    options.maxSearches = 1;
+    OptimizationResult result = ComponentOptimizer::optimize(problem.topology, problem.variables, problem.targets, options);
+
+    QCOMPARE(formatOutput(problem.topology, problem.variables, problem.targets, result),
+             std::string("objective = 0.000384468\nr:1 = 5.1\n\ncurrents\nr = 1.96078\n"));
+}
+
+QTEST_APPLESS_MAIN(componentOptimizer_tests)
+
+#include "tst_componentoptimizer_tests.moc"
@@ -0,0 +1,409 @@
+#include <QtTest>
+#include "../circuitMaster_core/circuitArena.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreConnection.h"
+#include "../circuitMaster_core/coreElement.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/liteXmlParser.h"
+
+/*!
+*\file
+*\brief Тесты для ядра программы без Qt: разбор xml, построение дерева и расчет
+*/
+
+class coreCircuit_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parse_attributesAndText();
+    void parse_commentsAndEntities();
+    void parse_lineNumbers();
+    void parse_mismatchedTag();
+    void parse_unquotedAttribute();
+
+    void build_simpleSeq();
+    void build_complexSeq();
+    void build_unnamedConnection();
+    void build_elementsInParConnection();
+    void build_duplicateName();
+    void build_inductivityWithoutFrequency();
+
+    void calculate_seqAndPar();
+    void calculate_frequencyElements();
+    void calculate_inArena();
+    void calculate_unnamedConnectionInError();
+    void calculate_wideParallel();
+    void calculate_wideParallelZeroAdmittance();
+    void calculate_wideSequential();
+
+    void normalize_flattensSameKindNesting();
+    void normalize_absorbsSingleChild();
+
+    void output_sortedNamedCurrents();
+};
+
+void coreCircuit_tests::parse_attributesAndText()
+{
+    DocumentNode root = LiteXmlParser().parseText("<?xml version=\"1.0\"?><seq voltage='20' name=\"a\"><type>R</type></seq>");
+
+    QCOMPARE(root.tagName, std::string("seq"));
+    QCOMPARE(root.attribute("voltage"), std::string("20"));
+    QCOMPARE(root.attribute("name"), std::string("a"));
+    QCOMPARE(root.attribute("frequency", "-1"), std::string("-1"));
+    QCOMPARE(root.children.size(), size_t(1));
+    QCOMPARE(root.firstChildElement("type")->textContent(), std::string("R"));
+}
+
+void coreCircuit_tests::parse_commentsAndEntities()
+{
+    DocumentNode root = LiteXmlParser().parseText("<seq name=\"a&amp;b\">\n  <!-- комментарий -->\n  <res><![CDATA[1]]>&#48;</res>\n</seq>");
+
+    QCOMPARE(root.attribute("name"), std::string("a&b"));
+    QCOMPARE(root.children.size(), size_t(1));
+    QCOMPARE(root.children[0].textContent(), std::string("10"));
+}
+
+void coreCircuit_tests::parse_lineNumbers()
+{
+    DocumentNode root = LiteXmlParser().parseText("<?xml version=\"1.0\"?>\n<seq>\n\t<elem>\n\t\t<type>R</type>\n\t</elem>\n</seq>");
+
+    QCOMPARE(root.lineNumber, 2);
+    QCOMPARE(root.children[0].lineNumber, 3);
+    QCOMPARE(root.children[0].children[0].lineNumber, 4);
+}
+
+void coreCircuit_tests::parse_mismatchedTag()
+{
+    try {
+        LiteXmlParser().parseText("<seq><elem></seq></elem>");
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void coreCircuit_tests::parse_unquotedAttribute()
+{
+    try {
+        LiteXmlParser().parseText("<seq voltage=20></seq>");
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void coreCircuit_tests::build_simpleSeq()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"20\" name=\"seq1\">"
+        "<elem><type>R</type><res>1</res></elem>"
+        "<elem><type>L</type><res>2</res></elem>"
+        "<elem><type>C</type><res>3</res></elem>"
+        "</seq>", circuitMap);
+
+    QCOMPARE(root->getName(), std::string("seq1"));
+    QCOMPARE(root->getType(), CoreConnection::ConnectionType::sequential);
+    QCOMPARE(root->getElements().size(), size_t(3));
+    CORE_COMPARE_COMPLEX(std::complex<double>(20, 0), root->getVoltage(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(1, 0), root->getElements()[0].getElemResistance(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(0, 2), root->getElements()[1].getElemResistance(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(0, -3), root->getElements()[2].getElemResistance(), 0.001);
+}
+
+void coreCircuit_tests::build_complexSeq()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"20\" name=\"root\">"
+        "<par name=\"par1\">"
+        "<seq name=\"seq1\"><elem><type>R</type><res>1</res></elem></seq>"
+        "<seq name=\"seq2\"><elem><type>R</type><res>2</res></elem></seq>"
+        "</par>"
+        "<seq name=\"seq3\"><elem><type>R</type><res>3</res></elem></seq>"
+        "</seq>", circuitMap);
+
+    QCOMPARE(circuitMap.size(), size_t(5));
+    QCOMPARE(root->getType(), CoreConnection::ConnectionType::sequentialComplex);
+    QCOMPARE(root->getChildren().size(), size_t(2));
+    QCOMPARE(root->getChildren()[0]->getType(), CoreConnection::ConnectionType::parallel);
+    QCOMPARE(root->getChildren()[0]->getChildren().size(), size_t(2));
+    QCOMPARE(root->getChildren()[1]->getName(), std::string("seq3"));
+}
+
+void coreCircuit_tests::build_unnamedConnection()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<par voltage=\"20\">\n"
+        "<seq><elem><type>R</type><res>1</res></elem></seq>\n"
+        "</par>", circuitMap);
+
+    QVERIFY(!root->isNameCustom());
+    QCOMPARE(root->getName(), std::string("par_1 на строке 1"));
+    QCOMPARE(root->getChildren()[0]->getName(), std::string("seq_2 на строке 2"));
+}
+
+void coreCircuit_tests::build_elementsInParConnection()
+{
+    CircuitMap circuitMap;
+    try {
+        coreCircuitFromText("<par voltage=\"20\"><elem><type>R</type><res>1</res></elem></par>", circuitMap);
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void coreCircuit_tests::build_duplicateName()
+{
+    CircuitMap circuitMap;
+    try {
+        coreCircuitFromText(
+            "<par voltage=\"20\">"
+            "<seq name=\"a\"><elem><type>R</type><res>1</res></elem></seq>"
+            "<seq name=\"a\"><elem><type>R</type><res>2</res></elem></seq>"
+            "</par>", circuitMap);
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void coreCircuit_tests::build_inductivityWithoutFrequency()
+{
+    CircuitMap circuitMap;
+    try {
+        coreCircuitFromText("<seq voltage=\"20\"><elem><type>L</type><ind>0.1</ind></elem></seq>", circuitMap);
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string) {
+        QVERIFY(true);
+    }
+}
+
+void coreCircuit_tests::calculate_seqAndPar()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<par voltage=\"50\">"
+        "<seq name=\"I1\"><elem><type>R</type><res>9</res></elem><elem><type>L</type><res>5</res></elem></seq>"
+        "<seq name=\"I2\"><elem><type>C</type><res>4.3</res></elem><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq name=\"I3\"><elem><type>R</type><res>7.6</res></elem><elem><type>C</type><res>3.8</res></elem></seq>"
+        "</par>", circuitMap);
+
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CORE_COMPARE_COMPLEX(std::complex<double>(4.24528, -2.35849), findCoreConnection(circuitMap, "I1")->getCurrent(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(5.74845, 4.94367), findCoreConnection(circuitMap, "I2")->getCurrent(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(5.26316, 2.63158), findCoreConnection(circuitMap, "I3")->getCurrent(), 0.001);
+}
+
+void coreCircuit_tests::calculate_frequencyElements()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"100\" frequency=\"50\">"
+        "<par>"
+        "<seq name=\"I1\"><elem><type>C</type><cap>60e-6</cap></elem><elem><type>R</type><res>12</res></elem></seq>"
+        "<seq name=\"I2\"><elem><type>L</type><ind>6e-3</ind></elem></seq>"
+        "</par>"
+        "<seq name=\"I3\"><elem><type>R</type><res>8</res></elem></seq>"
+        "<par>"
+        "<seq name=\"I4\"><elem><type>C</type><res>8</res></elem></seq>"
+        "<seq name=\"I5\"><elem><type>L</type><ind>8e-3</ind></elem></seq>"
+        "</par>"
+        "</seq>", circuitMap);
+
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CORE_COMPARE_COMPLEX(std::complex<double>(-0.244136, 0.272932), findCoreConnection(circuitMap, "I1")->getCurrent(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(8.37241, -5.86146), findCoreConnection(circuitMap, "I3")->getCurrent(), 0.001);
+    CORE_COMPARE_COMPLEX(std::complex<double>(12.2047, -8.54441), findCoreConnection(circuitMap, "I5")->getCurrent(), 0.001);
+}
+
+void coreCircuit_tests::calculate_inArena()
+{
+    CircuitArena arena(1024);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        CircuitMap circuitMap(arena.resource());
+        CoreConnection* root = coreCircuitFromText(
+            "<par voltage=\"10\">"
+            "<seq name=\"b\"><elem><type>R</type><res>5</res></elem></seq>"
+            "<seq><elem><type>R</type><res>5</res></elem></seq>"
+            "<seq name=\"a\"><elem><type>L</type><res>10</res></elem></seq>"
+            "</par>", circuitMap);
+
+        // Элементы и дети соединений размещаются в той же арене, что и сами соединения
+        QVERIFY(root->getChildren().get_allocator().resource() == arena.resource());
+        QVERIFY(root->getChildren()[0]->getElements().get_allocator().resource() == arena.resource());
+
+        root->calculateResistance();
+        root->calculateCurrentAndVoltage();
+        QCOMPARE(formatOutput(circuitMap), std::string("a = 0 - 1i\nb = 2\n"));
+    }
+
+    // Арена используется повторно после освобождения
+    arena.release();
+    CircuitMap circuitMap(arena.resource());
+    QCOMPARE(coreCircuitFromText("<seq voltage=\"1\"><elem><type>R</type><res>1</res></elem></seq>", circuitMap)->getName(),
+             std::string("seq_1 на строке 1"));
+}
+
+void coreCircuit_tests::calculate_unnamedConnectionInError()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"10\">\n"
+        "<par>\n"
+        "<seq><elem><type>L</type><res>5</res></elem></seq>\n"
+        "<seq><elem><type>C</type><res>5</res></elem></seq>\n"
+        "</par>\n"
+        "</seq>", circuitMap);
+
+    // Имя соединения без указания пользователем формируется только для сообщения об ошибке
+    try {
+        root->calculateResistance();
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string const & str) {
+        QVERIFY(str.find("соединения par_2 на строке 2 ") != std::string::npos);
+    }
+}
+
+/*!
+* \brief Текст параллельного соединения из множества ветвей с разными сопротивлениями
+* \param[in] count - количество ветвей
+* \return - текст документа
+*/
+static std::string wideParallelText(int count)
+{
+    std::string text = "<par voltage=\"10\">";
+    for (int i = 0; i < count; i++)
+    {
+        const char* types[] = { "R", "L", "C" };
+        text += formatStr("<seq><elem><type>%1</type><res>%2</res></elem><elem><type>R</type><res>%3</res></elem></seq>",
+                          { types[i % 3], numberToStr(1 + i % 17), numberToStr(1 + i % 5) });
+    }
+    return text + "</par>";
+}
+
+/*!
+* \brief Рассчитать сопротивление параллельного соединения делением std::complex, как для узких соединений
+* \param[in] root - параллельное соединение с рассчитанными детьми
+* \return - сопротивление
+*/
+static std::complex<double> scalarParallelResistance(CoreConnection const * root)
+{
+    std::complex<double> reverseSum = 0;
+    for (auto iter = root->getChildren().cbegin(); iter != root->getChildren().cend(); iter++)
+        reverseSum += 1.0 / (*iter)->getResistance();
+    return 1.0 / reverseSum;
+}
+
+void coreCircuit_tests::calculate_wideParallel()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(wideParallelText(5000), circuitMap);
+
+    std::complex<double> resistance = root->calculateResistance();
+    CORE_COMPARE_COMPLEX(scalarParallelResistance(root), resistance, 1e-12 * std::abs(resistance));
+}
+
+void coreCircuit_tests::calculate_wideParallelZeroAdmittance()
+{
+    // Проводимости катушек и конденсаторов с равными сопротивлениями взаимно уничтожаются
+    std::string text = "<par voltage=\"10\">";
+    for (int i = 0; i < 100; i++)
+        text += formatStr("<seq><elem><type>%1</type><res>5</res></elem></seq>", { i % 2 == 0 ? "L" : "C" });
+    text += "</par>";
+
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(text, circuitMap);
+    QVERIFY_EXCEPTION_THROWN(root->calculateResistance(), std::string);
+}
+
+void coreCircuit_tests::calculate_wideSequential()
+{
+    std::string text = "<seq voltage=\"10\">";
+    for (int i = 0; i < 3000; i++)
+        text += formatStr("<elem><type>%1</type><res>0.5</res></elem>", { i % 3 == 0 ? "L" : "R" });
+    text += "</seq>";
+
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(text, circuitMap);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CORE_COMPARE_COMPLEX(std::complex<double>(1000, 500), root->getResistance(), 1e-9);
+    CORE_COMPARE_COMPLEX(std::complex<double>(0.008, -0.004), root->getCurrent(), 1e-12);
+}
+
+void coreCircuit_tests::normalize_flattensSameKindNesting()
+{
+    std::string text =
+        "<seq voltage=\"10\">"
+        "<seq><seq name=\"a\"><elem><type>R</type><res>2</res></elem></seq><seq><elem><type>R</type><res>3</res></elem></seq></seq>"
+        "<par><par><seq><elem><type>R</type><res>10</res></elem></seq><seq><elem><type>R</type><res>10</res></elem></seq></par>"
+        "<seq name=\"b\"><elem><type>R</type><res>5</res></elem></seq></par>"
+        "</seq>";
+
+    CircuitMap expectedMap;
+    CoreConnection* expectedRoot = coreCircuitFromText(text, expectedMap);
+    expectedRoot->calculateResistance();
+    expectedRoot->calculateCurrentAndVoltage();
+
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(text, circuitMap);
+    QCOMPARE(root->normalize(circuitMap), size_t(2));
+    QCOMPARE(circuitMap.size(), size_t(7));
+    QCOMPARE(root->getChildren().size(), size_t(3));
+    QCOMPARE(root->getChildren()[2]->getChildren().size(), size_t(3));
+
+    // Именованные соединения остаются, результат расчета не меняется
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+    QCOMPARE(formatOutput(circuitMap), formatOutput(expectedMap));
+}
+
+void coreCircuit_tests::normalize_absorbsSingleChild()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"10\"><par><seq><elem><type>R</type><res>5</res></elem></seq></par></seq>", circuitMap);
+
+    QCOMPARE(root->normalize(circuitMap), size_t(2));
+    QCOMPARE(circuitMap.size(), size_t(1));
+    QCOMPARE(root->getType(), CoreConnection::ConnectionType::sequential);
+    QCOMPARE(root->getElements().size(), size_t(1));
+
+    // Соединение с именем не объединяется с родителем
+    CircuitMap namedMap;
+    root = coreCircuitFromText("<seq voltage=\"10\"><par name=\"a\"><seq><elem><type>R</type><res>5</res></elem></seq></par></seq>", namedMap);
+    QCOMPARE(root->normalize(namedMap), size_t(1));
+    QCOMPARE(root->getChildren().size(), size_t(1));
+    QCOMPARE(root->getChildren()[0]->getName(), std::string("a"));
+}
+
+void coreCircuit_tests::output_sortedNamedCurrents()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<par voltage=\"10\">"
+        "<seq name=\"b\"><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq name=\"a\"><elem><type>L</type><res>10</res></elem></seq>"
+        "</par>", circuitMap);
+
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    QCOMPARE(formatOutput(circuitMap), std::string("a = 0 - 1i\nb = 2\n"));
+}
+
+QTEST_APPLESS_MAIN(coreCircuit_tests)
+
+#include "tst_corecircuit_tests.moc"
@@ -0,0 +1,108 @@
+#include <QtTest>
+#include <thread>
+#include <vector>
+#include "../circuitMaster_core/batchPipeline.h"
+#include "../circuitMaster_core/coreMetrics.h"
+#include "../circuitMaster_core/liteXmlParser.h"
+
+/*!
+*\file
+*\brief Тесты для счетчиков, гистограмм и выгрузки метрик в формате Prometheus
+*/
+
+class coreMetrics_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void histogram_valueOnBoundInLowerBucket();
+    void histogram_valueAboveAllBoundsInInf();
+    void counter_manyThreads();
+
+    void evaluate_errorCountedByStage();
+    void evaluate_durationObserved();
+
+    void prometheus_cumulativeBuckets();
+};
+
+void coreMetrics_tests::init()
+{
+    Metrics::reset();
+}
+
+void coreMetrics_tests::histogram_valueOnBoundInLowerBucket()
+{
+    MetricHistogram histogram({ 1, 2, 5 });
+    histogram.observe(2);
+
+    QCOMPARE(histogram.getBucketCount(0), uint64_t(0));
+    QCOMPARE(histogram.getBucketCount(1), uint64_t(1));
+    QCOMPARE(histogram.getCount(), uint64_t(1));
+    QCOMPARE(histogram.getSum(), 2.0);
+}
+
+void coreMetrics_tests::histogram_valueAboveAllBoundsInInf()
+{
+    MetricHistogram histogram({ 1, 2, 5 });
+    histogram.observe(100);
+
+    QCOMPARE(histogram.getBucketCount(2), uint64_t(0));
+    QCOMPARE(histogram.getBucketCount(3), uint64_t(1));
+}
+
+void coreMetrics_tests::counter_manyThreads()
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([]() {
+            for (int j = 0; j < 10000; j++)
+            {
+                Metrics::countRequest(true);
+                Metrics::observeDuration(Metrics::Phase::evaluate, 0.001);
+            }
+        });
+    for (auto iter = threads.begin(); iter != threads.end(); iter++)
+        iter->join();
+
+    QCOMPARE(Metrics::getRequestCount(true), uint64_t(40000));
+    QCOMPARE(Metrics::getDurationHistogram(Metrics::Phase::evaluate).getCount(), uint64_t(40000));
+}
+
+void coreMetrics_tests::evaluate_errorCountedByStage()
+{
+    LiteXmlParser parser;
+    QVERIFY_EXCEPTION_THROWN(BatchPipeline::evaluateCircuitText("<seq", parser), std::string);
+    QVERIFY_EXCEPTION_THROWN(BatchPipeline::evaluateCircuitText("<seq voltage=\"20\" frequency=\"50\"></seq>", parser), std::string);
+
+    QCOMPARE(Metrics::getErrorCount(Metrics::Phase::parse), uint64_t(1));
+    QCOMPARE(Metrics::getErrorCount(Metrics::Phase::evaluate), uint64_t(1));
+}
+
+void coreMetrics_tests::evaluate_durationObserved()
+{
+    LiteXmlParser parser;
+    BatchPipeline::evaluateCircuitText("<seq voltage=\"20\" frequency=\"50\"><elem><type>R</type><res>10</res></elem></seq>", parser);
+
+    QCOMPARE(Metrics::getDurationHistogram(Metrics::Phase::parse).getCount(), uint64_t(1));
+    QCOMPARE(Metrics::getDurationHistogram(Metrics::Phase::evaluate).getCount(), uint64_t(1));
+    QVERIFY(Metrics::prometheusText().find("circuitmaster_circuit_elements_sum 1\n") != std::string::npos);
+}
+
+void coreMetrics_tests::prometheus_cumulativeBuckets()
+{
+    Metrics::observeCircuitSize(3, 1);
+    Metrics::observeCircuitSize(30, 1);
+    std::string text = Metrics::prometheusText();
+
+    QVERIFY(text.find("# TYPE circuitmaster_circuit_connections histogram\n") != std::string::npos);
+    QVERIFY(text.find("circuitmaster_circuit_connections_bucket{le=\"5\"} 1\n") != std::string::npos);
+    QVERIFY(text.find("circuitmaster_circuit_connections_bucket{le=\"50\"} 2\n") != std::string::npos);
+    QVERIFY(text.find("circuitmaster_circuit_connections_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    QVERIFY(text.find("circuitmaster_errors_total{stage=\"parse\"} 0\n") != std::string::npos);
+}
+
+QTEST_APPLESS_MAIN(coreMetrics_tests)
+
+#include "tst_coremetrics_tests.moc"
@@ -0,0 +1,111 @@
+#include <QtTest>
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/coreTrace.h"
+
+/*!
+*\file
+*\brief Тесты для трассировки этапов расчета
+*/
+
+class coreTrace_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void span_recordedWhenEnabled();
+    void span_skippedWhenDisabled();
+    void span_recursionDepthLimit();
+    void span_calculationPhases();
+
+    void export_chromeTraceJson();
+};
+
+/*!
+* \brief Рекурсивная функция с отмеченным участком
+* \param[in] depth - оставшаяся глубина рекурсии
+*/
+static void recursiveSpan(int depth)
+{
+    CORE_TRACE_RECURSIVE_SPAN("recursiveSpan");
+    if (depth > 1)
+        recursiveSpan(depth - 1);
+}
+
+void coreTrace_tests::span_recordedWhenEnabled()
+{
+    Trace::start(1);
+    {
+        CORE_TRACE_SPAN("first");
+        CORE_TRACE_SPAN("second");
+    }
+    Trace::stop();
+
+    QCOMPARE(Trace::eventCount(), size_t(2));
+}
+
+void coreTrace_tests::span_skippedWhenDisabled()
+{
+    Trace::start(1);
+    Trace::stop();
+    {
+        CORE_TRACE_SPAN("skipped");
+    }
+
+    QCOMPARE(Trace::eventCount(), size_t(0));
+}
+
+void coreTrace_tests::span_recursionDepthLimit()
+{
+    Trace::start(3);
+    recursiveSpan(10);
+    Trace::stop();
+    QCOMPARE(Trace::eventCount(), size_t(3));
+
+    // Глубина восстанавливается после выхода из рекурсии
+    Trace::start(3);
+    recursiveSpan(2);
+    Trace::stop();
+    QCOMPARE(Trace::eventCount(), size_t(2));
+}
+
+void coreTrace_tests::span_calculationPhases()
+{
+    CircuitMap circuitMap;
+    Trace::start(1);
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"20\">"
+        "<par><seq><elem><type>R</type><res>1</res></elem></seq><seq><elem><type>R</type><res>2</res></elem></seq></par>"
+        "</seq>", circuitMap);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+    Trace::stop();
+
+    std::string json = Trace::chromeTraceJson();
+    QVERIFY(json.find("\"CoreConnection::connectionFromDocElement\"") != std::string::npos);
+    QVERIFY(json.find("\"CoreConnection::calculateResistance\"") != std::string::npos);
+    QVERIFY(json.find("\"CoreConnection::calculateCurrentAndVoltage\"") != std::string::npos);
+
+    // Разбор, построение дерева и по одному вызову каждой рекурсивной функции на глубине 1
+    QCOMPARE(Trace::eventCount(), size_t(5));
+}
+
+void coreTrace_tests::export_chromeTraceJson()
+{
+    Trace::start(1);
+    Trace::setThreadName("main \"thread\"");
+    {
+        CORE_TRACE_SPAN("phase");
+    }
+    Trace::stop();
+
+    std::string json = Trace::chromeTraceJson();
+    QVERIFY(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+    QVERIFY(json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":") != std::string::npos);
+    QVERIFY(json.find("\"args\":{\"name\":\"main \\\"thread\\\"\"}") != std::string::npos);
+    QVERIFY(json.find("{\"name\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":") != std::string::npos);
+    QVERIFY(json.find("\"dur\":") != std::string::npos);
+}
+
+QTEST_APPLESS_MAIN(coreTrace_tests)
+
+#include "tst_coretrace_tests.moc"
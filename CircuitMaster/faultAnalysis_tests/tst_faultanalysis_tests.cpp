@@ -0,0 +1,217 @@
+#include <QtTest>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/faultAnalysis.h"
+#include "../circuitMaster_core/pathEvaluator.h"
+
+/*!
+*\file
+*\brief Тесты для расчета цепи при обрыве и замыкании каждого элемента
+*/
+
+class faultAnalysis_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void evaluate_matchesModifiedCircuit();
+    void evaluate_shortedParallelBranch();
+    void evaluate_shortedCircuitError();
+    void evaluate_wideConnections();
+    void evaluate_threadCountIndependent();
+
+    void pathEvaluator_severalChanges();
+
+    void formatOutput_sections();
+};
+
+/*!
+* \brief Текст цепи с вложенными последовательными и параллельными соединениями
+* \return - текст документа
+*/
+static std::string faultCircuitText()
+{
+    return "<seq voltage=\"100\" frequency=\"50\">"
+           "<par name=\"p\">"
+           "<seq name=\"a\"><elem><type>R</type><res>10</res></elem><elem><type>L</type><ind>0.05</ind></elem></seq>"
+           "<seq name=\"b\"><elem><type>C</type><cap>0.0002</cap></elem></seq>"
+           "<seq name=\"c\">"
+           "<par name=\"q\"><seq name=\"q1\"><elem><type>R</type><res>4</res></elem></seq>"
+           "<seq name=\"q2\"><elem><type>R</type><res>6</res></elem><elem><type>R</type><res>1</res></elem></seq></par>"
+           "<seq name=\"r\"><elem><type>R</type><res>3</res></elem></seq>"
+           "</seq>"
+           "</par>"
+           "<seq name=\"d\"><elem><type>R</type><res>5</res></elem><elem><type>L</type><ind>0.01</ind></elem></seq>"
+           "</seq>";
+}
+
+/*!
+* \brief Рассчитать силы тока цепи, в которой обрыв заменен очень большим сопротивлением, а замыкание - очень малым
+* \param[in] topology - топология цепи
+* \param[in] scenario - авария
+* \return - состояние расчета
+*/
+static CircuitState evaluateApproximateFault(CircuitTopology const & topology, FaultAnalysis::Scenario const & scenario)
+{
+    CircuitTopology changed = topology;
+    changed.elementResistances[scenario.element] = scenario.type == FaultAnalysis::FaultType::open ? 1e15 : 1e-15;
+    CircuitState state;
+    state.evaluate(changed);
+    return state;
+}
+
+void faultAnalysis_tests::evaluate_matchesModifiedCircuit()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(faultCircuitText(), circuitMap), 50);
+    FaultAnalysis analysis = FaultAnalysis::evaluate(topology, 1);
+
+    QCOMPARE(analysis.scenarios.size(), 2 * topology.elementResistances.size());
+    for (size_t s = 0; s < analysis.scenarios.size(); s++)
+    {
+        FaultAnalysis::Scenario const & scenario = analysis.scenarios[s];
+        QVERIFY(scenario.error.empty());
+        QCOMPARE(scenario.element, s / 2);
+
+        CircuitState state = evaluateApproximateFault(topology, scenario);
+        for (size_t i = 0; i < analysis.names.size(); i++)
+            CORE_COMPARE_COMPLEX(state.currents[topology.findNode(analysis.names[i])], analysis.current(s, i), 1e-9);
+    }
+}
+
+void faultAnalysis_tests::evaluate_shortedParallelBranch()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(faultCircuitText(), circuitMap), 50);
+    FaultAnalysis analysis = FaultAnalysis::evaluate(topology, { topology.findNode("a"), topology.findNode("b"), topology.findNode("d") }, 1);
+
+    // Замыкание конденсатора: ток всей цепи проходит через ветвь b, остальные ветви соединения p обесточены
+    size_t capacitor = 2;
+    FaultAnalysis::Scenario const & scenario = analysis.scenarios[2 * capacitor + 1];
+    QCOMPARE(scenario.type, FaultAnalysis::FaultType::shorted);
+    QCOMPARE(scenario.node, topology.findNode("b"));
+    QCOMPARE(analysis.current(2 * capacitor + 1, 0), std::complex<double>(0, 0));
+    QCOMPARE(analysis.current(2 * capacitor + 1, 1), analysis.current(2 * capacitor + 1, 2));
+    CORE_COMPARE_COMPLEX(100.0 / (topology.elementResistances[7] + topology.elementResistances[8]), analysis.current(2 * capacitor + 1, 2), 1e-12);
+
+    // Обрыв конденсатора: ток ветви b равен 0
+    QCOMPARE(analysis.current(2 * capacitor, 1), std::complex<double>(0, 0));
+}
+
+void faultAnalysis_tests::evaluate_shortedCircuitError()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\"><seq name=\"r\"><elem><type>R</type><res>5</res></elem></seq></seq>", circuitMap));
+    FaultAnalysis analysis = FaultAnalysis::evaluate(topology);
+
+    // Обрыв единственного элемента обесточивает цепь, замыкание - ошибка расчета только этой аварии
+    QCOMPARE(analysis.scenarios.size(), size_t(2));
+    QVERIFY(analysis.scenarios[0].error.empty());
+    QCOMPARE(analysis.current(0, 0), std::complex<double>(0, 0));
+    QVERIFY(!analysis.scenarios[1].error.empty());
+    CORE_COMPARE_COMPLEX(2, analysis.baseCurrents[0], 1e-12);
+}
+
+/*!
+* \brief Текст цепи с широкими параллельным и последовательным соединениями
+* \return - текст документа
+*/
+static std::string wideCircuitText()
+{
+    std::string text = "<seq voltage=\"10\" frequency=\"50\"><par name=\"bus\">";
+    for (int i = 0; i < 300; i++)
+        text += formatStr("<seq name=\"b%1\"><elem><type>R</type><res>%2</res></elem><elem><type>%3</type><res>%4</res></elem></seq>",
+                          { numberToStr(i), numberToStr(1 + i % 7), i % 2 == 0 ? "L" : "C", numberToStr(1 + i % 11) });
+    text += "</par><seq name=\"line\">";
+    for (int i = 0; i < 100; i++)
+        text += "<elem><type>R</type><res>0.25</res></elem>";
+    return text + "</seq></seq>";
+}
+
+void faultAnalysis_tests::evaluate_wideConnections()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(wideCircuitText(), circuitMap), 50);
+    std::vector<int> outputNodes = { topology.findNode("b0"), topology.findNode("b7"), topology.findNode("b299"), topology.findNode("line") };
+    FaultAnalysis analysis = FaultAnalysis::evaluate(topology, outputNodes, 1);
+
+    // Аварии первых ветвей, последней ветви и элемента линии
+    size_t scenarios[] = { 0, 1, 2, 3, 14, 15, 598, 599, 700, 701 };
+    for (size_t s : scenarios)
+    {
+        QVERIFY(analysis.scenarios[s].error.empty());
+        CircuitState state = evaluateApproximateFault(topology, analysis.scenarios[s]);
+        for (size_t i = 0; i < outputNodes.size(); i++)
+            CORE_COMPARE_COMPLEX(state.currents[outputNodes[i]], analysis.current(s, i), 1e-9);
+    }
+}
+
+void faultAnalysis_tests::evaluate_threadCountIndependent()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(wideCircuitText(), circuitMap), 50);
+    FaultAnalysis single = FaultAnalysis::evaluate(topology, 1);
+    FaultAnalysis parallel = FaultAnalysis::evaluate(topology, 4);
+
+    QCOMPARE(parallel.currents, single.currents);
+    QCOMPARE(formatOutput(topology, parallel), formatOutput(topology, single));
+}
+
+void faultAnalysis_tests::pathEvaluator_severalChanges()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(faultCircuitText(), circuitMap), 50);
+    CircuitState base;
+    base.evaluate(topology);
+    PathEvaluator evaluator(topology, base);
+
+    // Несколько изменений складываются, пока не вызван reset
+    CircuitTopology changed = topology;
+    changed.elementResistances[0] = 20;
+    changed.elementResistances[4] = std::complex<double>(2, 1);
+    changed.elementResistances[5] = 7;
+    evaluator.setElementResistance(0, 20);
+    evaluator.setElementResistance(4, std::complex<double>(2, 1));
+    evaluator.setElementResistance(5, 7);
+    CircuitState state;
+    state.evaluate(changed);
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        CORE_COMPARE_COMPLEX(state.resistances[n], evaluator.resistance(static_cast<int>(n)), 1e-12);
+        CORE_COMPARE_COMPLEX(state.currents[n], evaluator.current(static_cast<int>(n)), 1e-12);
+    }
+
+    // Обрыв и восстановление элемента
+    evaluator.reset();
+    evaluator.setElementResistance(3, PathEvaluator::openResistance());
+    QVERIFY(PathEvaluator::isOpen(evaluator.resistance(topology.findNode("q1"))));
+    evaluator.setElementResistance(3, topology.elementResistances[3]);
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+        CORE_COMPARE_COMPLEX(base.currents[n], evaluator.current(static_cast<int>(n)), 1e-12);
+}
+
+void faultAnalysis_tests::formatOutput_sections()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"12\"><par name=\"p\"><seq name=\"a\"><elem><type>R</type><res>6</res></elem></seq>"
+        "<seq name=\"b\"><elem><type>R</type><res>3</res></elem></seq></par></seq>", circuitMap));
+    FaultAnalysis analysis = FaultAnalysis::evaluate(topology);
+
+    QCOMPARE(formatOutput(topology, analysis),
+             std::string("fault = none\na = 2\nb = 4\np = 6\n\n"
+                         "fault = open a:1\na = 0\nb = 4\np = 4\n\n"
+                         "fault = short a:1\nerror = При расчете сопротивления соединения seq_1 на строке 1 был получен 0. "
+                         "Проверьте правильность входных данных.\n\n"
+                         "fault = open b:1\na = 2\nb = 0\np = 2\n\n"
+                         "fault = short b:1\nerror = При расчете сопротивления соединения seq_1 на строке 1 был получен 0. "
+                         "Проверьте правильность входных данных.\n"));
+}
+
+QTEST_APPLESS_MAIN(faultAnalysis_tests)
+
+#include "tst_faultanalysis_tests.moc"
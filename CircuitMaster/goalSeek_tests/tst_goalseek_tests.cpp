@@ -0,0 +1,212 @@
+#include <QtTest>
+#include <cmath>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/goalSeek.h"
+
+/*!
+*\file
+*\brief Тесты для подбора одного значения цепи под требуемую силу тока
+*/
+
+class goalSeek_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void solveElement_resistor();
+    void solveElement_inductorAndCapacitor();
+    void solveElement_deepCircuit();
+    void solveElement_unreachable();
+
+    void solveVoltage_keepsPhase();
+
+    void solveFrequency_inductor();
+    void solveFrequency_errors();
+
+    void goalSeekFromDocument_errors();
+
+    void formatOutput_sections();
+};
+
+/*!
+* \brief Текст цепи с требуемой силой тока соединения "a"
+* \return - текст документа
+*/
+static std::string goalSeekCircuitText()
+{
+    return "<seq voltage=\"230\" frequency=\"50\">"
+           "<par name=\"p\">"
+           "<seq name=\"a\" target=\"1.5\"><elem><type>R</type><res>100</res></elem><elem><type>L</type><ind>0.1</ind></elem></seq>"
+           "<seq name=\"b\"><elem><type>C</type><cap>0.0001</cap></elem></seq>"
+           "</par>"
+           "<seq name=\"d\"><elem><type>R</type><res>20</res></elem></seq>"
+           "</seq>";
+}
+
+/*!
+* \brief Цепь и требуемая сила тока, указанные в тексте документа
+*/
+class GoalSeekProblem
+{
+    public:
+    DocumentNode rootElement; /*!< Корневой узел документа */
+    CircuitTopology topology; /*!< Топология цепи */
+    CurrentTarget target; /*!< Требуемая сила тока */
+
+    explicit GoalSeekProblem(std::string const & text)
+        : topology(topologyFromText(text, this->rootElement))
+    {
+        this->target = goalSeekTargetFromDocument(this->rootElement, this->topology);
+    }
+
+    /*!
+    * \brief Подобрать значение элемента и проверить результат расчетом всей цепи
+    * \param[in] reference - элемент в виде "имя соединения:номер элемента"
+    * \param[out] result - найденное значение
+    */
+    void solveElement(std::string const & reference, GoalSeek& result) const
+    {
+        OptimizationVariable variable = goalSeekElementFromDocument(this->rootElement, this->topology, reference);
+        result = GoalSeek::solveElement(this->topology, variable, this->target);
+
+        CircuitState state = evaluateWithResistances(this->topology, { { variable.element, variable.resistance(this->topology, result.value) } });
+        for (size_t n = 0; n < this->topology.nodes.size(); n++)
+            CORE_COMPARE_COMPLEX(state.currents[n], result.state.currents[n], 1e-12);
+        QVERIFY(std::abs(std::abs(state.currents[this->target.node]) - this->target.current) <= 1e-9 * this->target.current);
+    }
+};
+
+void goalSeek_tests::solveElement_resistor()
+{
+    GoalSeekProblem problem(goalSeekCircuitText());
+    GoalSeek result;
+    problem.solveElement("a:1", result);
+    QVERIFY(result.iterations <= 6);
+
+    // Сопротивление, при котором |I| = U / R
+    GoalSeekProblem simple("<seq voltage=\"10\"><seq name=\"r\" target=\"2\"><elem><type>R</type><res>4</res></elem></seq></seq>");
+    simple.solveElement("r:1", result);
+    QVERIFY(std::abs(result.value - 5) <= 1e-9);
+}
+
+void goalSeek_tests::solveElement_inductorAndCapacitor()
+{
+    GoalSeekProblem problem(goalSeekCircuitText());
+    GoalSeek result;
+    problem.solveElement("a:2", result);
+    QVERIFY(result.iterations <= 10);
+    problem.solveElement("b:1", result);
+    QVERIFY(result.iterations <= 10);
+
+    // Емкость, при которой |I| = U / Xc. Сопротивления элементов рассчитываются с float и числом 3.14
+    GoalSeekProblem single("<seq voltage=\"100\" frequency=\"50\"><seq name=\"c\" target=\"2\"><elem><type>C</type><cap>0.001</cap></elem></seq></seq>");
+    single.solveElement("c:1", result);
+    double expected = 2 / (100 * 2 * 3.14 * 50);
+    QVERIFY(std::abs(result.value - expected) <= 1e-6 * expected);
+}
+
+void goalSeek_tests::solveElement_deepCircuit()
+{
+    // Лестница из вложенных параллельных соединений: элемент и требуемая сила тока на разных ветвях
+    std::string text = "<seq voltage=\"50\" frequency=\"1000\">";
+    for (int level = 0; level < 30; level++)
+        text += "<par><seq><elem><type>R</type><res>" + std::to_string(10 + level) + "</res></elem></seq><seq>";
+    text += "<seq name=\"leaf\"><elem><type>L</type><ind>0.001</ind></elem></seq>";
+    for (int level = 0; level < 30; level++)
+        text += "</seq></par>";
+    text += "<seq name=\"top\" target=\"9.5\"><elem><type>R</type><res>5</res></elem></seq></seq>";
+
+    GoalSeekProblem problem(text);
+    GoalSeek result;
+    problem.solveElement("leaf:1", result);
+    QVERIFY(result.iterations <= 10);
+}
+
+void goalSeek_tests::solveElement_unreachable()
+{
+    // Сила тока не может превысить U / R последовательного резистора
+    GoalSeekProblem problem("<seq voltage=\"10\"><seq name=\"r\" target=\"3\"><elem><type>R</type><res>5</res></elem>"
+                            "<elem><type>R</type><res>4</res></elem></seq></seq>");
+    OptimizationVariable variable = goalSeekElementFromDocument(problem.rootElement, problem.topology, "r:2");
+    QVERIFY_EXCEPTION_THROWN(GoalSeek::solveElement(problem.topology, variable, problem.target), std::string);
+}
+
+void goalSeek_tests::solveVoltage_keepsPhase()
+{
+    GoalSeekProblem problem("<seq voltage=\"10\" frequency=\"50\"><seq name=\"a\" target=\"2\"><elem><type>R</type><res>4</res></elem>"
+                            "<elem><type>L</type><ind>0.01</ind></elem></seq></seq>");
+    GoalSeek result = GoalSeek::solveVoltage(problem.topology, problem.target);
+    QCOMPARE(result.iterations, 1);
+
+    CircuitState state;
+    state.evaluate(problem.topology);
+    QVERIFY(std::abs(result.value - 10 * 2 / std::abs(state.currents[0])) <= 1e-12);
+    QVERIFY(std::abs(std::abs(result.state.currents[0]) - 2) <= 1e-12);
+    QVERIFY(std::abs(std::arg(result.state.currents[0]) - std::arg(state.currents[0])) <= 1e-12);
+}
+
+void goalSeek_tests::solveFrequency_inductor()
+{
+    // |I| = U / sqrt(R^2 + (2 * 3.14 * f * L)^2)
+    GoalSeekProblem problem("<seq voltage=\"10\" frequency=\"50\"><seq name=\"a\" target=\"1\"><elem><type>R</type><res>6</res></elem>"
+                            "<elem><type>L</type><ind>0.01</ind></elem></seq></seq>");
+    GoalSeek result = GoalSeek::solveFrequency(problem.topology, problem.target);
+    double expected = 8 / (2 * 3.14 * 0.01);
+    QVERIFY(std::abs(result.value - expected) <= 1e-6 * expected);
+    QVERIFY(std::abs(std::abs(result.state.currents[problem.target.node]) - 1) <= 1e-9);
+
+    GoalSeekProblem circuit(goalSeekCircuitText());
+    result = GoalSeek::solveFrequency(circuit.topology, circuit.target);
+    CircuitState state;
+    state.evaluate(circuit.topology, circuit.topology.rootVoltage, result.value);
+    CORE_COMPARE_COMPLEX(state.currents[circuit.target.node], result.state.currents[circuit.target.node], 1e-12);
+    QVERIFY(std::abs(std::abs(state.currents[circuit.target.node]) - 1.5) <= 1e-9);
+}
+
+void goalSeek_tests::solveFrequency_errors()
+{
+    // Без частоты подбирать нечего, у цепи из резисторов сила тока от частоты не зависит
+    GoalSeekProblem direct("<seq voltage=\"10\"><seq name=\"a\" target=\"1\"><elem><type>R</type><res>5</res></elem></seq></seq>");
+    QVERIFY_EXCEPTION_THROWN(GoalSeek::solveFrequency(direct.topology, direct.target), std::string);
+    GoalSeekProblem resistive("<seq voltage=\"10\" frequency=\"50\"><seq name=\"a\" target=\"1\"><elem><type>R</type><res>5</res></elem></seq></seq>");
+    QVERIFY_EXCEPTION_THROWN(GoalSeek::solveFrequency(resistive.topology, resistive.target), std::string);
+}
+
+void goalSeek_tests::goalSeekFromDocument_errors()
+{
+    char const * wrongTargets[] = {
+        "<seq voltage=\"10\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem></seq></seq>",
+        "<seq voltage=\"10\"><seq name=\"a\" target=\"1\"><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq name=\"b\" target=\"1\"><elem><type>R</type><res>5</res></elem></seq></seq>",
+        "<seq voltage=\"10\"><seq target=\"1\"><elem><type>R</type><res>5</res></elem></seq></seq>"
+    };
+    for (char const * text : wrongTargets)
+        QVERIFY_EXCEPTION_THROWN(GoalSeekProblem problem(text), std::string);
+
+    GoalSeekProblem problem(goalSeekCircuitText());
+    char const * wrongReferences[] = { "a", "x:1", "a:0", "a:3", "a:1.5", "a:x", "p:1" };
+    for (char const * reference : wrongReferences)
+        QVERIFY_EXCEPTION_THROWN(goalSeekElementFromDocument(problem.rootElement, problem.topology, reference), std::string);
+
+    OptimizationVariable variable = goalSeekElementFromDocument(problem.rootElement, problem.topology, "b:1");
+    QCOMPARE(variable.element, size_t(2));
+    QCOMPARE(variable.node, problem.topology.findNode("b"));
+    QCOMPARE(variable.position, 1);
+    QCOMPARE(variable.nominal, 0.0001);
+}
+
+void goalSeek_tests::formatOutput_sections()
+{
+    GoalSeekProblem problem("<seq voltage=\"10\"><seq name=\"r\" target=\"2\"><elem><type>R</type><res>4</res></elem></seq></seq>");
+    GoalSeek result;
+    problem.solveElement("r:1", result);
+    QCOMPARE(formatOutput(problem.topology, result), formatStr("value = 5\niterations = %1\n\nr = 2\n", { numberToStr(result.iterations) }));
+}
+
+QTEST_APPLESS_MAIN(goalSeek_tests)
+
+#include "tst_goalseek_tests.moc"
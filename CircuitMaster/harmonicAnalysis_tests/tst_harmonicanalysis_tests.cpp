@@ -0,0 +1,147 @@
+#include <QtTest>
+#include <cmath>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/harmonicAnalysis.h"
+#include "../circuitMaster_core/liteXmlParser.h"
+
+/*!
+*\file
+*\brief Тесты для расчета цепи на гармониках несинусоидального напряжения
+*/
+
+class harmonicAnalysis_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void evaluate_fundamentalMatchesConnectionTree();
+    void evaluate_harmonicsMatchCircuitState();
+    void evaluate_rmsCurrent();
+    void evaluate_reactiveElementsWithoutFrequency();
+
+    void harmonicsFromDocument_values();
+    void harmonicsFromDocument_errors();
+    void harmonicsFromDocument_notRootConnection();
+
+    void formatOutput_sections();
+};
+
+/*!
+* \brief Текст цепи с резисторами, катушками и конденсаторами
+* \param[in] harmonics - значение атрибута harmonics корневого элемента
+* \return - текст документа
+*/
+static std::string rlcCircuitText(std::string const & harmonics)
+{
+    return formatStr(
+        "<seq voltage=\"230\" frequency=\"50\" harmonics=\"%1\">"
+        "<par name=\"p\">"
+        "<seq name=\"a\"><elem><type>R</type><res>10</res></elem><elem><type>L</type><ind>0.05</ind></elem></seq>"
+        "<seq name=\"b\"><elem><type>C</type><cap>0.0002</cap></elem></seq>"
+        "</par>"
+        "<seq name=\"d\"><elem><type>R</type><res>5</res></elem></seq>"
+        "</seq>",
+        { harmonics });
+}
+
+void harmonicAnalysis_tests::evaluate_fundamentalMatchesConnectionTree()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(rlcCircuitText("3:20:30; 5:10"), circuitMap);
+    CircuitTopology topology = CircuitTopology::fromConnection(*root, 50);
+    HarmonicAnalysis analysis = HarmonicAnalysis::evaluate(topology, { { 1, 230 }, { 3, std::polar(20.0, 0.5) } });
+
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+    QCOMPARE(analysis.names.size(), size_t(4));
+    for (size_t i = 0; i < analysis.names.size(); i++)
+        CORE_COMPARE_COMPLEX(findCoreConnection(circuitMap, analysis.names[i])->getCurrent(), analysis.current(i, 0), 1e-9);
+}
+
+void harmonicAnalysis_tests::evaluate_harmonicsMatchCircuitState()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(rlcCircuitText(""), circuitMap), 50);
+    std::vector<Harmonic> harmonics = { { 1, 230 }, { 3, std::polar(20.0, 0.5) }, { 5, std::polar(10.0, -1.0) }, { 2.5, 3 } };
+    HarmonicAnalysis analysis = HarmonicAnalysis::evaluate(topology, harmonics);
+
+    // Гармоника - расчет цепи на частоте, кратной частоте исходной цепи
+    CircuitState state;
+    for (size_t h = 0; h < harmonics.size(); h++)
+    {
+        state.evaluate(topology, harmonics[h].voltage, 50 * harmonics[h].order);
+        for (size_t i = 0; i < analysis.names.size(); i++)
+            CORE_COMPARE_COMPLEX(state.currents[topology.findNode(analysis.names[i])], analysis.current(i, h), 1e-9);
+    }
+}
+
+void harmonicAnalysis_tests::evaluate_rmsCurrent()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\"><seq name=\"r\"><elem><type>R</type><res>2</res></elem></seq></seq>", circuitMap));
+    HarmonicAnalysis analysis = HarmonicAnalysis::evaluate(topology, { { 1, 10 }, { 3, std::complex<double>(0, 4) }, { 7, -2 } });
+
+    // Сопротивление резистора не зависит от частоты: I = sqrt(5^2 + 2^2 + 1^2)
+    QCOMPARE(analysis.orders, std::vector<double>({ 1, 3, 7 }));
+    CORE_COMPARE_COMPLEX(std::complex<double>(0, 2), analysis.current(0, 1), 1e-12);
+    QVERIFY(std::abs(analysis.rmsCurrent(0) - std::sqrt(30.0)) < 1e-12);
+}
+
+void harmonicAnalysis_tests::evaluate_reactiveElementsWithoutFrequency()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\"><elem><type>R</type><res>5</res></elem><elem><type>L</type><res>2</res></elem></seq>", circuitMap));
+
+    QVERIFY_EXCEPTION_THROWN(HarmonicAnalysis::evaluate(topology, { { 1, 10 }, { 3, 1 } }), std::string);
+    QVERIFY_EXCEPTION_THROWN(HarmonicAnalysis::evaluate(topology, { { 0, 10 } }), std::string);
+}
+
+void harmonicAnalysis_tests::harmonicsFromDocument_values()
+{
+    std::vector<Harmonic> harmonics = harmonicsFromDocument(LiteXmlParser().parseText(rlcCircuitText("3:20:90; 5:10 ;")));
+
+    QCOMPARE(harmonics.size(), size_t(3));
+    QCOMPARE(harmonics[0].order, 1.0);
+    CORE_COMPARE_COMPLEX(230, harmonics[0].voltage, 1e-12);
+    QCOMPARE(harmonics[1].order, 3.0);
+    CORE_COMPARE_COMPLEX(std::complex<double>(0, 20), harmonics[1].voltage, 1e-12);
+    QCOMPARE(harmonics[2].order, 5.0);
+    CORE_COMPARE_COMPLEX(10, harmonics[2].voltage, 1e-12);
+
+    // Без атрибута harmonics - только первая гармоника
+    QCOMPARE(harmonicsFromDocument(LiteXmlParser().parseText(rlcCircuitText(""))).size(), size_t(1));
+}
+
+void harmonicAnalysis_tests::harmonicsFromDocument_errors()
+{
+    char const * wrongLists[] = { "3", "3:20:30:1", "3:x", "0:20", "3:-20", "1:20", "3:20; 3:10" };
+    for (char const * list : wrongLists)
+        QVERIFY_EXCEPTION_THROWN(harmonicsFromDocument(LiteXmlParser().parseText(rlcCircuitText(list))), std::string);
+}
+
+void harmonicAnalysis_tests::harmonicsFromDocument_notRootConnection()
+{
+    CircuitMap circuitMap;
+    QVERIFY_EXCEPTION_THROWN(coreCircuitFromText(
+        "<seq voltage=\"10\"><seq harmonics=\"3:1\"><elem><type>R</type><res>5</res></elem></seq></seq>", circuitMap), std::string);
+}
+
+void harmonicAnalysis_tests::formatOutput_sections()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"8\"><seq name=\"r\"><elem><type>R</type><res>2</res></elem></seq></seq>", circuitMap));
+    HarmonicAnalysis analysis = HarmonicAnalysis::evaluate(topology, { { 1, 8 }, { 3, 6 } });
+
+    QCOMPARE(formatOutput(analysis), std::string("harmonic = 1\nr = 4\n\nharmonic = 3\nr = 3\n\nrms\nr = 5\n"));
+}
+
+QTEST_APPLESS_MAIN(harmonicAnalysis_tests)
+
+#include "tst_harmonicanalysis_tests.moc"
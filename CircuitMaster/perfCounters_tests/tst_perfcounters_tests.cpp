@@ -0,0 +1,85 @@
+#include <QtTest>
+#include "../circuitMaster_core/perfCounters.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+
+/*!
+*\file
+*\brief Тесты для сбора аппаратных счетчиков производительности по этапам расчета
+*/
+
+class perfCounters_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void phase_notCountedWhenDisabled();
+    void phase_recursiveCallsCountedOnce();
+    void phase_instructionsCountedWhenAvailable();
+
+    void report_containsAllPhases();
+};
+
+void perfCounters_tests::cleanup()
+{
+    PerfCounters::stop();
+    PerfCounters::reset();
+}
+
+void perfCounters_tests::phase_notCountedWhenDisabled()
+{
+    {
+        CORE_PERF_PHASE(documentLoad);
+    }
+    QCOMPARE(PerfCounters::get(PerfCounters::Phase::documentLoad).calls, uint64_t(0));
+}
+
+void perfCounters_tests::phase_recursiveCallsCountedOnce()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(
+        "<seq voltage=\"20\" frequency=\"50\">"
+        "<par><seq><elem><type>R</type><res>1</res></elem><elem><type>L</type><ind>0.01</ind></elem></seq>"
+        "<seq><elem><type>C</type><cap>0.001</cap></elem></seq></par>"
+        "</seq>", circuitMap);
+
+    PerfCounters::start();
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+    PerfCounters::stop();
+
+    // Вложенные вызовы входят в показания корневого
+    QCOMPARE(PerfCounters::get(PerfCounters::Phase::calculateResistance).calls, uint64_t(1));
+    QCOMPARE(PerfCounters::get(PerfCounters::Phase::calculateCurrentAndVoltage).calls, uint64_t(1));
+}
+
+void perfCounters_tests::phase_instructionsCountedWhenAvailable()
+{
+    PerfCounters::start();
+    {
+        CORE_PERF_PHASE(documentLoad);
+        CircuitMap circuitMap;
+        coreCircuitFromText("<seq voltage=\"20\" frequency=\"50\"><elem><type>R</type><res>1</res></elem></seq>", circuitMap);
+    }
+    PerfCounters::stop();
+
+    PerfCounters::Totals totals = PerfCounters::get(PerfCounters::Phase::documentLoad);
+    if (!totals.available[static_cast<int>(PerfCounters::Event::instructions)])
+        QSKIP(("Счетчик инструкций недоступен: " + PerfCounters::unavailableReason()).c_str());
+
+    QCOMPARE(totals.calls, uint64_t(1));
+    QVERIFY(totals.values[static_cast<int>(PerfCounters::Event::instructions)] > 0);
+}
+
+void perfCounters_tests::report_containsAllPhases()
+{
+    std::string report = PerfCounters::report();
+    QVERIFY(report.find("чтение и разбор xml: выполнений ") != std::string::npos);
+    QVERIFY(report.find("calculateResistance: выполнений ") != std::string::npos);
+    QVERIFY(report.find("calculateCurrentAndVoltage: выполнений ") != std::string::npos);
+}
+
+QTEST_APPLESS_MAIN(perfCounters_tests)
+
+#include "tst_perfcounters_tests.moc"
@@ -0,0 +1,190 @@
+#include <QtTest>
+#include "../circuitMaster_core/batchPipeline.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/liteXmlParser.h"
+#include "../circuitMaster_core/planCache.h"
+
+/*!
+*\file
+*\brief Тесты для кэша топологий цепей
+*/
+
+class planCache_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void signature_ignoresValues();
+    void signature_dependsOnStructure();
+
+    void evaluate_sameAsWithoutCache();
+    void evaluate_errorMessageFromFallback();
+    void evaluate_limitedCapacity();
+
+    void evaluateDocuments_sameAsSeparately();
+    void evaluateDocuments_invalidDocumentLeftForFallback();
+    void evaluateDocuments_floatRefinedToDouble();
+};
+
+/*!
+* \brief Текст цепи с заданными значениями
+* \param[in] voltage - напряжение
+* \param[in] res - сопротивление резистора
+* \param[in] cap - емкость конденсатора
+* \return - текст документа
+*/
+static std::string circuitText(std::string const & voltage, std::string const & res, std::string const & cap)
+{
+    return formatStr(
+        "<seq voltage=\"%1\" frequency=\"50\" name=\"root\">\n"
+        "  <par name=\"par1\">\n"
+        "    <seq name=\"seq1\"><elem><type>R</type><res>%2</res></elem></seq>\n"
+        "    <seq><elem><type>C</type><cap>%3</cap></elem></seq>\n"
+        "  </par>\n"
+        "  <seq name=\"seq2\"><elem><type>L</type><ind>0.2</ind></elem></seq>\n"
+        "</seq>", { voltage, res, cap });
+}
+
+void planCache_tests::signature_ignoresValues()
+{
+    std::string first = PlanCache::topologySignature(LiteXmlParser().parseText(circuitText("10", "5", "0.001")));
+    std::string second = PlanCache::topologySignature(LiteXmlParser().parseText(circuitText("220", "7.5", "0.02")));
+
+    QCOMPARE(first, second);
+    QCOMPARE(PlanCache::topologyFingerprint(first), PlanCache::topologyFingerprint(second));
+}
+
+void planCache_tests::signature_dependsOnStructure()
+{
+    LiteXmlParser parser;
+    std::string base = PlanCache::topologySignature(parser.parseText("<seq voltage=\"1\"><seq name=\"a\"><elem><type>R</type><res>1</res></elem></seq></seq>"));
+    std::string renamed = PlanCache::topologySignature(parser.parseText("<seq voltage=\"1\"><seq name=\"b\"><elem><type>R</type><res>1</res></elem></seq></seq>"));
+    std::string retyped = PlanCache::topologySignature(parser.parseText("<seq voltage=\"1\"><seq name=\"a\"><elem><type>L</type><res>1</res></elem></seq></seq>"));
+    std::string parallel = PlanCache::topologySignature(parser.parseText("<seq voltage=\"1\"><par name=\"a\"><elem><type>R</type><res>1</res></elem></par></seq>"));
+    std::string extraVoltage = PlanCache::topologySignature(parser.parseText("<seq voltage=\"1\"><seq name=\"a\" voltage=\"2\"><elem><type>R</type><res>1</res></elem></seq></seq>"));
+
+    QVERIFY(base != renamed);
+    QVERIFY(base != retyped);
+    QVERIFY(base != parallel);
+    QVERIFY(base != extraVoltage);
+}
+
+void planCache_tests::evaluate_sameAsWithoutCache()
+{
+    LiteXmlParser parser;
+    PlanCache cache;
+    const char* resistances[] = { "5", "1", "12.5", "300" };
+    for (const char* res : resistances)
+    {
+        std::string text = circuitText("20", res, "0.0005");
+        QCOMPARE(BatchPipeline::evaluateCircuitText(text, parser, &cache), BatchPipeline::evaluateCircuitText(text, parser));
+    }
+
+    QCOMPARE(cache.size(), size_t(1));
+    QCOMPARE(cache.getMisses(), size_t(1));
+    QCOMPARE(cache.getHits(), size_t(3));
+}
+
+void planCache_tests::evaluate_errorMessageFromFallback()
+{
+    LiteXmlParser parser;
+    PlanCache cache;
+    BatchPipeline::evaluateCircuitText(circuitText("20", "5", "0.001"), parser, &cache);
+
+    try {
+        BatchPipeline::evaluateCircuitText(circuitText("20", "-5", "0.001"), parser, &cache);
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string const & str) {
+        QCOMPARE(str, std::string("Недопустимое значение сопротивления на строке 3. Значение сопротивления должно быть больше 0."));
+    }
+
+    try {
+        BatchPipeline::evaluateCircuitText(circuitText("0", "5", "0.001"), parser, &cache);
+        QVERIFY2(false, "No exception is thrown");
+    } catch (std::string const & str) {
+        QCOMPARE(str, std::string("Недопустимое значение напряжения у соединения на строке 1. Значение напряжения должно быть больше 0."));
+    }
+
+    QCOMPARE(cache.getHits(), size_t(0));
+}
+
+void planCache_tests::evaluate_limitedCapacity()
+{
+    LiteXmlParser parser;
+    PlanCache cache(1);
+    BatchPipeline::evaluateCircuitText("<seq voltage=\"1\" name=\"a\"><elem><type>R</type><res>1</res></elem></seq>", parser, &cache);
+    BatchPipeline::evaluateCircuitText("<seq voltage=\"1\" name=\"b\"><elem><type>R</type><res>1</res></elem></seq>", parser, &cache);
+
+    QCOMPARE(cache.size(), size_t(1));
+    QCOMPARE(cache.getMisses(), size_t(2));
+}
+
+void planCache_tests::evaluateDocuments_sameAsSeparately()
+{
+    LiteXmlParser parser;
+    PlanCache cache;
+    const char* resistances[] = { "5", "1", "12.5", "300", "0.25" };
+    std::vector<DocumentNode> documents;
+    for (const char* res : resistances)
+        documents.push_back(parser.parseText(circuitText("20", res, "0.0005")));
+    std::vector<DocumentNode const *> rootElements;
+    for (auto iter = documents.cbegin(); iter != documents.cend(); iter++)
+        rootElements.push_back(&*iter);
+    std::string signature = PlanCache::topologySignature(documents[0]);
+
+    // Пока топологии нет в кэше, документы остаются для обычного расчета
+    std::vector<std::string> outputs;
+    QCOMPARE(cache.evaluateDocuments(signature, rootElements, outputs), std::vector<bool>(documents.size(), false));
+
+    BatchPipeline::evaluateCircuit(documents[0], &cache);
+    QCOMPARE(cache.evaluateDocuments(signature, rootElements, outputs), std::vector<bool>(documents.size(), true));
+    for (size_t k = 0; k < documents.size(); k++)
+        QCOMPARE(outputs[k], BatchPipeline::evaluateCircuit(documents[k]));
+    QCOMPARE(cache.getHits(), documents.size());
+    QCOMPARE(cache.getMisses(), size_t(1));
+}
+
+void planCache_tests::evaluateDocuments_invalidDocumentLeftForFallback()
+{
+    LiteXmlParser parser;
+    PlanCache cache;
+    DocumentNode valid = parser.parseText(circuitText("20", "5", "0.001"));
+    DocumentNode invalid = parser.parseText(circuitText("20", "-5", "0.001"));
+    BatchPipeline::evaluateCircuit(valid, &cache);
+
+    std::vector<std::string> outputs;
+    std::vector<bool> evaluated = cache.evaluateDocuments(PlanCache::topologySignature(valid), { &valid, &invalid, &valid }, outputs);
+
+    QCOMPARE(evaluated, std::vector<bool>({ true, false, true }));
+    QCOMPARE(outputs[0], BatchPipeline::evaluateCircuit(valid));
+    QCOMPARE(outputs[2], outputs[0]);
+    QCOMPARE(cache.getHits(), size_t(2));
+}
+
+void planCache_tests::evaluateDocuments_floatRefinedToDouble()
+{
+    LiteXmlParser parser;
+    PlanCache cache;
+    std::vector<DocumentNode> documents;
+    for (int k = 1; k <= 20; k++)
+        documents.push_back(parser.parseText(circuitText("20", numberToStr(k), "0.0005")));
+    std::vector<DocumentNode const *> rootElements;
+    for (auto iter = documents.cbegin(); iter != documents.cend(); iter++)
+        rootElements.push_back(&*iter);
+    std::string signature = PlanCache::topologySignature(documents[0]);
+    BatchPipeline::evaluateCircuit(documents[0], &cache);
+
+    std::vector<std::string> fullOutputs, singleOutputs, refinedOutputs;
+    std::vector<bool> allEvaluated(documents.size(), true);
+    QCOMPARE(cache.evaluateDocuments(signature, rootElements, fullOutputs), allEvaluated);
+    QCOMPARE(cache.evaluateDocuments(signature, rootElements, singleOutputs, VariantEvaluator::Precision::single), allEvaluated);
+
+    // Погрешность float больше допустимой у всех вариантов: все пересчитываются в double
+    QCOMPARE(cache.evaluateDocuments(signature, rootElements, refinedOutputs, VariantEvaluator::Precision::single, 1e-15), allEvaluated);
+    QCOMPARE(refinedOutputs, fullOutputs);
+}
+
+QTEST_APPLESS_MAIN(planCache_tests)
+
+#include "tst_plancache_tests.moc"
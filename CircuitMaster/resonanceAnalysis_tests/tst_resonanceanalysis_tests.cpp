@@ -0,0 +1,225 @@
+#include <QtTest>
+#include <cmath>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/frequencyDerivatives.h"
+#include "../circuitMaster_core/resonanceAnalysis.h"
+
+/*!
+*\file
+*\brief Тесты для поиска резонансов цепи в диапазоне частот
+*/
+
+class resonanceAnalysis_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void frequencyDerivatives_matchFiniteDifferences();
+
+    void evaluate_seriesCircuit();
+    void evaluate_parallelTank();
+    void evaluate_highQuality();
+    void evaluate_boundNearRangeEnd();
+    void evaluate_noResonances();
+    void evaluate_errors();
+
+    void formatOutput_sections();
+};
+
+/*!
+* \brief Получить текст последовательного колебательного контура
+* \param[in] resistance - сопротивление резистора
+* \return - текст документа
+*/
+static std::string seriesCircuitText(std::string const & resistance)
+{
+    return "<seq voltage=\"10\" frequency=\"50\"><seq name=\"s\"><elem><type>R</type><res>" + resistance + "</res></elem>"
+           "<elem><type>L</type><ind>0.1</ind></elem><elem><type>C</type><cap>0.00001</cap></elem></seq></seq>";
+}
+
+/*!
+* \brief Текст цепи из последовательного контура и параллельного контура
+* \return - текст документа
+*/
+static std::string tankCircuitText()
+{
+    return "<seq voltage=\"10\" frequency=\"50\">"
+           "<seq name=\"s\"><elem><type>R</type><res>10</res></elem><elem><type>L</type><ind>0.1</ind></elem>"
+           "<elem><type>C</type><cap>0.00001</cap></elem></seq>"
+           "<par name=\"tank\"><seq name=\"tl\"><elem><type>R</type><res>1</res></elem><elem><type>L</type><ind>0.001</ind></elem></seq>"
+           "<seq name=\"tc\"><elem><type>C</type><cap>0.000001</cap></elem></seq></par>"
+           "</seq>";
+}
+
+/*!
+* \brief Частота резонанса контура. Сопротивления элементов рассчитываются с float и числом 3.14,
+* поэтому совпадение проверяется с точностью 1e-6
+* \param[in] inductivity - индуктивность
+* \param[in] capacity - емкость
+* \return - частота
+*/
+static double resonanceFrequency(double inductivity, double capacity)
+{
+    return 1 / (2 * 3.14 * std::sqrt(inductivity * capacity));
+}
+
+/*!
+* \brief Рассчитать модуль сопротивления цепи на частоте
+* \param[in] topology - топология цепи
+* \param[in] frequency - частота
+* \return - модуль сопротивления
+*/
+static double impedanceAt(CircuitTopology const & topology, double frequency)
+{
+    CircuitState state;
+    state.evaluate(topology, topology.rootVoltage, frequency);
+    return std::abs(state.resistances[0]);
+}
+
+void resonanceAnalysis_tests::frequencyDerivatives_matchFiniteDifferences()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(tankCircuitText(), circuitMap), 50);
+    double frequency = 700, step = 1e-6;
+
+    CircuitState state, lower, upper;
+    state.evaluate(topology, topology.rootVoltage, frequency);
+    lower.evaluate(topology, topology.rootVoltage, frequency * std::exp(-step));
+    upper.evaluate(topology, topology.rootVoltage, frequency * std::exp(step));
+    FrequencyDerivatives derivatives;
+    derivatives.evaluate(topology, state);
+
+    // Производные по логарифму частоты сравниваются с центральной разностью
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        std::complex<double> resistance = (upper.resistances[n] - lower.resistances[n]) / (2 * step);
+        std::complex<double> current = (upper.currents[n] - lower.currents[n]) / (2 * step);
+        CORE_COMPARE_COMPLEX(resistance, derivatives.resistances[n], 1e-6 * std::abs(resistance) + 1e-9);
+        CORE_COMPARE_COMPLEX(current, derivatives.currents[n], 1e-6 * std::abs(current) + 1e-12);
+    }
+}
+
+void resonanceAnalysis_tests::evaluate_seriesCircuit()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(seriesCircuitText("10"), circuitMap), 50);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 10, 100000);
+
+    // Минимум сопротивления цепи и максимум силы тока соединения на одной частоте, Q = sqrt(L / C) / R
+    QCOMPARE(analysis.resonances.size(), size_t(2));
+    double expected = resonanceFrequency(0.1, 0.00001);
+    for (auto iter = analysis.resonances.cbegin(); iter != analysis.resonances.cend(); iter++)
+    {
+        QVERIFY(std::abs(iter->frequency - expected) <= 1e-6 * expected);
+        QVERIFY(std::abs(iter->q - 10) <= 1e-6);
+        CORE_COMPARE_COMPLEX(1.0, iter->current, 1e-9);
+    }
+    QCOMPARE(analysis.resonances[0].node, -1);
+    QVERIFY(!analysis.resonances[0].isMaximum);
+    QCOMPARE(analysis.resonances[1].node, topology.findNode("s"));
+    QVERIFY(analysis.resonances[1].isMaximum);
+}
+
+void resonanceAnalysis_tests::evaluate_parallelTank()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(tankCircuitText(), circuitMap), 50);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 10, 100000);
+
+    // Сопротивление цепи: минимум у последовательного контура, максимум у параллельного и минимум сразу после него
+    std::vector<Resonance> impedance;
+    for (auto iter = analysis.resonances.cbegin(); iter != analysis.resonances.cend(); iter++)
+    {
+        if (iter->node == -1)
+            impedance.push_back(*iter);
+    }
+    QCOMPARE(impedance.size(), size_t(3));
+    QVERIFY(!impedance[0].isMaximum && impedance[1].isMaximum && !impedance[2].isMaximum);
+    QVERIFY(std::abs(impedance[1].frequency / resonanceFrequency(0.001, 0.000001) - 1) < 0.02);
+
+    // Найденные частоты - точные экстремумы: соседние частоты не лучше
+    for (auto iter = impedance.cbegin(); iter != impedance.cend(); iter++)
+    {
+        double value = impedanceAt(topology, iter->frequency);
+        for (double ratio : { 1 - 1e-6, 1 + 1e-6 })
+        {
+            double neighbour = impedanceAt(topology, iter->frequency * ratio);
+            QVERIFY(iter->isMaximum ? neighbour <= value : neighbour >= value);
+        }
+        QVERIFY(iter->q > 1);
+    }
+
+    // Выбранные соединения - все именованные, по алфавиту
+    QCOMPARE(analysis.outputNodes, std::vector<int>({ topology.findNode("s"), topology.findNode("tank"), topology.findNode("tc"),
+                                                      topology.findNode("tl") }));
+}
+
+void resonanceAnalysis_tests::evaluate_highQuality()
+{
+    // Ширина полосы в миллион раз меньше шага начальной сетки
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(seriesCircuitText("0.0001"), circuitMap), 50);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 10, 100000);
+
+    QCOMPARE(analysis.resonances.size(), size_t(2));
+    double expected = resonanceFrequency(0.1, 0.00001);
+    QVERIFY(std::abs(analysis.resonances[0].frequency - expected) <= 1e-6 * expected);
+    QVERIFY(std::abs(analysis.resonances[0].q - 1e6) <= 1e-3 * 1e6);
+    QVERIFY(analysis.evaluationCount < 1000);
+}
+
+void resonanceAnalysis_tests::evaluate_boundNearRangeEnd()
+{
+    // Граница полосы за пределами диапазона: добротность оценивается по кривизне
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(seriesCircuitText("10"), circuitMap), 50);
+    double expected = resonanceFrequency(0.1, 0.00001);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 10, expected * 1.01);
+
+    QCOMPARE(analysis.resonances.size(), size_t(2));
+    QVERIFY(std::abs(analysis.resonances[0].frequency - expected) <= 1e-6 * expected);
+    QVERIFY(std::abs(analysis.resonances[0].q - 10) <= 0.01 * 10);
+}
+
+void resonanceAnalysis_tests::evaluate_noResonances()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\" frequency=\"50\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem>"
+        "<elem><type>L</type><ind>0.01</ind></elem></seq></seq>", circuitMap), 50);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 1, 1000);
+    QVERIFY(analysis.resonances.empty());
+    QCOMPARE(formatOutput(topology, analysis), std::string("resonance = none\n"));
+}
+
+void resonanceAnalysis_tests::evaluate_errors()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(seriesCircuitText("10"), circuitMap), 50);
+    QVERIFY_EXCEPTION_THROWN(ResonanceAnalysis::evaluate(topology, 0, 100), std::string);
+    QVERIFY_EXCEPTION_THROWN(ResonanceAnalysis::evaluate(topology, 100, 10), std::string);
+
+    CircuitMap resistiveMap;
+    CircuitTopology resistive = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem></seq></seq>", resistiveMap), -1);
+    QVERIFY_EXCEPTION_THROWN(ResonanceAnalysis::evaluate(resistive, 1, 100), std::string);
+}
+
+void resonanceAnalysis_tests::formatOutput_sections()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(seriesCircuitText("10"), circuitMap), 50);
+    ResonanceAnalysis analysis = ResonanceAnalysis::evaluate(topology, 10, 100000);
+    QCOMPARE(formatOutput(topology, analysis),
+             formatStr("resonance = impedance min\nfrequency = 159.236\nq = 10\ncurrent = %1\n\n"
+                       "resonance = current s max\nfrequency = 159.236\nq = 10\ncurrent = %2\n",
+                       { complexToString(analysis.resonances[0].current), complexToString(analysis.resonances[1].current) }));
+}
+
+QTEST_APPLESS_MAIN(resonanceAnalysis_tests)
+
+#include "tst_resonanceanalysis_tests.moc"
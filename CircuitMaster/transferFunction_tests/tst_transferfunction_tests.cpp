@@ -0,0 +1,206 @@
+#include <QtTest>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/transferFunction.h"
+
+/*!
+*\file
+*\brief Тесты для расчета цепи на любой частоте по передаточным функциям
+*/
+
+class transferFunction_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void evaluate_baseFrequencyMatchesConnectionTree();
+    void evaluate_otherFrequenciesMatchConnectionTree();
+    void evaluate_resistorsWithoutFrequency();
+    void evaluate_selectedNodes();
+
+    void compile_reactiveElementsWithoutFrequency();
+    void compile_degreeLimit();
+    void compile_ladderDegree();
+
+    void sweep_directMatchesTransferFunction();
+
+    void logFrequencies_endpoints();
+};
+
+/*!
+* \brief Текст цепи с резисторами, катушками и конденсаторами
+* \param[in] frequency - частота переменного тока
+* \return - текст документа
+*/
+static std::string rlcCircuitText(double frequency)
+{
+    return formatStr(
+        "<seq voltage=\"20\" frequency=\"%1\">"
+        "<par name=\"p\">"
+        "<seq name=\"a\"><elem><type>R</type><res>10</res></elem><elem><type>L</type><ind>0.05</ind></elem></seq>"
+        "<seq name=\"b\"><elem><type>C</type><cap>0.0002</cap></elem></seq>"
+        "<par><seq name=\"c\"><elem><type>R</type><res>30</res></elem></seq>"
+        "<seq><elem><type>L</type><ind>0.02</ind></elem><elem><type>C</type><cap>0.001</cap></elem></seq></par>"
+        "</par>"
+        "<seq name=\"d\"><elem><type>R</type><res>5</res></elem></seq>"
+        "</seq>",
+        { numberToStr(frequency) });
+}
+
+/*!
+* \brief Текст лестничной цепи: в каждом звене последовательно катушка с резистором и параллельно конденсатор,
+* последнее звено нагружено резистором
+* \param[in] sectionCount - количество звеньев
+* \return - текст документа
+*/
+static std::string ladderCircuitText(int sectionCount)
+{
+    std::string text = "<seq name=\"load\"><elem><type>R</type><res>50</res></elem></seq>";
+    for (int k = sectionCount; k >= 1; k--)
+    {
+        text = formatStr("<seq name=\"L%1\"><elem><type>L</type><ind>0.001</ind></elem><elem><type>R</type><res>0.5</res></elem></seq>"
+                         "<par><seq name=\"C%1\"><elem><type>C</type><cap>0.000001</cap></elem></seq><seq>%2</seq></par>",
+                         { numberToStr(k), text });
+    }
+    return "<seq voltage=\"10\" frequency=\"50\">" + text + "</seq>";
+}
+
+/*!
+* \brief Сравнить силы тока, рассчитанные по передаточным функциям, с расчетом дерева соединений
+* \param[in] function - передаточные функции
+* \param[in] frequency - частота переменного тока
+* \param[in] epsilon - допустимая погрешность
+*/
+static void compareWithConnectionTree(TransferFunction const & function, double frequency, double epsilon)
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(rlcCircuitText(frequency), circuitMap);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CORE_COMPARE_COMPLEX(root->getResistance(), function.evaluateImpedance(frequency), epsilon);
+    for (size_t i = 0; i < function.names.size(); i++)
+        CORE_COMPARE_COMPLEX(findCoreConnection(circuitMap, function.names[i])->getCurrent(), function.evaluateCurrent(i, frequency), epsilon);
+}
+
+void transferFunction_tests::evaluate_baseFrequencyMatchesConnectionTree()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(rlcCircuitText(50), circuitMap));
+    TransferFunction function = TransferFunction::compile(topology, 50);
+
+    QCOMPARE(function.names.size(), size_t(5));
+    compareWithConnectionTree(function, 50, 1e-9);
+}
+
+void transferFunction_tests::evaluate_otherFrequenciesMatchConnectionTree()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(rlcCircuitText(50), circuitMap));
+    TransferFunction function = TransferFunction::compile(topology, 50);
+
+    // Сопротивления элементов рассчитываются в float, поэтому на других частотах совпадение приближенное
+    std::vector<double> frequencies = TransferFunction::logFrequencies(1, 10000, 9);
+    for (auto iter = frequencies.cbegin(); iter != frequencies.cend(); iter++)
+        compareWithConnectionTree(function, *iter, 1e-4);
+}
+
+void transferFunction_tests::evaluate_resistorsWithoutFrequency()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<par voltage=\"10\"><seq name=\"a\"><elem><type>R</type><res>5</res></elem></seq>"
+        "<seq name=\"b\"><elem><type>R</type><res>20</res></elem></seq></par>", circuitMap));
+    TransferFunction function = TransferFunction::compile(topology, -1);
+
+    QCOMPARE(function.impedance.degree(), size_t(0));
+    CORE_COMPARE_COMPLEX(4, function.evaluateImpedance(1000), 1e-12);
+    CORE_COMPARE_COMPLEX(2, function.evaluateCurrent(0, 1), 1e-12);
+    CORE_COMPARE_COMPLEX(0.5, function.evaluateCurrent(1, 1e6), 1e-12);
+}
+
+void transferFunction_tests::evaluate_selectedNodes()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(rlcCircuitText(50), circuitMap));
+    TransferFunction function = TransferFunction::compile(topology, 50, { topology.findNode("c") });
+
+    QCOMPARE(function.names, std::vector<std::string>({ "c" }));
+    compareWithConnectionTree(function, 120, 1e-4);
+}
+
+void transferFunction_tests::compile_reactiveElementsWithoutFrequency()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\"><elem><type>R</type><res>5</res></elem><elem><type>L</type><res>2</res></elem></seq>", circuitMap));
+
+    QVERIFY_EXCEPTION_THROWN(TransferFunction::compile(topology, -1), std::string);
+}
+
+void transferFunction_tests::compile_degreeLimit()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(rlcCircuitText(50), circuitMap));
+
+    QVERIFY_EXCEPTION_THROWN(TransferFunction::compile(topology, 50, { 0 }, 2), std::string);
+}
+
+void transferFunction_tests::compile_ladderDegree()
+{
+    // Порядок цепи из 8 звеньев - 16: степени сил тока не должны складываться по всем предкам
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(ladderCircuitText(8), circuitMap), 50);
+    TransferFunction function = TransferFunction::compile(topology, 50);
+
+    QCOMPARE(function.names.size(), size_t(17));
+    CircuitState state;
+    std::vector<double> frequencies = TransferFunction::logFrequencies(10, 100000, 11);
+    for (auto iter = frequencies.cbegin(); iter != frequencies.cend(); iter++)
+    {
+        state.evaluate(topology, topology.rootVoltage, *iter);
+        for (size_t i = 0; i < function.names.size(); i++)
+        {
+            std::complex<double> expected = state.currents[topology.findNode(function.names[i])];
+            QVERIFY(function.currents[i].degree() <= 16);
+            CORE_COMPARE_COMPLEX(expected, function.evaluateCurrent(i, *iter), 1e-8 * std::abs(expected));
+        }
+    }
+}
+
+void transferFunction_tests::sweep_directMatchesTransferFunction()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(ladderCircuitText(3), circuitMap), 50);
+    std::vector<double> frequencies = TransferFunction::logFrequencies(10, 1000, 3);
+    FrequencySweep compiled = FrequencySweep::evaluate(topology, frequencies);
+    QVERIFY(!compiled.isDirect);
+    QCOMPARE(formatOutput(FrequencySweep::evaluateDirect(topology, frequencies)), formatOutput(compiled));
+
+    // Цепь, степень которой больше допустимой, рассчитывается на каждой частоте напрямую
+    CircuitMap largeMap;
+    CircuitTopology large = CircuitTopology::fromConnection(*coreCircuitFromText(ladderCircuitText(30), largeMap), 50);
+    QVERIFY_EXCEPTION_THROWN(TransferFunction::compile(large, 50), std::string);
+    FrequencySweep direct = FrequencySweep::evaluate(large, frequencies);
+    QVERIFY(direct.isDirect);
+    QCOMPARE(direct.currents.size(), frequencies.size());
+    QVERIFY(formatOutput(direct).find("load = ") != std::string::npos);
+}
+
+void transferFunction_tests::logFrequencies_endpoints()
+{
+    std::vector<double> frequencies = TransferFunction::logFrequencies(10, 1000, 3);
+
+    QCOMPARE(frequencies.size(), size_t(3));
+    QCOMPARE(frequencies[0], 10.0);
+    QVERIFY(std::abs(frequencies[1] - 100) < 1e-9);
+    QVERIFY(std::abs(frequencies[2] - 1000) < 1e-9);
+    QVERIFY_EXCEPTION_THROWN(TransferFunction::logFrequencies(0, 1000, 3), std::string);
+}
+
+QTEST_APPLESS_MAIN(transferFunction_tests)
+
+#include "tst_transferfunction_tests.moc"
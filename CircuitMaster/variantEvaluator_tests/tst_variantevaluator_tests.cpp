@@ -0,0 +1,441 @@
+#include <QtTest>
+#include <thread>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/variantEvaluator.h"
+
+/*!
+*\file
+*\brief Тесты для плоского представления цепи и расчета вариантов с одинаковой топологией
+*/
+
+class variantEvaluator_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void topology_preOrder();
+    void topology_findNode();
+
+    void evaluate_nominalValues();
+    void evaluate_matchesConnectionTree();
+    void evaluate_zeroResistanceVariant();
+    void evaluate_allSimdLevels();
+    void evaluate_defaultOutputNodes();
+
+    void single_matchesFullWithinBound();
+    void single_allSimdLevels();
+    void single_resonanceRefinedInDouble();
+
+    void state_matchesConnectionTree();
+    void state_otherFrequency();
+    void state_concurrentScenarios();
+    void state_zeroResistance();
+    void state_wideConnections();
+    void state_wideParallelExtremeResistances();
+};
+
+/*!
+* \brief Текст цепи, в которой сопротивления резисторов зависят от номера варианта
+* \param[in] variant - номер варианта
+* \return - текст документа
+*/
+static std::string variantCircuitText(int variant)
+{
+    return formatStr(
+        "<seq voltage=\"%1\" frequency=\"50\" name=\"root\">"
+        "<par name=\"par1\">"
+        "<seq name=\"seq1\"><elem><type>R</type><res>%2</res></elem><elem><type>L</type><res>0.1</res></elem></seq>"
+        "<seq name=\"seq2\"><elem><type>R</type><res>%3</res></elem></seq>"
+        "<seq name=\"seq3\"><elem><type>C</type><res>0.001</res></elem></seq>"
+        "</par>"
+        "<seq name=\"seq4\"><elem><type>R</type><res>%4</res></elem></seq>"
+        "</seq>",
+        { numberToStr(10 + variant % 7), numberToStr(1 + variant), numberToStr(2 + variant % 3), numberToStr(5 + variant % 11) });
+}
+
+/*!
+* \brief Номера всех соединений топологии
+* \param[in] topology - топология цепи
+* \return - номера соединений
+*/
+static std::vector<int> allNodes(CircuitTopology const & topology)
+{
+    std::vector<int> nodes;
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+        nodes.push_back(static_cast<int>(n));
+    return nodes;
+}
+
+void variantEvaluator_tests::topology_preOrder()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap));
+
+    QCOMPARE(topology.nodes.size(), size_t(6));
+    QCOMPARE(topology.elementTypes.size(), size_t(5));
+    QCOMPARE(topology.nodes[0].customName, std::string("root"));
+    QCOMPARE(topology.nodes[1].customName, std::string("par1"));
+    QCOMPARE(topology.nodes[2].customName, std::string("seq1"));
+    QCOMPARE(topology.nodes[5].customName, std::string("seq4"));
+
+    for (size_t i = 1; i < topology.nodes.size(); i++)
+        QVERIFY(topology.nodes[i].parent < static_cast<int>(i));
+
+    QCOMPARE(topology.nodes[1].childCount, 3);
+    QCOMPARE(topology.childIndices[topology.nodes[1].firstChild], 2);
+    QCOMPARE(topology.nodes[2].elementCount, 2);
+    QCOMPARE(topology.elementTypes[topology.nodes[2].firstElement + 1], CoreElement::ElemType::L);
+}
+
+void variantEvaluator_tests::topology_findNode()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap));
+
+    QCOMPARE(topology.findNode("seq3"), 4);
+    QCOMPARE(topology.findNode("missing"), -1);
+}
+
+void variantEvaluator_tests::evaluate_nominalValues()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(variantCircuitText(0), circuitMap);
+    CircuitTopology topology = CircuitTopology::fromConnection(*root);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    VariantResults results = VariantEvaluator(topology).evaluate(VariantBatch(topology, 3), allNodes(topology));
+
+    QCOMPARE(results.failedCount, size_t(0));
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        CoreConnection const * connection = findCoreConnection(circuitMap, topology.nodes[n].customName);
+        for (size_t k = 0; k < 3; k++)
+        {
+            CORE_COMPARE_COMPLEX(connection->getResistance(), results.resistance(n, k), 1e-9);
+            CORE_COMPARE_COMPLEX(connection->getCurrent(), results.current(n, k), 1e-9);
+            CORE_COMPARE_COMPLEX(connection->getVoltage(), results.voltage(n, k), 1e-9);
+        }
+    }
+}
+
+void variantEvaluator_tests::evaluate_matchesConnectionTree()
+{
+    // Количество вариантов не кратно ширине векторов и размеру блока
+    const int count = 263;
+    std::vector<CircuitMap> circuits(count);
+    std::vector<CircuitTopology> topologies;
+    for (int k = 0; k < count; k++)
+        topologies.push_back(CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(k), circuits[k])));
+
+    VariantBatch batch(topologies[0], count);
+    for (int k = 0; k < count; k++)
+    {
+        for (size_t e = 0; e < topologies[k].elementResistances.size(); e++)
+            batch.setElementResistance(e, k, topologies[k].elementResistances[e]);
+        batch.setVoltage(k, topologies[k].rootVoltage);
+    }
+
+    VariantResults results = VariantEvaluator(topologies[0]).evaluate(batch, allNodes(topologies[0]));
+    QCOMPARE(results.failedCount, size_t(0));
+
+    for (int k = 0; k < count; k++)
+    {
+        CoreConnection& root = circuits[k].begin()->second;
+        root.calculateResistance();
+        root.calculateCurrentAndVoltage();
+        for (size_t n = 0; n < topologies[0].nodes.size(); n++)
+        {
+            CoreConnection const * connection = findCoreConnection(circuits[k], topologies[0].nodes[n].customName);
+            CORE_COMPARE_COMPLEX(connection->getCurrent(), results.current(n, k), 1e-9);
+            CORE_COMPARE_COMPLEX(connection->getVoltage(), results.voltage(n, k), 1e-9);
+        }
+    }
+}
+
+void variantEvaluator_tests::evaluate_zeroResistanceVariant()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap));
+
+    VariantBatch batch(topology, 10);
+    int element = topology.nodes[topology.findNode("seq4")].firstElement;
+    batch.setElementResistance(element, 7, 0);
+
+    VariantResults results = VariantEvaluator(topology).evaluate(batch);
+
+    QCOMPARE(results.failedCount, size_t(1));
+    QCOMPARE(results.errors[7], std::string("При расчете сопротивления соединения seq4 был получен 0. Проверьте правильность входных данных."));
+    QVERIFY(results.errors[6].empty());
+    QVERIFY(results.errors[8].empty());
+    CORE_COMPARE_COMPLEX(results.current(0, 0), results.current(0, 8), 1e-12);
+}
+
+void variantEvaluator_tests::evaluate_allSimdLevels()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap));
+
+    const size_t count = 37;
+    VariantBatch batch(topology, count);
+    for (size_t k = 0; k < count; k++)
+        batch.setElementResistance(0, k, std::complex<double>(1 + k, 0));
+
+    VariantResults expected = VariantEvaluator(topology, VariantEvaluator::SimdLevel::scalar).evaluate(batch, allNodes(topology));
+    VariantEvaluator::SimdLevel levels[] = { VariantEvaluator::SimdLevel::sse2, VariantEvaluator::SimdLevel::avx2,
+                                             VariantEvaluator::SimdLevel::avx512 };
+    for (VariantEvaluator::SimdLevel level : levels)
+    {
+        VariantEvaluator evaluator(topology, level);
+        QVERIFY(static_cast<int>(evaluator.getSimdLevel()) <= static_cast<int>(level));
+
+        VariantResults actual = evaluator.evaluate(batch, allNodes(topology));
+        for (size_t n = 0; n < topology.nodes.size(); n++)
+        {
+            for (size_t k = 0; k < count; k++)
+                CORE_COMPARE_COMPLEX(expected.current(n, k), actual.current(n, k), 1e-12);
+        }
+    }
+}
+
+void variantEvaluator_tests::evaluate_defaultOutputNodes()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\">"
+        "<seq name=\"named\"><elem><type>R</type><res>2</res></elem></seq>"
+        "<seq><elem><type>R</type><res>3</res></elem></seq>"
+        "</seq>", circuitMap));
+
+    VariantResults results = VariantEvaluator(topology).evaluate(VariantBatch(topology, 5));
+
+    QVERIFY(results.hasNode(0));
+    QVERIFY(results.hasNode(1));
+    QVERIFY(!results.hasNode(2));
+    CORE_COMPARE_COMPLEX(std::complex<double>(2, 0), results.current(0, 4), 1e-12);
+    CORE_COMPARE_COMPLEX(std::complex<double>(4, 0), results.voltage(1, 4), 1e-12);
+}
+
+void variantEvaluator_tests::single_matchesFullWithinBound()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap));
+
+    const size_t count = 100;
+    VariantBatch batch(topology, count);
+    for (size_t k = 0; k < count; k++)
+        batch.setElementResistance(0, k, std::complex<double>(1 + 0.37 * k, 0));
+
+    VariantResults expected = VariantEvaluator(topology).evaluate(batch, allNodes(topology));
+    VariantEvaluator evaluator(topology, VariantEvaluator::SimdLevel::automatic, VariantEvaluator::Precision::single);
+    QVERIFY(evaluator.getPrecision() == VariantEvaluator::Precision::single);
+    VariantResults actual = evaluator.evaluate(batch, allNodes(topology));
+
+    // Цепь без резонансов рассчитывается в float целиком, погрешность не превышает оценку
+    QCOMPARE(actual.refinedCount, size_t(0));
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        for (size_t k = 0; k < count; k++)
+        {
+            double bound = actual.currentErrorBound(n, k);
+            QVERIFY(bound > 0 && bound <= 1e-4);
+            QVERIFY(std::abs(actual.current(n, k) - expected.current(n, k)) <= bound * std::abs(expected.current(n, k)));
+        }
+    }
+}
+
+void variantEvaluator_tests::single_allSimdLevels()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(3), circuitMap));
+
+    const size_t count = 37;
+    VariantBatch batch(topology, count);
+    for (size_t k = 0; k < count; k++)
+        batch.setVoltage(k, std::complex<double>(5 + k, 1));
+
+    VariantResults expected = VariantEvaluator(topology).evaluate(batch, allNodes(topology));
+    VariantEvaluator::SimdLevel levels[] = { VariantEvaluator::SimdLevel::scalar, VariantEvaluator::SimdLevel::sse2,
+                                             VariantEvaluator::SimdLevel::avx2, VariantEvaluator::SimdLevel::avx512 };
+    for (VariantEvaluator::SimdLevel level : levels)
+    {
+        VariantResults actual = VariantEvaluator(topology, level, VariantEvaluator::Precision::single).evaluate(batch, allNodes(topology));
+        for (size_t n = 0; n < topology.nodes.size(); n++)
+        {
+            for (size_t k = 0; k < count; k++)
+                CORE_COMPARE_COMPLEX(expected.current(n, k), actual.current(n, k), actual.currentErrorBound(n, k) * std::abs(expected.current(n, k)));
+        }
+    }
+}
+
+void variantEvaluator_tests::single_resonanceRefinedInDouble()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\" frequency=\"50\">"
+        "<par name=\"tank\">"
+        "<seq name=\"coil\"><elem><type>L</type><res>4</res></elem></seq>"
+        "<seq name=\"capacitor\"><elem><type>C</type><res>4</res></elem></seq>"
+        "</par>"
+        "<seq><elem><type>R</type><res>1</res></elem></seq>"
+        "</seq>", circuitMap));
+
+    // У вариантов с нечетным номером проводимости катушки и конденсатора почти уравновешены:
+    // их сумма теряет в float все значащие цифры, такие варианты пересчитываются в double
+    const size_t count = 20;
+    int capacitor = topology.nodes[topology.findNode("capacitor")].firstElement;
+    VariantBatch batch(topology, count);
+    for (size_t k = 0; k < count; k++)
+        batch.setElementResistance(capacitor, k, std::complex<double>(0, k % 2 ? -4 * (1 + 1e-7) : -2));
+
+    VariantResults expected = VariantEvaluator(topology).evaluate(batch, allNodes(topology));
+    VariantResults actual = VariantEvaluator(topology, VariantEvaluator::SimdLevel::automatic,
+                                             VariantEvaluator::Precision::single).evaluate(batch, allNodes(topology));
+
+    QCOMPARE(actual.refinedCount, count / 2);
+    QCOMPARE(actual.failedCount, size_t(0));
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        for (size_t k = 1; k < count; k += 2)
+        {
+            QCOMPARE(actual.currentErrorBound(n, k), 0.0);
+            QCOMPARE(actual.current(n, k), expected.current(n, k));
+        }
+    }
+}
+
+void variantEvaluator_tests::state_matchesConnectionTree()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(variantCircuitText(3), circuitMap);
+    CircuitTopology topology = CircuitTopology::fromConnection(*root, 50);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CircuitState state;
+    state.evaluate(topology);
+
+    for (size_t n = 0; n < topology.nodes.size(); n++)
+    {
+        CoreConnection const * connection = findCoreConnection(circuitMap, topology.nodes[n].customName);
+        QCOMPARE(state.resistances[n], connection->getResistance());
+        QCOMPARE(state.currents[n], connection->getCurrent());
+        QCOMPARE(state.voltages[n], connection->getVoltage());
+    }
+    QCOMPARE(formatOutput(topology, state), formatOutput(circuitMap));
+}
+
+void variantEvaluator_tests::state_otherFrequency()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<seq voltage=\"10\" frequency=\"50\"><elem><type>R</type><res>3</res></elem>"
+        "<elem><type>L</type><res>2</res></elem><elem><type>C</type><res>8</res></elem></seq>", circuitMap), 50);
+
+    CircuitState state;
+    state.evaluate(topology, 20, 100);
+
+    // На удвоенной частоте сопротивление катушки удваивается, конденсатора - уменьшается вдвое
+    CORE_COMPARE_COMPLEX(std::complex<double>(3, 0), state.resistances[0], 1e-12);
+    CORE_COMPARE_COMPLEX(std::complex<double>(20, 0) / 3.0, state.currents[0], 1e-12);
+
+    // Исходная топология не изменяется
+    QCOMPARE(topology.elementResistances[1], std::complex<double>(0, 2));
+}
+
+void variantEvaluator_tests::state_concurrentScenarios()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(variantCircuitText(0), circuitMap), 50);
+
+    // Потоки рассчитывают одну топологию с разными напряжениями, каждый со своим состоянием
+    const int threadCount = 4;
+    std::vector<CircuitState> states(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+        threads.emplace_back([&, t]() {
+            for (int k = 0; k < 1000; k++)
+                states[t].evaluate(topology, std::complex<double>(t + 1, 0));
+        });
+    for (auto iter = threads.begin(); iter != threads.end(); iter++)
+        iter->join();
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        for (size_t n = 0; n < topology.nodes.size(); n++)
+            CORE_COMPARE_COMPLEX(states[0].currents[n] * double(t + 1), states[t].currents[n], 1e-9);
+    }
+}
+
+void variantEvaluator_tests::state_zeroResistance()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(
+        "<par voltage=\"10\" frequency=\"50\"><seq><elem><type>L</type><res>2</res></elem></seq>"
+        "<seq><elem><type>C</type><res>2</res></elem></seq></par>", circuitMap), 50);
+
+    CircuitState state;
+    QVERIFY_EXCEPTION_THROWN(state.evaluate(topology), std::string);
+    state.evaluate(topology, 10, 100);
+    CORE_COMPARE_COMPLEX(std::complex<double>(0, 7.5), state.currents[0], 1e-12);
+}
+
+/*!
+* \brief Текст цепи с широким параллельным соединением и длинной цепочкой элементов
+* \return - текст документа
+*/
+static std::string wideCircuitText()
+{
+    std::string text = "<seq voltage=\"10\" frequency=\"50\"><par name=\"bus\">";
+    for (int i = 0; i < 2000; i++)
+        text += formatStr("<seq><elem><type>R</type><res>%1</res></elem><elem><type>%2</type><res>%3</res></elem></seq>",
+                          { numberToStr(1 + i % 7), i % 2 == 0 ? "L" : "C", numberToStr(1 + i % 11) });
+    text += "</par><seq name=\"line\">";
+    for (int i = 0; i < 100; i++)
+        text += "<elem><type>R</type><res>0.25</res></elem>";
+    return text + "</seq></seq>";
+}
+
+void variantEvaluator_tests::state_wideConnections()
+{
+    CircuitMap circuitMap;
+    CoreConnection* root = coreCircuitFromText(wideCircuitText(), circuitMap);
+    CircuitTopology topology = CircuitTopology::fromConnection(*root, 50);
+    root->calculateResistance();
+    root->calculateCurrentAndVoltage();
+
+    CircuitState state;
+    state.evaluate(topology);
+
+    // Дерево соединений и состояние складывают слагаемые широких соединений в одном порядке
+    QCOMPARE(formatOutput(topology, state), formatOutput(circuitMap));
+    CORE_COMPARE_COMPLEX(std::complex<double>(25, 0), state.resistances[topology.findNode("line")], 1e-12);
+}
+
+void variantEvaluator_tests::state_wideParallelExtremeResistances()
+{
+    CircuitMap circuitMap;
+    CircuitTopology topology = CircuitTopology::fromConnection(*coreCircuitFromText(wideCircuitText(), circuitMap), 50);
+    CircuitState state;
+    state.evaluate(topology);
+    std::complex<double> busResistance = state.resistances[topology.findNode("bus")];
+
+    // Квадраты модулей таких сопротивлений не помещаются в double, сумма пересчитывается делением std::complex
+    double scales[] = { 1e160, 1e-160 };
+    for (double scale : scales)
+    {
+        CircuitTopology scaled = topology;
+        for (auto iter = scaled.elementResistances.begin(); iter != scaled.elementResistances.end(); iter++)
+            *iter *= scale;
+        state.evaluate(scaled);
+        CORE_COMPARE_COMPLEX(busResistance, state.resistances[scaled.findNode("bus")] / scale, 1e-12 * std::abs(busResistance));
+    }
+}
+
+QTEST_APPLESS_MAIN(variantEvaluator_tests)
+
+#include "tst_variantevaluator_tests.moc"
@@ -0,0 +1,257 @@
+#include <QtTest>
+#include <cmath>
+#include <limits>
+#include <random>
+#include "../circuitMaster_core/circuitState.h"
+#include "../circuitMaster_core/circuitTopology.h"
+#include "../circuitMaster_core/coreIo.h"
+#include "../circuitMaster_core/coreStrings.h"
+#include "../circuitMaster_core/coreTestFunctions.h"
+#include "../circuitMaster_core/worstCaseAnalysis.h"
+
+/*!
+*\file
+*\brief Тесты для расчета наихудших сил тока при допусках элементов
+*/
+
+class worstCaseAnalysis_tests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void relative_multipliers();
+
+    void evaluate_singleResistor();
+    void evaluate_zeroTolerance();
+    void evaluate_containsSamples();
+    void evaluate_resonantTank();
+    void evaluate_unbounded();
+    void evaluate_errors();
+
+    void tolerancesFromDocument_attributes();
+    void tolerancesFromDocument_errors();
+
+    void formatOutput_lines();
+};
+
+/*!
+* \brief Цепь и допуски элементов, указанные в тексте документа
+*/
+class WorstCaseProblem
+{
+    public:
+    DocumentNode rootElement; /*!< Корневой узел документа */
+    CircuitTopology topology; /*!< Топология цепи */
+    std::vector<ElementTolerance> tolerances; /*!< Допуски элементов */
+
+    explicit WorstCaseProblem(std::string const & text)
+        : topology(topologyFromText(text, this->rootElement))
+    {
+        this->tolerances = tolerancesFromDocument(this->rootElement, this->topology);
+    }
+
+    /*!
+    * \brief Рассчитать модули сил тока выбранных соединений при заданных отклонениях элементов
+    * \param[in] analysis - границы, в которых указаны выбранные соединения
+    * \param[in] deviations - отклонения элементов от -1 до 1
+    * \return - модули сил тока в порядке analysis.outputNodes
+    */
+    std::vector<double> currents(WorstCaseAnalysis const & analysis, std::vector<double> const & deviations) const
+    {
+        std::vector<std::pair<int, std::complex<double>>> resistances;
+        for (size_t e = 0; e < deviations.size(); e++)
+        {
+            ElementTolerance const & tolerance = this->tolerances[e];
+            double multiplier = (tolerance.lower + tolerance.upper) / 2 + deviations[e] * (tolerance.upper - tolerance.lower) / 2;
+            resistances.push_back({ static_cast<int>(e), this->topology.elementResistances[e] * multiplier });
+        }
+        CircuitState state = evaluateWithResistances(this->topology, resistances);
+        std::vector<double> result;
+        for (auto iter = analysis.outputNodes.cbegin(); iter != analysis.outputNodes.cend(); iter++)
+            result.push_back(std::abs(state.currents[*iter]));
+        return result;
+    }
+
+    /*!
+    * \brief Проверить, что границы содержат силы тока во всех вершинах и случайных точках допусков
+    * \param[in] analysis - рассчитанные границы
+    * \param[in] maxRatio - наибольшее допустимое отношение ширины границ к ширине найденного диапазона
+    */
+    void verifySamples(WorstCaseAnalysis const & analysis, double maxRatio) const
+    {
+        size_t elementCount = this->tolerances.size();
+        std::vector<double> minimums(analysis.outputNodes.size(), std::numeric_limits<double>::infinity());
+        std::vector<double> maximums(analysis.outputNodes.size(), 0);
+        std::mt19937 generator(5);
+        std::uniform_real_distribution<double> distribution(-1, 1);
+        size_t vertexCount = size_t(1) << elementCount;
+        for (size_t sample = 0; sample < vertexCount + 1000; sample++)
+        {
+            std::vector<double> deviations(elementCount);
+            for (size_t e = 0; e < elementCount; e++)
+                deviations[e] = sample < vertexCount ? ((sample >> e) & 1 ? 1 : -1) : distribution(generator);
+            std::vector<double> currents = this->currents(analysis, deviations);
+            for (size_t i = 0; i < currents.size(); i++)
+            {
+                minimums[i] = std::min(minimums[i], currents[i]);
+                maximums[i] = std::max(maximums[i], currents[i]);
+            }
+        }
+
+        for (size_t i = 0; i < analysis.outputNodes.size(); i++)
+        {
+            QVERIFY(analysis.minimums[i] <= minimums[i]);
+            QVERIFY(analysis.maximums[i] >= maximums[i]);
+            QVERIFY(analysis.maximums[i] - analysis.minimums[i] <= maxRatio * (maximums[i] - minimums[i]));
+        }
+    }
+};
+
+void worstCaseAnalysis_tests::relative_multipliers()
+{
+    ElementTolerance direct = ElementTolerance::relative(0.1, false);
+    QCOMPARE(direct.lower, 0.9);
+    QCOMPARE(direct.upper, 1.1);
+
+    // Сопротивление конденсатора обратно пропорционально емкости
+    ElementTolerance reciprocal = ElementTolerance::relative(0.1, true);
+    QCOMPARE(reciprocal.lower, 1 / 1.1);
+    QCOMPARE(reciprocal.upper, 1 / 0.9);
+}
+
+void worstCaseAnalysis_tests::evaluate_singleResistor()
+{
+    // |I| = U / R при R от 4.5 до 5.5
+    WorstCaseProblem problem("<seq voltage=\"10\"><seq name=\"r\"><elem tolerance=\"10%\"><type>R</type><res>5</res></elem></seq></seq>");
+    WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances);
+    QCOMPARE(analysis.outputNodes, std::vector<int>({ problem.topology.findNode("r") }));
+    QVERIFY(analysis.minimums[0] <= 10 / 5.5 && analysis.minimums[0] >= 0.97 * 10 / 5.5);
+    QVERIFY(analysis.maximums[0] >= 10 / 4.5 && analysis.maximums[0] <= 1e-6 + 10 / 4.5);
+}
+
+void worstCaseAnalysis_tests::evaluate_zeroTolerance()
+{
+    WorstCaseProblem problem("<seq voltage=\"230\" frequency=\"50\">"
+                             "<par name=\"p\">"
+                             "<seq name=\"a\"><elem><type>R</type><res>100</res></elem><elem><type>L</type><ind>0.1</ind></elem></seq>"
+                             "<seq name=\"b\"><elem><type>C</type><cap>0.0001</cap></elem></seq>"
+                             "</par>"
+                             "<seq name=\"d\"><elem><type>R</type><res>20</res></elem></seq>"
+                             "</seq>");
+    WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances);
+
+    // Без допусков границы совпадают с модулями сил тока исходной цепи
+    CircuitState state;
+    state.evaluate(problem.topology);
+    for (size_t i = 0; i < analysis.outputNodes.size(); i++)
+    {
+        double current = std::abs(state.currents[analysis.outputNodes[i]]);
+        QVERIFY(std::abs(analysis.minimums[i] - current) <= 1e-8 * current);
+        QVERIFY(std::abs(analysis.maximums[i] - current) <= 1e-8 * current);
+    }
+}
+
+void worstCaseAnalysis_tests::evaluate_containsSamples()
+{
+    WorstCaseProblem problem("<seq voltage=\"230\" frequency=\"50\" tolerance=\"5%\">"
+                             "<par name=\"p\">"
+                             "<seq name=\"a\"><elem tolerance=\"1%\"><type>R</type><res>100</res></elem><elem><type>L</type><ind>0.1</ind></elem></seq>"
+                             "<seq name=\"b\"><elem><type>C</type><cap>0.0001</cap></elem></seq>"
+                             "<seq name=\"c\"><elem><type>R</type><res>50</res></elem><elem><type>C</type><res>30</res></elem></seq>"
+                             "</par>"
+                             "<seq name=\"d\"><elem><type>R</type><res>20</res></elem><elem><type>L</type><ind>0.05</ind></elem></seq>"
+                             "</seq>");
+    // Границы гарантированы при любом количестве слагаемых
+    for (int termCount = 1; termCount <= WorstCaseAnalysis::maxTermCount; termCount++)
+    {
+        WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances, termCount);
+        QCOMPARE(analysis.outputNodes.size(), size_t(5));
+        problem.verifySamples(analysis, 3);
+    }
+}
+
+void worstCaseAnalysis_tests::evaluate_resonantTank()
+{
+    // Параллельный контур, сопротивление которого может быть бесконечным: силы тока остаются ограниченными.
+    // Вершины допусков не попадают точно в резонанс, иначе проверочный расчет завершится ошибкой
+    WorstCaseProblem problem("<seq voltage=\"10\" frequency=\"50\" tolerance=\"2%\">"
+                             "<seq name=\"r\"><elem><type>R</type><res>10</res></elem></seq>"
+                             "<par name=\"tank\"><seq name=\"l\"><elem><type>L</type><res>100</res></elem></seq>"
+                             "<seq name=\"c\"><elem><type>C</type><res>101</res></elem></seq></par>"
+                             "</seq>");
+    for (int termCount = 1; termCount <= WorstCaseAnalysis::maxTermCount; termCount++)
+    {
+        WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances, termCount);
+        for (size_t i = 0; i < analysis.outputNodes.size(); i++)
+            QVERIFY(std::isfinite(analysis.maximums[i]));
+        problem.verifySamples(analysis, 4);
+    }
+}
+
+void worstCaseAnalysis_tests::evaluate_unbounded()
+{
+    // Последовательный контур в резонансе: сила тока ограничена только малым резистором
+    WorstCaseProblem problem("<seq voltage=\"10\" frequency=\"50\" tolerance=\"2%\">"
+                             "<seq name=\"s\"><elem><type>L</type><res>100</res></elem><elem><type>C</type><res>100</res></elem></seq>"
+                             "</seq>");
+    WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances);
+    QCOMPARE(analysis.minimums[0], 0.0);
+    QVERIFY(std::isinf(analysis.maximums[0]));
+    QCOMPARE(formatOutput(problem.topology, analysis), std::string("s = 0 .. inf\n"));
+}
+
+void worstCaseAnalysis_tests::evaluate_errors()
+{
+    WorstCaseProblem problem("<seq voltage=\"10\"><seq name=\"r\"><elem><type>R</type><res>5</res></elem></seq></seq>");
+    QVERIFY_EXCEPTION_THROWN(WorstCaseAnalysis::evaluate(problem.topology, std::vector<ElementTolerance>(2)), std::string);
+    QVERIFY_EXCEPTION_THROWN(WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances, 0), std::string);
+    QVERIFY_EXCEPTION_THROWN(WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances, WorstCaseAnalysis::maxTermCount + 1), std::string);
+
+    // Без допусков нулевое сопротивление - ошибка, как и при обычном расчете
+    WorstCaseProblem resonance("<seq voltage=\"10\"><seq name=\"s\"><elem><type>L</type><res>100</res></elem>"
+                               "<elem><type>C</type><res>100</res></elem></seq></seq>");
+    QVERIFY_EXCEPTION_THROWN(WorstCaseAnalysis::evaluate(resonance.topology, resonance.tolerances), std::string);
+}
+
+void worstCaseAnalysis_tests::tolerancesFromDocument_attributes()
+{
+    // Допуск корневого узла действует на элементы без своего допуска
+    WorstCaseProblem problem("<seq voltage=\"10\" frequency=\"50\" tolerance=\"0.1\">"
+                             "<seq><elem><type>R</type><res>5</res></elem><elem tolerance=\"20%\"><type>L</type><ind>0.1</ind></elem></seq>"
+                             "<par><seq><elem tolerance=\"0\"><type>C</type><cap>0.001</cap></elem></seq>"
+                             "<seq><elem><type>C</type><cap>0.001</cap></elem></seq><seq><elem><type>C</type><res>3</res></elem></seq></par>"
+                             "</seq>");
+    std::vector<ElementTolerance> const & tolerances = problem.tolerances;
+    QCOMPARE(tolerances.size(), size_t(5));
+    QCOMPARE(tolerances[0].lower, 0.9);
+    QCOMPARE(tolerances[1].upper, 1.2);
+    QCOMPARE(tolerances[2].lower, 1.0);
+    QCOMPARE(tolerances[2].upper, 1.0);
+    QCOMPARE(tolerances[3].upper, 1 / 0.9);
+    QCOMPARE(tolerances[4].upper, 1.1);
+}
+
+void worstCaseAnalysis_tests::tolerancesFromDocument_errors()
+{
+    char const * wrongTolerances[] = { "-0.1", "1", "100%", "x", "5%%" };
+    for (char const * tolerance : wrongTolerances)
+    {
+        std::string text = std::string("<seq voltage=\"10\"><seq><elem tolerance=\"") + tolerance +
+                           "\"><type>R</type><res>5</res></elem></seq></seq>";
+        QVERIFY_EXCEPTION_THROWN(WorstCaseProblem problem(text), std::string);
+    }
+}
+
+void worstCaseAnalysis_tests::formatOutput_lines()
+{
+    WorstCaseProblem problem("<seq voltage=\"10\" tolerance=\"10%\"><seq name=\"b\"><elem><type>R</type><res>5</res></elem></seq>"
+                             "<seq name=\"a\"><elem tolerance=\"0\"><type>R</type><res>5</res></elem></seq></seq>");
+    WorstCaseAnalysis analysis = WorstCaseAnalysis::evaluate(problem.topology, problem.tolerances);
+    QCOMPARE(formatOutput(problem.topology, analysis),
+             formatStr("a = %1 .. %2\nb = %3 .. %4\n", { numberToStr(analysis.minimums[0]), numberToStr(analysis.maximums[0]),
+                                                        numberToStr(analysis.minimums[1]), numberToStr(analysis.maximums[1]) }));
+}
+
+QTEST_APPLESS_MAIN(worstCaseAnalysis_tests)
+
+#include "tst_worstcaseanalysis_tests.moc"